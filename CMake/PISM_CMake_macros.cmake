@@ -158,6 +158,9 @@ macro(pism_find_prerequisites)
   # MPI
   find_package (MPI REQUIRED COMPONENTS C)
 
+  # Threads (used to write output files asynchronously)
+  find_package (Threads REQUIRED)
+
   # Other required libraries
   find_package (UDUNITS2 REQUIRED)
   find_package (GSL REQUIRED)
@@ -178,6 +181,10 @@ macro(pism_find_prerequisites)
     find_package (ParallelIO REQUIRED)
   endif()
 
+  if (Pism_USE_OPENMP)
+    find_package (OpenMP REQUIRED)
+  endif()
+
   if (Pism_USE_PARALLEL_NETCDF4)
     # Try to find netcdf_par.h. We assume that NetCDF was compiled with
     # parallel I/O if this header is present.
@@ -242,7 +249,8 @@ macro(pism_set_dependencies)
     ${NETCDF_LIBRARIES}
     ${MPI_C_LIBRARIES}
     ${HDF5_LIBRARIES}
-    ${HDF5_HL_LIBRARIES})
+    ${HDF5_HL_LIBRARIES}
+    ${CMAKE_THREAD_LIBS_INIT})
 
   # optional libraries
   if (Pism_USE_JANSSON)
@@ -265,6 +273,13 @@ macro(pism_set_dependencies)
     list (APPEND Pism_EXTERNAL_LIBS ${PNETCDF_LIBRARIES})
   endif()
 
+  if (Pism_USE_OPENMP)
+    set (CMAKE_C_FLAGS "${CMAKE_C_FLAGS} ${OpenMP_C_FLAGS}")
+    set (CMAKE_CXX_FLAGS "${CMAKE_CXX_FLAGS} ${OpenMP_CXX_FLAGS}")
+    set (CMAKE_EXE_LINKER_FLAGS "${CMAKE_EXE_LINKER_FLAGS} ${OpenMP_CXX_FLAGS}")
+    set (CMAKE_SHARED_LINKER_FLAGS "${CMAKE_SHARED_LINKER_FLAGS} ${OpenMP_CXX_FLAGS}")
+  endif()
+
   # Hide distracting CMake variables
   mark_as_advanced(file_cmd MPI_LIBRARY MPI_EXTRA_LIBRARY
     HDF5_C_LIBRARY_dl HDF5_C_LIBRARY_hdf5 HDF5_C_LIBRARY_hdf5_hl HDF5_C_LIBRARY_m HDF5_C_LIBRARY_z
@@ -21,6 +21,7 @@
 
 #include "pism/age/AgeColumnSystem.hh"
 #include "pism/util/error_handling.hh"
+#include "pism/util/pism_utilities.hh"
 #include "pism/util/Vars.hh"
 #include "pism/util/io/File.hh"
 
@@ -62,6 +63,8 @@ AgeModel::AgeModel(IceGrid::ConstPtr grid, stressbalance::StressBalance *stress_
     m_work(m_grid, "work_vector", WITHOUT_GHOSTS),
     m_stress_balance(stress_balance) {
 
+  m_ice_age.set_precision(storage_precision(*m_config, "age"));
+
   m_ice_age.set_attrs("model_state", "age of ice",
                       "s", "years", "" /* no standard name*/, 0);
 
@@ -119,51 +122,56 @@ void AgeModel::update(double t, double dt, const AgeModelInputs &inputs) {
     &v3 = *inputs.v3,
     &w3 = *inputs.w3;
 
-  AgeColumnSystem system(m_grid->z(), "age",
-                         m_grid->dx(), m_grid->dy(), dt,
-                         m_ice_age, u3, v3, w3); // linear system to solve in each column
-
-  size_t Mz_fine = system.z().size();
-  std::vector<double> x(Mz_fine);   // space for solution
-
   IceModelVec::AccessList list{&ice_thickness, &u3, &v3, &w3, &m_ice_age, &m_work};
 
   unsigned int Mz = m_grid->Mz();
 
   ParallelSection loop(m_grid->com);
-  try {
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      system.init(i, j, ice_thickness(i, j));
-
-      if (system.ks() == 0) {
-        // if no ice, set the entire column to zero age
-        m_work.set_column(i, j, 0.0);
-      } else {
-        // general case: solve advection PDE
-
-        // solve the system for this column; call checks that params set
-        system.solve(x);
-
-        // put solution in IceModelVec3
-        system.fine_to_coarse(x, i, j, m_work);
-
-        // Ensure that the age of the ice is non-negative.
-        //
-        // FIXME: this is a kludge. We need to ensure that our numerical method has the maximum
-        // principle instead. (We may still need this for correctness, though.)
-        double *column = m_work.get_column(i, j);
-        for (unsigned int k = 0; k < Mz; ++k) {
-          if (column[k] < 0.0) {
-            column[k] = 0.0;
+#pragma omp parallel
+  {
+    try {
+      // linear system to solve in each column (one per thread; constructed here so that
+      // exceptions are caught)
+      AgeColumnSystem system(m_grid->z(), "age",
+                             m_grid->dx(), m_grid->dy(), dt,
+                             m_ice_age, u3, v3, w3);
+
+      size_t Mz_fine = system.z().size();
+      std::vector<double> x(Mz_fine);   // space for solution
+
+      for (Points p(*m_grid, thread_index(), thread_count()); p; p.next()) {
+        const int i = p.i(), j = p.j();
+
+        system.init(i, j, ice_thickness(i, j));
+
+        if (system.ks() == 0) {
+          // if no ice, set the entire column to zero age
+          m_work.set_column(i, j, 0.0);
+        } else {
+          // general case: solve advection PDE
+
+          // solve the system for this column; call checks that params set
+          system.solve(x);
+
+          // put solution in IceModelVec3
+          system.fine_to_coarse(x, i, j, m_work);
+
+          // Ensure that the age of the ice is non-negative.
+          //
+          // FIXME: this is a kludge. We need to ensure that our numerical method has the maximum
+          // principle instead. (We may still need this for correctness, though.)
+          double *column = m_work.get_column(i, j);
+          for (unsigned int k = 0; k < Mz; ++k) {
+            if (column[k] < 0.0) {
+              column[k] = 0.0;
+            }
           }
         }
       }
+    } catch (...) {
+      loop.failed();
     }
-  } catch (...) {
-    loop.failed();
-  }
+  } // end of the parallel region
   loop.check();
 
   m_work.update_ghosts(m_ice_age);
@@ -38,6 +38,7 @@
 #include "pism/util/Vars.hh"
 #include "pism/util/iceModelVec.hh"
 #include "pism/util/Time.hh"
+#include "pism/util/pism_utilities.hh"
 #include "pism/geometry/Geometry.hh"
 
 #include "pism/coupler/util/options.hh"
@@ -341,16 +342,28 @@ void Pico::compute_ocean_input_per_basin(const PicoPhysics &physics, const IceMo
     }
   }
 
+  // compute global sums for all basins at once
+  {
+    GlobalReduction sums(m_grid->com);
+    int
+      C = sums.add(GlobalReduction::SUM, std::vector<double>(count.begin(), count.end())),
+      S = sums.add(GlobalReduction::SUM, salinity),
+      T = sums.add(GlobalReduction::SUM, temperature);
+    sums.reduce();
+
+    for (int basin_id = 0; basin_id < m_n_basins; basin_id++) {
+      count[basin_id]       = sums[C + basin_id];
+      salinity[basin_id]    = sums[S + basin_id];
+      temperature[basin_id] = sums[T + basin_id];
+    }
+  }
+
   // Divide by number of grid cells if more than zero cells belong to the basin. if no
   // ocean_contshelf_mask values intersect with the basin, count is zero. In such case,
   // use dummy temperature and salinity. This could happen, for example, if the ice shelf
   // front advances beyond the continental shelf break.
   for (int basin_id = 0; basin_id < m_n_basins; basin_id++) {
 
-    count[basin_id]       = GlobalSum(m_grid->com, count[basin_id]);
-    salinity[basin_id]    = GlobalSum(m_grid->com, salinity[basin_id]);
-    temperature[basin_id] = GlobalSum(m_grid->com, temperature[basin_id]);
-
     // if basin is not dummy basin 0 or there are no ocean cells in this basin to take the mean over.
     if (basin_id > 0 && count[basin_id] == 0) {
       m_log->message(2, "PICO ocean WARNING: basin %d contains no cells with ocean data on continental shelf\n"
@@ -402,10 +415,21 @@ void Pico::set_ocean_input_fields(const PicoPhysics &physics, const IceModelVec2
       n_shelf_cells[s]++;
     }
 
+    GlobalReduction sums(m_grid->com);
+    std::vector<int> per_basin(m_n_shelves);
+    int per_shelf = sums.add(GlobalReduction::SUM,
+                             std::vector<double>(n_shelf_cells.begin(), n_shelf_cells.end()));
     for (int s = 0; s < m_n_shelves; s++) {
-      n_shelf_cells[s] = GlobalSum(m_grid->com, n_shelf_cells[s]);
+      per_basin[s] = sums.add(GlobalReduction::SUM,
+                              std::vector<double>(n_shelf_cells_per_basin[s].begin(),
+                                                  n_shelf_cells_per_basin[s].end()));
+    }
+    sums.reduce();
+
+    for (int s = 0; s < m_n_shelves; s++) {
+      n_shelf_cells[s] = sums[per_shelf + s];
       for (int b = 0; b < m_n_basins; b++) {
-        n_shelf_cells_per_basin[s][b] = GlobalSum(m_grid->com, n_shelf_cells_per_basin[s][b]);
+        n_shelf_cells_per_basin[s][b] = sums[per_basin[s] + b];
       }
     }
   }
@@ -755,13 +779,20 @@ void Pico::compute_box_average(int box_id,
   }
 
   // compute the global sum and average
+  GlobalReduction sums(m_grid->com);
+  int
+    N = sums.add(GlobalReduction::SUM,
+                 std::vector<double>(n_cells_per_box.begin(), n_cells_per_box.end())),
+    F = sums.add(GlobalReduction::SUM, result);
+  sums.reduce();
+
   for (int s = 0; s < m_n_shelves; ++s) {
-    auto n_cells = GlobalSum(m_grid->com, n_cells_per_box[s]);
+    auto n_cells = sums[N + s];
 
-    result[s] = GlobalSum(m_grid->com, result[s]);
+    result[s] = sums[F + s];
 
     if (n_cells > 0) {
-      result[s] /= (double)n_cells;
+      result[s] /= n_cells;
     }
   }
 }
@@ -795,8 +826,11 @@ void Pico::compute_box_area(int box_id,
   }
 
   // compute global sums
+  GlobalReduction sums(m_grid->com);
+  sums.add(GlobalReduction::SUM, result);
+  sums.reduce();
   for (int s = 1; s < m_n_shelves; ++s) {
-    result[s] = GlobalSum(m_grid->com, result[s]);
+    result[s] = sums[s];
   }
 }
 
@@ -161,8 +161,11 @@ static void relabel(RelabelingType type,
     }
     loop.check();
 
+    GlobalReduction sums(grid->com);
+    sums.add(GlobalReduction::SUM, area);
+    sums.reduce();
     for (unsigned int k = 0; k < area.size(); ++k) {
-      area[k] = grid->cell_area() * GlobalSum(grid->com, area[k]);
+      area[k] = grid->cell_area() * sums[k];
     }
   }
 
@@ -646,9 +649,17 @@ void PicoGeometry::compute_box_mask(const IceModelVec2Int &D_gl, const IceModelV
   }
 
   // compute global maximums
-  for (int k = 0; k < n_shelves; ++k) {
-    GL_distance_max[k] = GlobalMax(m_grid->com, GL_distance_max[k]);
-    CF_distance_max[k] = GlobalMax(m_grid->com, CF_distance_max[k]);
+  {
+    GlobalReduction maxima(m_grid->com);
+    int
+      GL = maxima.add(GlobalReduction::MAX, GL_distance_max),
+      CF = maxima.add(GlobalReduction::MAX, CF_distance_max);
+    maxima.reduce();
+
+    for (int k = 0; k < n_shelves; ++k) {
+      GL_distance_max[k] = maxima[GL + k];
+      CF_distance_max[k] = maxima[CF + k];
+    }
   }
 
   double GL_distance_ref = *std::max_element(GL_distance_max.begin(), GL_distance_max.end());
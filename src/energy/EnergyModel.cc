@@ -119,10 +119,18 @@ bool marginal(const IceModelVec2S &thickness, int i, int j, double threshold) {
 
 
 void EnergyModelStats::sum(MPI_Comm com) {
-  bulge_counter            = GlobalSum(com, bulge_counter);
-  reduced_accuracy_counter = GlobalSum(com, reduced_accuracy_counter);
-  low_temperature_counter  = GlobalSum(com, low_temperature_counter);
-  liquified_ice_volume     = GlobalSum(com, liquified_ice_volume);
+  GlobalReduction sums(com);
+  int
+    bulge            = sums.add(GlobalReduction::SUM, bulge_counter),
+    reduced_accuracy = sums.add(GlobalReduction::SUM, reduced_accuracy_counter),
+    low_temperature  = sums.add(GlobalReduction::SUM, low_temperature_counter),
+    liquified_volume = sums.add(GlobalReduction::SUM, liquified_ice_volume);
+  sums.reduce();
+
+  bulge_counter            = sums[bulge];
+  reduced_accuracy_counter = sums[reduced_accuracy];
+  low_temperature_counter  = sums[low_temperature];
+  liquified_ice_volume     = sums[liquified_volume];
 }
 
 
@@ -134,6 +142,7 @@ EnergyModel::EnergyModel(IceGrid::ConstPtr grid,
 
   {
     m_ice_enthalpy.create(m_grid, "enthalpy", WITH_GHOSTS, WIDE_STENCIL);
+    m_ice_enthalpy.set_precision(storage_precision(*m_config, "enthalpy"));
     // POSSIBLE standard name = land_ice_enthalpy
     m_ice_enthalpy.set_attrs("model_state",
                              "ice enthalpy (includes sensible heat, latent heat, pressure)",
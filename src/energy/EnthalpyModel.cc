@@ -138,13 +138,6 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
     &ice_surface_temp         = *inputs.surface_temp,
     &till_water_thickness     = *inputs.till_water_thickness;
 
-  energy::enthSystemCtx system(m_grid->z(), "energy.enthalpy", m_grid->dx(), m_grid->dy(), dt,
-                               *m_config, m_ice_enthalpy, u3, v3, w3, strain_heating3, EC);
-
-  const size_t Mz_fine = system.z().size();
-  const double dz = system.dz();
-  std::vector<double> Enthnew(Mz_fine); // new enthalpy in column
-
   IceModelVec::AccessList list{&ice_surface_temp, &shelf_base_temp, &surface_liquid_fraction,
       &ice_thickness, &basal_frictional_heating, &basal_heat_flux, &till_water_thickness,
       &cell_type, &u3, &v3, &w3, &strain_heating3, &m_basal_melt_rate, &m_ice_enthalpy,
@@ -152,234 +145,251 @@ void EnthalpyModel::update_impl(double t, double dt, const Inputs &inputs) {
 
   double margin_threshold = m_config->get_number("energy.margin_ice_thickness_limit");
 
-  unsigned int liquifiedCount = 0;
-
   ParallelSection loop(m_grid->com);
-  try {
-    for (Points pt(*m_grid); pt; pt.next()) {
-      const int i = pt.i(), j = pt.j();
-
-      const double H = ice_thickness(i, j);
-
-      system.init(i, j,
-                  marginal(ice_thickness, i, j, margin_threshold),
-                  H);
-
-      // enthalpy and pressures at top of ice
-      const double
-        depth_ks = H - system.ks() * dz,
-        p_ks     = EC->pressure(depth_ks); // FIXME issue #15
-
-      const double Enth_ks = EC->enthalpy_permissive(ice_surface_temp(i, j),
-                                                     surface_liquid_fraction(i, j), p_ks);
-
-      const bool ice_free_column = (system.ks() == 0);
-
-      // deal completely with columns with no ice; enthalpy and basal_melt_rate need setting
-      if (ice_free_column) {
-        m_work.set_column(i, j, Enth_ks);
-        // The floating basal melt rate will be set later; cover this
-        // case and set to zero for now. Also, there is no basal melt
-        // rate on ice free land and ice free ocean
-        m_basal_melt_rate(i, j) = 0.0;
-        continue;
-      } // end of if (ice_free_column)
-
-      if (system.lambda() < 1.0) {
-        m_stats.reduced_accuracy_counter += 1; // count columns with lambda < 1
-      }
+#pragma omp parallel
+  {
+    // counters are per-thread
+    EnergyModelStats stats;
+    unsigned int liquifiedCount = 0;
+
+    try {
+      // column systems and work space are per-thread (constructed here so that exceptions
+      // are caught)
+      energy::enthSystemCtx system(m_grid->z(), "energy.enthalpy", m_grid->dx(), m_grid->dy(), dt,
+                                   *m_config, m_ice_enthalpy, u3, v3, w3, strain_heating3, EC);
+
+      const size_t Mz_fine = system.z().size();
+      const double dz = system.dz();
+      std::vector<double> Enthnew(Mz_fine); // new enthalpy in column
+
+      for (Points pt(*m_grid, thread_index(), thread_count()); pt; pt.next()) {
+        const int i = pt.i(), j = pt.j();
+
+        const double H = ice_thickness(i, j);
+
+        system.init(i, j,
+                    marginal(ice_thickness, i, j, margin_threshold),
+                    H);
+
+        // enthalpy and pressures at top of ice
+        const double
+          depth_ks = H - system.ks() * dz,
+          p_ks     = EC->pressure(depth_ks); // FIXME issue #15
+
+        const double Enth_ks = EC->enthalpy_permissive(ice_surface_temp(i, j),
+                                                       surface_liquid_fraction(i, j), p_ks);
+
+        const bool ice_free_column = (system.ks() == 0);
+
+        // deal completely with columns with no ice; enthalpy and basal_melt_rate need setting
+        if (ice_free_column) {
+          m_work.set_column(i, j, Enth_ks);
+          // The floating basal melt rate will be set later; cover this
+          // case and set to zero for now. Also, there is no basal melt
+          // rate on ice free land and ice free ocean
+          m_basal_melt_rate(i, j) = 0.0;
+          continue;
+        } // end of if (ice_free_column)
 
-      const bool
-        is_floating        = cell_type.ocean(i, j),
-        base_is_warm       = system.Enth(0) >= system.Enth_s(0),
-        above_base_is_warm = system.Enth(1) >= system.Enth_s(1);
-
-      // set boundary conditions and update enthalpy
-      {
-        system.set_surface_dirichlet_bc(Enth_ks);
-
-        // determine lowest-level equation at bottom of ice; see
-        // decision chart in the source code browser and page
-        // documenting BOMBPROOF
-        if (is_floating) {
-          // floating base: Dirichlet application of known temperature from ocean
-          //   coupler; assumes base of ice shelf has zero liquid fraction
-          double Enth0 = EC->enthalpy_permissive(shelf_base_temp(i, j), 0.0, EC->pressure(H));
-
-          system.set_basal_dirichlet_bc(Enth0);
-        } else {
-          // grounded ice warm and wet
-          if (base_is_warm && (till_water_thickness(i, j) > 0.0)) {
-            if (above_base_is_warm) {
-              // temperate layer at base (Neumann) case:  q . n = 0  (K0 grad E . n = 0)
-              system.set_basal_heat_flux(0.0);
-            } else {
-              // only the base is warm: E = E_s(p) (Dirichlet)
-              // ( Assumes ice has zero liquid fraction. Is this a valid assumption here?
-              system.set_basal_dirichlet_bc(system.Enth_s(0));
-            }
-          } else {
-            // (Neumann) case:  q . n = q_lith . n + F_b
-            // a) cold and dry base, or
-            // b) base that is still warm from the last time step, but without basal water
-            system.set_basal_heat_flux(basal_heat_flux(i, j) + basal_frictional_heating(i, j));
-          }
+        if (system.lambda() < 1.0) {
+          stats.reduced_accuracy_counter += 1; // count columns with lambda < 1
         }
 
-        // solve the system
-        system.solve(Enthnew);
-
-      }
-
-      // post-process (drainage and bulge-limiting)
-      double Hdrainedtotal = 0.0;
-      double Hfrozen = 0.0;
-      {
-        // drain ice segments by mechanism in [\ref AschwandenBuelerKhroulevBlatter],
-        //   using DrainageCalculator dc
-        for (unsigned int k=0; k < system.ks(); k++) {
-          if (Enthnew[k] > system.Enth_s(k)) { // avoid doing any more work if cold
-
-            const double
-              depth = H - k * dz,
-              p     = EC->pressure(depth), // FIXME issue #15
-              T_m   = EC->melting_temperature(p),
-              L     = EC->L(T_m);
-
-            if (Enthnew[k] >= system.Enth_s(k) + 0.5 * L) {
-              liquifiedCount++; // count these rare events...
-              Enthnew[k] = system.Enth_s(k) + 0.5 * L; //  but lose the energy
-            }
+        const bool
+          is_floating        = cell_type.ocean(i, j),
+          base_is_warm       = system.Enth(0) >= system.Enth_s(0),
+          above_base_is_warm = system.Enth(1) >= system.Enth_s(1);
 
-            double omega = EC->water_fraction(Enthnew[k], p);
+        // set boundary conditions and update enthalpy
+        {
+          system.set_surface_dirichlet_bc(Enth_ks);
 
-            if (omega > target_water_fraction) {
-              double fractiondrained = dc.get_drainage_rate(omega) * dt; // pure number
+          // determine lowest-level equation at bottom of ice; see
+          // decision chart in the source code browser and page
+          // documenting BOMBPROOF
+          if (is_floating) {
+            // floating base: Dirichlet application of known temperature from ocean
+            //   coupler; assumes base of ice shelf has zero liquid fraction
+            double Enth0 = EC->enthalpy_permissive(shelf_base_temp(i, j), 0.0, EC->pressure(H));
 
-              fractiondrained  = std::min(fractiondrained,
-                                          omega - target_water_fraction);
-              Hdrainedtotal   += fractiondrained * dz; // always a positive contribution
-              Enthnew[k]      -= fractiondrained * L;
+            system.set_basal_dirichlet_bc(Enth0);
+          } else {
+            // grounded ice warm and wet
+            if (base_is_warm && (till_water_thickness(i, j) > 0.0)) {
+              if (above_base_is_warm) {
+                // temperate layer at base (Neumann) case:  q . n = 0  (K0 grad E . n = 0)
+                system.set_basal_heat_flux(0.0);
+              } else {
+                // only the base is warm: E = E_s(p) (Dirichlet)
+                // ( Assumes ice has zero liquid fraction. Is this a valid assumption here?
+                system.set_basal_dirichlet_bc(system.Enth_s(0));
+              }
+            } else {
+              // (Neumann) case:  q . n = q_lith . n + F_b
+              // a) cold and dry base, or
+              // b) base that is still warm from the last time step, but without basal water
+              system.set_basal_heat_flux(basal_heat_flux(i, j) + basal_frictional_heating(i, j));
             }
           }
-        }
 
-        // apply bulge limiter
-        const double lowerEnthLimit = Enth_ks - bulgeEnthMax;
-        for (unsigned int k=0; k < system.ks(); k++) {
-          if (Enthnew[k] < lowerEnthLimit) {
-            // Count grid points which have very large cold limit advection bulge... enthalpy not
-            // too low.
-            m_stats.bulge_counter += 1;
-            Enthnew[k] = lowerEnthLimit;
-          }
+          // solve the system
+          system.solve(Enthnew);
+
         }
 
-        // if there is subglacial water, don't allow ice base enthalpy to be below
-        // pressure-melting; that is, assume subglacial water is at the pressure-
-        // melting temperature and enforce continuity of temperature
+        // post-process (drainage and bulge-limiting)
+        double Hdrainedtotal = 0.0;
+        double Hfrozen = 0.0;
         {
-          if (Enthnew[0] < system.Enth_s(0) && till_water_thickness(i,j) > 0.0) {
-            const double E_difference = system.Enth_s(0) - Enthnew[0];
-
-            const double depth = H,
-              pressure         = EC->pressure(depth),
-              T_m              = EC->melting_temperature(pressure);
-
-            Enthnew[0] = system.Enth_s(0);
-            // This adjustment creates energy out of nothing. We will
-            // freeze some basal water, subtracting an equal amount of
-            // energy, to make up for it.
-            //
-            // Note that [E_difference] = J/kg, so
-            //
-            // U_difference = E_difference * ice_density * dx * dy * (0.5*dz)
-            //
-            // is the amount of energy created (we changed enthalpy of
-            // a block of ice with the volume equal to
-            // dx*dy*(0.5*dz); note that the control volume
-            // corresponding to the grid point at the base of the
-            // column has thickness 0.5*dz, not dz).
-            //
-            // Also, [L] = J/kg, so
-            //
-            // U_freeze_on = L * ice_density * dx * dy * Hfrozen,
-            //
-            // is the amount of energy created by freezing a water
-            // layer of thickness Hfrozen (using units of ice
-            // equivalent thickness).
-            //
-            // Setting U_difference = U_freeze_on and solving for
-            // Hfrozen, we find the thickness of the basal water layer
-            // we need to freeze co restore energy conservation.
-
-            Hfrozen = E_difference * (0.5*dz) / EC->L(T_m);
-          }
-        }
+          // drain ice segments by mechanism in [\ref AschwandenBuelerKhroulevBlatter],
+          //   using DrainageCalculator dc
+          for (unsigned int k=0; k < system.ks(); k++) {
+            if (Enthnew[k] > system.Enth_s(k)) { // avoid doing any more work if cold
 
-      } // end of post-processing
-
-      // compute basal melt rate
-      {
-        bool base_is_cold = (Enthnew[0] < system.Enth_s(0)) && (till_water_thickness(i,j) == 0.0);
-        // Determine melt rate, but only preliminarily because of
-        // drainage, from heat flux out of bedrock, heat flux into
-        // ice, and frictional heating
-        if (is_floating) {
-          // The floating basal melt rate will be set later; cover
-          // this case and set to zero for now. Note that
-          // Hdrainedtotal is discarded (the ocean model determines
-          // the basal melt).
-          m_basal_melt_rate(i, j) = 0.0;
-        } else {
-          if (base_is_cold) {
-            m_basal_melt_rate(i, j) = 0.0;  // zero melt rate if cold base
-          } else {
-            const double
-              p_0 = EC->pressure(H),
-              p_1 = EC->pressure(H - dz), // FIXME issue #15
-              Tpmp_0 = EC->melting_temperature(p_0);
-
-            const bool k1_istemperate = EC->is_temperate(Enthnew[1], p_1); // level  z = + \Delta z
-            double hf_up = 0.0;
-            if (k1_istemperate) {
               const double
-                Tpmp_1 = EC->melting_temperature(p_1);
+                depth = H - k * dz,
+                p     = EC->pressure(depth), // FIXME issue #15
+                T_m   = EC->melting_temperature(p),
+                L     = EC->L(T_m);
+
+              if (Enthnew[k] >= system.Enth_s(k) + 0.5 * L) {
+                liquifiedCount++; // count these rare events...
+                Enthnew[k] = system.Enth_s(k) + 0.5 * L; //  but lose the energy
+              }
+
+              double omega = EC->water_fraction(Enthnew[k], p);
+
+              if (omega > target_water_fraction) {
+                double fractiondrained = dc.get_drainage_rate(omega) * dt; // pure number
+
+                fractiondrained  = std::min(fractiondrained,
+                                            omega - target_water_fraction);
+                Hdrainedtotal   += fractiondrained * dz; // always a positive contribution
+                Enthnew[k]      -= fractiondrained * L;
+              }
+            }
+          }
 
-              hf_up = -system.k_from_T(Tpmp_0) * (Tpmp_1 - Tpmp_0) / dz;
-            } else {
-              double T_0 = EC->temperature(Enthnew[0], p_0);
-              const double K_0 = system.k_from_T(T_0) / EC->c();
+          // apply bulge limiter
+          const double lowerEnthLimit = Enth_ks - bulgeEnthMax;
+          for (unsigned int k=0; k < system.ks(); k++) {
+            if (Enthnew[k] < lowerEnthLimit) {
+              // Count grid points which have very large cold limit advection bulge... enthalpy not
+              // too low.
+              stats.bulge_counter += 1;
+              Enthnew[k] = lowerEnthLimit;
+            }
+          }
 
-              hf_up = -K_0 * (Enthnew[1] - Enthnew[0]) / dz;
+          // if there is subglacial water, don't allow ice base enthalpy to be below
+          // pressure-melting; that is, assume subglacial water is at the pressure-
+          // melting temperature and enforce continuity of temperature
+          {
+            if (Enthnew[0] < system.Enth_s(0) && till_water_thickness(i,j) > 0.0) {
+              const double E_difference = system.Enth_s(0) - Enthnew[0];
+
+              const double depth = H,
+                pressure         = EC->pressure(depth),
+                T_m              = EC->melting_temperature(pressure);
+
+              Enthnew[0] = system.Enth_s(0);
+              // This adjustment creates energy out of nothing. We will
+              // freeze some basal water, subtracting an equal amount of
+              // energy, to make up for it.
+              //
+              // Note that [E_difference] = J/kg, so
+              //
+              // U_difference = E_difference * ice_density * dx * dy * (0.5*dz)
+              //
+              // is the amount of energy created (we changed enthalpy of
+              // a block of ice with the volume equal to
+              // dx*dy*(0.5*dz); note that the control volume
+              // corresponding to the grid point at the base of the
+              // column has thickness 0.5*dz, not dz).
+              //
+              // Also, [L] = J/kg, so
+              //
+              // U_freeze_on = L * ice_density * dx * dy * Hfrozen,
+              //
+              // is the amount of energy created by freezing a water
+              // layer of thickness Hfrozen (using units of ice
+              // equivalent thickness).
+              //
+              // Setting U_difference = U_freeze_on and solving for
+              // Hfrozen, we find the thickness of the basal water layer
+              // we need to freeze co restore energy conservation.
+
+              Hfrozen = E_difference * (0.5*dz) / EC->L(T_m);
             }
+          }
 
-            // compute basal melt rate from flux balance:
-            //
-            // basal_melt_rate = - Mb / rho in [\ref AschwandenBuelerKhroulevBlatter];
-            //
-            // after we compute it we make sure there is no refreeze if
-            // there is no available basal water
-            m_basal_melt_rate(i, j) = (basal_frictional_heating(i, j) + basal_heat_flux(i, j) - hf_up) / (ice_density * EC->L(Tpmp_0));
+        } // end of post-processing
 
-            if (till_water_thickness(i, j) <= 0 && m_basal_melt_rate(i, j) < 0) {
-              m_basal_melt_rate(i, j) = 0.0;
+        // compute basal melt rate
+        {
+          bool base_is_cold = (Enthnew[0] < system.Enth_s(0)) && (till_water_thickness(i,j) == 0.0);
+          // Determine melt rate, but only preliminarily because of
+          // drainage, from heat flux out of bedrock, heat flux into
+          // ice, and frictional heating
+          if (is_floating) {
+            // The floating basal melt rate will be set later; cover
+            // this case and set to zero for now. Note that
+            // Hdrainedtotal is discarded (the ocean model determines
+            // the basal melt).
+            m_basal_melt_rate(i, j) = 0.0;
+          } else {
+            if (base_is_cold) {
+              m_basal_melt_rate(i, j) = 0.0;  // zero melt rate if cold base
+            } else {
+              const double
+                p_0 = EC->pressure(H),
+                p_1 = EC->pressure(H - dz), // FIXME issue #15
+                Tpmp_0 = EC->melting_temperature(p_0);
+
+              const bool k1_istemperate = EC->is_temperate(Enthnew[1], p_1); // level  z = + \Delta z
+              double hf_up = 0.0;
+              if (k1_istemperate) {
+                const double
+                  Tpmp_1 = EC->melting_temperature(p_1);
+
+                hf_up = -system.k_from_T(Tpmp_0) * (Tpmp_1 - Tpmp_0) / dz;
+              } else {
+                double T_0 = EC->temperature(Enthnew[0], p_0);
+                const double K_0 = system.k_from_T(T_0) / EC->c();
+
+                hf_up = -K_0 * (Enthnew[1] - Enthnew[0]) / dz;
+              }
+
+              // compute basal melt rate from flux balance:
+              //
+              // basal_melt_rate = - Mb / rho in [\ref AschwandenBuelerKhroulevBlatter];
+              //
+              // after we compute it we make sure there is no refreeze if
+              // there is no available basal water
+              m_basal_melt_rate(i, j) = (basal_frictional_heating(i, j) + basal_heat_flux(i, j) - hf_up) / (ice_density * EC->L(Tpmp_0));
+
+              if (till_water_thickness(i, j) <= 0 && m_basal_melt_rate(i, j) < 0) {
+                m_basal_melt_rate(i, j) = 0.0;
+              }
             }
-          }
 
-          // Add drained water from the column to basal melt rate.
-          m_basal_melt_rate(i, j) += (Hdrainedtotal - Hfrozen) / dt;
-        } // end of the grounded case
-      } // end of the basal melt rate computation
+            // Add drained water from the column to basal melt rate.
+            m_basal_melt_rate(i, j) += (Hdrainedtotal - Hfrozen) / dt;
+          } // end of the grounded case
+        } // end of the basal melt rate computation
 
-      system.fine_to_coarse(Enthnew, i, j, m_work);
+        system.fine_to_coarse(Enthnew, i, j, m_work);
+      }
+
+      stats.liquified_ice_volume = ((double) liquifiedCount) * dz * m_grid->cell_area();
+    } catch (...) {
+      loop.failed();
     }
-  } catch (...) {
-    loop.failed();
-  }
-  loop.check();
 
-  m_stats.liquified_ice_volume = ((double) liquifiedCount) * dz * m_grid->cell_area();
+#pragma omp critical (pism_energy_stats)
+    m_stats += stats;
+  } // end of the parallel region
+  loop.check();
 }
 
 void EnthalpyModel::define_model_state_impl(const File &output) const {
@@ -205,17 +205,6 @@ void TemperatureModel::update_impl(double t, double dt, const Inputs &inputs) {
       &cell_type, &basal_heat_flux, &till_water_thickness, &basal_frictional_heating,
       &u3, &v3, &w3, &strain_heating3, &m_basal_melt_rate, &m_ice_temperature, &m_work};
 
-  energy::tempSystemCtx system(m_grid->z(), "temperature",
-                               m_grid->dx(), m_grid->dy(), dt,
-                               *m_config,
-                               m_ice_temperature, u3, v3, w3, strain_heating3);
-
-  double dz = system.dz();
-  const std::vector<double>& z_fine = system.z();
-  size_t Mz_fine = z_fine.size();
-  std::vector<double> x(Mz_fine);// space for solution of system
-  std::vector<double> Tnew(Mz_fine); // post-processed solution
-
   // counts unreasonably low temperature values; deprecated?
   unsigned int maxLowTempCount = m_config->get_number("energy.max_low_temperature_count");
   const double T_minimum = m_config->get_number("energy.minimum_allowed_temperature");
@@ -223,127 +212,151 @@ void TemperatureModel::update_impl(double t, double dt, const Inputs &inputs) {
   double margin_threshold = m_config->get_number("energy.margin_ice_thickness_limit");
 
   ParallelSection loop(m_grid->com);
-  try {
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
+#pragma omp parallel
+  {
+    // counters are per-thread
+    EnergyModelStats stats;
 
-      MaskValue mask = static_cast<MaskValue>(cell_type.as_int(i,j));
+    try {
+      // column systems and work space are per-thread (constructed here so that exceptions
+      // are caught)
+      energy::tempSystemCtx system(m_grid->z(), "temperature",
+                                   m_grid->dx(), m_grid->dy(), dt,
+                                   *m_config,
+                                   m_ice_temperature, u3, v3, w3, strain_heating3);
 
-      const double H = ice_thickness(i, j);
-      const double T_surface = ice_surface_temp(i, j);
+      double dz = system.dz();
+      const std::vector<double>& z_fine = system.z();
+      size_t Mz_fine = z_fine.size();
+      std::vector<double> x(Mz_fine);// space for solution of system
+      std::vector<double> Tnew(Mz_fine); // post-processed solution
 
-      system.initThisColumn(i, j,
-                            marginal(ice_thickness, i, j, margin_threshold),
-                            mask, H);
+      for (Points p(*m_grid, thread_index(), thread_count()); p; p.next()) {
+        const int i = p.i(), j = p.j();
 
-      const int ks = system.ks();
+        MaskValue mask = static_cast<MaskValue>(cell_type.as_int(i,j));
 
-      if (ks > 0) { // if there are enough points in ice to bother ...
+        const double H = ice_thickness(i, j);
+        const double T_surface = ice_surface_temp(i, j);
 
-        if (system.lambda() < 1.0) {
-          m_stats.reduced_accuracy_counter += 1; // count columns with lambda < 1
-        }
+        system.initThisColumn(i, j,
+                              marginal(ice_thickness, i, j, margin_threshold),
+                              mask, H);
 
-        // set boundary values for tridiagonal system
-        system.setSurfaceBoundaryValuesThisColumn(T_surface);
-        system.setBasalBoundaryValuesThisColumn(basal_heat_flux(i,j),
-                                                shelf_base_temp(i,j),
-                                                basal_frictional_heating(i,j));
+        const int ks = system.ks();
 
-        // solve the system for this column; melting not addressed yet
-        system.solveThisColumn(x);
-      }       // end of "if there are enough points in ice to bother ..."
+        if (ks > 0) { // if there are enough points in ice to bother ...
 
-      // prepare for melting/refreezing
-      double bwatnew = till_water_thickness(i,j);
+          if (system.lambda() < 1.0) {
+            stats.reduced_accuracy_counter += 1; // count columns with lambda < 1
+          }
 
-      // insert solution for generic ice segments
-      for (int k=1; k <= ks; k++) {
-        if (allow_above_melting) { // in the ice
-          Tnew[k] = x[k];
-        } else {
-          const double
-            Tpmp = melting_point_temp - beta_CC_grad * (H - z_fine[k]); // FIXME issue #15
-          if (x[k] > Tpmp) {
-            Tnew[k] = Tpmp;
-            double Texcess = x[k] - Tpmp; // always positive
-            column_drainage(ice_density, ice_c, L, z_fine[k], dz, &Texcess, &bwatnew);
-            // Texcess  will always come back zero here; ignore it
-          } else {
+          // set boundary values for tridiagonal system
+          system.setSurfaceBoundaryValuesThisColumn(T_surface);
+          system.setBasalBoundaryValuesThisColumn(basal_heat_flux(i,j),
+                                                  shelf_base_temp(i,j),
+                                                  basal_frictional_heating(i,j));
+
+          // solve the system for this column; melting not addressed yet
+          system.solveThisColumn(x);
+        }       // end of "if there are enough points in ice to bother ..."
+
+        // prepare for melting/refreezing
+        double bwatnew = till_water_thickness(i,j);
+
+        // insert solution for generic ice segments
+        for (int k=1; k <= ks; k++) {
+          if (allow_above_melting) { // in the ice
             Tnew[k] = x[k];
+          } else {
+            const double
+              Tpmp = melting_point_temp - beta_CC_grad * (H - z_fine[k]); // FIXME issue #15
+            if (x[k] > Tpmp) {
+              Tnew[k] = Tpmp;
+              double Texcess = x[k] - Tpmp; // always positive
+              column_drainage(ice_density, ice_c, L, z_fine[k], dz, &Texcess, &bwatnew);
+              // Texcess  will always come back zero here; ignore it
+            } else {
+              Tnew[k] = x[k];
+            }
+          }
+          if (Tnew[k] < T_minimum) {
+#pragma omp critical (pism_temperature_log)
+            log.message(1,
+                        "  [[too low (<200) ice segment temp T = %f at %d, %d, %d;"
+                        " proc %d; mask=%d; w=%f m year-1]]\n",
+                        Tnew[k], i, j, k, m_grid->rank(), mask,
+                        units::convert(m_sys, system.w(k), "m second-1", "m year-1"));
+
+            stats.low_temperature_counter++;
+          }
+          if (Tnew[k] < T_surface - bulge_max) {
+            Tnew[k] = T_surface - bulge_max;
+            stats.bulge_counter += 1;
           }
         }
-        if (Tnew[k] < T_minimum) {
-          log.message(1,
-                      "  [[too low (<200) ice segment temp T = %f at %d, %d, %d;"
-                      " proc %d; mask=%d; w=%f m year-1]]\n",
-                      Tnew[k], i, j, k, m_grid->rank(), mask,
-                      units::convert(m_sys, system.w(k), "m second-1", "m year-1"));
-
-          m_stats.low_temperature_counter++;
-        }
-        if (Tnew[k] < T_surface - bulge_max) {
-          Tnew[k] = T_surface - bulge_max;
-          m_stats.bulge_counter += 1;
-        }
-      }
 
-      // insert solution for ice base segment
-      if (ks > 0) {
-        if (allow_above_melting == true) { // ice/rock interface
-          Tnew[0] = x[0];
-        } else {  // compute diff between x[k0] and Tpmp; melt or refreeze as appropriate
-          const double Tpmp = melting_point_temp - beta_CC_grad * H; // FIXME issue #15
-          double Texcess = x[0] - Tpmp; // positive or negative
-          if (ocean(mask)) {
-            // when floating, only half a segment has had its temperature raised
-            // above Tpmp
-            column_drainage(ice_density, ice_c, L, 0.0, dz/2.0, &Texcess, &bwatnew);
-          } else {
-            column_drainage(ice_density, ice_c, L, 0.0, dz, &Texcess, &bwatnew);
+        // insert solution for ice base segment
+        if (ks > 0) {
+          if (allow_above_melting == true) { // ice/rock interface
+            Tnew[0] = x[0];
+          } else {  // compute diff between x[k0] and Tpmp; melt or refreeze as appropriate
+            const double Tpmp = melting_point_temp - beta_CC_grad * H; // FIXME issue #15
+            double Texcess = x[0] - Tpmp; // positive or negative
+            if (ocean(mask)) {
+              // when floating, only half a segment has had its temperature raised
+              // above Tpmp
+              column_drainage(ice_density, ice_c, L, 0.0, dz/2.0, &Texcess, &bwatnew);
+            } else {
+              column_drainage(ice_density, ice_c, L, 0.0, dz, &Texcess, &bwatnew);
+            }
+            Tnew[0] = Tpmp + Texcess;
+            if (Tnew[0] > (Tpmp + 0.00001)) {
+              throw RuntimeError(PISM_ERROR_LOCATION, "updated temperature came out above Tpmp");
+            }
           }
-          Tnew[0] = Tpmp + Texcess;
-          if (Tnew[0] > (Tpmp + 0.00001)) {
-            throw RuntimeError(PISM_ERROR_LOCATION, "updated temperature came out above Tpmp");
+          if (Tnew[0] < T_minimum) {
+#pragma omp critical (pism_temperature_log)
+            log.message(1,
+                        "  [[too low (<200) ice/bedrock segment temp T = %f at %d,%d;"
+                        " proc %d; mask=%d; w=%f]]\n",
+                        Tnew[0],i,j,m_grid->rank(), mask,
+                        units::convert(m_sys, system.w(0), "m second-1", "m year-1"));
+
+            stats.low_temperature_counter++;
+          }
+          if (Tnew[0] < T_surface - bulge_max) {
+            Tnew[0] = T_surface - bulge_max;
+            stats.bulge_counter += 1;
           }
         }
-        if (Tnew[0] < T_minimum) {
-          log.message(1,
-                      "  [[too low (<200) ice/bedrock segment temp T = %f at %d,%d;"
-                      " proc %d; mask=%d; w=%f]]\n",
-                      Tnew[0],i,j,m_grid->rank(), mask,
-                      units::convert(m_sys, system.w(0), "m second-1", "m year-1"));
-
-          m_stats.low_temperature_counter++;
-        }
-        if (Tnew[0] < T_surface - bulge_max) {
-          Tnew[0] = T_surface - bulge_max;
-          m_stats.bulge_counter += 1;
+
+        // set to air temp above ice
+        for (unsigned int k = ks; k < Mz_fine; k++) {
+          Tnew[k] = T_surface;
         }
-      }
 
-      // set to air temp above ice
-      for (unsigned int k = ks; k < Mz_fine; k++) {
-        Tnew[k] = T_surface;
-      }
+        // transfer column into m_work; communication later
+        system.fine_to_coarse(Tnew, i, j, m_work);
 
-      // transfer column into m_work; communication later
-      system.fine_to_coarse(Tnew, i, j, m_work);
-
-      // basal_melt_rate(i,j) is rate of mass loss at bottom of ice
-      if (ocean(mask)) {
-        m_basal_melt_rate(i,j) = 0.0;
-      } else {
-        // basalMeltRate is rate of change of bwat;  can be negative
-        //   (subglacial water freezes-on); note this rate is calculated
-        //   *before* limiting or other nontrivial modelling of bwat,
-        //   which is Hydrology's job
-        m_basal_melt_rate(i,j) = (bwatnew - till_water_thickness(i,j)) / dt;
-      } // end of the grounded case
+        // basal_melt_rate(i,j) is rate of mass loss at bottom of ice
+        if (ocean(mask)) {
+          m_basal_melt_rate(i,j) = 0.0;
+        } else {
+          // basalMeltRate is rate of change of bwat;  can be negative
+          //   (subglacial water freezes-on); note this rate is calculated
+          //   *before* limiting or other nontrivial modelling of bwat,
+          //   which is Hydrology's job
+          m_basal_melt_rate(i,j) = (bwatnew - till_water_thickness(i,j)) / dt;
+        } // end of the grounded case
+      }
+    } catch (...) {
+      loop.failed();
     }
-  } catch (...) {
-    loop.failed();
-  }
+
+#pragma omp critical (pism_energy_stats)
+    m_stats += stats;
+  } // end of the parallel region
   loop.check();
 
   m_stats.low_temperature_counter = GlobalSum(m_grid->com, m_stats.low_temperature_counter);
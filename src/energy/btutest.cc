@@ -222,7 +222,8 @@ int main(int argc, char *argv[]) {
               outname,
               string_to_backend(config->get_string("output.format")),
               PISM_READWRITE_MOVE,
-              ctx->pio_iosys_id());
+              ctx->pio_iosys_id(),
+              config->get_number("output.netcdf3.n_aggregators"));
 
     io::define_time(file, *ctx);
     io::append_time(file, *ctx->config(), ctx->time()->current());
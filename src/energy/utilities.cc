@@ -53,16 +53,20 @@ void compute_enthalpy_cold(const IceModelVec3 &temperature,
   const unsigned int Mz = grid->Mz();
   const std::vector<double> &z = grid->z();
 
+  // result may be stored in single precision, so we use set_column()
+  std::vector<double> Enthij(Mz);
+
   for (Points p(*grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
     const double *Tij = temperature.get_column(i,j);
-    double *Enthij = result.get_column(i,j);
 
     for (unsigned int k = 0; k < Mz; ++k) {
       const double depth = ice_thickness(i, j) - z[k]; // FIXME issue #15
       Enthij[k] = EC->enthalpy_permissive(Tij[k], 0.0, EC->pressure(depth));
     }
+
+    result.set_column(i, j, &Enthij[0]);
   }
 
   result.inc_state_counter();
@@ -115,17 +119,21 @@ void compute_enthalpy(const IceModelVec3 &temperature,
   const unsigned int Mz = grid->Mz();
   const std::vector<double> &z = grid->z();
 
+  // result may be stored in single precision, so we use set_column()
+  std::vector<double> E(Mz);
+
   for (Points p(*grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
     const double *T     = temperature.get_column(i,j);
     const double *omega = liquid_water_fraction.get_column(i,j);
-    double       *E     = result.get_column(i,j);
 
     for (unsigned int k = 0; k < Mz; ++k) {
       const double depth = ice_thickness(i,j) - z[k]; // FIXME issue #15
       E[k] = EC->enthalpy_permissive(T[k], omega[k], EC->pressure(depth));
     }
+
+    result.set_column(i, j, &E[0]);
   }
 
   result.update_ghosts();
@@ -364,6 +372,9 @@ void bootstrap_ice_temperature(const IceModelVec2S &ice_thickness,
   IceModelVec::AccessList list{&ice_surface_temp, &surface_mass_balance,
       &ice_thickness, &basal_heat_flux, &result};
 
+  // result may be stored in single precision, so we use set_column()
+  std::vector<double> T(grid->Mz());
+
   ParallelSection loop(grid->com);
   try {
     for (Points p(*grid); p; p.next()) {
@@ -389,8 +400,6 @@ void bootstrap_ice_temperature(const IceModelVec2S &ice_thickness,
 
       const unsigned int ks = grid->kBelowHeight(H);
 
-      double *T = result.get_column(i, j);
-
       // within ice
       if (use_smb) { // method 1:  includes surface mass balance in estimate
 
@@ -424,6 +433,8 @@ void bootstrap_ice_temperature(const IceModelVec2S &ice_thickness,
       for (unsigned int k = ks; k < grid->Mz(); k++) {
         T[k] = T_surface;
       }
+
+      result.set_column(i, j, &T[0]);
     }
   } catch (...) {
     loop.failed();
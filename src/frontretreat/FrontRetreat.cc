@@ -109,9 +109,18 @@ MaxTimestep FrontRetreat::max_timestep(const IceModelVec2CellType &cell_type,
     }
   }
 
-  N_cells           = GlobalSum(grid->com, N_cells);
-  retreat_rate_mean = GlobalSum(grid->com, retreat_rate_mean);
-  retreat_rate_max  = GlobalMax(grid->com, retreat_rate_max);
+  {
+    GlobalReduction reduction(grid->com);
+    int
+      N        = reduction.add(GlobalReduction::SUM, N_cells),
+      mean     = reduction.add(GlobalReduction::SUM, retreat_rate_mean),
+      rate_max = reduction.add(GlobalReduction::MAX, retreat_rate_max);
+    reduction.reduce();
+
+    N_cells           = reduction[N];
+    retreat_rate_mean = reduction[mean];
+    retreat_rate_max  = reduction[rate_max];
+  }
 
   if (N_cells > 0.0) {
     retreat_rate_mean /= N_cells;
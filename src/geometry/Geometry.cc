@@ -236,7 +236,7 @@ double ice_volume(const Geometry &geometry, double thickness_threshold) {
     for (Points p(*grid); p; p.next()) {
       const int i = p.i(), j = p.j();
 
-      if (geometry.ice_thickness(i,j) >= thickness_threshold) {
+      if (ice_counts(geometry, thickness_threshold, i, j)) {
         volume += geometry.ice_thickness(i,j) * cell_area;
       }
     }
@@ -263,6 +263,7 @@ double ice_volume_not_displacing_seawater(const Geometry &geometry,
   const double
     sea_water_density = config->get_number("constants.sea_water.density"),
     ice_density       = config->get_number("constants.ice.density"),
+    density_ratio     = sea_water_density / ice_density,
     cell_area         = grid->cell_area();
 
   IceModelVec::AccessList list{&geometry.cell_type, &geometry.ice_thickness,
@@ -273,20 +274,8 @@ double ice_volume_not_displacing_seawater(const Geometry &geometry,
   for (Points p(*grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
-    const double
-      bed       = geometry.bed_elevation(i, j),
-      thickness = geometry.ice_thickness(i, j),
-      sea_level = geometry.sea_level_elevation(i, j);
-
-    if (geometry.cell_type.grounded(i, j) and thickness > thickness_threshold) {
-      const double cell_ice_volume = thickness * cell_area;
-      if (bed > sea_level) {
-        volume += cell_ice_volume;
-      } else {
-        const double max_floating_volume = (sea_level - bed) * cell_area * (sea_water_density / ice_density);
-        volume += cell_ice_volume - max_floating_volume;
-      }
-    }
+    volume += thickness_not_displacing_seawater(geometry, thickness_threshold,
+                                                density_ratio, i, j) * cell_area;
   } // end of the loop over grid points
 
   return GlobalSum(grid->com, volume);
@@ -304,7 +293,7 @@ double ice_area(const Geometry &geometry, double thickness_threshold) {
   for (Points p(*grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
-    if (geometry.ice_thickness(i, j) >= thickness_threshold) {
+    if (ice_counts(geometry, thickness_threshold, i, j)) {
       area += cell_area;
     }
   }
@@ -324,8 +313,7 @@ double ice_area_grounded(const Geometry &geometry, double thickness_threshold) {
   for (Points p(*grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
-    if (geometry.cell_type.grounded(i, j) and
-        geometry.ice_thickness(i, j) >= thickness_threshold) {
+    if (grounded_ice_counts(geometry, thickness_threshold, i, j)) {
       area += cell_area;
     }
   }
@@ -345,8 +333,7 @@ double ice_area_floating(const Geometry &geometry, double thickness_threshold) {
   for (Points p(*grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
-    if (geometry.cell_type.ocean(i, j) and
-        geometry.ice_thickness(i, j) >= thickness_threshold) {
+    if (floating_ice_counts(geometry, thickness_threshold, i, j)) {
       area += cell_area;
     }
   }
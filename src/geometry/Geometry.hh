@@ -69,6 +69,52 @@ double ice_volume_not_displacing_seawater(const Geometry &geometry,
                                           double thickness_threshold);
 double sea_level_rise_potential(const Geometry &geometry, double thickness_threshold);
 
+/*!
+ * Per-cell criteria used by ice_volume(), ice_area*() and
+ * ice_volume_not_displacing_seawater(), as well as by scalar diagnostics computing the same
+ * quantities in one pass over the grid. Fields used have to be accessible.
+ */
+
+//! True if the ice in the cell `(i, j)` is counted in ice area and volume.
+inline bool ice_counts(const Geometry &geometry, double thickness_threshold, int i, int j) {
+  return geometry.ice_thickness(i, j) >= thickness_threshold;
+}
+
+//! True if the cell `(i, j)` contains grounded ice that is counted in ice area and volume.
+inline bool grounded_ice_counts(const Geometry &geometry, double thickness_threshold,
+                                int i, int j) {
+  return geometry.cell_type.grounded(i, j) and ice_counts(geometry, thickness_threshold, i, j);
+}
+
+//! True if the cell `(i, j)` contains floating ice that is counted in ice area and volume.
+inline bool floating_ice_counts(const Geometry &geometry, double thickness_threshold,
+                                int i, int j) {
+  return geometry.cell_type.ocean(i, j) and ice_counts(geometry, thickness_threshold, i, j);
+}
+
+/*!
+ * Thickness of the ice in the cell `(i, j)` that does not displace sea water, in meters.
+ *
+ * @param[in] density_ratio ratio of sea water and ice densities
+ */
+inline double thickness_not_displacing_seawater(const Geometry &geometry,
+                                                double thickness_threshold,
+                                                double density_ratio,
+                                                int i, int j) {
+  const double
+    bed       = geometry.bed_elevation(i, j),
+    thickness = geometry.ice_thickness(i, j),
+    sea_level = geometry.sea_level_elevation(i, j);
+
+  if (geometry.cell_type.grounded(i, j) and thickness > thickness_threshold) {
+    if (bed > sea_level) {
+      return thickness;
+    }
+    return thickness - (sea_level - bed) * density_ratio;
+  }
+  return 0.0;
+}
+
 void set_no_model_strip(const IceGrid &grid, double width, IceModelVec2Int &result);
 
 } // end of namespace pism
@@ -273,7 +273,9 @@ void GeometryEvolution::flow_step(const Geometry &geometry, double dt,
                            m_impl->flux_staggered);    // out
   m_impl->profile.end("ge.interface_fluxes");
 
-  m_impl->flux_staggered.update_ghosts();
+  // The ghost update is finished in compute_flux_divergence() after computing the flux
+  // divergence at interior points of this sub-domain.
+  m_impl->flux_staggered.update_ghosts_begin();
 
   m_impl->profile.begin("ge.flux_divergence");
   compute_flux_divergence(m_impl->flux_staggered,   // in (uses ghosts)
@@ -640,8 +642,11 @@ void GeometryEvolution::compute_interface_fluxes(const IceModelVec2CellType &cel
  * Compute flux divergence using cell interface fluxes on the staggered grid.
  *
  * The flux divergence at *ice thickness* Dirichlet B.C. locations is set to zero.
+ *
+ * If a ghost update of `flux` is in progress (see IceModelVec::update_ghosts_begin()), it
+ * is finished after computing the divergence at interior points of this sub-domain.
  */
-void GeometryEvolution::compute_flux_divergence(const IceModelVec2Stag &flux,
+void GeometryEvolution::compute_flux_divergence(IceModelVec2Stag &flux,
                                                 const IceModelVec2Int &thickness_bc_mask,
                                                 IceModelVec2S &output) {
   const double
@@ -650,18 +655,26 @@ void GeometryEvolution::compute_flux_divergence(const IceModelVec2Stag &flux,
 
   IceModelVec::AccessList list{&flux, &thickness_bc_mask, &output};
 
+  auto divergence = [&](int i, int j) {
+    if (thickness_bc_mask(i, j) > 0.5) {
+      output(i, j) = 0.0;
+    } else {
+      StarStencil<double> Q = flux.star(i, j);
+
+      output(i, j) = (Q.e - Q.w) / dx + (Q.n - Q.s) / dy;
+    }
+  };
+
   ParallelSection loop(m_grid->com);
   try {
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
+    for (PointsInterior p(*m_grid, 1); p; p.next()) {
+      divergence(p.i(), p.j());
+    }
 
-      if (thickness_bc_mask(i, j) > 0.5) {
-        output(i, j) = 0.0;
-      } else {
-        StarStencil<double> Q = flux.star(i, j);
+    flux.update_ghosts_end();
 
-        output(i, j) = (Q.e - Q.w) / dx + (Q.n - Q.s) / dy;
-      }
+    for (PointsBoundary p(*m_grid, 1); p; p.next()) {
+      divergence(p.i(), p.j());
     }
   } catch (...) {
     loop.failed();
@@ -863,19 +876,27 @@ void GeometryEvolution::residual_redistribution_iteration(const IceModelVec2S  &
       }
     }
 
-    residual.update_ghosts();
-
-    // update area_specific_volume using adjusted residuals
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
+    // update area_specific_volume using adjusted residuals (at interior points while the
+    // ghost update of residual is in progress)
+    auto redistribute = [&](int i, int j) {
       if (cell_type.ice_free_ocean(i, j)) {
         area_specific_volume(i, j) += (residual(i + 1, j) +
                                        residual(i - 1, j) +
                                        residual(i, j + 1) +
                                        residual(i, j - 1));
       }
+    };
+
+    residual.update_ghosts_begin();
+
+    for (PointsInterior p(*m_grid, 1); p; p.next()) {
+      redistribute(p.i(), p.j());
+    }
+
+    residual.update_ghosts_end();
 
+    for (PointsBoundary p(*m_grid, 1); p; p.next()) {
+      redistribute(p.i(), p.j());
     }
 
     residual.set(0.0);
@@ -1246,14 +1267,50 @@ void GeometryEvolution::set_no_model_mask_impl(const IceModelVec2Int &mask) {
   // the default implementation is a no-op
 }
 
+/*!
+ * Volume flux (in m^3 / s) across the grounding line into the floating cell (i,j).
+ *
+ * Returns zero if (i,j) is not floating. Requires read access to `cell_type` and `flux`; `dx`
+ * and `dy` are grid spacings.
+ */
+double grounding_line_volume_flux(const IceModelVec2CellType &cell_type,
+                                  const IceModelVec2Stag &flux,
+                                  double dx, double dy,
+                                  int i, int j) {
+  using mask::grounded;
+
+  double result = 0.0;
+
+  if (cell_type.ocean(i ,j)) {
+    auto M = cell_type.int_star(i, j);
+    auto Q = flux.star(i, j); // m^2 / s
+
+    if (grounded(M.n) and Q.n <= 0.0) {
+      result += Q.n * dx;
+    }
+
+    if (grounded(M.e) and Q.e <= 0.0) {
+      result += Q.e * dy;
+    }
+
+    if (grounded(M.s) and Q.s >= 0.0) {
+      result -= Q.s * dx;
+    }
+
+    if (grounded(M.w) and Q.w >= 0.0) {
+      result -= Q.w * dy;
+    }
+  }
+
+  return result;
+}
+
 void grounding_line_flux(const IceModelVec2CellType &cell_type,
                          const IceModelVec2Stag &flux,
                          double dt,
                          InsertMode flag,
                          IceModelVec2S &output) {
 
-  using mask::grounded;
-
   auto grid = output.grid();
 
   const double
@@ -1271,31 +1328,9 @@ void grounding_line_flux(const IceModelVec2CellType &cell_type,
     for (Points p(*grid); p; p.next()) {
       const int i = p.i(), j = p.j();
 
-      double result = 0.0;
-
-      if (cell_type.ocean(i ,j)) {
-        auto M = cell_type.int_star(i, j);
-        auto Q = flux.star(i, j);
-
-        if (grounded(M.n) and Q.n <= 0.0) {
-          result += Q.n * dx;
-        }
-
-        if (grounded(M.e) and Q.e <= 0.0) {
-          result += Q.e * dy;
-        }
-
-        if (grounded(M.s) and Q.s >= 0.0) {
-          result -= Q.s * dx;
-        }
-
-        if (grounded(M.w) and Q.w >= 0.0) {
-          result -= Q.w * dy;
-        }
-
-        // convert from "m^3 / s" to "kg / m^2"
-        result *= dt * (ice_density / cell_area);
-      }
+      // convert from "m^3 / s" to "kg / m^2"
+      double result = (grounding_line_volume_flux(cell_type, flux, dx, dy, i, j) *
+                       dt * (ice_density / cell_area));
 
       if (flag == ADD_VALUES) {
         output(i, j) += result;
@@ -1315,8 +1350,6 @@ void grounding_line_flux(const IceModelVec2CellType &cell_type,
 double total_grounding_line_flux(const IceModelVec2CellType &cell_type,
                                  const IceModelVec2Stag &flux,
                                  double dt) {
-  using mask::grounded;
-
   auto grid = cell_type.grid();
 
   const double
@@ -1334,31 +1367,8 @@ double total_grounding_line_flux(const IceModelVec2CellType &cell_type,
     for (Points p(*grid); p; p.next()) {
       const int i = p.i(), j = p.j();
 
-      double volume_flux = 0.0;
-
-      if (cell_type.ocean(i ,j)) {
-        auto M = cell_type.int_star(i, j);
-        auto Q = flux.star(i, j); // m^2 / s
-
-        if (grounded(M.n) and Q.n <= 0.0) {
-          volume_flux += Q.n * dx;
-        }
-
-        if (grounded(M.e) and Q.e <= 0.0) {
-          volume_flux += Q.e * dy;
-        }
-
-        if (grounded(M.s) and Q.s >= 0.0) {
-          volume_flux -= Q.s * dx;
-        }
-
-        if (grounded(M.w) and Q.w >= 0.0) {
-          volume_flux -= Q.w * dy;
-        }
-      }
-
       // convert from "m^3 / s" to "kg" and sum up
-      total_flux += volume_flux * dt * ice_density;
+      total_flux += grounding_line_volume_flux(cell_type, flux, dx, dy, i, j) * dt * ice_density;
     }
   } catch (...) {
     loop.failed();
@@ -98,7 +98,7 @@ protected:
                                         const IceModelVec2Stag     &diffusive_flux,
                                         IceModelVec2Stag           &output);
 
-  virtual void compute_flux_divergence(const IceModelVec2Stag &flux_staggered,
+  virtual void compute_flux_divergence(IceModelVec2Stag &flux_staggered,
                                        const IceModelVec2Int &thickness_bc_mask,
                                        IceModelVec2S &flux_fivergence);
 
@@ -169,6 +169,11 @@ void grounding_line_flux(const IceModelVec2CellType &cell_type,
 double total_grounding_line_flux(const IceModelVec2CellType &cell_type,
                                  const IceModelVec2Stag &flux,
                                  double dt);
+
+double grounding_line_volume_flux(const IceModelVec2CellType &cell_type,
+                                  const IceModelVec2Stag &flux,
+                                  double dx, double dy,
+                                  int i, int j);
 } // end of namespace pism
 
 #endif /* GEOMETRYEVOLUTION_H */
@@ -393,8 +393,11 @@ const IceModelVec2Stag& Routing::velocity_staggered() const {
 
 //! Average the regular grid water thickness to values at the center of cell edges.
 /*! Uses mask values to avoid averaging using water thickness values from
-  either ice-free or floating areas. */
-void Routing::water_thickness_staggered(const IceModelVec2S &W,
+  either ice-free or floating areas.
+
+  If a ghost update of `W` is in progress (see IceModelVec::update_ghosts_begin()), it is
+  finished after computing values at interior points of this sub-domain. */
+void Routing::water_thickness_staggered(IceModelVec2S &W,
                                         const IceModelVec2CellType &mask,
                                         IceModelVec2Stag &result) {
 
@@ -402,9 +405,7 @@ void Routing::water_thickness_staggered(const IceModelVec2S &W,
 
   IceModelVec::AccessList list{ &mask, &W, &result };
 
-  for (Points p(*m_grid); p; p.next()) {
-    const int i = p.i(), j = p.j();
-
+  auto average = [&](int i, int j) {
     if (include_floating) {
       // east
       if (mask.icy(i, j)) {
@@ -432,6 +433,16 @@ void Routing::water_thickness_staggered(const IceModelVec2S &W,
         result(i, j, 1) = mask.grounded_ice(i, j + 1) ? W(i, j + 1) : 0.0;
       }
     }
+  };
+
+  for (PointsInterior p(*m_grid, 1); p; p.next()) {
+    average(p.i(), p.j());
+  }
+
+  W.update_ghosts_end();
+
+  for (PointsBoundary p(*m_grid, 1); p; p.next()) {
+    average(p.i(), p.j());
   }
 
   result.update_ghosts();
@@ -866,8 +877,9 @@ void Routing::update_impl(double t, double dt, const Inputs& inputs) {
 
   m_Qstag_average.set(0.0);
 
-  // make sure W has valid ghosts before starting hydrology steps
-  m_W.update_ghosts();
+  // make sure W has valid ghosts before starting hydrology steps (the update is finished
+  // in water_thickness_staggered())
+  m_W.update_ghosts_begin();
 
   unsigned int step_counter = 0;
   for (; ht < t_final; ht += hdt) {
@@ -965,8 +977,18 @@ void Routing::update_impl(double t, double dt, const Inputs& inputs) {
                      m_conservation_error_change,
                      m_no_model_mask_change);
 
-      // transfer new into old (updates ghosts of m_W)
-      m_W.copy_from(m_Wnew);
+      // transfer new into old
+      {
+        IceModelVec::AccessList list{&m_W, &m_Wnew};
+
+        for (Points p(*m_grid); p; p.next()) {
+          const int i = p.i(), j = p.j();
+
+          m_W(i, j) = m_Wnew(i, j);
+        }
+      }
+      // the ghost update is finished by water_thickness_staggered() in the next step
+      m_W.update_ghosts_begin();
       m_grid->ctx()->profiling().end("routing_W");
     }
 
@@ -974,6 +996,8 @@ void Routing::update_impl(double t, double dt, const Inputs& inputs) {
     m_Wtill.copy_from(m_Wtillnew);
   } // end of the time-stepping loop
 
+  m_W.update_ghosts_end();
+
   staggered_to_regular(inputs.geometry->cell_type, m_Qstag_average,
                        m_config->get_flag("hydrology.routing.include_floating_ice"),
                        m_Q);
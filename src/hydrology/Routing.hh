@@ -134,7 +134,7 @@ protected:
 
   IceModelVec2S m_bottom_surface;
 
-  void water_thickness_staggered(const IceModelVec2S &W,
+  void water_thickness_staggered(IceModelVec2S &W,
                                  const IceModelVec2CellType &mask,
                                  IceModelVec2Stag &result);
 
@@ -21,7 +21,8 @@ void VecBundleWriter::init() {
                   fname,
                   string_to_backend(m_grid->ctx()->config()->get_string("output.format")),
                   PISM_READWRITE_MOVE,
-                  m_grid->ctx()->pio_iosys_id());
+                  m_grid->ctx()->pio_iosys_id(),
+                  m_grid->ctx()->config()->get_number("output.netcdf3.n_aggregators"));
 
   io::define_time(file,
                   m_grid->ctx()->config()->get_string("time.dimension_name"),
@@ -40,7 +41,8 @@ void VecBundleWriter::write(double time_s) {
                   fname,
                   string_to_backend(m_grid->ctx()->config()->get_string("output.format")),
                   PISM_READWRITE, // append to file
-                  m_grid->ctx()->pio_iosys_id());
+                  m_grid->ctx()->pio_iosys_id(),
+                  m_grid->ctx()->config()->get_number("output.netcdf3.n_aggregators"));
 
   io::append_time(file, m_grid->ctx()->config()->get_string("time.dimension_name"), time_s);
 
@@ -436,7 +436,8 @@ void IceModel::step(bool do_mass_continuity,
     File file(m_grid->com, o_file,
               string_to_backend(m_config->get_string("output.format")),
               PISM_READWRITE_MOVE,
-              m_ctx->pio_iosys_id());
+              m_ctx->pio_iosys_id(),
+              m_config->get_number("output.netcdf3.n_aggregators"));
 
     update_run_stats();
     write_metadata(file, WRITE_MAPPING, PREPEND_HISTORY);
@@ -663,7 +664,8 @@ void IceModel::step(bool do_mass_continuity,
               o_file,
               string_to_backend(m_config->get_string("output.format")),
               PISM_READWRITE_MOVE,
-              m_ctx->pio_iosys_id());
+              m_ctx->pio_iosys_id(),
+              m_config->get_number("output.netcdf3.n_aggregators"));
 
     update_run_stats();
     write_metadata(file, WRITE_MAPPING, PREPEND_HISTORY);
@@ -772,9 +774,7 @@ void IceModel::run() {
   // This is needed to compute rates of change of the ice mass, volume, etc.
   {
     const double time = m_time->current();
-    for (auto d : m_ts_diagnostics) {
-      d.second->update(time, time);
-    }
+    update_ts_diagnostics(*m_grid, m_ts_diagnostics, time, time);
   }
 
   m_log->message(2, "running forward ...\n");
@@ -790,6 +790,8 @@ void IceModel::run() {
   // main loop for time evolution
   // IceModel::step calls Time::step(dt), ensuring that this while loop
   // will terminate
+  int step_number = 0;
+
   profiling.stage_begin("time-stepping loop");
   while (m_time->current() < m_time->end()) {
 
@@ -814,8 +816,12 @@ void IceModel::run() {
     write_snapshot();
     write_extras();
     write_backup();
+    write_timeseries();
     profiling.end("io");
 
+    profiling.record_step(step_number, m_time->current());
+    step_number++;
+
     if (stepcount >= 0) {
       stepcount++;
     }
@@ -1037,10 +1043,10 @@ void IceModel::update_diagnostics(double dt) {
     d.second->update(dt);
   }
 
+  // Scalar diagnostics that are sums over the grid are computed together (one pass, one
+  // reduction).
   const double time = m_time->current();
-  for (auto d : m_ts_diagnostics) {
-    d.second->update(time - dt, time);
-  }
+  update_ts_diagnostics(*m_grid, m_ts_diagnostics, time - dt, time);
 }
 
 /*!
@@ -70,6 +70,10 @@ namespace hydrology {
 class Hydrology;
 }
 
+namespace io {
+class AsyncWriter;
+}
+
 namespace calving {
 class EigenCalving;
 class vonMisesCalving;
@@ -103,6 +107,7 @@ class IceModelVec2T;
 class Component;
 class FrontRetreat;
 class PrescribedRetreat;
+class OutputGrid;
 
 //! The base class for PISM. Contains all essential variables, parameters, and flags for modelling
 //! an ice sheet.
@@ -135,11 +140,6 @@ public:
   const IceModelVec2S &frontal_melt() const;
   const IceModelVec2S &forced_retreat() const;
 
-  double ice_volume_temperate(double thickness_threshold) const;
-  double ice_volume_cold(double thickness_threshold) const;
-  double ice_area_temperate(double thickness_threshold) const;
-  double ice_area_cold(double thickness_threshold) const;
-
   const stressbalance::StressBalance* stress_balance() const;
   const ocean::OceanModel* ocean_model() const;
   const frontalmelt::FrontalMelt* frontalmelt_model() const;
@@ -208,6 +208,12 @@ protected:
                               double time,
                               IO_Type default_diagnostics_type = PISM_FLOAT);
 
+  void save_diagnostics(const File &file,
+                        const OutputGrid &output_grid,
+                        const std::set<std::string> &variables,
+                        double time,
+                        IO_Type default_type);
+
   virtual void define_model_state(const File &file);
   virtual void write_model_state(const File &file);
 
@@ -219,6 +225,10 @@ protected:
   virtual void write_mapping(const File &file);
   virtual void write_run_stats(const File &file);
 
+  std::unique_ptr<File> output_file(const std::string &filename, IO_Mode mode);
+  //! writer used to write output files in the background (if `output.asynchronous` is set)
+  std::shared_ptr<io::AsyncWriter> m_output_writer;
+
 
   virtual void define_diagnostics(const File &file,
                                   const std::set<std::string> &variables,
@@ -408,7 +418,11 @@ protected:
   //! requested times for scalar time-series
   std::shared_ptr<std::vector<double>> m_ts_times;
   std::set<std::string> m_ts_vars;
+  //! wall clock time (in hours, since the beginning of the run) of the last write of
+  //! scalar time-series
+  double m_last_ts_flush_time;
   void init_timeseries();
+  void write_timeseries();
   void flush_timeseries();
   MaxTimestep ts_max_timestep(double my_t);
 
@@ -421,6 +435,8 @@ protected:
   std::set<std::string> m_extra_vars;
   TimeBoundsMetadata m_extra_bounds;
   std::unique_ptr<File> m_extra_file;
+  //! coarser and/or smaller grid used to write spatial time-series (if set)
+  std::shared_ptr<OutputGrid> m_extra_grid;
   void init_extras();
   void write_extras();
   MaxTimestep extras_max_timestep(double my_t);
@@ -429,8 +445,14 @@ protected:
   std::string m_backup_filename;
   double m_last_backup_time;
   std::set<std::string> m_backup_vars;
+  //! number of backups written since the last full backup
+  unsigned int m_n_incremental_backups;
+  //! state counters and checksums of variables in the backup file (incremental backups)
+  std::map<std::string, std::pair<int, uint64_t> > m_backup_state;
   void init_backups();
   void write_backup();
+  void record_backup_state(const File &file);
+  std::set<std::string> unchanged_backup_variables();
 
   // last time at which PISM hit a multiple of X years, see the configuration parameter
   // time_stepping.hit_multiples
@@ -963,29 +963,367 @@ IceModelVec::Ptr TemperateIceThicknessBasal::compute_impl() const {
 
 namespace scalar {
 
+/*!
+ * Helpers for scalar diagnostics computed as sums over the grid. They are evaluated in one pass
+ * over the grid with a single reduction (see update_ts_diagnostics()).
+ */
+
+//! Ice volume, in m^3, including ice in the "area specific volume" field (see ice_volume()).
+class IceVolumeSum : public TSLocalSum {
+public:
+  IceVolumeSum(const IceModel *m, bool glacierized)
+    : m_model(m), m_glacierized(glacierized),
+      m_geometry(nullptr), m_thickness_threshold(0.0), m_cell_area(0.0), m_part_grid(false) {
+    // empty
+  }
+protected:
+  void begin_local_sum(IceModelVec::AccessList &list) {
+    auto config = m_model->ctx()->config();
+
+    m_geometry            = &m_model->geometry();
+    m_thickness_threshold = (m_glacierized ?
+                             config->get_number("output.ice_free_thickness_standard") : 0.0);
+    m_cell_area           = m_model->grid()->cell_area();
+    m_part_grid           = config->get_flag("geometry.part_grid.enabled");
+
+    list.add(m_geometry->ice_thickness);
+    if (m_part_grid) {
+      list.add(m_geometry->ice_area_specific_volume);
+    }
+  }
+
+  double local_sum(int i, int j) const {
+    double volume = (ice_counts(*m_geometry, m_thickness_threshold, i, j) ?
+                     m_geometry->ice_thickness(i, j) * m_cell_area : 0.0);
+
+    if (m_part_grid) {
+      volume += m_geometry->ice_area_specific_volume(i, j) * m_cell_area;
+    }
+
+    return volume;
+  }
+
+  const IceModel *m_model;
+  bool m_glacierized;
+  const Geometry *m_geometry;
+  double m_thickness_threshold, m_cell_area;
+  bool m_part_grid;
+};
+
+//! Area or volume of the ice in glacierized areas, possibly restricted to grounded or floating
+//! ice.
+class GlacierizedSum : public TSLocalSum {
+public:
+  GlacierizedSum(const IceModel *m, AreaType area, bool volume)
+    : m_model(m), m_area(area), m_volume(volume),
+      m_geometry(nullptr), m_thickness_threshold(0.0), m_cell_area(0.0) {
+    // empty
+  }
+protected:
+  void begin_local_sum(IceModelVec::AccessList &list) {
+    m_geometry            = &m_model->geometry();
+    m_thickness_threshold = m_model->ctx()->config()->get_number("output.ice_free_thickness_standard");
+    m_cell_area           = m_model->grid()->cell_area();
+
+    list.add({&m_geometry->ice_thickness, &m_geometry->cell_type});
+  }
+
+  double local_sum(int i, int j) const {
+    const Geometry &g = *m_geometry;
+    const double threshold = m_thickness_threshold;
+
+    if ((m_area == BOTH and ice_counts(g, threshold, i, j)) or
+        (m_area == GROUNDED and grounded_ice_counts(g, threshold, i, j)) or
+        (m_area == SHELF and floating_ice_counts(g, threshold, i, j))) {
+      return m_volume ? m_cell_area * g.ice_thickness(i, j) : m_cell_area;
+    }
+    return 0.0;
+  }
+
+  const IceModel *m_model;
+  AreaType m_area;
+  bool m_volume;
+  const Geometry *m_geometry;
+  double m_thickness_threshold, m_cell_area;
+};
+
+//! Volume of the ice not displacing sea water, in m^3 (see ice_volume_not_displacing_seawater()).
+class VolumeNotDisplacingSeaWaterSum : public TSLocalSum {
+public:
+  VolumeNotDisplacingSeaWaterSum(const IceModel *m)
+    : m_model(m), m_geometry(nullptr), m_thickness_threshold(0.0), m_cell_area(0.0),
+      m_density_ratio(0.0) {
+    // empty
+  }
+protected:
+  void begin_local_sum(IceModelVec::AccessList &list) {
+    auto config = m_model->ctx()->config();
+
+    m_geometry            = &m_model->geometry();
+    m_thickness_threshold = config->get_number("output.ice_free_thickness_standard");
+    m_cell_area           = m_model->grid()->cell_area();
+    m_density_ratio       = (config->get_number("constants.sea_water.density") /
+                             config->get_number("constants.ice.density"));
+
+    list.add({&m_geometry->cell_type, &m_geometry->ice_thickness,
+              &m_geometry->bed_elevation, &m_geometry->sea_level_elevation});
+  }
+
+  double local_sum(int i, int j) const {
+    return thickness_not_displacing_seawater(*m_geometry, m_thickness_threshold,
+                                             m_density_ratio, i, j) * m_cell_area;
+  }
+
+  const IceModel *m_model;
+  const Geometry *m_geometry;
+  double m_thickness_threshold, m_cell_area, m_density_ratio;
+};
+
+enum ColumnQuantity {TEMPERATE_VOLUME, COLD_VOLUME, TEMPERATE_BASE_AREA, COLD_BASE_AREA, ENTHALPY};
+
+/*!
+ * Quantities computed using ice enthalpy: volumes of temperate and cold ice (m^3), areas where
+ * the basal ice is temperate or cold (m^2) and the total enthalpy (J).
+ */
+class IceColumnSum : public TSLocalSum {
+public:
+  IceColumnSum(const IceModel *m, bool glacierized, ColumnQuantity quantity)
+    : m_model(m), m_glacierized(glacierized), m_quantity(quantity),
+      m_thickness(nullptr), m_enthalpy(nullptr),
+      m_thickness_threshold(0.0), m_cell_area(0.0), m_ice_density(0.0) {
+    // empty
+  }
+protected:
+  void begin_local_sum(IceModelVec::AccessList &list) {
+    auto config = m_model->ctx()->config();
+
+    m_EC                  = m_model->ctx()->enthalpy_converter();
+    m_ice_grid            = m_model->grid();
+    m_thickness           = &m_model->geometry().ice_thickness;
+    m_enthalpy            = &m_model->energy_balance_model()->enthalpy();
+    m_thickness_threshold = (m_glacierized ?
+                             config->get_number("output.ice_free_thickness_standard") : 0.0);
+    m_cell_area           = m_model->grid()->cell_area();
+    m_ice_density         = config->get_number("constants.ice.density");
+
+    list.add({m_thickness, m_enthalpy});
+  }
+
+  double local_sum(int i, int j) const {
+    const double H = (*m_thickness)(i, j);
+
+    if (H < m_thickness_threshold) {
+      return 0.0;
+    }
+
+    const std::vector<double> &z = m_ice_grid->z();
+
+    const double
+      *E       = m_enthalpy->get_column(i, j),
+      pressure = m_EC->pressure(H);
+
+    if (m_quantity == TEMPERATE_BASE_AREA or m_quantity == COLD_BASE_AREA) {
+      const bool temperate = m_EC->is_temperate_relaxed(E[0], pressure); // FIXME issue #15
+      return temperate == (m_quantity == TEMPERATE_BASE_AREA) ? m_cell_area : 0.0;
+    }
+
+    const int ks = m_ice_grid->kBelowHeight(H);
+
+    double result = 0.0;
+    for (int k = 0; k <= ks; ++k) {
+      const double dz = k < ks ? z[k + 1] - z[k] : H - z[ks];
+
+      if (m_quantity == ENTHALPY) {
+        result += m_cell_area * E[k] * dz;
+      } else {
+        const bool temperate = m_EC->is_temperate_relaxed(E[k], pressure); // FIXME issue #15
+        if (temperate == (m_quantity == TEMPERATE_VOLUME)) {
+          result += m_cell_area * dz;
+        }
+      }
+    }
+    return result;
+  }
+
+  double finish_local_sum(double sum) const {
+    // convert from J/kg * m^3 to J
+    return m_quantity == ENTHALPY ? sum * m_ice_density : sum;
+  }
+
+  const IceModel *m_model;
+  bool m_glacierized;
+  ColumnQuantity m_quantity;
+  IceGrid::ConstPtr m_ice_grid;
+  EnthalpyConverter::Ptr m_EC;
+  const IceModelVec2S *m_thickness;
+  const IceModelVec3 *m_enthalpy;
+  double m_thickness_threshold, m_cell_area, m_ice_density;
+};
+
+/*!
+ * Total mass change due to one of the terms in the mass continuity equation, in kg.
+ *
+ * Possible terms are
+ *
+ * - SMB: surface mass balance
+ * - BMB: basal mass balance
+ * - FLOW: ice flow
+ * - ERROR: numerical flux needed to preserve non-negativity of thickness
+ *
+ * This computation can be restricted to grounded and floating areas
+ * using the `area` argument.
+ *
+ * - BOTH: include all contributions
+ * - GROUNDED: include grounded areas only
+ * - SHELF: include floating areas only
+ *
+ * When computing mass changes due to flow it is important to remember
+ * that ice mass in a cell can be represented by its thickness *or* an
+ * "area specific volume". Transferring mass from one representation
+ * to the other does not change the mass in a cell. This explains the
+ * special case used when `term == FLOW`. (Note that surface and basal
+ * mass balances do not affect the area specific volume field.)
+ */
+class MassChangeSum : public TSLocalSum {
+public:
+  MassChangeSum(const IceModel *m, TermType term, AreaType area)
+    : m_model(m), m_term(term), m_area(area),
+      m_cell_type(nullptr), m_thickness_change(nullptr), m_volume_change(nullptr),
+      m_cell_area(0.0), m_ice_density(0.0) {
+    // empty
+  }
+protected:
+  void begin_local_sum(IceModelVec::AccessList &list) {
+    const GeometryEvolution &geometry_evolution = m_model->geometry_evolution();
+
+    switch (m_term) {
+    case FLOW:
+      m_thickness_change = &geometry_evolution.thickness_change_due_to_flow();
+      break;
+    case SMB:
+      m_thickness_change = &geometry_evolution.top_surface_mass_balance();
+      break;
+    case BMB:
+      m_thickness_change = &geometry_evolution.bottom_surface_mass_balance();
+      break;
+    case ERROR:
+      m_thickness_change = &geometry_evolution.conservation_error();
+      break;
+    default:
+      // can't happen
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION, "invalid term type");
+    }
+
+    m_cell_type     = &m_model->geometry().cell_type;
+    m_volume_change = &geometry_evolution.area_specific_volume_change_due_to_flow();
+    m_cell_area     = m_model->grid()->cell_area();
+    m_ice_density   = m_model->ctx()->config()->get_number("constants.ice.density");
+
+    list.add({m_cell_type, m_thickness_change});
+
+    if (m_term == FLOW) {
+      list.add(*m_volume_change);
+    }
+  }
+
+  double local_sum(int i, int j) const {
+    if ((m_area == BOTH) or
+        (m_area == GROUNDED and m_cell_type->grounded(i, j)) or
+        (m_area == SHELF and m_cell_type->ocean(i, j))) {
+
+      double dV = m_term == FLOW ? (*m_volume_change)(i, j) : 0.0;
+
+      // m^3 = m^2 * m
+      return m_cell_area * ((*m_thickness_change)(i, j) + dV);
+    }
+    return 0.0;
+  }
+
+  double finish_local_sum(double volume_change) const {
+    // (kg / m^3) * m^3 = kg
+    return m_ice_density * volume_change;
+  }
+
+  const IceModel *m_model;
+  TermType m_term;
+  AreaType m_area;
+  const IceModelVec2CellType *m_cell_type;
+  const IceModelVec2S *m_thickness_change, *m_volume_change;
+  double m_cell_area, m_ice_density;
+};
+
+//! Total mass change due to calving or to all discharge processes (calving, frontal melt and
+//! forced retreat), in kg.
+class DischargeSum : public TSLocalSum {
+public:
+  DischargeSum(const IceModel *m, bool calving_only)
+    : m_model(m), m_calving_only(calving_only),
+      m_calving(nullptr), m_frontal_melt(nullptr), m_forced_retreat(nullptr),
+      m_cell_area(0.0), m_ice_density(0.0) {
+    // empty
+  }
+protected:
+  void begin_local_sum(IceModelVec::AccessList &list) {
+    m_calving        = &m_model->calving();
+    m_frontal_melt   = &m_model->frontal_melt();
+    m_forced_retreat = &m_model->forced_retreat();
+    m_cell_area      = m_model->grid()->cell_area();
+    m_ice_density    = m_model->ctx()->config()->get_number("constants.ice.density");
+
+    list.add(*m_calving);
+    if (not m_calving_only) {
+      list.add({m_frontal_melt, m_forced_retreat});
+    }
+  }
+
+  double local_sum(int i, int j) const {
+    double dH = (*m_calving)(i, j);
+
+    if (not m_calving_only) {
+      dH += (*m_frontal_melt)(i, j) + (*m_forced_retreat)(i, j);
+    }
+
+    // m^2 * m = m^3
+    return m_cell_area * dH;
+  }
+
+  double finish_local_sum(double volume_change) const {
+    // (kg/m^3) * m^3 = kg
+    return m_ice_density * volume_change;
+  }
+
+  const IceModel *m_model;
+  bool m_calving_only;
+  const IceModelVec2S *m_calving, *m_frontal_melt, *m_forced_retreat;
+  double m_cell_area, m_ice_density;
+};
+
 //! \brief Computes the total ice volume in glacierized areas.
-class IceVolumeGlacierized : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceVolumeGlacierized : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                             public IceVolumeSum
 {
 public:
   IceVolumeGlacierized(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized"),
+      IceVolumeSum(m, true) {
 
     set_units("m3", "m3");
     m_ts.variable().set_string("long_name", "volume of the ice in glacierized areas");
     m_ts.variable().set_number("valid_min", 0.0);
   }
   double compute() {
-    return ice_volume(model->geometry(),
-                      m_config->get_number("output.ice_free_thickness_standard"));
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total ice volume.
-class IceVolume : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceVolume : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                  public IceVolumeSum
 {
 public:
   IceVolume(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume"),
+      IceVolumeSum(m, false) {
 
     set_units("m3", "m3");
     m_ts.variable().set_string("long_name", "volume of the ice, including seasonal cover");
@@ -993,16 +1331,18 @@ public:
   }
 
   double compute() {
-    return ice_volume(model->geometry(), 0.0);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total ice volume which is relevant for sea-level
-class SeaLevelRisePotential : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class SeaLevelRisePotential : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                              public VolumeNotDisplacingSeaWaterSum
 {
 public:
   SeaLevelRisePotential(const IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "sea_level_rise_potential") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "sea_level_rise_potential"),
+      VolumeNotDisplacingSeaWaterSum(m) {
 
     set_units("m", "m");
     m_ts.variable().set_string("long_name", "the sea level rise that would result if all the ice were melted");
@@ -1010,34 +1350,46 @@ public:
   }
 
   double compute() {
-    return sea_level_rise_potential(model->geometry(),
-                                    m_config->get_number("output.ice_free_thickness_standard"));
+    return local_sum_value(*m_grid);
+  }
+
+  double finish_local_sum(double volume) const {
+    // see sea_level_rise_potential()
+    const double
+      water_density = m_config->get_number("constants.fresh_water.density"),
+      ice_density   = m_config->get_number("constants.ice.density"),
+      ocean_area    = m_config->get_number("constants.global_ocean_area");
+
+    return (ice_density / water_density) * volume / ocean_area;
   }
 };
 
 //! \brief Computes the rate of change of the total ice volume in glacierized areas.
-class IceVolumeRateOfChangeGlacierized : public TSDiag<TSRateDiagnostic, IceModel>
+class IceVolumeRateOfChangeGlacierized : public TSDiag<TSRateDiagnostic, IceModel>,
+                                         public IceVolumeSum
 {
 public:
   IceVolumeRateOfChangeGlacierized(IceModel *m)
-    : TSDiag<TSRateDiagnostic, IceModel>(m, "tendency_of_ice_volume_glacierized") {
+    : TSDiag<TSRateDiagnostic, IceModel>(m, "tendency_of_ice_volume_glacierized"),
+      IceVolumeSum(m, true) {
 
     set_units("m3 s-1", "m3 year-1");
     m_ts.variable().set_string("long_name", "rate of change of the ice volume in glacierized areas");
   }
 
   double compute() {
-    return ice_volume(model->geometry(),
-                      m_config->get_number("output.ice_free_thickness_standard"));
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the rate of change of the total ice volume.
-class IceVolumeRateOfChange : public TSDiag<TSRateDiagnostic, IceModel>
+class IceVolumeRateOfChange : public TSDiag<TSRateDiagnostic, IceModel>,
+                              public IceVolumeSum
 {
 public:
   IceVolumeRateOfChange(IceModel *m)
-    : TSDiag<TSRateDiagnostic, IceModel>(m, "tendency_of_ice_volume") {
+    : TSDiag<TSRateDiagnostic, IceModel>(m, "tendency_of_ice_volume"),
+      IceVolumeSum(m, false) {
 
     set_units("m3 s-1", "m3 year-1");
     m_ts.variable().set_string("long_name",
@@ -1045,16 +1397,18 @@ public:
   }
 
   double compute() {
-    return ice_volume(model->geometry(), 0.0);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total ice area.
-class IceAreaGlacierized : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceAreaGlacierized : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                           public GlacierizedSum
 {
 public:
   IceAreaGlacierized(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized"),
+      GlacierizedSum(m, BOTH, false) {
 
     set_units("m2", "m2");
     m_ts.variable().set_string("long_name", "glacierized area");
@@ -1062,16 +1416,18 @@ public:
   }
 
   double compute() {
-    return ice_area(model->geometry(), m_config->get_number("output.ice_free_thickness_standard"));
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total mass of the ice not displacing sea water.
-class IceMassNotDisplacingSeaWater : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceMassNotDisplacingSeaWater : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                                     public VolumeNotDisplacingSeaWaterSum
 {
 public:
   IceMassNotDisplacingSeaWater(const IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "limnsw") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "limnsw"),
+      VolumeNotDisplacingSeaWaterSum(m) {
 
     set_units("kg", "kg");
     m_ts.variable().set_string("long_name", "mass of the ice not displacing sea water");
@@ -1080,24 +1436,22 @@ public:
   }
 
   double compute() {
+    return local_sum_value(*m_grid);
+  }
 
-    const double
-      thickness_standard = m_config->get_number("output.ice_free_thickness_standard"),
-      ice_density        = m_config->get_number("constants.ice.density"),
-      ice_volume         = ice_volume_not_displacing_seawater(model->geometry(),
-                                                              thickness_standard),
-      ice_mass           = ice_volume * ice_density;
-
-    return ice_mass;
+  double finish_local_sum(double volume) const {
+    return volume * m_config->get_number("constants.ice.density");
   }
 };
 
 //! \brief Computes the total ice mass in glacierized areas.
-class IceMassGlacierized : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceMassGlacierized : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                           public IceVolumeSum
 {
 public:
   IceMassGlacierized(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_mass_glacierized") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_mass_glacierized"),
+      IceVolumeSum(m, true) {
 
     set_units("kg", "kg");
     m_ts.variable().set_string("long_name", "mass of the ice in glacierized areas");
@@ -1105,19 +1459,22 @@ public:
   }
 
   double compute() {
-    double
-      ice_density        = m_config->get_number("constants.ice.density"),
-      thickness_standard = m_config->get_number("output.ice_free_thickness_standard");
-    return ice_volume(model->geometry(), thickness_standard) * ice_density;
+    return local_sum_value(*m_grid);
+  }
+
+  double finish_local_sum(double volume) const {
+    return volume * m_config->get_number("constants.ice.density");
   }
 };
 
 //! \brief Computes the total ice mass.
-class IceMass : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceMass : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                public IceVolumeSum
 {
 public:
   IceMass(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_mass") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_mass"),
+      IceVolumeSum(m, false) {
 
     if (m_config->get_flag("output.ISMIP6")) {
       m_ts.variable().set_name("lim");
@@ -1130,27 +1487,33 @@ public:
   }
 
   double compute() {
-    return (ice_volume(model->geometry(), 0.0) *
-            m_config->get_number("constants.ice.density"));
+    return local_sum_value(*m_grid);
+  }
+
+  double finish_local_sum(double volume) const {
+    return volume * m_config->get_number("constants.ice.density");
   }
 };
 
 //! \brief Computes the rate of change of the total ice mass in glacierized areas.
-class IceMassRateOfChangeGlacierized : public TSDiag<TSRateDiagnostic, IceModel>
+class IceMassRateOfChangeGlacierized : public TSDiag<TSRateDiagnostic, IceModel>,
+                                       public IceVolumeSum
 {
 public:
   IceMassRateOfChangeGlacierized(IceModel *m)
-    : TSDiag<TSRateDiagnostic, IceModel>(m, "tendency_of_ice_mass_glacierized") {
+    : TSDiag<TSRateDiagnostic, IceModel>(m, "tendency_of_ice_mass_glacierized"),
+      IceVolumeSum(m, true) {
 
     set_units("kg s-1", "Gt year-1");
     m_ts.variable().set_string("long_name", "rate of change of the ice mass in glacierized areas");
   }
 
   double compute() {
-    double
-      ice_density         = m_config->get_number("constants.ice.density"),
-      thickness_threshold = m_config->get_number("output.ice_free_thickness_standard");
-    return ice_volume(model->geometry(), thickness_threshold) * ice_density;
+    return local_sum_value(*m_grid);
+  }
+
+  double finish_local_sum(double volume) const {
+    return volume * m_config->get_number("constants.ice.density");
   }
 };
 
@@ -1159,11 +1522,13 @@ public:
 /*!
  * This is the change in mass resulting from prescribing (fixing) ice thickness.
  */
-class IceMassRateOfChangeDueToFlow : public TSDiag<TSFluxDiagnostic, IceModel>
+class IceMassRateOfChangeDueToFlow : public TSDiag<TSFluxDiagnostic, IceModel>,
+                                     public MassChangeSum
 {
 public:
   IceMassRateOfChangeDueToFlow(IceModel *m)
-    : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_flow") {
+    : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_flow"),
+      MassChangeSum(m, FLOW, BOTH) {
 
     set_units("kg s-1", "Gt year-1");
     m_ts.variable().set_string("long_name", "rate of change of the mass of ice due to flow"
@@ -1171,36 +1536,18 @@ public:
   }
 
   double compute() {
-
-    const double
-      ice_density = m_config->get_number("constants.ice.density");
-
-    const IceModelVec2S
-      &dH = model->geometry_evolution().thickness_change_due_to_flow(),
-      &dV = model->geometry_evolution().area_specific_volume_change_due_to_flow();
-
-    auto cell_area = m_grid->cell_area();
-
-    IceModelVec::AccessList list{&dH, &dV};
-
-    double volume_change = 0.0;
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-      // m * m^2 = m^3
-      volume_change += (dH(i, j) + dV(i, j)) * cell_area;
-    }
-
-    // (kg/m^3) * m^3 = kg
-    return ice_density * GlobalSum(m_grid->com, volume_change);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the rate of change of the total ice mass.
-class IceMassRateOfChange : public TSDiag<TSRateDiagnostic, IceModel>
+class IceMassRateOfChange : public TSDiag<TSRateDiagnostic, IceModel>,
+                            public IceVolumeSum
 {
 public:
   IceMassRateOfChange(IceModel *m)
-    : TSDiag<TSRateDiagnostic, IceModel>(m, "tendency_of_ice_mass") {
+    : TSDiag<TSRateDiagnostic, IceModel>(m, "tendency_of_ice_mass"),
+      IceVolumeSum(m, false) {
 
     set_units("kg s-1", "Gt year-1");
     m_ts.variable().set_string("long_name",
@@ -1208,18 +1555,23 @@ public:
   }
 
   double compute() {
-    const double ice_density = m_config->get_number("constants.ice.density");
-    return ice_volume(model->geometry(), 0.0) * ice_density;
+    return local_sum_value(*m_grid);
+  }
+
+  double finish_local_sum(double volume) const {
+    return volume * m_config->get_number("constants.ice.density");
   }
 };
 
 
 //! \brief Computes the total volume of the temperate ice in glacierized areas.
-class IceVolumeGlacierizedTemperate : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceVolumeGlacierizedTemperate : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                                      public IceColumnSum
 {
 public:
   IceVolumeGlacierizedTemperate(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized_temperate") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized_temperate"),
+      IceColumnSum(m, true, TEMPERATE_VOLUME) {
 
     set_units("m3", "m3");
     m_ts.variable().set_string("long_name", "volume of temperate ice in glacierized areas");
@@ -1227,16 +1579,18 @@ public:
   }
 
   double compute() {
-    return model->ice_volume_temperate(m_config->get_number("output.ice_free_thickness_standard"));
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total volume of the temperate ice.
-class IceVolumeTemperate : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceVolumeTemperate : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                           public IceColumnSum
 {
 public:
   IceVolumeTemperate(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_temperate") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_temperate"),
+      IceColumnSum(m, false, TEMPERATE_VOLUME) {
 
     set_units("m3", "m3");
     m_ts.variable().set_string("long_name", "volume of temperate ice, including seasonal cover");
@@ -1244,16 +1598,18 @@ public:
   }
 
   double compute() {
-    return model->ice_volume_temperate(0.0);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total volume of the cold ice in glacierized areas.
-class IceVolumeGlacierizedCold : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceVolumeGlacierizedCold : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                                 public IceColumnSum
 {
 public:
   IceVolumeGlacierizedCold(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized_cold") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized_cold"),
+      IceColumnSum(m, true, COLD_VOLUME) {
 
     set_units("m3", "m3");
     m_ts.variable().set_string("long_name", "volume of cold ice in glacierized areas");
@@ -1261,16 +1617,18 @@ public:
   }
 
   double compute() {
-    return model->ice_volume_cold(m_config->get_number("output.ice_free_thickness_standard"));
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total volume of the cold ice.
-class IceVolumeCold : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceVolumeCold : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                      public IceColumnSum
 {
 public:
   IceVolumeCold(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_cold") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_cold"),
+      IceColumnSum(m, false, COLD_VOLUME) {
 
     set_units("m3", "m3");
     m_ts.variable().set_string("long_name", "volume of cold ice, including seasonal cover");
@@ -1278,16 +1636,18 @@ public:
   }
 
   double compute() {
-    return model->ice_volume_cold(0.0);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total area of the temperate ice.
-class IceAreaGlacierizedTemperateBase : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceAreaGlacierizedTemperateBase : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                                        public IceColumnSum
 {
 public:
   IceAreaGlacierizedTemperateBase(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized_temperate_base") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized_temperate_base"),
+      IceColumnSum(m, true, TEMPERATE_BASE_AREA) {
 
     set_units("m2", "m2");
     m_ts.variable().set_string("long_name", "glacierized area where basal ice is temperate");
@@ -1295,16 +1655,18 @@ public:
   }
 
   double compute() {
-    return model->ice_area_temperate(m_config->get_number("output.ice_free_thickness_standard"));
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total area of the cold ice.
-class IceAreaGlacierizedColdBase : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceAreaGlacierizedColdBase : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                                   public IceColumnSum
 {
 public:
   IceAreaGlacierizedColdBase(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized_cold_base") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized_cold_base"),
+      IceColumnSum(m, true, COLD_BASE_AREA) {
 
     set_units("m2", "m2");
     m_ts.variable().set_string("long_name", "glacierized area where basal ice is cold");
@@ -1312,16 +1674,18 @@ public:
   }
 
   double compute() {
-    return model->ice_area_cold(m_config->get_number("output.ice_free_thickness_standard"));
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total ice enthalpy in glacierized areas.
-class IceEnthalpyGlacierized : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceEnthalpyGlacierized : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                               public IceColumnSum
 {
 public:
   IceEnthalpyGlacierized(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_enthalpy_glacierized") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_enthalpy_glacierized"),
+      IceColumnSum(m, true, ENTHALPY) {
 
     set_units("J", "J");
     m_ts.variable().set_string("long_name", "enthalpy of the ice in glacierized areas");
@@ -1329,18 +1693,18 @@ public:
   }
 
   double compute() {
-    return energy::total_ice_enthalpy(m_config->get_number("output.ice_free_thickness_standard"),
-                                      model->energy_balance_model()->enthalpy(),
-                                      model->geometry().ice_thickness);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total ice enthalpy.
-class IceEnthalpy : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceEnthalpy : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                    public IceColumnSum
 {
 public:
   IceEnthalpy(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_enthalpy") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_enthalpy"),
+      IceColumnSum(m, false, ENTHALPY) {
 
     set_units("J", "J");
     m_ts.variable().set_string("long_name", "enthalpy of the ice, including seasonal cover");
@@ -1348,18 +1712,18 @@ public:
   }
 
   double compute() {
-    return energy::total_ice_enthalpy(0.0,
-                                      model->energy_balance_model()->enthalpy(),
-                                      model->geometry().ice_thickness);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total grounded ice area.
-class IceAreaGlacierizedGrounded : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceAreaGlacierizedGrounded : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                                   public GlacierizedSum
 {
 public:
   IceAreaGlacierizedGrounded(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized_grounded") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized_grounded"),
+      GlacierizedSum(m, GROUNDED, false) {
 
     if (m_config->get_flag("output.ISMIP6")) {
       m_ts.variable().set_name("iareagr");
@@ -1372,17 +1736,18 @@ public:
   }
 
   double compute() {
-    return ice_area_grounded(model->geometry(),
-                             m_config->get_number("output.ice_free_thickness_standard"));
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total floating ice area.
-class IceAreaGlacierizedShelf : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceAreaGlacierizedShelf : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                                public GlacierizedSum
 {
 public:
   IceAreaGlacierizedShelf(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized_floating") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_area_glacierized_floating"),
+      GlacierizedSum(m, SHELF, false) {
 
     if (m_config->get_flag("output.ISMIP6")) {
       m_ts.variable().set_name("iareafl");
@@ -1395,17 +1760,18 @@ public:
   }
 
   double compute() {
-    return ice_area_floating(model->geometry(),
-                             m_config->get_number("output.ice_free_thickness_standard"));
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total grounded ice volume.
-class IceVolumeGlacierizedGrounded : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceVolumeGlacierizedGrounded : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                                     public GlacierizedSum
 {
 public:
   IceVolumeGlacierizedGrounded(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized_grounded") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized_grounded"),
+      GlacierizedSum(m, GROUNDED, true) {
 
     set_units("m3", "m3");
     m_ts.variable().set_string("long_name", "volume of grounded ice in glacierized areas");
@@ -1413,37 +1779,18 @@ public:
   }
 
   double compute() {
-    const IceModelVec2CellType &cell_type = model->geometry().cell_type;
-
-    const IceModelVec2S &ice_thickness = model->geometry().ice_thickness;
-
-    const double
-      thickness_threshold = m_config->get_number("output.ice_free_thickness_standard"),
-      cell_area           = m_grid->cell_area();
-
-    IceModelVec::AccessList list{&ice_thickness, &cell_type};
-
-    double volume = 0.0;
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      const double H = ice_thickness(i, j);
-
-      if (cell_type.grounded(i, j) and H >= thickness_threshold) {
-        volume += cell_area * H;
-      }
-    }
-
-    return GlobalSum(m_grid->com, volume);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Computes the total floating ice volume.
-class IceVolumeGlacierizedShelf : public TSDiag<TSSnapshotDiagnostic, IceModel>
+class IceVolumeGlacierizedShelf : public TSDiag<TSSnapshotDiagnostic, IceModel>,
+                                  public GlacierizedSum
 {
 public:
   IceVolumeGlacierizedShelf(IceModel *m)
-    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized_floating") {
+    : TSDiag<TSSnapshotDiagnostic, IceModel>(m, "ice_volume_glacierized_floating"),
+      GlacierizedSum(m, SHELF, true) {
 
     set_units("m3", "m3");
     m_ts.variable().set_string("long_name", "volume of ice shelves in glacierized areas");
@@ -1451,28 +1798,7 @@ public:
   }
 
   double compute() {
-    const IceModelVec2CellType &cell_type = model->geometry().cell_type;
-
-    const IceModelVec2S &ice_thickness = model->geometry().ice_thickness;
-
-    const double
-      thickness_threshold = m_config->get_number("output.ice_free_thickness_standard"),
-      cell_area           = m_grid->cell_area();
-
-    IceModelVec::AccessList list{&ice_thickness, &cell_type};
-
-    double volume = 0.0;
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      const double H = ice_thickness(i, j);
-
-      if (cell_type.ocean(i, j) and H >= thickness_threshold) {
-        volume += cell_area * H;
-      }
-    }
-
-    return GlobalSum(m_grid->com, volume);
+    return local_sum_value(*m_grid);
   }
 };
 
@@ -1541,93 +1867,14 @@ public:
   }
 };
 
-/*!
- * Return total mass change due to one of the terms in the mass continuity equation.
- *
- * Possible terms are
- *
- * - SMB: surface mass balance
- * - BMB: basal mass balance
- * - FLOW: ice flow
- * - ERROR: numerical flux needed to preserve non-negativity of thickness
- *
- * This computation can be restricted to grounded and floating areas
- * using the `area` argument.
- *
- * - BOTH: include all contributions
- * - GROUNDED: include grounded areas only
- * - SHELF: include floating areas only
- *
- * When computing mass changes due to flow it is important to remember
- * that ice mass in a cell can be represented by its thickness *or* an
- * "area specific volume". Transferring mass from one representation
- * to the other does not change the mass in a cell. This explains the
- * special case used when `term == FLOW`. (Note that surface and basal
- * mass balances do not affect the area specific volume field.)
- */
-double mass_change(const IceModel *model, TermType term, AreaType area) {
-  const IceGrid &grid = *model->grid();
-  const Config &config = *grid.ctx()->config();
-
-  const double
-    ice_density = config.get_number("constants.ice.density"),
-    cell_area   = grid.cell_area();
-
-  const IceModelVec2CellType &cell_type = model->geometry().cell_type;
-
-  const IceModelVec2S *thickness_change = nullptr;
-
-  switch (term) {
-  case FLOW:
-    thickness_change = &model->geometry_evolution().thickness_change_due_to_flow();
-    break;
-  case SMB:
-    thickness_change = &model->geometry_evolution().top_surface_mass_balance();
-    break;
-  case BMB:
-    thickness_change = &model->geometry_evolution().bottom_surface_mass_balance();
-    break;
-  case ERROR:
-    thickness_change = &model->geometry_evolution().conservation_error();
-    break;
-  default:
-    // can't happen
-    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "invalid term type");
-  }
-
-  const IceModelVec2S &dV_flow = model->geometry_evolution().area_specific_volume_change_due_to_flow();
-
-  IceModelVec::AccessList list{&cell_type, thickness_change};
-
-  if (term == FLOW) {
-    list.add(dV_flow);
-  }
-
-  double volume_change = 0.0;
-  for (Points p(grid); p; p.next()) {
-    const int i = p.i(), j = p.j();
-
-    if ((area == BOTH) or
-        (area == GROUNDED and cell_type.grounded(i, j)) or
-        (area == SHELF and cell_type.ocean(i, j))) {
-
-      double dV = term == FLOW ? dV_flow(i, j) : 0.0;
-
-      // m^3 = m^2 * m
-      volume_change += cell_area * ((*thickness_change)(i, j) + dV);
-    }
-  }
-
-  // (kg / m^3) * m^3 = kg
-  return ice_density * GlobalSum(grid.com, volume_change);
-}
-
 //! \brief Reports the total bottom surface ice flux.
-class IceMassFluxBasal : public TSDiag<TSFluxDiagnostic, IceModel>
+class IceMassFluxBasal : public TSDiag<TSFluxDiagnostic, IceModel>,
+                         public MassChangeSum
 {
 public:
   IceMassFluxBasal(const IceModel *m)
-    : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_basal_mass_flux") {
+    : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_basal_mass_flux"),
+      MassChangeSum(m, BMB, BOTH) {
 
     if (m_config->get_flag("output.ISMIP6")) {
       m_ts.variable().set_name("tendlibmassbf");
@@ -1640,16 +1887,18 @@ public:
   }
 
   double compute() {
-    return mass_change(model, BMB, BOTH);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Reports the total top surface ice flux.
-class IceMassFluxSurface : public TSDiag<TSFluxDiagnostic, IceModel>
+class IceMassFluxSurface : public TSDiag<TSFluxDiagnostic, IceModel>,
+                           public MassChangeSum
 {
 public:
   IceMassFluxSurface(const IceModel *m)
-    : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_surface_mass_flux") {
+    : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_surface_mass_flux"),
+      MassChangeSum(m, SMB, BOTH) {
 
     if (m_config->get_flag("output.ISMIP6")) {
       m_ts.variable().set_name("tendacabf");
@@ -1662,16 +1911,18 @@ public:
   }
 
   double compute() {
-    return mass_change(model, SMB, BOTH);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Reports the total basal ice flux over the grounded region.
-class IceMassFluxBasalGrounded : public TSDiag<TSFluxDiagnostic, IceModel>
+class IceMassFluxBasalGrounded : public TSDiag<TSFluxDiagnostic, IceModel>,
+                                 public MassChangeSum
 {
 public:
   IceMassFluxBasalGrounded(const IceModel *m)
-    : TSDiag<TSFluxDiagnostic, IceModel>(m, "basal_mass_flux_grounded") {
+    : TSDiag<TSFluxDiagnostic, IceModel>(m, "basal_mass_flux_grounded"),
+      MassChangeSum(m, BMB, GROUNDED) {
 
     set_units("kg s-1", "Gt year-1");
     m_ts.variable().set_string("long_name", "total over grounded ice domain of basal mass flux");
@@ -1680,16 +1931,18 @@ public:
   }
 
   double compute() {
-    return mass_change(model, BMB, GROUNDED);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Reports the total sub-shelf ice flux.
-class IceMassFluxBasalFloating : public TSDiag<TSFluxDiagnostic, IceModel>
+class IceMassFluxBasalFloating : public TSDiag<TSFluxDiagnostic, IceModel>,
+                                 public MassChangeSum
 {
 public:
   IceMassFluxBasalFloating(const IceModel *m)
-    : TSDiag<TSFluxDiagnostic, IceModel>(m, "basal_mass_flux_floating") {
+    : TSDiag<TSFluxDiagnostic, IceModel>(m, "basal_mass_flux_floating"),
+      MassChangeSum(m, BMB, SHELF) {
 
     if (m_config->get_flag("output.ISMIP6")) {
       m_ts.variable().set_name("tendlibmassbffl");
@@ -1702,17 +1955,19 @@ public:
   }
 
   double compute() {
-    return mass_change(model, BMB, SHELF);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Reports the total numerical mass flux needed to preserve
 //! non-negativity of ice thickness.
-class IceMassFluxConservationError : public TSDiag<TSFluxDiagnostic, IceModel>
+class IceMassFluxConservationError : public TSDiag<TSFluxDiagnostic, IceModel>,
+                                     public MassChangeSum
 {
 public:
   IceMassFluxConservationError(const IceModel *m)
-    : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_conservation_error") {
+    : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_conservation_error"),
+      MassChangeSum(m, ERROR, BOTH) {
 
     set_units("kg s-1", "Gt year-1");
     m_ts.variable().set_string("long_name", "total numerical flux needed to preserve non-negativity"
@@ -1721,16 +1976,18 @@ public:
   }
 
   double compute() {
-    return mass_change(model, ERROR, BOTH);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Reports the total discharge flux.
-class IceMassFluxDischarge : public TSDiag<TSFluxDiagnostic, IceModel>
+class IceMassFluxDischarge : public TSDiag<TSFluxDiagnostic, IceModel>,
+                             public DischargeSum
 {
 public:
   IceMassFluxDischarge(const IceModel *m)
-    : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_discharge") {
+    : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_discharge"),
+      DischargeSum(m, false) {
 
     if (m_config->get_flag("output.ISMIP6")) {
       m_ts.variable().set_name("tendlifmassbf");
@@ -1745,35 +2002,18 @@ public:
   }
 
   double compute() {
-    const double ice_density = m_config->get_number("constants.ice.density");
-
-    const IceModelVec2S &calving = model->calving();
-    const IceModelVec2S &frontal_melt = model->frontal_melt();
-    const IceModelVec2S &forced_retreat = model->forced_retreat();
-
-    auto cell_area = m_grid->cell_area();
-
-    double volume_change = 0.0;
-
-    IceModelVec::AccessList list{&calving, &frontal_melt, &forced_retreat};
-
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-      // m^2 * m = m^3
-      volume_change += cell_area * (calving(i, j) + frontal_melt(i, j) + forced_retreat(i, j));
-    }
-
-    // (kg/m^3) * m^3 = kg
-    return ice_density * GlobalSum(m_grid->com, volume_change);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! \brief Reports the total calving flux.
-class IceMassFluxCalving : public TSDiag<TSFluxDiagnostic, IceModel>
+class IceMassFluxCalving : public TSDiag<TSFluxDiagnostic, IceModel>,
+                           public DischargeSum
 {
 public:
   IceMassFluxCalving(const IceModel *m)
-    : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_calving") {
+    : TSDiag<TSFluxDiagnostic, IceModel>(m, "tendency_of_ice_mass_due_to_calving"),
+      DischargeSum(m, true) {
 
     if (m_config->get_flag("output.ISMIP6")) {
       m_ts.variable().set_name("tendlicalvf");
@@ -1786,33 +2026,18 @@ public:
   }
 
   double compute() {
-    const double ice_density = m_config->get_number("constants.ice.density");
-
-    const IceModelVec2S &calving = model->calving();
-
-    auto cell_area = m_grid->cell_area();
-
-    double volume_change = 0.0;
-
-    IceModelVec::AccessList list{&calving};
-
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-      // m^2 * m = m^3
-      volume_change += cell_area * calving(i, j);
-    }
-
-    // (kg/m^3) * m^3 = kg
-    return ice_density * GlobalSum(m_grid->com, volume_change);
+    return local_sum_value(*m_grid);
   }
 };
 
 //! @brief Reports the total flux across the grounding line.
-class IceMassFluxAtGroundingLine : public TSDiag<TSFluxDiagnostic, IceModel>
+class IceMassFluxAtGroundingLine : public TSDiag<TSFluxDiagnostic, IceModel>,
+                                   public TSLocalSum
 {
 public:
   IceMassFluxAtGroundingLine(const IceModel *m)
-    : TSDiag<TSFluxDiagnostic, IceModel>(m, "grounding_line_flux") {
+    : TSDiag<TSFluxDiagnostic, IceModel>(m, "grounding_line_flux"),
+      m_cell_type(nullptr), m_flux(nullptr), m_dx(0.0), m_dy(0.0) {
 
     if (m_config->get_flag("output.ISMIP6")) {
       m_ts.variable().set_name("tendligroundf");
@@ -1827,10 +2052,32 @@ public:
   }
 
   double compute() {
-    return total_grounding_line_flux(model->geometry().cell_type,
-                                     model->geometry_evolution().flux_staggered(),
-                                     model->dt());
+    return local_sum_value(*m_grid);
+  }
+
+protected:
+  // see total_grounding_line_flux()
+  void begin_local_sum(IceModelVec::AccessList &list) {
+    m_cell_type = &model->geometry().cell_type;
+    m_flux      = &model->geometry_evolution().flux_staggered();
+    m_dx        = m_grid->dx();
+    m_dy        = m_grid->dy();
+
+    list.add({m_cell_type, m_flux});
+  }
+
+  double local_sum(int i, int j) const {
+    return grounding_line_volume_flux(*m_cell_type, *m_flux, m_dx, m_dy, i, j);
+  }
+
+  double finish_local_sum(double volume_flux) const {
+    // convert from "m^3 / s" to "kg"
+    return volume_flux * model->dt() * m_config->get_number("constants.ice.density");
   }
+
+  const IceModelVec2CellType *m_cell_type;
+  const IceModelVec2Stag *m_flux;
+  double m_dx, m_dy;
 };
 
 } // end of namespace scalar
@@ -3097,160 +3344,4 @@ double IceModel::compute_original_ice_fraction(double total_ice_volume) {
   return result;
 }
 
-
-//! Computes the temperate ice volume, in m^3.
-double IceModel::ice_volume_temperate(double thickness_threshold) const {
-
-  EnthalpyConverter::Ptr EC = m_ctx->enthalpy_converter();
-
-  const IceModelVec3 &ice_enthalpy = m_energy_model->enthalpy();
-
-  auto cell_area = m_grid->cell_area();
-
-  double volume = 0.0;
-
-  IceModelVec::AccessList list{&m_geometry.ice_thickness, &ice_enthalpy};
-  ParallelSection loop(m_grid->com);
-  try {
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      if (m_geometry.ice_thickness(i,j) >= thickness_threshold) {
-        const int ks = m_grid->kBelowHeight(m_geometry.ice_thickness(i,j));
-        const double *Enth = ice_enthalpy.get_column(i,j);
-
-        for (int k = 0; k < ks; ++k) {
-          if (EC->is_temperate_relaxed(Enth[k],EC->pressure(m_geometry.ice_thickness(i,j)))) { // FIXME issue #15
-            volume += (m_grid->z(k + 1) - m_grid->z(k)) * cell_area;
-          }
-        }
-
-        if (EC->is_temperate_relaxed(Enth[ks],EC->pressure(m_geometry.ice_thickness(i,j)))) { // FIXME issue #15
-          volume += (m_geometry.ice_thickness(i,j) - m_grid->z(ks)) * cell_area;
-        }
-      }
-    }
-  } catch (...) {
-    loop.failed();
-  }
-  loop.check();
-
-
-  return GlobalSum(m_grid->com, volume);
-}
-
-//! Computes the cold ice volume, in m^3.
-double IceModel::ice_volume_cold(double thickness_threshold) const {
-
-  EnthalpyConverter::Ptr EC = m_ctx->enthalpy_converter();
-
-  const IceModelVec3 &ice_enthalpy = m_energy_model->enthalpy();
-
-  double volume = 0.0;
-
-  auto cell_area = m_grid->cell_area();
-
-  IceModelVec::AccessList list{&m_geometry.ice_thickness, &ice_enthalpy};
-
-  ParallelSection loop(m_grid->com);
-  try {
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      const double thickness = m_geometry.ice_thickness(i, j);
-
-      // count all ice, including cells which have so little they
-      // are considered "ice-free"
-      if (thickness >= thickness_threshold) {
-        const int ks = m_grid->kBelowHeight(thickness);
-        const double *Enth = ice_enthalpy.get_column(i, j);
-
-        for (int k=0; k<ks; ++k) {
-          if (not EC->is_temperate_relaxed(Enth[k], EC->pressure(thickness))) { // FIXME issue #15
-            volume += (m_grid->z(k+1) - m_grid->z(k)) * cell_area;
-          }
-        }
-
-        if (not EC->is_temperate_relaxed(Enth[ks], EC->pressure(thickness))) { // FIXME issue #15
-          volume += (thickness - m_grid->z(ks)) * cell_area;
-        }
-      }
-    }
-  } catch (...) {
-    loop.failed();
-  }
-  loop.check();
-
-
-  return GlobalSum(m_grid->com, volume);
-}
-
-//! Computes area of basal ice which is temperate, in m^2.
-double IceModel::ice_area_temperate(double thickness_threshold) const {
-
-  EnthalpyConverter::Ptr EC = m_ctx->enthalpy_converter();
-
-  const IceModelVec3 &ice_enthalpy = m_energy_model->enthalpy();
-
-  double area = 0.0;
-
-  auto cell_area = m_grid->cell_area();
-
-  IceModelVec::AccessList list{&m_geometry.ice_thickness, &ice_enthalpy};
-  ParallelSection loop(m_grid->com);
-  try {
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      const double
-        thickness      = m_geometry.ice_thickness(i, j),
-        basal_enthalpy = ice_enthalpy.get_column(i, j)[0];
-
-      if (thickness >= thickness_threshold and
-          EC->is_temperate_relaxed(basal_enthalpy, EC->pressure(thickness))) { // FIXME issue #15
-        area += cell_area;
-      }
-    }
-  } catch (...) {
-    loop.failed();
-  }
-  loop.check();
-
-  return GlobalSum(m_grid->com, area);
-}
-
-//! Computes area of basal ice which is cold, in m^2.
-double IceModel::ice_area_cold(double thickness_threshold) const {
-
-  EnthalpyConverter::Ptr EC = m_ctx->enthalpy_converter();
-
-  const IceModelVec3 &ice_enthalpy = m_energy_model->enthalpy();
-
-  double area = 0.0;
-
-  auto cell_area = m_grid->cell_area();
-
-  IceModelVec::AccessList list{&ice_enthalpy, &m_geometry.ice_thickness};
-  ParallelSection loop(m_grid->com);
-  try {
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      const double
-        thickness = m_geometry.ice_thickness(i, j),
-        basal_enthalpy = ice_enthalpy.get_column(i, j)[0];
-
-      if (thickness >= thickness_threshold and
-          not EC->is_temperate_relaxed(basal_enthalpy, EC->pressure(thickness))) { // FIXME issue #15
-        area += cell_area;
-      }
-    }
-  } catch (...) {
-    loop.failed();
-  }
-  loop.check();
-
-  return GlobalSum(m_grid->com, area);
-}
-
 } // end of namespace pism
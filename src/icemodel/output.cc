@@ -30,6 +30,7 @@
 #include "pism/util/Time.hh"
 #include "pism/util/error_handling.hh"
 #include "pism/util/io/File.hh"
+#include "pism/util/io/AsyncWriter.hh"
 #include "pism/util/pism_options.hh"
 
 #include "pism/util/Vars.hh"
@@ -125,27 +126,58 @@ void IceModel::save_results() {
                    "PISM WARNING: output file name does not have the '.nc' suffix!\n");
   }
 
+  // this is the end of the run: write all buffered scalar time-series
+  flush_timeseries();
+
   const Profiling &profiling = m_ctx->profiling();
 
   profiling.begin("io.model_state");
   if (m_config->get_string("output.size") != "none") {
     m_log->message(2, "Writing model state to file `%s'...\n", filename.c_str());
-    File file(m_grid->com,
-              filename,
-              string_to_backend(m_config->get_string("output.format")),
-              PISM_READWRITE_MOVE,
-              m_ctx->pio_iosys_id());
+    auto file = output_file(filename, PISM_READWRITE_MOVE);
 
-    write_metadata(file, WRITE_MAPPING, PREPEND_HISTORY);
+    write_metadata(*file, WRITE_MAPPING, PREPEND_HISTORY);
 
-    write_run_stats(file);
+    write_run_stats(*file);
 
-    save_variables(file, INCLUDE_MODEL_STATE, m_output_vars,
+    save_variables(*file, INCLUDE_MODEL_STATE, m_output_vars,
                    m_time->current());
   }
+
+  if (m_output_writer) {
+    // this is the end of the run: close the extra file (if it is open), write all output
+    // files and report errors
+    m_extra_file.reset(nullptr);
+
+    auto writer = m_output_writer;
+    m_output_writer.reset();
+    writer->close();
+  }
   profiling.end("io.model_state");
 }
 
+//! Open an output file (extra, backup or the final output file) for writing.
+/*!
+ * If `output.asynchronous` is set the file is written by a background thread.
+ */
+std::unique_ptr<File> IceModel::output_file(const std::string &filename, IO_Mode mode) {
+  IO_Backend backend = string_to_backend(m_config->get_string("output.format"));
+
+  if (m_config->get_flag("output.asynchronous")) {
+    if (not m_output_writer) {
+      size_t buffer_size = m_config->get_number("output.asynchronous_buffer_size");
+      m_output_writer.reset(new io::AsyncWriter(m_grid->com, buffer_size * 1024 * 1024));
+    }
+
+    return std::unique_ptr<File>(new File(m_output_writer, filename, backend, mode));
+  }
+
+  int n_aggregators = m_config->get_number("output.netcdf3.n_aggregators");
+
+  return std::unique_ptr<File>(new File(m_grid->com, filename, backend, mode,
+                                        m_ctx->pio_iosys_id(), n_aggregators));
+}
+
 void IceModel::write_mapping(const File &file) {
   // only write mapping if it is set.
   const VariableMetadata &mapping = m_grid->get_mapping_info().mapping;
@@ -21,6 +21,9 @@
 
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/Profiling.hh"
+#include "pism/util/Vars.hh"
+#include "pism/util/io/File.hh"
+#include "pism/util/io/io_helpers.hh"
 
 namespace pism {
 
@@ -34,8 +37,68 @@ void IceModel::init_backups() {
     m_backup_filename = "pism_backup.nc";
   }
 
+  if (m_config->get_string("output.backup_format") == "native") {
+    // native backups are not NetCDF files
+    if (ends_with(m_backup_filename, ".nc")) {
+      m_backup_filename.resize(m_backup_filename.size() - 3);
+    }
+    m_backup_filename += ".pism";
+  }
+
   m_backup_vars = output_variables(m_config->get_string("output.backup_size"));
   m_last_backup_time = 0.0;
+  m_n_incremental_backups = 0;
+  m_backup_state.clear();
+}
+
+//! Record state counters and checksums of model state variables in a backup `file`.
+/*!
+ * Only variables stored in single-component fields registered in IceGrid::variables()
+ * are tracked; all others are re-written every time.
+ */
+void IceModel::record_backup_state(const File &file) {
+  m_backup_state.clear();
+
+  const Vars &vars = m_grid->variables();
+
+  unsigned int n_vars = file.nvariables();
+  for (unsigned int k = 0; k < n_vars; ++k) {
+    std::string name = file.variable_name(k);
+
+    if (not vars.is_available(name)) {
+      continue;
+    }
+
+    const IceModelVec *v = vars.get(name);
+    if (v->ndof() != 1 or v->metadata().get_name() != name) {
+      continue;
+    }
+
+    m_backup_state[name] = {v->state_counter(), v->fletcher64()};
+  }
+}
+
+//! Names of variables in the backup file that did not change since they were written.
+/*!
+ * In-place modifications (e.g. by the mass continuity code) do not advance state
+ * counters, so a variable with an unchanged counter is re-written if its checksum
+ * changed.
+ */
+std::set<std::string> IceModel::unchanged_backup_variables() {
+  std::set<std::string> result;
+
+  const Vars &vars = m_grid->variables();
+
+  for (const auto &s : m_backup_state) {
+    const IceModelVec *v = vars.get(s.first);
+
+    if (v->state_counter() == s.second.first and
+        v->fletcher64() == s.second.second) {
+      result.insert(s.first);
+    }
+  }
+
+  return result;
 }
 
   //! Write a backup (i.e. an intermediate result of a run).
@@ -62,16 +125,62 @@ void IceModel::write_backup() {
   double backup_start_time = get_time();
   profiling.begin("io.backup");
   {
-    File file(m_grid->com,
-              m_backup_filename,
-              string_to_backend(m_config->get_string("output.format")),
-              PISM_READWRITE_MOVE,
-              m_ctx->pio_iosys_id());
-
-    write_metadata(file, WRITE_MAPPING, PREPEND_HISTORY);
-    write_run_stats(file);
-
-    save_variables(file, INCLUDE_MODEL_STATE, m_backup_vars, m_time->current());
+    bool native = m_config->get_string("output.backup_format") == "native";
+
+    // Use an incremental backup if possible: a full backup has to exist and NativeFile
+    // does not support updating files.
+    bool incremental = (m_config->get_flag("output.backup_incremental") and
+                        not native and
+                        not m_backup_state.empty() and
+                        m_n_incremental_backups + 1 < m_config->get_number("output.backup_full_interval") and
+                        io::file_exists(m_grid->com, m_backup_filename));
+
+    std::unique_ptr<File> file;
+    if (native) {
+      // Each rank writes its part of the model state to a separate file. Such a backup can
+      // be used as an input file (-i) by the following run.
+      file.reset(new File(m_grid->com, m_backup_filename, PISM_NATIVE, PISM_READWRITE_MOVE));
+    } else if (incremental) {
+      file = output_file(m_backup_filename, PISM_READWRITE);
+    } else {
+      file = output_file(m_backup_filename, PISM_READWRITE_MOVE);
+    }
+
+    if (incremental) {
+      std::set<std::string> unchanged = unchanged_backup_variables();
+
+      m_log->message(2, "  Re-writing %d of %d tracked variables...\n",
+                     (int)(m_backup_state.size() - unchanged.size()),
+                     (int)m_backup_state.size());
+
+      // Overwrite the only record instead of appending a new one. Variables listed in
+      // "unchanged" keep the values written by an earlier backup.
+      double time = m_time->current();
+      file->write_variable(m_config->get_string("time.dimension_name"), {0}, {1}, &time);
+
+      write_run_stats(*file);
+
+      file->skip_writing(unchanged);
+      write_model_state(*file);
+      write_diagnostics(*file, m_backup_vars);
+      file->skip_writing({});
+
+      io::write_timeseries(*file, m_timestamp, 0,
+                           wall_clock_hours(m_grid->com, m_start_time));
+
+      m_n_incremental_backups += 1;
+    } else {
+      write_metadata(*file, WRITE_MAPPING, PREPEND_HISTORY);
+      write_run_stats(*file);
+
+      save_variables(*file, INCLUDE_MODEL_STATE, m_backup_vars, m_time->current());
+
+      m_n_incremental_backups = 0;
+    }
+
+    if (m_config->get_flag("output.backup_incremental") and not native) {
+      record_backup_state(*file);
+    }
   }
   profiling.end("io.backup");
   double backup_end_time = get_time();
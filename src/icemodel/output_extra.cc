@@ -27,6 +27,9 @@
 #include "pism/util/pism_options.hh"
 #include "pism/util/pism_utilities.hh"
 #include "pism/util/Profiling.hh"
+#include "pism/util/OutputGrid.hh"
+#include "pism/util/io/File.hh"
+#include "pism/util/io/io_helpers.hh"
 
 namespace pism {
 
@@ -227,6 +230,63 @@ void IceModel::init_extras() {
     m_log->message(2,
                    "PISM WARNING: output.extra.vars was not set. Writing the model state...\n");
   } // end of the else clause after "if (extra_vars_set)"
+
+  m_extra_grid = OutputGrid::FromConfig(m_grid);
+
+  if (m_extra_grid) {
+    if (m_extra_vars.empty()) {
+      throw RuntimeError(PISM_ERROR_LOCATION,
+                         "output.extra.vars has to be set to save spatial time-series"
+                         " using a coarser or smaller grid");
+    }
+
+    auto g = m_extra_grid->grid();
+    m_log->message(2, "saving spatial time-series on a %d x %d grid (dx = %3.3f km, dy = %3.3f km)\n",
+                   g->Mx(), g->My(), units::convert(m_sys, g->dx(), "m", "km"),
+                   units::convert(m_sys, g->dy(), "m", "km"));
+  }
+}
+
+//! Save diagnostics listed in `variables` using the grid `output_grid`.
+/*!
+ * Similar to save_variables(), but computes values of diagnostic quantities on the output
+ * grid before defining and writing them.
+ */
+void IceModel::save_diagnostics(const File &file,
+                                const OutputGrid &output_grid,
+                                const std::set<std::string> &variables,
+                                double time,
+                                IO_Type default_type) {
+
+  io::define_time(file, *m_grid->ctx());
+  io::define_timeseries(m_timestamp, file, PISM_FLOAT);
+  io::append_time(file, *m_config, time);
+
+  write_run_stats(file);
+
+  // compute all diagnostics first to define all variables before writing any data
+  // (fields on the output grid are small)
+  std::vector<IceModelVec::Ptr> fields;
+  for (auto variable : variables) {
+    auto diag = m_diagnostics.find(variable);
+
+    if (diag != m_diagnostics.end()) {
+      fields.push_back(output_grid.map(*diag->second->compute()));
+    }
+  }
+
+  for (auto f : fields) {
+    f->define(file, default_type);
+  }
+
+  for (auto f : fields) {
+    f->write(file);
+  }
+
+  unsigned int time_length = file.dimension_length(m_config->get_string("time.dimension_name"));
+  size_t start = time_length > 0 ? static_cast<size_t>(time_length - 1) : 0;
+  io::write_timeseries(file, m_timestamp, start,
+                       wall_clock_hours(m_grid->com, m_start_time));
 }
 
 //! Write spatially-variable diagnostic quantities.
@@ -314,11 +374,7 @@ void IceModel::write_extras() {
   profiling.begin("io.extra_file");
   {
     if (not m_extra_file) {
-      m_extra_file.reset(new File(m_grid->com,
-                                  filename,
-                                  string_to_backend(m_config->get_string("output.format")),
-                                  mode,
-                                  m_ctx->pio_iosys_id()));
+      m_extra_file = output_file(filename, mode);
     }
 
     std::string time_name = m_config->get_string("time.dimension_name");
@@ -337,12 +393,16 @@ void IceModel::write_extras() {
 
     write_run_stats(*m_extra_file);
 
-    save_variables(*m_extra_file,
-                   m_extra_vars.empty() ? INCLUDE_MODEL_STATE : JUST_DIAGNOSTICS,
-                   m_extra_vars,
-                   0.5 * (m_last_extra + current_time), // use the mid-point of the
-                                                        // current reporting interval
-                   PISM_FLOAT);
+    // use the mid-point of the current reporting interval
+    double time = 0.5 * (m_last_extra + current_time);
+
+    if (m_extra_grid) {
+      save_diagnostics(*m_extra_file, *m_extra_grid, m_extra_vars, time, PISM_FLOAT);
+    } else {
+      save_variables(*m_extra_file,
+                     m_extra_vars.empty() ? INCLUDE_MODEL_STATE : JUST_DIAGNOSTICS,
+                     m_extra_vars, time, PISM_FLOAT);
+    }
 
     // Get the length of the time dimension *after* it is appended to.
     unsigned int time_length = m_extra_file->dimension_length(time_name);
@@ -355,7 +415,7 @@ void IceModel::write_extras() {
   }
   profiling.end("io.extra_file");
 
-  flush_timeseries();
+  write_timeseries();
 
   if (m_split_extra) {
     // each record is saved to a new file, so we can close this one
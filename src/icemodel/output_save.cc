@@ -132,8 +132,8 @@ void IceModel::write_snapshot() {
     return;
   }
 
-  // flush time-series buffers
-  flush_timeseries();
+  // write time-series if necessary
+  write_timeseries();
 
   if (m_split_snapshots) {
     m_snapshots_file_is_ready = false;    // each snapshot is written to a separate file
@@ -157,7 +157,8 @@ void IceModel::write_snapshot() {
               filename,
               string_to_backend(m_config->get_string("output.format")),
               mode,
-              m_ctx->pio_iosys_id());
+              m_ctx->pio_iosys_id(),
+              m_config->get_number("output.netcdf3.n_aggregators"));
 
     if (not m_snapshots_file_is_ready) {
       write_metadata(file, WRITE_MAPPING, PREPEND_HISTORY);
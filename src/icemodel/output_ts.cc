@@ -17,10 +17,13 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <algorithm>            // std::max
+
 #include "IceModel.hh"
 
 #include "pism/util/pism_options.hh"
 #include "pism/util/pism_utilities.hh"
+#include "pism/util/Profiling.hh"
 
 namespace pism {
 
@@ -45,6 +48,7 @@ static std::set<std::string> process_ts_shortcuts(const Config &config,
 void IceModel::init_timeseries() {
 
   m_ts_filename = m_config->get_string("output.timeseries.filename");
+  m_last_ts_flush_time = 0.0;
 
   auto times = m_config->get_string("output.timeseries.times");
   bool times_set = not times.empty();
@@ -115,18 +119,64 @@ MaxTimestep IceModel::ts_max_timestep(double my_t) {
   return reporting_max_timestep(*m_ts_times, my_t, "reporting (-ts_times)");
 }
 
+//! Write scalar time-series if buffers are full or if it is time to do it.
+/*!
+ * Scalar diagnostics are kept in memory until `output.timeseries.buffer_size` records are
+ * accumulated or `output.timeseries.flush_interval` wall clock hours passed since the last
+ * write.
+ */
+void IceModel::write_timeseries() {
+  if (m_ts_diagnostics.empty()) {
+    return;
+  }
+
+  size_t n_records = 0;
+  for (auto d : m_ts_diagnostics) {
+    n_records = std::max(n_records, d.second->n_buffered());
+  }
+
+  if (n_records == 0) {
+    return;
+  }
+
+  const size_t buffer_size = m_config->get_number("output.timeseries.buffer_size");
+  const double flush_interval = m_config->get_number("output.timeseries.flush_interval");
+
+  // Note: wall_clock_hours() returns the same value on all ranks.
+  double wall_clock_hours = pism::wall_clock_hours(m_grid->com, m_start_time);
+
+  if (n_records >= buffer_size or
+      (flush_interval > 0.0 and wall_clock_hours - m_last_ts_flush_time >= flush_interval)) {
+    flush_timeseries();
+  }
+}
+
 //! Flush scalar time-series.
+/*!
+ * Writes all buffered records (using one open/close cycle) and updates run_stats in the time
+ * series output file.
+ */
 void IceModel::flush_timeseries() {
-  // flush all the time-series buffers:
-  for (auto d : m_ts_diagnostics) {
-    d.second->flush();
+  if (m_ts_diagnostics.empty()) {
+    return;
   }
 
-  // update run_stats in the time series output file
-  if (not m_ts_diagnostics.empty()) {
+  const Profiling &profiling = m_ctx->profiling();
+
+  profiling.begin("io.timeseries");
+  {
     File file(m_grid->com, m_ts_filename, PISM_NETCDF3, PISM_READWRITE);
+
+    // flush all the time-series buffers:
+    for (auto d : m_ts_diagnostics) {
+      d.second->flush(file);
+    }
+
     write_run_stats(file);
   }
+  profiling.end("io.timeseries");
+
+  m_last_ts_flush_time = pism::wall_clock_hours(m_grid->com, m_start_time);
 }
 
 } // end of namespace pism
@@ -71,7 +71,8 @@ int IceModel::process_signals() {
               file_name,
               string_to_backend(m_config->get_string("output.format")),
               PISM_READWRITE_MOVE,
-              m_ctx->pio_iosys_id());
+              m_ctx->pio_iosys_id(),
+              m_config->get_number("output.netcdf3.n_aggregators"));
     save_variables(file, INCLUDE_MODEL_STATE, m_output_vars, m_time->current());
 
     // flush all the time-series buffers:
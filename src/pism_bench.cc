@@ -0,0 +1,512 @@
+// Copyright (C) 2020 PISM Authors
+//
+// This file is part of PISM.
+//
+// PISM is free software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the Free Software
+// Foundation; either version 3 of the License, or (at your option) any later
+// version.
+//
+// PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+// WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+// FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+// details.
+//
+// You should have received a copy of the GNU General Public License
+// along with PISM; if not, write to the Free Software
+// Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+
+static char help[] =
+  "\nPISM_BENCH\n"
+  "  Runs standardized computational kernels (SIA, SSAFD, enthalpy column solves,\n"
+  "  routing hydrology, mass transport, NetCDF output) on a synthetic ice dome\n"
+  "  and reports wall-clock times in JSON.\n\n";
+
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <functional>
+#include <sys/stat.h>
+
+#include "pism/util/IceGrid.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Logger.hh"
+#include "pism/util/Time.hh"
+#include "pism/util/Mask.hh"
+#include "pism/util/EnthalpyConverter.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/iceModelVec.hh"
+#include "pism/util/io/File.hh"
+#include "pism/util/io/io_helpers.hh"
+#include "pism/util/petscwrappers/PetscInitializer.hh"
+#include "pism/util/pism_options.hh"
+#include "pism/util/pism_utilities.hh"
+#include "pism/geometry/Geometry.hh"
+#include "pism/geometry/GeometryEvolution.hh"
+#include "pism/stressbalance/StressBalance.hh"
+#include "pism/stressbalance/ShallowStressBalance.hh"
+#include "pism/stressbalance/sia/SIAFD.hh"
+#include "pism/stressbalance/ssa/SSAFD.hh"
+#include "pism/energy/enthSystem.hh"
+#include "pism/hydrology/Routing.hh"
+
+namespace pism {
+
+//! Timings of one kernel (maximum over all ranks for each repetition).
+struct KernelTiming {
+  std::string name;
+  std::vector<double> times;
+  //! additional (name, JSON value) pairs describing this kernel's settings and results
+  std::vector<std::pair<std::string, std::string> > details;
+};
+
+/*!
+ * Run `kernel` `repeat` times (after one warm-up run) and record the wall-clock time of
+ * each run. Uses the time of the slowest rank.
+ */
+static KernelTiming time_kernel(MPI_Comm com, const std::string &name, int repeat,
+                                std::function<void()> kernel) {
+  KernelTiming result;
+  result.name = name;
+
+  // warm-up run (allocations, PETSc setup, file system caches)
+  kernel();
+
+  for (int k = 0; k < repeat; ++k) {
+    MPI_Barrier(com);
+    double start = get_time();
+
+    kernel();
+
+    double local = get_time() - start;
+    result.times.push_back(GlobalMax(com, local));
+  }
+  return result;
+}
+
+//! Set up a dome-shaped ice sheet on a flat, grounded bed.
+static void set_dome_geometry(const IceGrid &grid, double H0, Geometry &geometry) {
+  const double R = 0.8 * std::min(grid.Lx(), grid.Ly());
+
+  geometry.bed_elevation.set(0.0);
+  geometry.sea_level_elevation.set(-1000.0);
+
+  IceModelVec::AccessList list{&geometry.ice_thickness};
+
+  for (Points p(grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    const double r = radius(grid, i, j);
+
+    if (r < R) {
+      geometry.ice_thickness(i, j) = H0 * pow(1.0 - pow(r / R, 4.0 / 3.0), 3.0 / 8.0);
+    } else {
+      geometry.ice_thickness(i, j) = 0.0;
+    }
+  }
+  geometry.ice_thickness.update_ghosts();
+
+  geometry.ensure_consistency(0.0);
+}
+
+//! Cold ice with a linear temperature profile.
+static void set_enthalpy(const IceGrid &grid, const EnthalpyConverter &EC,
+                         const IceModelVec2S &ice_thickness, IceModelVec3 &enthalpy) {
+  const double
+    T_surface = 243.15,
+    T_base    = 268.15;
+
+  // enthalpy may be stored in single precision, so columns are filled using a buffer
+  std::vector<double> E(grid.Mz());
+
+  IceModelVec::AccessList list{&ice_thickness, &enthalpy};
+
+  for (Points p(grid); p; p.next()) {
+    const int i = p.i(), j = p.j();
+
+    const double H = ice_thickness(i, j);
+
+    for (unsigned int k = 0; k < grid.Mz(); ++k) {
+      const double
+        z     = grid.z(k),
+        depth = std::max(H - z, 0.0),
+        T     = H > 0.0 ? T_base + (T_surface - T_base) * std::min(z / H, 1.0) : T_surface;
+      E[k] = EC.enthalpy(T, 0.0, EC.pressure(depth));
+    }
+    enthalpy.set_column(i, j, &E[0]);
+  }
+  enthalpy.update_ghosts();
+}
+
+//! Size of the file on disk in bytes (0 if it does not exist). Collective.
+/*!
+ * Files in the PISM_NATIVE format consist of the index file and one data file per rank.
+ */
+static double file_size(const IceGrid &grid, const std::string &filename, IO_Backend backend) {
+  std::vector<std::string> names;
+  if (grid.rank() == 0) {
+    names.push_back(filename);
+  }
+  if (backend == PISM_NATIVE) {
+    names.push_back(pism::printf("%s.%d", filename.c_str(), grid.rank()));
+  }
+
+  double size = 0.0;
+  for (const auto &name : names) {
+    struct stat info;
+    if (stat(name.c_str(), &info) == 0) {
+      size += info.st_size;
+    }
+  }
+
+  return GlobalSum(grid.com, size);
+}
+
+static std::string json_report(const IceGrid &grid, int repeat,
+                               const std::vector<KernelTiming> &timings) {
+  std::ostringstream out;
+
+  out.precision(9);
+
+  out << "{\n"
+      << "  \"Mx\": " << grid.Mx() << ",\n"
+      << "  \"My\": " << grid.My() << ",\n"
+      << "  \"Mz\": " << grid.Mz() << ",\n"
+      << "  \"ranks\": " << grid.size() << ",\n"
+      << "  \"repeat\": " << repeat << ",\n"
+      << "  \"kernels\": {\n";
+
+  for (size_t n = 0; n < timings.size(); ++n) {
+    const auto &t = timings[n];
+
+    double sum = 0.0;
+    for (auto x : t.times) {
+      sum += x;
+    }
+
+    out << "    \"" << t.name << "\": {"
+        << "\"min\": " << vector_min(t.times) << ", "
+        << "\"mean\": " << sum / t.times.size() << ", "
+        << "\"max\": " << vector_max(t.times) << ", "
+        << "\"times\": [";
+    for (size_t k = 0; k < t.times.size(); ++k) {
+      out << t.times[k] << (k + 1 < t.times.size() ? ", " : "");
+    }
+    out << "]";
+    for (const auto &d : t.details) {
+      out << ", \"" << d.first << "\": " << d.second;
+    }
+    out << "}" << (n + 1 < timings.size() ? "," : "") << "\n";
+  }
+
+  out << "  }\n"
+      << "}\n";
+
+  return out.str();
+}
+
+} // end of namespace pism
+
+int main(int argc, char *argv[]) {
+
+  using namespace pism;
+
+  MPI_Comm com = MPI_COMM_WORLD;
+  petsc::Initializer petsc(argc, argv, help);
+
+  com = PETSC_COMM_WORLD;
+
+  /* This explicit scoping forces destructors to be called before PetscFinalize() */
+  try {
+    Context::Ptr ctx = context_from_options(com, "pism_bench");
+    Config::Ptr config = ctx->config();
+    Logger::ConstPtr log = ctx->log();
+
+    std::string usage = "\n"
+      "usage of PISM_BENCH:\n"
+      "  run pism_bench -Mx <number> -My <number> -Mz <number> [-bench_kernels <list>]\n"
+      "                 [-bench_repeat <number>] [-bench_report <file.json>] [-o <file.nc>]\n"
+      "\n"
+      "  kernels: sia, ssafd, enthalpy, routing, mass_transport, output\n"
+      "\n"
+      "  The output kernel uses -o_format, -output.netcdf4.chunking,\n"
+      "  -output.netcdf4.compression_level and -output.netcdf4.compression_overrides\n"
+      "  and reports the size of the file it writes.\n"
+      "\n";
+
+    bool stop = show_usage_check_req_opts(*log, "pism_bench", {}, usage);
+
+    if (stop) {
+      return 0;
+    }
+
+    options::StringSet kernels("-bench_kernels", "Kernels to run",
+                               "sia,ssafd,enthalpy,routing,mass_transport,output");
+    options::Integer repeat("-bench_repeat", "Number of timed runs of each kernel", 5);
+    options::String report("-bench_report", "Name of the JSON file to save timings to", "");
+
+    if (repeat < 1) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "-bench_repeat has to be positive (got %d)",
+                                    (int)repeat);
+    }
+
+    GridParameters P(config);
+    P.horizontal_size_from_options();
+    P.horizontal_extent_from_options();
+    P.vertical_grid_from_options(config);
+    P.ownership_ranges_from_options(ctx->size());
+
+    IceGrid::Ptr grid(new IceGrid(ctx, P));
+    grid->report_parameters();
+
+    EnthalpyConverter::Ptr EC = ctx->enthalpy_converter();
+
+    const int WIDE_STENCIL = config->get_number("grid.max_stencil_width");
+
+    Geometry geometry(grid);
+    set_dome_geometry(*grid, 0.75 * grid->Lz(), geometry);
+
+    IceModelVec3 enthalpy(grid, "enthalpy", WITH_GHOSTS, WIDE_STENCIL);
+    enthalpy.set_attrs("model_state",
+                       "ice enthalpy (includes sensible heat, latent heat, pressure)",
+                       "J kg-1", "J kg-1", "", 0);
+    set_enthalpy(*grid, *EC, geometry.ice_thickness, enthalpy);
+
+    IceModelVec3 age(grid, "age", WITHOUT_GHOSTS);
+    age.set_attrs("diagnostic", "age of the ice", "s", "s", "", 0);
+    age.set(0.0);
+
+    IceModelVec2S zero(grid, "zero", WITHOUT_GHOSTS);
+    zero.set_attrs("internal", "zero", "", "", "", 0);
+    zero.set(0.0);
+
+    IceModelVec2S basal_yield_stress(grid, "tauc", WITH_GHOSTS, 1);
+    basal_yield_stress.set_attrs("internal", "basal yield stress", "Pa", "Pa", "", 0);
+    basal_yield_stress.set(1e5);
+
+    std::vector<KernelTiming> timings;
+
+    const double dt = units::convert(ctx->unit_system(), 1.0, "year", "seconds");
+
+    if (member("sia", kernels)) {
+      using namespace stressbalance;
+
+      StressBalance model(grid, new ZeroSliding(grid), new SIAFD(grid));
+      model.init();
+
+      Inputs inputs;
+      inputs.geometry              = &geometry;
+      inputs.melange_back_pressure = &zero;
+      inputs.enthalpy              = &enthalpy;
+      inputs.age                   = &age;
+
+      timings.push_back(time_kernel(com, "sia", repeat,
+                                    [&]() { model.update(inputs, true); }));
+    }
+
+    if (member("ssafd", kernels)) {
+      using namespace stressbalance;
+
+      SSAFD model(grid);
+      model.init();
+
+      Inputs inputs;
+      inputs.geometry              = &geometry;
+      inputs.melange_back_pressure = &zero;
+      inputs.enthalpy              = &enthalpy;
+      inputs.basal_yield_stress    = &basal_yield_stress;
+
+      // start each solve from the same initial guess
+      IceModelVec2V guess(grid, "guess", WITHOUT_GHOSTS);
+      guess.set(0.0);
+
+      timings.push_back(time_kernel(com, "ssafd", repeat,
+                                    [&]() {
+                                      model.set_initial_guess(guess);
+                                      model.update(inputs, true);
+                                    }));
+    }
+
+    if (member("enthalpy", kernels)) {
+      IceModelVec3
+        u(grid, "u", WITH_GHOSTS),
+        v(grid, "v", WITH_GHOSTS),
+        w(grid, "w", WITHOUT_GHOSTS),
+        strain_heating(grid, "strain_heating", WITHOUT_GHOSTS),
+        result(grid, "enthalpy_new", WITHOUT_GHOSTS);
+      u.set(0.0);
+      v.set(0.0);
+      w.set(0.0);
+      strain_heating.set(0.0);
+
+      const double G = 0.042;   // geothermal flux, W m-2
+
+      auto kernel = [&]() {
+        energy::enthSystemCtx system(grid->z(), "energy.enthalpy", grid->dx(), grid->dy(), dt,
+                                     *config, enthalpy, u, v, w, strain_heating, EC);
+
+        std::vector<double> E_new(system.z().size());
+
+        IceModelVec::AccessList list{&geometry.ice_thickness, &enthalpy, &u, &v, &w,
+            &strain_heating, &result};
+
+        for (Points p(*grid); p; p.next()) {
+          const int i = p.i(), j = p.j();
+
+          const double H = geometry.ice_thickness(i, j);
+
+          system.init(i, j, false, H);
+
+          if (system.ks() == 0) {
+            continue;
+          }
+
+          system.set_surface_dirichlet_bc(system.Enth(system.ks()));
+          system.set_basal_heat_flux(G);
+          system.solve(E_new);
+
+          system.fine_to_coarse(E_new, i, j, result);
+        }
+      };
+
+      timings.push_back(time_kernel(com, "enthalpy", repeat, kernel));
+    }
+
+    if (member("routing", kernels)) {
+      hydrology::Routing model(grid);
+
+      IceModelVec2S W(grid, "W", WITHOUT_GHOSTS);
+      W.set_attrs("internal", "initial water thickness", "m", "m", "", 0);
+      W.set(0.01);
+
+      IceModelVec2S melt(grid, "melt", WITHOUT_GHOSTS);
+      melt.set_attrs("internal", "basal melt rate", "m s-1", "m s-1", "", 0);
+      melt.set(units::convert(ctx->unit_system(), 0.01, "m year-1", "m second-1"));
+
+      model.init(zero, W, zero);
+
+      hydrology::Inputs inputs;
+      inputs.no_model_mask      = nullptr;
+      inputs.geometry           = &geometry;
+      inputs.surface_input_rate = nullptr;
+      inputs.basal_melt_rate    = &melt;
+      inputs.ice_sliding_speed  = &zero;
+
+      // a fixed number of hydrology sub-steps
+      const double hydrology_dt = 10.0 * config->get_number("hydrology.maximum_time_step",
+                                                            "seconds");
+
+      double t = ctx->time()->current();
+      timings.push_back(time_kernel(com, "routing", repeat,
+                                    [&]() {
+                                      model.update(t, hydrology_dt, inputs);
+                                      t += hydrology_dt;
+                                    }));
+    }
+
+    if (member("mass_transport", kernels)) {
+      GeometryEvolution model(grid);
+
+      Geometry state(grid);
+      set_dome_geometry(*grid, 0.75 * grid->Lz(), state);
+
+      // radial spreading with the speed of 100 m/year at the margin
+      IceModelVec2V velocity(grid, "velocity", WITH_GHOSTS, 1);
+      {
+        const double
+          R     = 0.8 * std::min(grid->Lx(), grid->Ly()),
+          speed = units::convert(ctx->unit_system(), 100.0, "m year-1", "m second-1");
+
+        IceModelVec::AccessList list{&velocity};
+        for (Points p(*grid); p; p.next()) {
+          const int i = p.i(), j = p.j();
+
+          velocity(i, j).u = speed * grid->x(i) / R;
+          velocity(i, j).v = speed * grid->y(j) / R;
+        }
+        velocity.update_ghosts();
+      }
+
+      IceModelVec2Stag diffusive_flux(grid, "diffusive_flux", WITH_GHOSTS, 1);
+      diffusive_flux.set(0.0);
+
+      IceModelVec2Int bc_mask(grid, "bc_mask", WITH_GHOSTS, 1);
+      bc_mask.set(0.0);
+
+      const double transport_dt = units::convert(ctx->unit_system(), 1.0, "day", "seconds");
+
+      timings.push_back(time_kernel(com, "mass_transport", repeat,
+                                    [&]() {
+                                      model.flow_step(state, transport_dt,
+                                                      velocity, diffusive_flux,
+                                                      bc_mask, bc_mask);
+                                      model.apply_flux_divergence(state);
+                                      state.ensure_consistency(0.0);
+                                    }));
+    }
+
+    if (member("output", kernels)) {
+      // Uses output.format, output.netcdf4.chunking, output.netcdf4.compression_level and
+      // output.netcdf4.compression_overrides (set using command-line options, e.g.
+      // -output.netcdf4.compression_overrides enthalpy:1,thk:0).
+      auto filename = config->get_string("output.file_name");
+      auto format   = config->get_string("output.format");
+      auto backend  = string_to_backend(format);
+
+      // enthalpy is written in double precision, age is a diagnostic saved in single
+      // precision (rounded using output.float_significant_bits)
+      std::vector<const IceModelVec*> fields{&enthalpy, &age, &geometry.ice_thickness,
+                                             &geometry.bed_elevation, &basal_yield_stress};
+
+      auto kernel = time_kernel(com, "output", repeat,
+                                [&]() {
+                                  File file(com, filename, backend, PISM_READWRITE_MOVE,
+                                            ctx->pio_iosys_id(),
+                                            config->get_number("output.netcdf3.n_aggregators"));
+                                  io::define_time(file, *ctx);
+                                  io::append_time(file, *config, ctx->time()->current());
+                                  for (auto f : fields) {
+                                    f->define(file, f == &age ? PISM_FLOAT : PISM_DOUBLE);
+                                  }
+                                  for (auto f : fields) {
+                                    f->write(file);
+                                  }
+                                  file.close();
+                                });
+
+      kernel.details = {
+        {"format", "\"" + format + "\""},
+        {"chunking", config->get_flag("output.netcdf4.chunking") ? "true" : "false"},
+        {"compression_level",
+         pism::printf("%d", (int)config->get_number("output.netcdf4.compression_level"))},
+        {"compression_overrides",
+         "\"" + config->get_string("output.netcdf4.compression_overrides") + "\""},
+        {"file_size", pism::printf("%.0f", file_size(*grid, filename, backend))}
+      };
+
+      timings.push_back(kernel);
+    }
+
+    std::string json = json_report(*grid, repeat, timings);
+
+    if (report->empty()) {
+      log->message(1, json);
+    } else if (grid->rank() == 0) {
+      FILE *f = fopen(report->c_str(), "w");
+      if (f == NULL) {
+        throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                      "failed to open %s for writing", report->c_str());
+      }
+      fputs(json.c_str(), f);
+      fclose(f);
+    }
+  }
+  catch (...) {
+    handle_fatal_errors(com);
+    return 1;
+  }
+
+  return 0;
+}
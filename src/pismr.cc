@@ -71,12 +71,20 @@ int main(int argc, char *argv[]) {
     options::String profiling_log = options::String("-profile",
                                                     "Save detailed profiling data to a file.");
 
+    options::String profiling_timeline("-profile_timeline",
+                                       "Save per-time-step, per-rank profiling data"
+                                       " to a JSON file.");
+
     Config::Ptr config = ctx->config();
 
     if (profiling_log.is_set()) {
       ctx->profiling().start();
     }
 
+    if (profiling_timeline.is_set()) {
+      ctx->profiling().start_timeline();
+    }
+
     IceGrid::Ptr grid;
     std::unique_ptr<IceModel> model;
 
@@ -112,6 +120,10 @@ int main(int argc, char *argv[]) {
     if (profiling_log.is_set()) {
       ctx->profiling().report(profiling_log);
     }
+
+    if (profiling_timeline.is_set()) {
+      ctx->profiling().report_timeline(com, profiling_timeline);
+    }
   }
   catch (...) {
     handle_fatal_errors(com);
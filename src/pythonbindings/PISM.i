@@ -67,6 +67,8 @@
 #include "util/Time_Calendar.hh"
 #include "util/Poisson.hh"
 #include "util/label_components.hh"
+#include "util/RaggedColumns.hh"
+#include "util/OutputGrid.hh"
 %}
 
 // Tell SWIG that the following variables are truly constant
@@ -191,6 +193,7 @@
 
 
 /* PISM header with no dependence on other PISM headers. */
+%rename(__getitem__) pism::GlobalReduction::operator[];
 %include "util/pism_utilities.hh"
 %include "util/interpolation.hh"
 
@@ -330,6 +333,12 @@ pism_class(pism::RegionalYieldStress, "pism/regional/RegionalYieldStress.hh")
 %include "util/FETools.hh"
 %include "util/node_types.hh"
 
+%ignore pism::RaggedColumns::column;
+%include "util/RaggedColumns.hh"
+
+%shared_ptr(pism::OutputGrid)
+%include "util/OutputGrid.hh"
+
 %include pism_inverse.i
 
 %include "coupler/util/PCFactory.hh"
@@ -14,6 +14,36 @@
 %shared_ptr(pism::rheology::PatersonBuddCold)
 %shared_ptr(pism::rheology::PatersonBuddWarm)
 
+%ignore pism::rheology::FlowLaw::hardness_n(const double*, const double*, unsigned int, double*) const;
+%ignore pism::rheology::FlowLaw::flow_n(const double*, const double*, const double*, const double*,
+                                       unsigned int, double*) const;
+%extend pism::rheology::FlowLaw
+{
+std::vector<double> hardness_n(const std::vector<double> &enthalpy,
+                               const std::vector<double> &pressure) {
+  if (enthalpy.size() != pressure.size()) {
+    throw pism::RuntimeError(PISM_ERROR_LOCATION, "arguments have different sizes");
+  }
+  std::vector<double> result(enthalpy.size());
+  $self->hardness_n(enthalpy.data(), pressure.data(), enthalpy.size(), result.data());
+  return result;
+}
+
+std::vector<double> flow_n(const std::vector<double> &stress,
+                           const std::vector<double> &enthalpy,
+                           const std::vector<double> &pressure,
+                           const std::vector<double> &grainsize) {
+  const size_t n = stress.size();
+  if (enthalpy.size() != n or pressure.size() != n or grainsize.size() != n) {
+    throw pism::RuntimeError(PISM_ERROR_LOCATION, "arguments have different sizes");
+  }
+  std::vector<double> result(n);
+  $self->flow_n(stress.data(), enthalpy.data(), pressure.data(), grainsize.data(),
+                n, result.data());
+  return result;
+}
+};
+
 %include "rheology/FlowLaw.hh"
 %include "rheology/GPBLD.hh"
 %include "rheology/PatersonBudd.hh"
@@ -93,6 +93,22 @@ double FlowLaw::softness_paterson_budd(double T_pa) const {
   return A * exp(-Q / (m_ideal_gas_constant * T_pa));
 }
 
+//! Compute the Paterson-Budd softness at `n` points.
+/*!
+ * The loop does not branch, so that compilers can vectorize it (including `exp()` if a
+ * vector math library is available).
+ */
+void FlowLaw::softness_paterson_budd(const double *T_pa, unsigned int n, double *result) const {
+  for (unsigned int k = 0; k < n; ++k) {
+    const bool cold = T_pa[k] < m_crit_temp;
+    const double
+      A = cold ? m_A_cold : m_A_warm,
+      Q = cold ? m_Q_cold : m_Q_warm;
+
+    result[k] = A * exp(-Q / (m_ideal_gas_constant * T_pa[k]));
+  }
+}
+
 //! The flow law itself.
 double FlowLaw::flow(double stress, double enthalpy,
                      double pressure, double gs) const {
@@ -224,21 +240,32 @@ double averaged_hardness(const FlowLaw &ice,
 
   // Use trapezoidal rule to integrate from 0 to zlevels[kbelowH]:
   if (kbelowH > 0) {
-    double
-      p0 = EC.pressure(thickness),
-      E0 = enthalpy[0],
-      h0 = ice.hardness(E0, p0); // ice hardness at the left endpoint
+    // Hardness is computed in blocks of levels using FlowLaw::hardness_n() to avoid
+    // allocating work space for the whole column.
+    const int block_size = 64;
+    double pressure[block_size], hardness[block_size];
+
+    double h0 = 0.0;            // ice hardness at the left endpoint
+    for (int k0 = 0; k0 <= kbelowH; k0 += block_size) {
+      const int N = std::min(block_size, kbelowH + 1 - k0);
+
+      for (int k = 0; k < N; ++k) {
+        pressure[k] = EC.pressure(thickness - zlevels[k0 + k]);
+      }
+
+      ice.hardness_n(&enthalpy[k0], pressure, N, hardness);
 
-    for (int i = 1; i <= kbelowH; ++i) { // note the "1" and the "<="
-      const double
-        p1 = EC.pressure(thickness - zlevels[i]), // pressure at the right endpoint
-        E1 = enthalpy[i], // enthalpy at the right endpoint
-        h1 = ice.hardness(E1, p1); // ice hardness at the right endpoint
+      for (int k = 0; k < N; ++k) {
+        const int i = k0 + k;
+        const double h1 = hardness[k]; // ice hardness at the right endpoint
 
-      // The trapezoid rule sans the "1/2":
-      B += (zlevels[i] - zlevels[i-1]) * (h0 + h1);
+        if (i > 0) {
+          // The trapezoid rule sans the "1/2":
+          B += (zlevels[i] - zlevels[i-1]) * (h0 + h1);
+        }
 
-      h0 = h1;
+        h0 = h1;
+      }
     }
   }
 
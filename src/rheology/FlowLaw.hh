@@ -120,6 +120,7 @@ protected:
   EnthalpyConverter::Ptr m_EC;
 
   double softness_paterson_budd(double T_pa) const;
+  void softness_paterson_budd(const double *T_pa, unsigned int n, double *result) const;
 
   //! regularizing length
   double m_schoofLen;
@@ -17,6 +17,9 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <cmath>
+#include <algorithm>            // std::min
+
 #include "GPBLD.hh"
 #include "pism/util/ConfigInterface.hh"
 
@@ -60,5 +63,57 @@ double GPBLD::softness_impl(double enthalpy, double pressure) const {
   }
 }
 
+/*!
+ * Computes softness at `n` points (see softness_impl()).
+ *
+ * Levels are processed in blocks: each step is a separate loop over a block without
+ * branches and virtual function calls, so that the compiler can vectorize it.
+ */
+void GPBLD::softness_n(const double *enthalpy, const double *pressure,
+                       unsigned int n, double *result) const {
+  const unsigned int block_size = 64;
+  double E_s[block_size], T_pa[block_size], omega[block_size];
+
+  for (unsigned int k0 = 0; k0 < n; k0 += block_size) {
+    const unsigned int N = std::min(block_size, n - k0);
+    const double *E = enthalpy + k0, *P = pressure + k0;
+    double *A = result + k0;
+
+    m_EC->enthalpy_cts(P, N, E_s);
+    m_EC->pressure_adjusted_temperature(E, P, N, T_pa);
+    m_EC->water_fraction(E, P, N, omega);
+
+    // temperate ice uses the softness at the melting point (omega is zero in cold ice)
+    for (unsigned int k = 0; k < N; ++k) {
+      T_pa[k] = E[k] < E_s[k] ? T_pa[k] : m_T_0;
+    }
+
+    softness_paterson_budd(T_pa, N, A);
+
+    for (unsigned int k = 0; k < N; ++k) {
+      A[k] *= 1.0 + m_water_frac_coeff * std::min(omega[k], m_water_frac_observed_limit);
+    }
+  }
+}
+
+void GPBLD::flow_n_impl(const double *stress, const double *enthalpy,
+                        const double *pressure, const double * /* grainsize */,
+                        unsigned int n, double *result) const {
+  softness_n(enthalpy, pressure, n, result);
+
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] *= pow(stress[k], m_n - 1);
+  }
+}
+
+void GPBLD::hardness_n_impl(const double *enthalpy, const double *pressure,
+                            unsigned int n, double *result) const {
+  softness_n(enthalpy, pressure, n, result);
+
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = pow(result[k], m_hardness_power);
+  }
+}
+
 } // end of namespace rheology
 } // end of namespace pism
@@ -50,5 +50,20 @@ double IsothermalGlen::flow_from_temp(double stress, double, double, double) con
   return m_softness_A * pow(stress,m_n-1);
 }
 
+void IsothermalGlen::flow_n_impl(const double *stress, const double *,
+                                 const double *, const double *,
+                                 unsigned int n, double *result) const {
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = m_softness_A * pow(stress[k], m_n - 1);
+  }
+}
+
+void IsothermalGlen::hardness_n_impl(const double *, const double *,
+                                     unsigned int n, double *result) const {
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = m_hardness_B;
+  }
+}
+
 } // end of namespace rheology
 } // end of namespace pism
@@ -34,6 +34,12 @@ protected:
   double softness_impl(double, double) const;
   double hardness_impl(double, double) const;
   double flow_from_temp(double stress, double, double, double) const;
+
+  void flow_n_impl(const double *stress, const double *E,
+                   const double *pressure, const double *grainsize,
+                   unsigned int n, double *result) const;
+  void hardness_n_impl(const double *enthalpy, const double *pressure,
+                       unsigned int n, double *result) const;
 protected:
   double m_softness_A, m_hardness_B;
 };
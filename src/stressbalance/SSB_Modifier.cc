@@ -36,6 +36,9 @@ SSB_Modifier::SSB_Modifier(IceGrid::ConstPtr g)
     m_strain_heating(m_grid, "strainheat", WITHOUT_GHOSTS) {
   m_D_max = 0.0;
 
+  m_u.set_precision(storage_precision(*m_config, "velocity"));
+  m_v.set_precision(storage_precision(*m_config, "velocity"));
+
   m_u.set_attrs("diagnostic", "horizontal velocity of ice in the X direction",
                 "m s-1", "m year-1", "land_ice_x_velocity", 0);
 
@@ -27,6 +27,7 @@
 #include "pism/util/ConfigInterface.hh"
 #include "pism/util/Vars.hh"
 #include "pism/util/error_handling.hh"
+#include "pism/util/pism_utilities.hh"
 #include "pism/util/Profiling.hh"
 #include "pism/util/IceModelVec2CellType.hh"
 #include "pism/util/Time.hh"
@@ -144,6 +145,9 @@ StressBalance::StressBalance(IceGrid::ConstPtr g,
     m_shallow_stress_balance(sb),
     m_modifier(ssb_mod) {
 
+  m_w.set_precision(storage_precision(*m_config, "velocity"));
+  m_strain_heating.set_precision(storage_precision(*m_config, "strain_heating"));
+
   m_w.set_attrs("diagnostic",
                 "vertical velocity of ice, relative to base of ice directly below",
                 "m s-1", "m year-1", "", 0);
@@ -301,13 +305,12 @@ void StressBalance::compute_vertical_velocity(const IceModelVec2CellType &mask,
     dx = m_grid->dx(),
     dy = m_grid->dy();
 
-  std::vector<double> u_x_plus_v_y(Mz);
+  // result may be stored in single precision, so we use set_column()
+  std::vector<double> u_x_plus_v_y(Mz), w_ij(Mz);
 
   for (Points p(*m_grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
-    double *w_ij = result.get_column(i,j);
-
     const double
       *u_w  = u.get_column(i-1,j),
       *u_ij = u.get_column(i,j),
@@ -420,6 +423,8 @@ void StressBalance::compute_vertical_velocity(const IceModelVec2CellType &mask,
 
       w_ij[k] = w_ij[k - 1] - (0.5 * dz) * (u_x_plus_v_y[k] + u_x_plus_v_y[k - 1]);
     }
+
+    result.set_column(i, j, &w_ij[0]);
   }
 }
 
@@ -505,8 +510,6 @@ static inline double D2(double u_x, double u_y, double u_z, double v_x, double v
   @return 0 on success
  */
 void StressBalance::compute_volumetric_strain_heating(const Inputs &inputs) {
-  PetscErrorCode ierr;
-
   const rheology::FlowLaw &flow_law = *m_shallow_stress_balance->flow_law();
   EnthalpyConverter::Ptr EC = m_shallow_stress_balance->enthalpy_converter();
 
@@ -529,115 +532,118 @@ void StressBalance::compute_volumetric_strain_heating(const Inputs &inputs) {
 
   const std::vector<double> &z = m_grid->z();
   const unsigned int Mz = m_grid->Mz();
-  std::vector<double> depth(Mz), pressure(Mz), hardness(Mz);
 
   ParallelSection loop(m_grid->com);
-  try {
-    for (Points p(*m_grid); p; p.next()) {
-      const int i = p.i(), j = p.j();
-
-      double H = thickness(i, j);
-      int ks = m_grid->kBelowHeight(H);
-      const double
-        *u_ij, *u_w, *u_n, *u_e, *u_s,
-        *v_ij, *v_w, *v_n, *v_e, *v_s;
-      double *Sigma;
-      const double *E_ij;
-
-      double west = 1, east = 1, south = 1, north = 1,
-        D_x = 0,                // 1/(dx), 1/(2dx), or 0
-        D_y = 0;                // 1/(dy), 1/(2dy), or 0
-
-      // x-derivative
-      {
-        if ((mask.icy(i,j) and mask.ice_free(i+1,j)) or (mask.ice_free(i,j) and mask.icy(i+1,j))) {
-          east = 0;
-        }
-        if ((mask.icy(i,j) and mask.ice_free(i-1,j)) or (mask.ice_free(i,j) and mask.icy(i-1,j))) {
-          west = 0;
-        }
+#pragma omp parallel
+  {
+    try {
+      // per-thread work space (m_strain_heating may be stored in single precision, so we
+      // use set_column(); allocated here so that exceptions are caught)
+      std::vector<double> depth(Mz), pressure(Mz), hardness(Mz), Sigma(Mz, 0.0);
 
-        if (east + west > 0) {
-          D_x = 1.0 / (m_grid->dx() * (east + west));
-        } else {
-          D_x = 0.0;
-        }
-      }
+      for (Points p(*m_grid, thread_index(), thread_count()); p; p.next()) {
+        const int i = p.i(), j = p.j();
 
-      // y-derivative
-      {
-        if ((mask.icy(i,j) and mask.ice_free(i,j+1)) or (mask.ice_free(i,j) and mask.icy(i,j+1))) {
-          north = 0;
-        }
-        if ((mask.icy(i,j) and mask.ice_free(i,j-1)) or (mask.ice_free(i,j) and mask.icy(i,j-1))) {
-          south = 0;
+        double H = thickness(i, j);
+        int ks = m_grid->kBelowHeight(H);
+        const double
+          *u_ij, *u_w, *u_n, *u_e, *u_s,
+          *v_ij, *v_w, *v_n, *v_e, *v_s;
+        const double *E_ij;
+
+        double west = 1, east = 1, south = 1, north = 1,
+          D_x = 0,                // 1/(dx), 1/(2dx), or 0
+          D_y = 0;                // 1/(dy), 1/(2dy), or 0
+
+        // x-derivative
+        {
+          if ((mask.icy(i,j) and mask.ice_free(i+1,j)) or (mask.ice_free(i,j) and mask.icy(i+1,j))) {
+            east = 0;
+          }
+          if ((mask.icy(i,j) and mask.ice_free(i-1,j)) or (mask.ice_free(i,j) and mask.icy(i-1,j))) {
+            west = 0;
+          }
+
+          if (east + west > 0) {
+            D_x = 1.0 / (m_grid->dx() * (east + west));
+          } else {
+            D_x = 0.0;
+          }
         }
 
-        if (north + south > 0) {
-          D_y = 1.0 / (m_grid->dy() * (north + south));
-        } else {
-          D_y = 0.0;
+        // y-derivative
+        {
+          if ((mask.icy(i,j) and mask.ice_free(i,j+1)) or (mask.ice_free(i,j) and mask.icy(i,j+1))) {
+            north = 0;
+          }
+          if ((mask.icy(i,j) and mask.ice_free(i,j-1)) or (mask.ice_free(i,j) and mask.icy(i,j-1))) {
+            south = 0;
+          }
+
+          if (north + south > 0) {
+            D_y = 1.0 / (m_grid->dy() * (north + south));
+          } else {
+            D_y = 0.0;
+          }
         }
-      }
-
-      u_ij = u.get_column(i,     j);
-      u_w  = u.get_column(i - 1, j);
-      u_e  = u.get_column(i + 1, j);
-      u_s  = u.get_column(i,     j - 1);
-      u_n  = u.get_column(i,     j + 1);
-
-      v_ij = v.get_column(i,     j);
-      v_w  = v.get_column(i - 1, j);
-      v_e  = v.get_column(i + 1, j);
-      v_s  = v.get_column(i,     j - 1);
-      v_n  = v.get_column(i,     j + 1);
-
-      E_ij = enthalpy->get_column(i, j);
-      Sigma = m_strain_heating.get_column(i, j);
 
-      for (int k = 0; k <= ks; ++k) {
-        depth[k] = H - z[k];
-      }
-
-      // pressure added by the ice (i.e. pressure difference between the
-      // current level and the top of the column)
-      EC->pressure(depth, ks, pressure); // FIXME issue #15
-
-      flow_law.hardness_n(E_ij, &pressure[0], ks + 1, &hardness[0]);
+        u_ij = u.get_column(i,     j);
+        u_w  = u.get_column(i - 1, j);
+        u_e  = u.get_column(i + 1, j);
+        u_s  = u.get_column(i,     j - 1);
+        u_n  = u.get_column(i,     j + 1);
 
-      for (int k = 0; k <= ks; ++k) {
-        double dz;
+        v_ij = v.get_column(i,     j);
+        v_w  = v.get_column(i - 1, j);
+        v_e  = v.get_column(i + 1, j);
+        v_s  = v.get_column(i,     j - 1);
+        v_n  = v.get_column(i,     j + 1);
 
-        double u_z = 0.0, v_z = 0.0,
-          u_x = D_x * (west  * (u_ij[k] - u_w[k]) + east  * (u_e[k] - u_ij[k])),
-          u_y = D_y * (south * (u_ij[k] - u_s[k]) + north * (u_n[k] - u_ij[k])),
-          v_x = D_x * (west  * (v_ij[k] - v_w[k]) + east  * (v_e[k] - v_ij[k])),
-          v_y = D_y * (south * (v_ij[k] - v_s[k]) + north * (v_n[k] - v_ij[k]));
+        E_ij = enthalpy->get_column(i, j);
 
-        if (k > 0) {
-          dz = z[k+1] - z[k-1];
-          u_z = (u_ij[k+1] - u_ij[k-1]) / dz;
-          v_z = (v_ij[k+1] - v_ij[k-1]) / dz;
-        } else {
-          // use one-sided differences for u_z and v_z on the bottom level
-          dz = z[1] - z[0];
-          u_z = (u_ij[1] - u_ij[0]) / dz;
-          v_z = (v_ij[1] - v_ij[0]) / dz;
+        for (int k = 0; k <= ks; ++k) {
+          depth[k] = H - z[k];
         }
 
-        Sigma[k] = 2.0 * e_to_a_power * hardness[k] * pow(D2(u_x, u_y, u_z, v_x, v_y, v_z), exponent);
-      } // k-loop
+        // pressure added by the ice (i.e. pressure difference between the
+        // current level and the top of the column)
+        EC->pressure(depth, ks, pressure); // FIXME issue #15
+
+        flow_law.hardness_n(E_ij, &pressure[0], ks + 1, &hardness[0]);
+
+        for (int k = 0; k <= ks; ++k) {
+          double dz;
+
+          double u_z = 0.0, v_z = 0.0,
+            u_x = D_x * (west  * (u_ij[k] - u_w[k]) + east  * (u_e[k] - u_ij[k])),
+            u_y = D_y * (south * (u_ij[k] - u_s[k]) + north * (u_n[k] - u_ij[k])),
+            v_x = D_x * (west  * (v_ij[k] - v_w[k]) + east  * (v_e[k] - v_ij[k])),
+            v_y = D_y * (south * (v_ij[k] - v_s[k]) + north * (v_n[k] - v_ij[k]));
+
+          if (k > 0) {
+            dz = z[k+1] - z[k-1];
+            u_z = (u_ij[k+1] - u_ij[k-1]) / dz;
+            v_z = (v_ij[k+1] - v_ij[k-1]) / dz;
+          } else {
+            // use one-sided differences for u_z and v_z on the bottom level
+            dz = z[1] - z[0];
+            u_z = (u_ij[1] - u_ij[0]) / dz;
+            v_z = (v_ij[1] - v_ij[0]) / dz;
+          }
+
+          Sigma[k] = 2.0 * e_to_a_power * hardness[k] * pow(D2(u_x, u_y, u_z, v_x, v_y, v_z), exponent);
+        } // k-loop
+
+        for (unsigned int k = ks + 1; k < Mz; ++k) {
+          Sigma[k] = 0.0;
+        }
 
-      int remaining_levels = Mz - (ks + 1);
-      if (remaining_levels > 0) {
-        ierr = PetscMemzero(&Sigma[ks+1],
-                            remaining_levels*sizeof(double));
-        PISM_CHK(ierr, "PetscMemzero");
+        m_strain_heating.set_column(i, j, &Sigma[0]);
       }
+    } catch (...) {
+      loop.failed();
     }
-  } catch (...) {
-    loop.failed();
-  }
+  } // end of the parallel region
   loop.check();
 }
 
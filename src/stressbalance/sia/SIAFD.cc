@@ -18,6 +18,7 @@
 
 #include <cstdlib>
 #include <cassert>
+#include <algorithm>            // std::copy, std::max
 
 #include "SIAFD.hh"
 #include "BedSmoother.hh"
@@ -47,10 +48,10 @@ SIAFD::SIAFD(IceGrid::ConstPtr g)
     m_h_x(m_grid, "h_x", WITH_GHOSTS),
     m_h_y(m_grid, "h_y", WITH_GHOSTS),
     m_D(m_grid, "diffusivity", WITH_GHOSTS),
-    m_delta_0(m_grid, "delta_0", WITH_GHOSTS),
-    m_delta_1(m_grid, "delta_1", WITH_GHOSTS),
-    m_work_3d_0(m_grid, "work_3d_0", WITH_GHOSTS),
-    m_work_3d_1(m_grid, "work_3d_1", WITH_GHOSTS)
+    m_delta_0(*m_grid, 1),
+    m_delta_1(*m_grid, 1),
+    m_work_3d_0(*m_grid, 1),
+    m_work_3d_1(*m_grid, 1)
 {
   // bed smoother
   m_bed_smoother = new BedSmoother(m_grid, m_stencil_width);
@@ -500,6 +501,33 @@ void SIAFD::surface_gradient_haseloff(const IceModelVec2S &ice_surface_elevation
 }
 
 
+//! Allocate storage for delta on the staggered grid (in the direction `o`): only levels in
+//! the ice are stored.
+/*!
+ * Uses the same thickness (and so the same number of levels) as compute_diffusivity().
+ */
+static void allocate_delta(const IceModelVec2S &thk_smooth, int o, RaggedColumns &delta) {
+  IceGrid::ConstPtr grid = thk_smooth.grid();
+
+  const int oi = 1 - o, oj = o;
+
+  ParallelSection loop(grid->com);
+  try {
+    for (PointsWithGhosts p(*grid, 1); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      const double thk = 0.5 * (thk_smooth(i, j) + thk_smooth(i + oi, j + oj));
+
+      delta.set_size(i, j, grid->kBelowHeight(thk) + 1);
+    }
+  } catch (...) {
+    loop.failed();
+  }
+  loop.check();
+
+  delta.pack();
+}
+
 //! \brief Compute the SIA diffusivity. If full_update, also store delta on the staggered grid.
 /*!
  * Recall that \f$ Q = -D \nabla h \f$ is the diffusive flux in the mass-continuity equation
@@ -556,7 +584,7 @@ void SIAFD::compute_diffusivity(bool full_update,
     &H = geometry.ice_thickness;
 
   const IceModelVec2CellType &mask = geometry.cell_type;
-  IceModelVec3* delta[] = {&m_delta_0, &m_delta_1};
+  RaggedColumns* delta[] = {&m_delta_0, &m_delta_1};
 
   result.set(0.0);
 
@@ -572,8 +600,6 @@ void SIAFD::compute_diffusivity(bool full_update,
     limit_diffusivity            = m_config->get_flag("stress_balance.sia.limit_diffusivity"),
     use_age                      = compute_grain_size_using_age or e_age_coupling;
 
-  rheology::grain_size_vostok gs_vostok;
-
   // get "theta" from Schoof (2003) bed smoothness calculation and the
   // thickness relative to the smoothed bed; each IceModelVec2S involved must
   // have stencil width WIDE_GHOSTS for this too work
@@ -588,12 +614,6 @@ void SIAFD::compute_diffusivity(bool full_update,
     list.add(*age);
   }
 
-  if (full_update) {
-    list.add({delta[0], delta[1]});
-    assert(m_delta_0.stencil_width()  >= 1);
-    assert(m_delta_1.stencil_width()  >= 1);
-  }
-
   assert(theta.stencil_width()      >= 2);
   assert(thk_smooth.stencil_width() >= 2);
   assert(result.stencil_width()     >= 1);
@@ -607,141 +627,150 @@ void SIAFD::compute_diffusivity(bool full_update,
     My = m_grid->My(),
     Mz = m_grid->Mz();
 
-  std::vector<double> depth(Mz), stress(Mz), pressure(Mz), E(Mz), flow(Mz);
-  std::vector<double> delta_ij(Mz);
-  std::vector<double> A(Mz), ice_grain_size(Mz, m_config->get_number("constants.ice.grain_size", "m"));
-  std::vector<double> e_factor(Mz, enhancement_factor);
+  const double grain_size = m_config->get_number("constants.ice.grain_size", "m");
 
   double D_max = 0.0;
   int high_diffusivity_counter = 0;
   for (int o=0; o<2; o++) {
-    ParallelSection loop(m_grid->com);
-    try {
-      for (PointsWithGhosts p(*m_grid); p; p.next()) {
-        const int i = p.i(), j = p.j();
+    if (full_update) {
+      allocate_delta(thk_smooth, o, *delta[o]);
+    }
 
-        // staggered point: o=0 is i+1/2, o=1 is j+1/2, (i, j) and (i+oi, j+oj)
-        //   are regular grid neighbors of a staggered point:
-        const int oi = 1 - o, oj = o;
+    ParallelSection loop(m_grid->com);
+#pragma omp parallel reduction(max:D_max) reduction(+:high_diffusivity_counter)
+    {
+      try {
+        // per-thread work space (allocated here so that exceptions are caught)
+        std::vector<double> depth(Mz), stress(Mz), pressure(Mz), E(Mz), flow(Mz);
+        std::vector<double> delta_ij(Mz);
+        std::vector<double> A(Mz), ice_grain_size(Mz, grain_size);
+        std::vector<double> e_factor(Mz, enhancement_factor);
 
-        const double
-          thk = 0.5 * (thk_smooth(i, j) + thk_smooth(i+oi, j+oj));
+        rheology::grain_size_vostok gs_vostok;
 
-        // zero thickness case:
-        if (thk == 0.0) {
-          result(i, j, o) = 0.0;
-          if (full_update) {
-            delta[o]->set_column(i, j, 0.0);
-          }
-          continue;
-        }
+        for (PointsWithGhosts p(*m_grid, 1, thread_index(), thread_count()); p; p.next()) {
+          const int i = p.i(), j = p.j();
 
-        const int ks = m_grid->kBelowHeight(thk);
+          // staggered point: o=0 is i+1/2, o=1 is j+1/2, (i, j) and (i+oi, j+oj)
+          //   are regular grid neighbors of a staggered point:
+          const int oi = 1 - o, oj = o;
 
-        for (int k = 0; k <= ks; ++k) {
-          depth[k] = thk - z[k];
-        }
+          const double
+            thk = 0.5 * (thk_smooth(i, j) + thk_smooth(i+oi, j+oj));
 
-        // pressure added by the ice (i.e. pressure difference between the
-        // current level and the top of the column)
-        m_EC->pressure(depth, ks, pressure); // FIXME issue #15
+          // zero thickness case:
+          if (thk == 0.0) {
+            result(i, j, o) = 0.0;
+            if (full_update) {
+              delta[o]->column(i, j)[0] = 0.0;
+            }
+            continue;
+          }
 
-        if (use_age) {
-          const double
-            *age_ij     = age->get_column(i, j),
-            *age_offset = age->get_column(i+oi, j+oj);
+          const int ks = m_grid->kBelowHeight(thk);
 
           for (int k = 0; k <= ks; ++k) {
-            A[k] = 0.5 * (age_ij[k] + age_offset[k]);
+            depth[k] = thk - z[k];
           }
 
-          if (compute_grain_size_using_age) {
+          // pressure added by the ice (i.e. pressure difference between the
+          // current level and the top of the column)
+          m_EC->pressure(depth, ks, pressure); // FIXME issue #15
+
+          if (use_age) {
+            const double
+              *age_ij     = age->get_column(i, j),
+              *age_offset = age->get_column(i+oi, j+oj);
+
             for (int k = 0; k <= ks; ++k) {
-              // convert age from seconds to years:
-              ice_grain_size[k] = gs_vostok(A[k] * m_seconds_per_year);
+              A[k] = 0.5 * (age_ij[k] + age_offset[k]);
+            }
+
+            if (compute_grain_size_using_age) {
+              for (int k = 0; k <= ks; ++k) {
+                // convert age from seconds to years:
+                ice_grain_size[k] = gs_vostok(A[k] * m_seconds_per_year);
+              }
+            }
+
+            if (e_age_coupling) {
+              for (int k = 0; k <= ks; ++k) {
+                const double accumulation_time = current_time - A[k];
+                if (interglacial(accumulation_time)) {
+                  e_factor[k] = enhancement_factor_interglacial;
+                } else {
+                  e_factor[k] = enhancement_factor;
+                }
+              }
             }
           }
 
-          if (e_age_coupling) {
+          {
+            const double
+              *E_ij     = enthalpy->get_column(i, j),
+              *E_offset = enthalpy->get_column(i+oi, j+oj);
             for (int k = 0; k <= ks; ++k) {
-              const double accumulation_time = current_time - A[k];
-              if (interglacial(accumulation_time)) {
-                e_factor[k] = enhancement_factor_interglacial;
-              } else {
-                e_factor[k] = enhancement_factor;
-              }
+              E[k] = 0.5 * (E_ij[k] + E_offset[k]);
             }
           }
-        }
 
-        {
-          const double
-            *E_ij     = enthalpy->get_column(i, j),
-            *E_offset = enthalpy->get_column(i+oi, j+oj);
+          const double alpha = sqrt(PetscSqr(h_x(i, j, o)) + PetscSqr(h_y(i, j, o)));
           for (int k = 0; k <= ks; ++k) {
-            E[k] = 0.5 * (E_ij[k] + E_offset[k]);
+            stress[k] = alpha * pressure[k];
           }
-        }
-
-        const double alpha = sqrt(PetscSqr(h_x(i, j, o)) + PetscSqr(h_y(i, j, o)));
-        for (int k = 0; k <= ks; ++k) {
-          stress[k] = alpha * pressure[k];
-        }
 
-        m_flow_law->flow_n(&stress[0], &E[0], &pressure[0], &ice_grain_size[0], ks + 1,
-                           &flow[0]);
+          m_flow_law->flow_n(&stress[0], &E[0], &pressure[0], &ice_grain_size[0], ks + 1,
+                             &flow[0]);
 
-        const double theta_local = 0.5 * (theta(i, j) + theta(i+oi, j+oj));
-        for (int k = 0; k <= ks; ++k) {
-          delta_ij[k] = e_factor[k] * theta_local * 2.0 * pressure[k] * flow[k];
-        }
+          const double theta_local = 0.5 * (theta(i, j) + theta(i+oi, j+oj));
+          for (int k = 0; k <= ks; ++k) {
+            delta_ij[k] = e_factor[k] * theta_local * 2.0 * pressure[k] * flow[k];
+          }
 
-        double D = 0.0;  // diffusivity for deformational SIA flow
-        {
-          for (int k = 1; k <= ks; ++k) {
-            // trapezoidal rule
-            const double dz = z[k] - z[k-1];
-            D += 0.5 * dz * ((depth[k] + dz) * delta_ij[k-1] + depth[k] * delta_ij[k]);
+          double D = 0.0;  // diffusivity for deformational SIA flow
+          {
+            for (int k = 1; k <= ks; ++k) {
+              // trapezoidal rule
+              const double dz = z[k] - z[k-1];
+              D += 0.5 * dz * ((depth[k] + dz) * delta_ij[k-1] + depth[k] * delta_ij[k]);
+            }
+            // finish off D with (1/2) dz (0 + (H-z[ks])*delta_ij[ks]), but dz=H-z[ks]:
+            const double dz = thk - z[ks];
+            D += 0.5 * dz * dz * delta_ij[ks];
           }
-          // finish off D with (1/2) dz (0 + (H-z[ks])*delta_ij[ks]), but dz=H-z[ks]:
-          const double dz = thk - z[ks];
-          D += 0.5 * dz * dz * delta_ij[ks];
-        }
 
-        // Override diffusivity at the edges of the domain. (At these
-        // locations PISM uses ghost cells *beyond* the boundary of
-        // the computational domain. This does not matter if the ice
-        // does not extend all the way to the domain boundary, as in
-        // whole-ice-sheet simulations. In a regional setup, though,
-        // this adjustment lets us avoid taking very small time-steps
-        // because of the possible thickness and bed elevation
-        // "discontinuities" at the boundary.)
-        if (i < 0 || i >= (int)Mx - 1 ||
-            j < 0 || j >= (int)My - 1) {
-          D = 0.0;
-        }
+          // Override diffusivity at the edges of the domain. (At these
+          // locations PISM uses ghost cells *beyond* the boundary of
+          // the computational domain. This does not matter if the ice
+          // does not extend all the way to the domain boundary, as in
+          // whole-ice-sheet simulations. In a regional setup, though,
+          // this adjustment lets us avoid taking very small time-steps
+          // because of the possible thickness and bed elevation
+          // "discontinuities" at the boundary.)
+          if (i < 0 || i >= (int)Mx - 1 ||
+              j < 0 || j >= (int)My - 1) {
+            D = 0.0;
+          }
 
-        if (limit_diffusivity and D >= D_limit) {
-          D = D_limit;
-          high_diffusivity_counter += 1;
-        }
+          if (limit_diffusivity and D >= D_limit) {
+            D = D_limit;
+            high_diffusivity_counter += 1;
+          }
 
-        D_max = std::max(D_max, D);
+          D_max = std::max(D_max, D);
 
-        result(i, j, o) = D;
+          result(i, j, o) = D;
 
-        // if doing the full update, fill the delta column above the ice and
-        // store it:
-        if (full_update) {
-          for (unsigned int k = ks + 1; k < Mz; ++k) {
-            delta_ij[k] = 0.0;
+          // if doing the full update, store the delta column (levels in the ice only, see
+          // allocate_delta())
+          if (full_update) {
+            std::copy(delta_ij.begin(), delta_ij.begin() + ks + 1, delta[o]->column(i, j));
           }
-          delta[o]->set_column(i, j, &delta_ij[0]);
-        }
-      } // i, j-loop
-    } catch (...) {
-      loop.failed();
-    }
+        } // i, j-loop
+      } catch (...) {
+        loop.failed();
+      }
+    } // end of the parallel region
     loop.check();
   } // o-loop
 
@@ -803,28 +832,14 @@ void SIAFD::compute_diffusive_flux(const IceModelVec2Stag &h_x, const IceModelVe
  *
  * The result is stored in work_3d[0,1] and is used to compute the SIA component
  * of the 3D-distributed horizontal ice velocity.
+ *
+ * I is constant above the ice, so it is stored at the same levels as delta (i.e. levels
+ * in the ice, see compute_diffusivity()).
  */
-void SIAFD::compute_I(const Geometry &geometry) {
-
-  IceModelVec2S &thk_smooth = m_work_2d_0;
-  IceModelVec3* I[] = {&m_work_3d_0, &m_work_3d_1};
-  IceModelVec3* delta[] = {&m_delta_0, &m_delta_1};
-
-  const IceModelVec2S
-    &h = geometry.ice_surface_elevation,
-    &H = geometry.ice_thickness;
-
-  const IceModelVec2CellType &mask = geometry.cell_type;
-
-  m_bed_smoother->smoothed_thk(h, H, mask, thk_smooth);
+void SIAFD::compute_I() {
 
-  IceModelVec::AccessList list{delta[0], delta[1], I[0], I[1], &thk_smooth};
-
-  assert(I[0]->stencil_width()     >= 1);
-  assert(I[1]->stencil_width()     >= 1);
-  assert(delta[0]->stencil_width() >= 1);
-  assert(delta[1]->stencil_width() >= 1);
-  assert(thk_smooth.stencil_width() >= 2);
+  RaggedColumns* I[] = {&m_work_3d_0, &m_work_3d_1};
+  const RaggedColumns* delta[] = {&m_delta_0, &m_delta_1};
 
   const unsigned int Mz = m_grid->Mz();
 
@@ -834,38 +849,30 @@ void SIAFD::compute_I(const Geometry &geometry) {
   }
 
   for (int o = 0; o < 2; ++o) {
-    ParallelSection loop(m_grid->com);
-    try {
-      for (PointsWithGhosts p(*m_grid); p; p.next()) {
-        const int i = p.i(), j = p.j();
+    for (PointsWithGhosts p(*m_grid, 1); p; p.next()) {
+      const int i = p.i(), j = p.j();
 
-        const int oi = 1 - o, oj = o;
-        const double
-          thk = 0.5 * (thk_smooth(i, j) + thk_smooth(i + oi, j + oj));
+      I[o]->set_size(i, j, delta[o]->size(i, j));
+    }
+    I[o]->pack();
 
-        const double *delta_ij = delta[o]->get_column(i, j);
-        double       *I_ij     = I[o]->get_column(i, j);
+    for (PointsWithGhosts p(*m_grid, 1); p; p.next()) {
+      const int i = p.i(), j = p.j();
 
-        const unsigned int ks = m_grid->kBelowHeight(thk);
+      const double *delta_ij = delta[o]->column(i, j);
+      double       *I_ij     = I[o]->column(i, j);
 
-        // within the ice:
-        I_ij[0] = 0.0;
-        double I_current = 0.0;
-        for (unsigned int k = 1; k <= ks; ++k) {
-          // trapezoidal rule
-          I_current += 0.5 * dz[k] * (delta_ij[k - 1] + delta_ij[k]);
-          I_ij[k] = I_current;
-        }
+      // number of levels in the ice
+      const unsigned int N = delta[o]->size(i, j);
 
-        // above the ice:
-        for (unsigned int k = ks + 1; k < Mz; ++k) {
-          I_ij[k] = I_current;
-        }
+      I_ij[0] = 0.0;
+      double I_current = 0.0;
+      for (unsigned int k = 1; k < N; ++k) {
+        // trapezoidal rule
+        I_current += 0.5 * dz[k] * (delta_ij[k - 1] + delta_ij[k]);
+        I_ij[k] = I_current;
       }
-    } catch (...) {
-      loop.failed();
     }
-    loop.check();
   } // o-loop
 }
 
@@ -893,22 +900,33 @@ void SIAFD::compute_3d_horizontal_velocity(const Geometry &geometry,
                                            const IceModelVec2V &sliding_velocity,
                                            IceModelVec3 &u_out, IceModelVec3 &v_out) {
 
-  compute_I(geometry);
+  // delta (computed by compute_diffusivity()) and so I do not depend on the geometry
+  (void) geometry;
+
+  compute_I();
   // after the compute_I() call work_3d[0,1] contains I on the staggered grid
-  IceModelVec3* I[] = {&m_work_3d_0, &m_work_3d_1};
+  const RaggedColumns* I[] = {&m_work_3d_0, &m_work_3d_1};
 
-  IceModelVec::AccessList list{&u_out, &v_out, &h_x, &h_y, &sliding_velocity, I[0], I[1]};
+  IceModelVec::AccessList list{&u_out, &v_out, &h_x, &h_y, &sliding_velocity};
 
   const unsigned int Mz = m_grid->Mz();
 
+  // u_out and v_out may be stored in single precision, so we use set_column()
+  std::vector<double> u_ij(Mz), v_ij(Mz);
+  std::vector<double> I_e(Mz), I_w(Mz), I_n(Mz), I_s(Mz);
+
   for (Points p(*m_grid); p; p.next()) {
     const int i = p.i(), j = p.j();
 
-    const double
-      *I_e = I[0]->get_column(i, j),
-      *I_w = I[0]->get_column(i - 1, j),
-      *I_n = I[1]->get_column(i, j),
-      *I_s = I[1]->get_column(i, j - 1);
+    // I (and so the velocity) is constant above the top level stored in any of the four
+    // neighboring columns
+    const unsigned int N = std::max(std::max(I[0]->size(i, j), I[0]->size(i - 1, j)),
+                                    std::max(I[1]->size(i, j), I[1]->size(i, j - 1)));
+
+    I[0]->get_column(i,     j,     N, &I_e[0]);
+    I[0]->get_column(i - 1, j,     N, &I_w[0]);
+    I[1]->get_column(i,     j,     N, &I_n[0]);
+    I[1]->get_column(i,     j - 1, N, &I_s[0]);
 
     // Fetch values from 2D fields *outside* of the k-loop:
     const double
@@ -927,19 +945,22 @@ void SIAFD::compute_3d_horizontal_velocity(const Geometry &geometry,
       sliding_velocity_u = sliding_velocity(i, j).u,
       sliding_velocity_v = sliding_velocity(i, j).v;
 
-    double
-      *u_ij = u_out.get_column(i, j),
-      *v_ij = v_out.get_column(i, j);
-
     // split into two loops to encourage auto-vectorization
-    for (unsigned int k = 0; k < Mz; ++k) {
+    for (unsigned int k = 0; k < N; ++k) {
       u_ij[k] = sliding_velocity_u - 0.25 * (I_e[k] * h_x_e + I_w[k] * h_x_w +
                                              I_n[k] * h_x_n + I_s[k] * h_x_s);
     }
-    for (unsigned int k = 0; k < Mz; ++k) {
+    for (unsigned int k = 0; k < N; ++k) {
       v_ij[k] = sliding_velocity_v - 0.25 * (I_e[k] * h_y_e + I_w[k] * h_y_w +
                                              I_n[k] * h_y_n + I_s[k] * h_y_s);
     }
+    for (unsigned int k = N; k < Mz; ++k) {
+      u_ij[k] = u_ij[N - 1];
+      v_ij[k] = v_ij[N - 1];
+    }
+
+    u_out.set_column(i, j, &u_ij[0]);
+    v_out.set_column(i, j, &v_ij[0]);
   }
 
   // Communicate to get ghosts:
@@ -20,6 +20,7 @@
 #define _SIAFD_H_
 
 #include "pism/stressbalance/SSB_Modifier.hh"      // derives from SSB_Modifier
+#include "pism/util/RaggedColumns.hh"
 
 namespace pism {
 
@@ -99,7 +100,7 @@ protected:
                                               const IceModelVec2V &vel_input,
                                               IceModelVec3 &u_out, IceModelVec3 &v_out);
 
-  virtual void compute_I(const Geometry &geometry);
+  virtual void compute_I();
 
   bool interglacial(double accumulation_time);
 
@@ -110,12 +111,12 @@ protected:
   IceModelVec2S m_work_2d_1;
   //! temporary storage for the surface gradient and the diffusivity
   IceModelVec2Stag m_h_x, m_h_y, m_D;
-  //! temporary storage for delta on the staggered grid
-  IceModelVec3 m_delta_0;
-  IceModelVec3 m_delta_1;
-  //! temporary storage used to store I and strain_heating on the staggered grid
-  IceModelVec3 m_work_3d_0;
-  IceModelVec3 m_work_3d_1;
+  //! temporary storage for delta on the staggered grid (levels in the ice only)
+  RaggedColumns m_delta_0;
+  RaggedColumns m_delta_1;
+  //! temporary storage used to store I on the staggered grid (levels in the ice only)
+  RaggedColumns m_work_3d_0;
+  RaggedColumns m_work_3d_1;
 
   BedSmoother *m_bed_smoother;
 
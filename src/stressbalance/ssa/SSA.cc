@@ -26,6 +26,7 @@
 #include "pism/util/io/File.hh"
 #include "pism/util/pism_options.hh"
 #include "pism/util/pism_utilities.hh"
+#include "pism/util/Time.hh"
 #include "pism/util/IceModelVec2CellType.hh"
 #include "pism/stressbalance/StressBalance.hh"
 #include "pism/geometry/Geometry.hh"
@@ -112,6 +113,15 @@ SSA::SSA(IceGrid::ConstPtr g)
 
   m_da = m_velocity_global.dm();
 
+  m_extrapolate_initial_guess = m_config->get_flag("stress_balance.ssa.extrapolate_initial_guess");
+  m_n_solutions   = 0;
+  m_time_last     = 0.0;
+  m_time_previous = 0.0;
+  if (m_extrapolate_initial_guess) {
+    m_velocity_last.create(m_grid, "velocity_last", WITH_GHOSTS);
+    m_velocity_previous.create(m_grid, "velocity_previous", WITH_GHOSTS);
+  }
+
   {
     rheology::FlowLawFactory ice_factory("stress_balance.ssa.", m_config, m_EC);
     ice_factory.remove(ICE_GOLDSBY_KOHLSTEDT);
@@ -175,7 +185,18 @@ void SSA::update(const Inputs &inputs, bool full_update) {
   }
 
   if (full_update) {
+    const double t = m_grid->ctx()->time()->current();
+
+    if (m_extrapolate_initial_guess) {
+      extrapolate_initial_guess(t);
+    }
+
     solve(inputs);
+
+    if (m_extrapolate_initial_guess) {
+      record_solution(t);
+    }
+
     compute_basal_frictional_heating(m_velocity,
                                      *inputs.basal_yield_stress,
                                      m_mask,
@@ -183,6 +204,53 @@ void SSA::update(const Inputs &inputs, bool full_update) {
   }
 }
 
+//! \brief Set the initial guess (`m_velocity`) using linear extrapolation in time from
+//! the last two solutions.
+/*!
+ * Velocity usually evolves smoothly in transient runs, so this initial guess is closer to
+ * the solution than the last solution used otherwise. This reduces the number of nonlinear
+ * iterations. (In SSAFD the effective viscosity is computed from the initial guess, so it
+ * is extrapolated as well.)
+ *
+ * To stay on the safe side we do not extrapolate further than the length of the last
+ * interval between solutions.
+ *
+ * Does nothing if fewer than two solutions are available (e.g. right after
+ * initialization).
+ */
+void SSA::extrapolate_initial_guess(double t) {
+  if (m_n_solutions < 2 or not (t > m_time_last)) {
+    return;
+  }
+
+  const double lambda = std::min((t - m_time_last) / (m_time_last - m_time_previous), 1.0);
+
+  // m_velocity = m_velocity_last + lambda * (m_velocity_last - m_velocity_previous)
+  m_velocity.copy_from(m_velocity_last);
+  m_velocity.scale(1.0 + lambda);
+  m_velocity.add(-lambda, m_velocity_previous);
+}
+
+//! \brief Add the current solution (`m_velocity`) corresponding to the time `t` to the
+//! history used by extrapolate_initial_guess().
+void SSA::record_solution(double t) {
+  if (m_n_solutions > 0 and not (t > m_time_last)) {
+    // replace the last solution (the same time, e.g. during initialization)
+    m_velocity_last.copy_from(m_velocity);
+    return;
+  }
+
+  if (m_n_solutions > 0) {
+    m_velocity_previous.copy_from(m_velocity_last);
+    m_time_previous = m_time_last;
+  }
+
+  m_velocity_last.copy_from(m_velocity);
+  m_time_last = t;
+
+  m_n_solutions = std::min(m_n_solutions + 1, 2U);
+}
+
 /*!
  * Compute the weight used to determine if the difference between locations `i,j` and `n`
  * (neighbor) should be used in the computation of the surface gradient in
@@ -355,6 +423,45 @@ const IceModelVec2V& SSA::driving_stress() const {
   return m_taud;
 }
 
+//! \brief Set the near null space of an SSA matrix `A` (used by algebraic multigrid).
+/*!
+ * Uses rigid body modes (two translations and one rotation) in the horizontal plane. Does
+ * nothing if `A` already has a near null space.
+ */
+void SSA::set_near_null_space(Mat A) {
+  PetscErrorCode ierr;
+
+  MatNullSpace null_space = NULL;
+  ierr = MatGetNearNullSpace(A, &null_space);
+  PISM_CHK(ierr, "MatGetNearNullSpace");
+
+  if (null_space != NULL) {
+    return;
+  }
+
+  // coordinates of grid points (a Vec with the block size of 2)
+  IceModelVec2V coordinates(m_grid, "coordinates", WITHOUT_GHOSTS);
+  {
+    IceModelVec::AccessList list{&coordinates};
+
+    for (Points p(*m_grid); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      coordinates(i, j) = Vector2(m_grid->x(i), m_grid->y(j));
+    }
+  }
+
+  ierr = MatNullSpaceCreateRigidBody(coordinates.vec(), &null_space);
+  PISM_CHK(ierr, "MatNullSpaceCreateRigidBody");
+
+  ierr = MatSetNearNullSpace(A, null_space);
+  PISM_CHK(ierr, "MatSetNearNullSpace");
+
+  // A keeps a reference
+  ierr = MatNullSpaceDestroy(&null_space);
+  PISM_CHK(ierr, "MatNullSpaceDestroy");
+}
+
 
 void SSA::define_model_state_impl(const File &output) const {
   m_velocity.define(output);
@@ -137,6 +137,12 @@ protected:
 
   virtual void solve(const Inputs &inputs) = 0;
 
+  void set_near_null_space(Mat A);
+
+  void extrapolate_initial_guess(double t);
+
+  void record_solution(double t);
+
   IceModelVec2CellType m_mask;
   IceModelVec2V m_taud;
 
@@ -146,6 +152,16 @@ protected:
   petsc::DM::Ptr  m_da;               // dof=2 DA
   IceModelVec2V m_velocity_global; // global vector for solution
 
+  // solution history used to extrapolate the initial guess (see extrapolate_initial_guess())
+  //! true if the history is kept
+  bool m_extrapolate_initial_guess;
+  //! number of solutions in the history (0, 1, or 2)
+  unsigned int m_n_solutions;
+  //! the last solution and the one before it
+  IceModelVec2V m_velocity_last, m_velocity_previous;
+  //! times corresponding to m_velocity_last and m_velocity_previous
+  double m_time_last, m_time_previous;
+
   // profiling
   int m_event_ssa;
 };
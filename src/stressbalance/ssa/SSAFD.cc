@@ -16,6 +16,7 @@
 // along with PISM; if not, write to the Free Software
 // Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
@@ -95,6 +96,14 @@ SSAFD::SSAFD(IceGrid::ConstPtr g)
 
   m_scaling = 1.0e9;  // comparable to typical beta for an ice stream;
 
+  m_anderson_depth         = 0;
+  m_anderson_size          = 0;
+  m_anderson_next          = 0;
+  m_anderson_have_previous = false;
+
+  m_anderson_f.create(m_grid, "anderson_residual", WITHOUT_GHOSTS);
+  m_anderson_g.create(m_grid, "anderson_picard_iterate", WITHOUT_GHOSTS);
+
   // The nuH viewer:
   m_view_nuh = false;
   m_nuh_viewer_size = 300;
@@ -108,6 +117,8 @@ SSAFD::SSAFD(IceGrid::ConstPtr g)
     ierr = DMCreateMatrix(*m_da, m_A.rawptr());
     PISM_CHK(ierr, "DMCreateMatrix");
 
+    compute_matrix_positions();
+
     ierr = KSPCreate(m_grid->com, m_KSP.rawptr());
     PISM_CHK(ierr, "KSPCreate");
 
@@ -153,6 +164,44 @@ void SSAFD::pc_setup_bjacobi() {
   PISM_CHK(ierr, "KSPSetFromOptions");
 }
 
+//! @note Uses `PetscErrorCode` *intentionally*.
+void SSAFD::pc_setup_gamg() {
+  PetscErrorCode ierr;
+  PC pc;
+
+  // Set parameters equivalent to
+  // -ksp_type gmres -pc_type gamg -pc_gamg_reuse_interpolation
+
+  ierr = KSPSetType(m_KSP, KSPGMRES);
+  PISM_CHK(ierr, "KSPSetType");
+
+  ierr = KSPSetOperators(m_KSP, m_A, m_A);
+  PISM_CHK(ierr, "KSPSetOperators");
+
+  // Get the PC from the KSP solver:
+  ierr = KSPGetPC(m_KSP, &pc);
+  PISM_CHK(ierr, "KSPGetPC");
+
+  // Set the PC type:
+  ierr = PCSetType(pc, PCGAMG);
+  PISM_CHK(ierr, "PCSetType");
+
+#if PETSC_VERSION_GE(3,7,0)
+  // The matrix changes during Picard iterations, but its sparsity pattern does not.
+  // Re-using interpolation operators saves most of the set up cost.
+  ierr = PCGAMGSetReuseInterpolation(pc, PETSC_TRUE);
+  PISM_CHK(ierr, "PCGAMGSetReuseInterpolation");
+#endif
+
+  // The matrix has the block size of 2 (set by DMCreateMatrix()); use rigid body modes to
+  // build coarse spaces.
+  set_near_null_space(m_A);
+
+  // Process options:
+  ierr = KSPSetFromOptions(m_KSP);
+  PISM_CHK(ierr, "KSPSetFromOptions");
+}
+
 //! @note Uses `PetscErrorCode` *intentionally*.
 void SSAFD::pc_setup_asm() {
   PetscErrorCode ierr;
@@ -482,8 +531,10 @@ It follows immediately that the matrix we assemble in the current method has
 grid values of \f$u\f$ and 8 grid values of \f$v\f$ used in this scheme.  For
 the second equation we also have 13 nonzeros per row.
 
-FIXME:  document use of DAGetMatrix and MatStencil and MatSetValuesStencil
-
+The sparsity pattern of \f$A\f$ is created by DMCreateMatrix() and does not change. If
+`A` is m_A we write all coefficients directly into its storage using positions computed
+once by compute_matrix_positions(). Otherwise we use MatSetValuesStencil(). In both cases
+we set all entries in each row, so there is no need to zero the matrix first.
 */
 void SSAFD::assemble_matrix(const Inputs &inputs,
                             bool include_basal_shear, Mat A) {
@@ -512,8 +563,70 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
   // FIXME: bedrock_boundary is a misleading name
   const bool bedrock_boundary = m_config->get_flag("stress_balance.ssa.dirichlet_bc");
 
-  ierr = MatZeroEntries(A);
-  PISM_CHK(ierr, "MatZeroEntries");
+  // We use DMCreateMatrix() to obtain the SSA matrix, which means that all 18 non-zeros
+  // get allocated, even though we use only 13 (or 14). The remaining 5 (or 4) coefficients
+  // are zeros, but we set them anyway, because this makes the code easier to understand.
+  //
+  // Entry m of a row corresponds to the component m / 9 at the point
+  // (i - 1 + m % 3, j + 1 - (m / 3) % 3).
+  const int n_nonzeros = 18;
+
+  // Write coefficients directly into the storage of A if possible.
+  const bool direct = (A == m_A.get() and not m_A_positions.empty());
+  ::Mat A_diag = A, A_offdiag = NULL;
+  double *values_diag = NULL, *values_offdiag = NULL;
+  if (direct) {
+    PetscBool mpi = PETSC_FALSE;
+    ierr = PetscObjectTypeCompare((PetscObject)A, MATMPIAIJ, &mpi);
+    PISM_CHK(ierr, "PetscObjectTypeCompare");
+
+    if (mpi) {
+      ierr = MatMPIAIJGetSeqAIJ(A, &A_diag, &A_offdiag, NULL);
+      PISM_CHK(ierr, "MatMPIAIJGetSeqAIJ");
+
+      ierr = MatSeqAIJGetArray(A_offdiag, &values_offdiag);
+      PISM_CHK(ierr, "MatSeqAIJGetArray");
+    }
+
+    ierr = MatSeqAIJGetArray(A_diag, &values_diag);
+    PISM_CHK(ierr, "MatSeqAIJGetArray");
+  }
+
+  const int
+    xs = m_grid->xs(),
+    ys = m_grid->ys(),
+    xm = m_grid->xm();
+
+  // Sets all entries in the row of the system corresponding to the component c at (i, j).
+  auto set_row = [&](int i, int j, int c, const double *values) {
+    if (direct) {
+      const PetscInt *position = &m_A_positions[(((j - ys) * xm + (i - xs)) * 2 + c) * n_nonzeros];
+      for (int m = 0; m < n_nonzeros; ++m) {
+        if (position[m] >= 0) {
+          values_diag[position[m]] = values[m];
+        } else {
+          values_offdiag[-position[m] - 1] = values[m];
+        }
+      }
+    } else {
+      MatStencil row, col[n_nonzeros];
+      row.i = i;
+      row.j = j;
+      row.c = c;
+      for (int m = 0; m < n_nonzeros; ++m) {
+        col[m].i = i - 1 + m % 3;
+        col[m].j = j + 1 - (m / 3) % 3;
+        col[m].c = m / 9;
+      }
+      ierr = MatSetValuesStencil(A, 1, &row, n_nonzeros, col, values, INSERT_VALUES);
+      PISM_CHK(ierr, "MatSetValuesStencil");
+    }
+  };
+
+  // rows corresponding to Dirichlet B.C. locations and ice-free cells (scaled identity)
+  double identity_u[n_nonzeros] = {0.0}, identity_v[n_nonzeros] = {0.0};
+  identity_u[4]  = m_scaling;
+  identity_v[13] = m_scaling;
 
   IceModelVec::AccessList list{&m_nuH, &tauc, &vel, &m_mask, &bed, &surface};
 
@@ -544,8 +657,8 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
       // Handle the easy case: provided Dirichlet boundary conditions
       if (inputs.bc_values && inputs.bc_mask && inputs.bc_mask->as_int(i,j) == 1) {
         // set diagonal entry to one (scaled); RHS entry will be known velocity;
-        set_diagonal_matrix_entry(A, i, j, 0, m_scaling);
-        set_diagonal_matrix_entry(A, i, j, 1, m_scaling);
+        set_row(i, j, 0, identity_u);
+        set_row(i, j, 1, identity_v);
         continue;
       }
 
@@ -586,13 +699,6 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
         }
       }
 
-      // We use DAGetMatrix to obtain the SSA matrix, which means that all 18
-      // non-zeros get allocated, even though we use only 13 (or 14). The
-      // remaining 5 (or 4) coefficients are zeros, but we set them anyway,
-      // because this makes the code easier to understand.
-      const int n_nonzeros = 18;
-      MatStencil row, col[n_nonzeros];
-
       // |-----+-----+---+-----+-----|
       // | NW  | NNW | N | NNE | NE  |
       // | WNW |     | | |     | ENE |
@@ -622,8 +728,8 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
         // at both ice/ice-free-ocean and ice/ice-free-bedrock interfaces below
         // to be consistent.
         if (ice_free(M.ij)) {
-          set_diagonal_matrix_entry(A, i, j, 0, m_scaling);
-          set_diagonal_matrix_entry(A, i, j, 1, m_scaling);
+          set_row(i, j, 0, identity_u);
+          set_row(i, j, 1, identity_v);
           continue;
         }
 
@@ -714,36 +820,6 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
         -c_w*W/dx2,  (4*c_n*N+4*c_s*S)/dy2+(c_e*E+c_w*W)/dx2,  -c_e*E/dx2,
         0,  -4*c_s*S/dy2,  0,
       };
-
-      /* i indices */
-      const int I[] = {
-        i-1,  i,  i+1,
-        i-1,  i,  i+1,
-        i-1,  i,  i+1,
-        i-1,  i,  i+1,
-        i-1,  i,  i+1,
-        i-1,  i,  i+1,
-      };
-
-      /* j indices */
-      const int J[] = {
-        j+1,  j+1,  j+1,
-        j,  j,  j,
-        j-1,  j-1,  j-1,
-        j+1,  j+1,  j+1,
-        j,  j,  j,
-        j-1,  j-1,  j-1,
-      };
-
-      /* component indices */
-      const int C[] = {
-        0,  0,  0,
-        0,  0,  0,
-        0,  0,  0,
-        1,  1,  1,
-        1,  1,  1,
-        1,  1,  1,
-      };
       /* end Maxima-generated code */
 
       /* Dragging ice experiences friction at the bed determined by the
@@ -812,27 +888,30 @@ void SSAFD::assemble_matrix(const Inputs &inputs,
         }
       }
 
-      row.i = i;
-      row.j = j;
-      for (int m = 0; m < n_nonzeros; m++) {
-        col[m].i = I[m];
-        col[m].j = J[m];
-        col[m].c = C[m];
-      }
-
       // set coefficients of the first equation:
-      row.c = 0;
-      ierr = MatSetValuesStencil(A, 1, &row, n_nonzeros, col, eq1, INSERT_VALUES);
-      PISM_CHK(ierr, "MatSetValuesStencil");
+      set_row(i, j, 0, eq1);
 
       // set coefficients of the second equation:
-      row.c = 1;
-      ierr = MatSetValuesStencil(A, 1, &row, n_nonzeros, col, eq2, INSERT_VALUES);
-      PISM_CHK(ierr, "MatSetValuesStencil");
+      set_row(i, j, 1, eq2);
     } // i,j-loop
   } catch (...) {
     loop.failed();
   }
+
+  if (direct) {
+    ierr = MatSeqAIJRestoreArray(A_diag, &values_diag);
+    PISM_CHK(ierr, "MatSeqAIJRestoreArray");
+
+    if (A_offdiag) {
+      ierr = MatSeqAIJRestoreArray(A_offdiag, &values_offdiag);
+      PISM_CHK(ierr, "MatSeqAIJRestoreArray");
+    }
+
+    // make sure that KSP knows that A changed
+    ierr = PetscObjectStateIncrease((PetscObject)A);
+    PISM_CHK(ierr, "PetscObjectStateIncrease");
+  }
+
   loop.check();
 
   ierr = MatAssemblyBegin(A, MAT_FINAL_ASSEMBLY);
@@ -915,6 +994,21 @@ void SSAFD::solve(const Inputs &inputs) {
     compute_hardav_staggered(inputs);
   }
 
+  {
+    // each previous iteration uses two more 2D fields and adds a column to the
+    // least-squares problem solved at every iteration, so the depth has to be small
+    const int max_depth = 20;
+
+    double depth = m_config->get_number("stress_balance.ssa.fd.anderson_depth");
+    if (depth < 0 or depth > max_depth) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "stress_balance.ssa.fd.anderson_depth = %d is invalid"
+                                    " (has to be between 0 and %d)",
+                                    (int)depth, max_depth);
+    }
+    m_anderson_depth = depth;
+  }
+
   for (unsigned int k = 0; k < 3; ++k) {
     try {
       if (k == 0) {
@@ -942,7 +1036,8 @@ void SSAFD::solve(const Inputs &inputs) {
         throw RuntimeError(PISM_ERROR_LOCATION, "all SSAFD strategies failed");
       }
     } catch (PicardFailure &f) {
-      // proceed to the next strategy
+      // proceed to the next strategy (without Anderson acceleration)
+      m_anderson_depth = 0;
     }
   }
 
@@ -960,10 +1055,15 @@ void SSAFD::picard_iteration(const Inputs &inputs,
                              double nuH_iter_failure_underrelax) {
 
   if (m_default_pc_failure_count < m_default_pc_failure_max_count) {
-    // Give BJACOBI another shot if we haven't tried it enough yet
+    // Give the default preconditioner (BJACOBI or GAMG) another shot if we haven't tried
+    // it enough yet
 
     try {
-      pc_setup_bjacobi();
+      if (m_config->get_flag("stress_balance.ssa.multigrid")) {
+        pc_setup_gamg();
+      } else {
+        pc_setup_bjacobi();
+      }
       picard_manager(inputs, nuH_regularization,
                      nuH_iter_failure_underrelax);
 
@@ -1011,6 +1111,8 @@ void SSAFD::picard_manager(const Inputs &inputs,
   // set the initial guess:
   m_velocity_global.copy_from(m_velocity);
 
+  anderson_reset();
+
   m_stdout_ssa.clear();
 
   bool use_cfbc = m_config->get_flag("stress_balance.calving_front_stress_bc");
@@ -1076,6 +1178,15 @@ void SSAFD::picard_manager(const Inputs &inputs,
       m_stdout_ssa += tempstr;
     }
 
+    if (m_anderson_depth > 0) {
+      anderson_update();
+
+      if (very_verbose) {
+        snprintf(tempstr, 100, "AA:%d: ", (int)m_anderson_size);
+        m_stdout_ssa += tempstr;
+      }
+    }
+
     // limit ice speed
     {
       auto max_speed = m_config->get_number("stress_balance.ssa.fd.max_speed", "m second-1");
@@ -1169,6 +1280,149 @@ void SSAFD::picard_manager(const Inputs &inputs,
   }
 }
 
+//! Prepare for Anderson acceleration of a new sequence of Picard iterations.
+void SSAFD::anderson_reset() {
+  m_anderson_size          = 0;
+  m_anderson_next          = 0;
+  m_anderson_have_previous = false;
+
+  while (m_anderson_df.size() < m_anderson_depth) {
+    IceModelVec2V::Ptr df(new IceModelVec2V), dg(new IceModelVec2V);
+
+    df->create(m_grid, "anderson_residual_difference", WITHOUT_GHOSTS);
+    dg->create(m_grid, "anderson_picard_iterate_difference", WITHOUT_GHOSTS);
+
+    m_anderson_df.push_back(df);
+    m_anderson_dg.push_back(dg);
+  }
+}
+
+//! \brief Replace the Picard iterate in m_velocity_global with the Anderson-accelerated
+//! one.
+/*!
+Let \f$u_k\f$ be the current velocity (`m_velocity`) and \f$G(u_k)\f$ the result of
+one Picard iteration (`m_velocity_global`). Anderson acceleration uses the residual
+\f$f_k = G(u_k) - u_k\f$ and differences \f$\Delta f_i\f$ and \f$\Delta G_i\f$ of
+residuals and Picard iterates from up to `m_anderson_depth` previous iterations to
+compute the next iterate
+
+  \f[ u_{k+1} = G(u_k) - \sum_i \gamma_i \Delta G_i, \f]
+
+where \f$\gamma\f$ minimizes \f$\| f_k - \sum_i \gamma_i \Delta f_i \|_2\f$.
+
+This re-uses assemble_matrix(), assemble_rhs() and the computation of \f$\nu H\f$
+unchanged and usually reduces the number of Picard iterations considerably.
+
+We solve the normal equations of this tiny least squares problem (redundantly) on all
+ranks. If they are numerically singular we drop stored differences and use the Picard
+iterate.
+*/
+void SSAFD::anderson_update() {
+  PetscErrorCode ierr;
+
+  const unsigned int slot = m_anderson_next;
+
+  if (m_anderson_have_previous) {
+    m_anderson_df[slot]->copy_from(m_anderson_f);
+    m_anderson_dg[slot]->copy_from(m_anderson_g);
+  }
+
+  // f_k = G(u_k) - u_k
+  m_anderson_f.copy_from(m_velocity);
+  m_anderson_f.scale(-1.0);
+  m_anderson_f.add(1.0, m_velocity_global);
+
+  m_anderson_g.copy_from(m_velocity_global);
+
+  if (m_anderson_have_previous) {
+    m_anderson_df[slot]->scale(-1.0);
+    m_anderson_df[slot]->add(1.0, m_anderson_f);
+
+    m_anderson_dg[slot]->scale(-1.0);
+    m_anderson_dg[slot]->add(1.0, m_anderson_g);
+
+    m_anderson_size = std::min(m_anderson_size + 1, m_anderson_depth);
+    m_anderson_next = (m_anderson_next + 1) % m_anderson_depth;
+  }
+  m_anderson_have_previous = true;
+
+  const unsigned int n = m_anderson_size;
+  if (n == 0) {
+    return;
+  }
+
+  // normal equations A gamma = b
+  std::vector<Vec> df(n);
+  for (unsigned int k = 0; k < n; ++k) {
+    df[k] = m_anderson_df[k]->vec();
+  }
+
+  std::vector<double> A(n * n), b(n), gamma(n);
+
+  ierr = VecMDot(m_anderson_f.vec(), n, df.data(), b.data());
+  PISM_CHK(ierr, "VecMDot");
+
+  for (unsigned int k = 0; k < n; ++k) {
+    ierr = VecMDot(df[k], n, df.data(), &A[k * n]);
+    PISM_CHK(ierr, "VecMDot");
+  }
+
+  double max_diagonal = 0.0;
+  for (unsigned int k = 0; k < n; ++k) {
+    max_diagonal = std::max(max_diagonal, A[k * n + k]);
+  }
+  const double threshold = 1e-14 * max_diagonal;
+
+  // Gaussian elimination with partial pivoting
+  bool singular = (max_diagonal <= 0.0);
+  for (unsigned int c = 0; c < n and not singular; ++c) {
+    unsigned int p = c;
+    for (unsigned int r = c + 1; r < n; ++r) {
+      if (fabs(A[r * n + c]) > fabs(A[p * n + c])) {
+        p = r;
+      }
+    }
+
+    if (fabs(A[p * n + c]) <= threshold) {
+      singular = true;
+      break;
+    }
+
+    if (p != c) {
+      for (unsigned int k = 0; k < n; ++k) {
+        std::swap(A[p * n + k], A[c * n + k]);
+      }
+      std::swap(b[p], b[c]);
+    }
+
+    for (unsigned int r = c + 1; r < n; ++r) {
+      const double factor = A[r * n + c] / A[c * n + c];
+      for (unsigned int k = c; k < n; ++k) {
+        A[r * n + k] -= factor * A[c * n + k];
+      }
+      b[r] -= factor * b[c];
+    }
+  }
+
+  if (singular) {
+    m_anderson_size = 0;
+    m_anderson_next = 0;
+    return;
+  }
+
+  for (int c = n - 1; c >= 0; --c) {
+    double sum = b[c];
+    for (unsigned int k = c + 1; k < n; ++k) {
+      sum -= A[c * n + k] * gamma[k];
+    }
+    gamma[c] = sum / A[c * n + c];
+  }
+
+  for (unsigned int k = 0; k < n; ++k) {
+    m_velocity_global.add(-gamma[k], *m_anderson_dg[k]);
+  }
+}
+
 //! Old SSAFD recovery strategy: increase the SSA regularization parameter.
 void SSAFD::picard_strategy_regularization(const Inputs &inputs) {
   // this has no units; epsilon goes up by this ratio when previous value failed
@@ -1661,20 +1915,163 @@ void SSAFD::update_nuH_viewers() {
   tmp.view(m_nuh_viewer, petsc::Viewer::Ptr());
 }
 
-void SSAFD::set_diagonal_matrix_entry(Mat A, int i, int j, int component,
-                                      double value) {
-  MatStencil row, col;
+//! Compute positions of entries of locally-owned rows of m_A in its AIJ storage.
+/*!
+ * The sparsity pattern of m_A is created (and preallocated) by DMCreateMatrix(). It
+ * includes all 18 entries of the 9-point stencil (both components) in each row, whether
+ * they are used or not, so it does not depend on the cell type mask and does not change
+ * between Picard iterations. This allows us to find positions of these entries once and
+ * then write coefficients directly, skipping the conversion of stencil indexes into global
+ * ones and the search for each column in MatSetValuesStencil().
+ *
+ * Positions in the diagonal block are stored as is, positions in the off-diagonal block
+ * (MPIAIJ matrices only) are stored as `-(position + 1)`.
+ *
+ * Leaves m_A_positions empty if m_A is not an assembled AIJ matrix or if an entry is
+ * missing from its sparsity pattern. In this case assemble_matrix() uses
+ * MatSetValuesStencil().
+ */
+void SSAFD::compute_matrix_positions() {
+  PetscErrorCode ierr;
+
+  m_A_positions.clear();
+
+  PetscBool seq = PETSC_FALSE, mpi = PETSC_FALSE, assembled = PETSC_FALSE;
+  ierr = PetscObjectTypeCompare((PetscObject)m_A.get(), MATSEQAIJ, &seq);
+  PISM_CHK(ierr, "PetscObjectTypeCompare");
 
-  row.i = i;
-  row.j = j;
-  row.c = component;
+  ierr = PetscObjectTypeCompare((PetscObject)m_A.get(), MATMPIAIJ, &mpi);
+  PISM_CHK(ierr, "PetscObjectTypeCompare");
 
-  col.i = i;
-  col.j = j;
-  col.c = component;
+  ierr = MatAssembled(m_A, &assembled);
+  PISM_CHK(ierr, "MatAssembled");
+
+  if (not (seq or mpi) or not assembled) {
+    return;
+  }
+
+  ::Mat A_diag = m_A, A_offdiag = NULL;
+  const PetscInt *garray = NULL;
+  if (mpi) {
+    ierr = MatMPIAIJGetSeqAIJ(m_A, &A_diag, &A_offdiag, &garray);
+    PISM_CHK(ierr, "MatMPIAIJGetSeqAIJ");
+  }
 
-  PetscErrorCode ierr = MatSetValuesStencil(A, 1, &row, 1, &col, &value, INSERT_VALUES);
-  PISM_CHK(ierr, "MatSetValuesStencil");
+  PetscInt row_start = 0, row_end = 0, col_start = 0, col_end = 0;
+  ierr = MatGetOwnershipRange(m_A, &row_start, &row_end);
+  PISM_CHK(ierr, "MatGetOwnershipRange");
+
+  ierr = MatGetOwnershipRangeColumn(m_A, &col_start, &col_end);
+  PISM_CHK(ierr, "MatGetOwnershipRangeColumn");
+
+  ISLocalToGlobalMapping ltog;
+  ierr = DMGetLocalToGlobalMapping(*m_da, &ltog);
+  PISM_CHK(ierr, "DMGetLocalToGlobalMapping");
+
+  PetscInt gxs = 0, gys = 0, gxm = 0, gym = 0;
+  ierr = DMDAGetGhostCorners(*m_da, &gxs, &gys, NULL, &gxm, &gym, NULL);
+  PISM_CHK(ierr, "DMDAGetGhostCorners");
+
+  // row pointers and column indexes of diagonal and off-diagonal blocks
+  PetscInt n_diag = 0, n_offdiag = 0;
+  const PetscInt *i_diag = NULL, *j_diag = NULL, *i_offdiag = NULL, *j_offdiag = NULL;
+  PetscBool done_diag = PETSC_FALSE, done_offdiag = PETSC_TRUE;
+
+  ierr = MatGetRowIJ(A_diag, 0, PETSC_FALSE, PETSC_FALSE,
+                     &n_diag, &i_diag, &j_diag, &done_diag);
+  PISM_CHK(ierr, "MatGetRowIJ");
+
+  if (A_offdiag) {
+    ierr = MatGetRowIJ(A_offdiag, 0, PETSC_FALSE, PETSC_FALSE,
+                       &n_offdiag, &i_offdiag, &j_offdiag, &done_offdiag);
+    PISM_CHK(ierr, "MatGetRowIJ");
+  }
+
+  const int
+    n_nonzeros = 18,
+    xs         = m_grid->xs(),
+    ys         = m_grid->ys(),
+    xm         = m_grid->xm(),
+    ym         = m_grid->ym();
+
+  // index of the component c at (i, j) in the ghosted local vector
+  auto local_index = [=](int i, int j, int c) {
+    return ((j - gys) * gxm + (i - gxs)) * 2 + c;
+  };
+
+  std::vector<PetscInt> positions(xm * ym * 2 * n_nonzeros);
+  bool success = done_diag and done_offdiag;
+
+  for (int j = ys; success and j < ys + ym; ++j) {
+    for (int i = xs; success and i < xs + xm; ++i) {
+      for (int c = 0; success and c < 2; ++c) {
+        PetscInt row = local_index(i, j, c), cols[n_nonzeros];
+        for (int m = 0; m < n_nonzeros; ++m) {
+          cols[m] = local_index(i - 1 + m % 3, j + 1 - (m / 3) % 3, m / 9);
+        }
+
+        PetscInt global_row = 0, global_cols[n_nonzeros];
+        ierr = ISLocalToGlobalMappingApply(ltog, 1, &row, &global_row);
+        PISM_CHK(ierr, "ISLocalToGlobalMappingApply");
+
+        ierr = ISLocalToGlobalMappingApply(ltog, n_nonzeros, cols, global_cols);
+        PISM_CHK(ierr, "ISLocalToGlobalMappingApply");
+
+        const PetscInt r = global_row - row_start;
+        PetscInt *result = &positions[(((j - ys) * xm + (i - xs)) * 2 + c) * n_nonzeros];
+
+        for (int m = 0; success and m < n_nonzeros; ++m) {
+          const PetscInt col = global_cols[m];
+
+          if (col >= col_start and col < col_end) {
+            // column indexes in a row are sorted
+            const PetscInt
+              *begin = j_diag + i_diag[r],
+              *end   = j_diag + i_diag[r + 1],
+              *k     = std::lower_bound(begin, end, col - col_start);
+
+            if (k != end and *k == col - col_start) {
+              result[m] = k - j_diag;
+            } else {
+              success = false;
+            }
+          } else if (A_offdiag) {
+            // columns of the off-diagonal block are numbered in the order of increasing
+            // global indexes stored in garray
+            const PetscInt
+              *begin = j_offdiag + i_offdiag[r],
+              *end   = j_offdiag + i_offdiag[r + 1],
+              *k     = std::lower_bound(begin, end, col,
+                                        [garray](PetscInt a, PetscInt b) {
+                                          return garray[a] < b;
+                                        });
+
+            if (k != end and garray[*k] == col) {
+              result[m] = -(k - j_offdiag + 1);
+            } else {
+              success = false;
+            }
+          } else {
+            success = false;
+          }
+        }
+      }
+    }
+  }
+
+  ierr = MatRestoreRowIJ(A_diag, 0, PETSC_FALSE, PETSC_FALSE,
+                         &n_diag, &i_diag, &j_diag, &done_diag);
+  PISM_CHK(ierr, "MatRestoreRowIJ");
+
+  if (A_offdiag) {
+    ierr = MatRestoreRowIJ(A_offdiag, 0, PETSC_FALSE, PETSC_FALSE,
+                           &n_offdiag, &i_offdiag, &j_offdiag, &done_offdiag);
+    PISM_CHK(ierr, "MatRestoreRowIJ");
+  }
+
+  if (success) {
+    m_A_positions.swap(positions);
+  }
 }
 
 //! \brief Checks if a cell is near or at the ice front.
@@ -19,6 +19,8 @@
 #ifndef _SSAFD_H_
 #define _SSAFD_H_
 
+#include <vector>
+
 #include "SSA.hh"
 
 #include "pism/util/error_handling.hh"
@@ -45,6 +47,8 @@ protected:
   virtual void pc_setup_bjacobi();
 
   virtual void pc_setup_asm();
+
+  virtual void pc_setup_gamg();
   
   virtual void solve(const Inputs &inputs);
 
@@ -58,6 +62,10 @@ protected:
 
   virtual void picard_strategy_regularization(const Inputs &inputs);
 
+  void anderson_reset();
+
+  void anderson_update();
+
   virtual void compute_hardav_staggered(const Inputs &inputs);
 
   virtual void compute_nuH_staggered(const Geometry &geometry,
@@ -80,8 +88,7 @@ protected:
 
   virtual void update_nuH_viewers();
 
-  void set_diagonal_matrix_entry(Mat A, int i, int j, int component,
-                                         double value);
+  void compute_matrix_positions();
 
   virtual bool is_marginal(int i, int j, bool ssa_dirichlet_bc);
 
@@ -92,11 +99,28 @@ protected:
   IceModelVec2 m_work;
   petsc::KSP m_KSP;
   petsc::Mat m_A;
+  //! positions of entries of locally-owned rows of m_A in its AIJ storage (empty if
+  //! m_A has to be assembled using MatSetValuesStencil())
+  std::vector<PetscInt> m_A_positions;
   IceModelVec2V m_b;            // right hand side
   double m_scaling;
 
   IceModelVec2V m_velocity_old;
 
+  // Anderson acceleration of Picard iterations (see anderson_update())
+  //! number of differences kept (zero disables acceleration)
+  unsigned int m_anderson_depth;
+  //! number of differences currently stored
+  unsigned int m_anderson_size;
+  //! index of the slot used to store the next difference
+  unsigned int m_anderson_next;
+  //! true if m_anderson_f and m_anderson_g contain values from the previous iteration
+  bool m_anderson_have_previous;
+  //! residual and Picard iterate from the previous iteration
+  IceModelVec2V m_anderson_f, m_anderson_g;
+  //! differences of residuals and Picard iterates
+  std::vector<IceModelVec2V::Ptr> m_anderson_df, m_anderson_dg;
+
   unsigned int m_default_pc_failure_count,
     m_default_pc_failure_max_count;
   
@@ -29,6 +29,7 @@
 #include "pism/geometry/Geometry.hh"
 
 #include "pism/util/node_types.hh"
+#include "pism/util/pism_utilities.hh"
 
 namespace pism {
 namespace stressbalance {
@@ -58,6 +59,7 @@ SSAFEM::SSAFEM(IceGrid::ConstPtr g)
 
   m_dirichletScale = 1.0;
   m_beta_ice_free_bedrock = m_config->get_number("basal_resistance.beta_ice_free_bedrock");
+  m_picard_preconditioner = false;
 
   ierr = SNESCreate(m_grid->com, m_snes.rawptr());
   PISM_CHK(ierr, "SNESCreate");
@@ -76,7 +78,10 @@ SSAFEM::SSAFEM(IceGrid::ConstPtr g)
                                   &m_callback_data);
   PISM_CHK(ierr, "DMDASNESSetJacobianLocal");
 
-  ierr = DMSetMatType(*m_da, "baij");
+  const bool multigrid = m_config->get_flag("stress_balance.ssa.multigrid");
+
+  // GAMG needs an AIJ matrix (the block size of 2 is set by the DM in both cases)
+  ierr = DMSetMatType(*m_da, multigrid ? "aij" : "baij");
   PISM_CHK(ierr, "DMSetMatType");
 
   ierr = DMSetApplicationContext(*m_da, &m_callback_data);
@@ -91,6 +96,49 @@ SSAFEM::SSAFEM(IceGrid::ConstPtr g)
                            snes_max_it, PETSC_DEFAULT);
   PISM_CHK(ierr, "SNESSetTolerances");
 
+  if (multigrid) {
+    // Use algebraic multigrid; the near null space is set in compute_local_jacobian().
+    KSP ksp;
+    ierr = SNESGetKSP(m_snes, &ksp);
+    PISM_CHK(ierr, "SNESGetKSP");
+
+    PC pc;
+    ierr = KSPGetPC(ksp, &pc);
+    PISM_CHK(ierr, "KSPGetPC");
+
+    ierr = PCSetType(pc, PCGAMG);
+    PISM_CHK(ierr, "PCSetType");
+  }
+
+  if (m_config->get_flag("stress_balance.ssa.fem.matrix_free")) {
+    // Apply the Jacobian using finite differences of the residual (equivalent to
+    // -snes_mf_operator). The assembled matrix is used to build the preconditioner only,
+    // so it does not have to be the Jacobian: we use the Picard linearization (see
+    // compute_local_jacobian()), which is symmetric and positive definite, and
+    // re-assemble it only every lag-th Newton iteration.
+    m_picard_preconditioner = true;
+
+#if PETSC_VERSION_GE(3,7,0)
+    ierr = SNESSetUseMatrixFree(m_snes, PETSC_TRUE, PETSC_FALSE);
+    PISM_CHK(ierr, "SNESSetUseMatrixFree");
+#else
+    throw RuntimeError(PISM_ERROR_LOCATION,
+                       "stress_balance.ssa.fem.matrix_free requires PETSc 3.7 or newer");
+#endif
+
+    int lag = static_cast<int>(m_config->get_number("stress_balance.ssa.fem.preconditioner_lag"));
+    if (lag < 1) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "stress_balance.ssa.fem.preconditioner_lag has to be"
+                                    " positive (got %d)", lag);
+    }
+
+    // Re-assemble the preconditioner matrix every lag-th Newton iteration (and at the
+    // beginning of each solve).
+    ierr = SNESSetLagJacobian(m_snes, lag);
+    PISM_CHK(ierr, "SNESSetLagJacobian");
+  }
+
   ierr = SNESSetFromOptions(m_snes);
   PISM_CHK(ierr, "SNESSetFromOptions");
 
@@ -190,6 +238,10 @@ TerminationReason::Ptr SSAFEM::solve_nocache() {
 
   m_epsilon_ssa = m_config->get_number("stress_balance.ssa.epsilon");
 
+  // Use the current velocity (the result of the previous solve or an extrapolated initial
+  // guess set by SSA::update()) as the initial guess.
+  m_velocity_global.copy_from(m_velocity);
+
   options::String filename("-ssa_view", "");
   if (filename.is_set()) {
     petsc::Viewer viewer;
@@ -218,6 +270,19 @@ TerminationReason::Ptr SSAFEM::solve_nocache() {
   ierr = SNESSolve(m_snes, NULL, m_velocity_global.vec());
   PISM_CHK(ierr, "SNESSolve");
 
+  if (m_log->get_threshold() >= 2) {
+    PetscInt snes_iterations = 0, ksp_iterations = 0;
+    ierr = SNESGetIterationNumber(m_snes, &snes_iterations);
+    PISM_CHK(ierr, "SNESGetIterationNumber");
+
+    ierr = SNESGetLinearSolveIterations(m_snes, &ksp_iterations);
+    PISM_CHK(ierr, "SNESGetLinearSolveIterations");
+
+    m_stdout_ssa += pism::printf("%d Newton iterations, ~%3.1f KSP iterations each ",
+                                 (int)snes_iterations,
+                                 snes_iterations > 0 ? (double)ksp_iterations / snes_iterations : 0.0);
+  }
+
   // See if it worked.
   SNESConvergedReason snes_reason;
   ierr = SNESGetConvergedReason(m_snes, &snes_reason); PISM_CHK(ierr, "SNESGetConvergedReason");
@@ -902,8 +967,13 @@ void SSAFEM::monitor_function(Vector2 const *const *const velocity_global,
   where \f$G\f$ is the weak form of the SSA, \f$x\f$ is the current
   approximate solution, and the \f$\psi_{ij}\f$ are test functions.
 
+  If `picard` is true, compute the Picard linearization instead, i.e. ignore derivatives
+  of the effective viscosity and of the basal drag coefficient with respect to the
+  velocity.
+
 */
-void SSAFEM::compute_local_jacobian(Vector2 const *const *const velocity_global, Mat Jac) {
+void SSAFEM::compute_local_jacobian(Vector2 const *const *const velocity_global, Mat Jac,
+                                    bool picard) {
 
   const unsigned int Nk     = fem::q1::n_chi;
   const unsigned int Nq_max = fem::MAX_QUADRATURE_SIZE;
@@ -1012,6 +1082,13 @@ void SSAFEM::compute_local_jacobian(Vector2 const *const *const velocity_global,
                               U[q], U_x[q], U_y[q],
                               &eta, &deta, &beta, &dbeta);
 
+          if (picard) {
+            // Picard linearization: treat the effective viscosity and the basal drag
+            // coefficient as constants
+            deta  = 0.0;
+            dbeta = 0.0;
+          }
+
           for (unsigned int l = 0; l < Nk; l++) { // Trial functions
 
             // Current trial function and its derivatives:
@@ -1099,6 +1176,10 @@ void SSAFEM::compute_local_jacobian(Vector2 const *const *const velocity_global,
   ierr = MatSetOption(Jac, MAT_SYMMETRIC, PETSC_TRUE);
   PISM_CHK(ierr, "MatSetOption");
 
+  if (m_config->get_flag("stress_balance.ssa.multigrid")) {
+    set_near_null_space(Jac);
+  }
+
   monitor_jacobian(Jac);
 }
 
@@ -1167,7 +1248,8 @@ PetscErrorCode SSAFEM::jacobian_callback(DMDALocalInfo *info,
   try {
     (void) A;
     (void) info;
-    fe->ssa->compute_local_jacobian(velocity, J);
+    // J is used to build the preconditioner only if A is applied matrix-free
+    fe->ssa->compute_local_jacobian(velocity, J, fe->ssa->m_picard_preconditioner);
   } catch (...) {
     MPI_Comm com = MPI_COMM_SELF;
     PetscErrorCode ierr = PetscObjectGetComm((PetscObject)fe->da, &com); CHKERRQ(ierr);
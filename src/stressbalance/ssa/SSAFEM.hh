@@ -103,7 +103,8 @@ protected:
   void compute_local_function(Vector2 const *const *const velocity,
                               Vector2 **residual);
 
-  void compute_local_jacobian(Vector2 const *const *const velocity, Mat J);
+  void compute_local_jacobian(Vector2 const *const *const velocity, Mat J,
+                              bool picard = false);
 
   virtual void solve(const Inputs &inputs);
 
@@ -135,6 +136,9 @@ protected:
   double m_dirichletScale;
   double m_beta_ice_free_bedrock;
   double m_epsilon_ssa;
+  //! true if the preconditioner is built using the Picard linearization (frozen
+  //! viscosity and basal drag) instead of the Jacobian
+  bool m_picard_preconditioner;
 
   fem::ElementIterator m_element_index;
   fem::ElementMap m_element;
@@ -91,12 +91,20 @@ CFLData max_timestep_cfl_3d(const IceModelVec2S &ice_thickness,
   }
   loop.check();
 
+  GlobalReduction reduction(grid->com);
+  int
+    U  = reduction.add(GlobalReduction::MAX, u_max),
+    V  = reduction.add(GlobalReduction::MAX, v_max),
+    W  = reduction.add(GlobalReduction::MAX, w_max),
+    DT = reduction.add(GlobalReduction::MIN, dt_max);
+  reduction.reduce();
+
   CFLData result;
 
-  result.u_max = GlobalMax(grid->com, u_max);
-  result.v_max = GlobalMax(grid->com, v_max);
-  result.w_max = GlobalMax(grid->com, w_max);
-  result.dt_max = MaxTimestep(GlobalMin(grid->com, dt_max));
+  result.u_max = reduction[U];
+  result.v_max = reduction[V];
+  result.w_max = reduction[W];
+  result.dt_max = MaxTimestep(reduction[DT]);
 
   return result;
 }
@@ -145,12 +153,19 @@ CFLData max_timestep_cfl_2d(const IceModelVec2S &ice_thickness,
     }
   }
 
+  GlobalReduction reduction(grid->com);
+  int
+    U  = reduction.add(GlobalReduction::MAX, u_max),
+    V  = reduction.add(GlobalReduction::MAX, v_max),
+    DT = reduction.add(GlobalReduction::MIN, dt_max);
+  reduction.reduce();
+
   CFLData result;
 
-  result.u_max = GlobalMax(grid->com, u_max);
-  result.v_max = GlobalMax(grid->com, v_max);
+  result.u_max = reduction[U];
+  result.v_max = reduction[V];
   result.w_max = 0.0;
-  result.dt_max = MaxTimestep(GlobalMin(grid->com, dt_max));
+  result.dt_max = MaxTimestep(reduction[DT]);
 
   return result;
 }
@@ -143,6 +143,8 @@ Config::Doubles Config::all_doubles() const {
 
 double Config::get_number(const std::string &name, UseFlag flag) const {
   if (flag == REMEMBER_THIS_USE) {
+    // column models may be created by several threads at once
+#pragma omp critical (pism_config_parameters_used)
     m_impl->parameters_used.insert(name);
   }
   return this->get_number_impl(name);
@@ -165,6 +167,7 @@ double Config::get_number(const std::string &name,
 
 std::vector<double> Config::get_numbers(const std::string &name, UseFlag flag) const {
   if (flag == REMEMBER_THIS_USE) {
+#pragma omp critical (pism_config_parameters_used)
     m_impl->parameters_used.insert(name);
   }
   return this->get_numbers_impl(name);
@@ -230,6 +233,7 @@ Config::Strings Config::all_strings() const {
 
 std::string Config::get_string(const std::string &name, UseFlag flag) const {
   if (flag == REMEMBER_THIS_USE) {
+#pragma omp critical (pism_config_parameters_used)
     m_impl->parameters_used.insert(name);
   }
   return this->get_string_impl(name);
@@ -259,6 +263,7 @@ Config::Flags Config::all_flags() const {
 
 bool Config::get_flag(const std::string& name, UseFlag flag) const {
   if (flag == REMEMBER_THIS_USE) {
+#pragma omp critical (pism_config_parameters_used)
     m_impl->parameters_used.insert(name);
   }
   return this->get_flag_impl(name);
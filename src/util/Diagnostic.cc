@@ -17,6 +17,8 @@
  * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
  */
 
+#include <algorithm>
+
 #include "Diagnostic.hh"
 #include "pism/util/Time.hh"
 #include "error_handling.hh"
@@ -174,6 +176,9 @@ IceModelVec::Ptr Diagnostic::compute() const {
   IceModelVec::Ptr result = this->compute_impl();
   m_grid->ctx()->log()->message(3, "-  Done computing %s.\n", all_names.c_str());
 
+  // results are short-lived: re-use their storage next time
+  result->use_storage_pool();
+
   return result;
 }
 
@@ -186,8 +191,6 @@ TSDiagnostic::TSDiagnostic(IceGrid::ConstPtr g, const std::string &name)
   m_current_time = 0;
   m_start        = 0;
 
-  m_buffer_size = (size_t)m_config->get_number("output.timeseries.buffer_size");
-
   m_ts.variable().set_string("ancillary_variables", name + "_aux");
 
   m_ts.dimension().set_string("calendar", m_grid->ctx()->time()->calendar());
@@ -347,16 +350,30 @@ void TSDiagnostic::define(const File &file) const {
   io::define_time_bounds(m_ts.bounds(), file, PISM_DOUBLE);
 }
 
+//! Write buffered data to the output file (opening and closing it).
 void TSDiagnostic::flush() {
 
   if (m_ts.times().empty()) {
     return;
   }
 
-  std::string dimension_name = m_ts.dimension().get_name();
-
   File file(m_grid->com, m_output_filename, PISM_NETCDF3, PISM_READWRITE); // OK to use netcdf3
 
+  flush(file);
+}
+
+//! Write buffered data to an open output file.
+/*!
+ * This makes it possible to write all scalar diagnostics using one "open/close" cycle.
+ */
+void TSDiagnostic::flush(const File &file) {
+
+  if (m_ts.times().empty()) {
+    return;
+  }
+
+  std::string dimension_name = m_ts.dimension().get_name();
+
   unsigned int len = file.dimension_length(dimension_name);
 
   if (len > 0) {
@@ -378,6 +395,11 @@ void TSDiagnostic::flush() {
   m_ts.reset();
 }
 
+//! Number of records waiting to be written.
+size_t TSDiagnostic::n_buffered() const {
+  return m_ts.times().size();
+}
+
 void TSDiagnostic::init(const File &output_file,
                         std::shared_ptr<std::vector<double>> requested_times) {
   m_output_filename = output_file.filename();
@@ -392,4 +414,102 @@ const VariableMetadata &TSDiagnostic::metadata() const {
   return m_ts.variable();
 }
 
+TSLocalSum::TSLocalSum()
+  : m_value(0.0), m_value_ready(false) {
+  // empty
+}
+
+TSLocalSum::~TSLocalSum() {
+  // empty
+}
+
+double TSLocalSum::finish_local_sum(double sum) const {
+  return sum;
+}
+
+/*!
+ * Return the value computed by the last call of evaluate() or, if it was not computed (e.g.
+ * this diagnostic is used outside of update_ts_diagnostics()), compute it now.
+ */
+double TSLocalSum::local_sum_value(const IceGrid &grid) {
+  if (not m_value_ready) {
+    evaluate(grid, {this});
+  }
+
+  m_value_ready = false;
+
+  return m_value;
+}
+
+//! Evaluate all `diagnostics` using one pass over the grid and one reduction.
+void TSLocalSum::evaluate(const IceGrid &grid, const std::vector<TSLocalSum*> &diagnostics) {
+  const size_t N = diagnostics.size();
+
+  if (N == 0) {
+    return;
+  }
+
+  std::vector<double> local(N, 0.0), global(N, 0.0);
+
+  IceModelVec::AccessList list;
+  for (auto d : diagnostics) {
+    d->begin_local_sum(list);
+  }
+
+  ParallelSection loop(grid.com);
+  try {
+    for (Points p(grid); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      for (size_t k = 0; k < N; ++k) {
+        local[k] += diagnostics[k]->local_sum(i, j);
+      }
+    }
+  } catch (...) {
+    loop.failed();
+  }
+  loop.check();
+
+  GlobalSum(grid.com, local.data(), global.data(), N);
+
+  for (size_t k = 0; k < N; ++k) {
+    diagnostics[k]->m_value       = diagnostics[k]->finish_local_sum(global[k]);
+    diagnostics[k]->m_value_ready = true;
+  }
+}
+
+/*!
+ * Update scalar diagnostics in `diagnostics`, computing all the ones implementing TSLocalSum in
+ * one pass.
+ *
+ * Note that the same diagnostic may appear in `diagnostics` more than once (under different
+ * names).
+ */
+void update_ts_diagnostics(const IceGrid &grid, const TSDiagnosticList &diagnostics,
+                           double t0, double t1) {
+  std::vector<TSLocalSum*> sums;
+
+  // Snapshot and flux diagnostics are not computed during zero-length time steps. Rate
+  // diagnostics are, but this happens once per run: compute them one at a time.
+  if (fabs(t1 - t0) >= 1e-2) {
+    for (auto d : diagnostics) {
+      auto s = dynamic_cast<TSLocalSum*>(d.second.get());
+      if (s != nullptr and std::find(sums.begin(), sums.end(), s) == sums.end()) {
+        sums.push_back(s);
+      }
+    }
+  }
+
+  TSLocalSum::evaluate(grid, sums);
+
+  std::vector<TSDiagnostic*> updated;
+  for (auto d : diagnostics) {
+    auto ptr = d.second.get();
+    if (std::find(updated.begin(), updated.end(), ptr) == updated.end()) {
+      ptr->update(t0, t1);
+      updated.push_back(ptr);
+    }
+  }
+}
+
 } // end of namespace pism
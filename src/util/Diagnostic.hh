@@ -22,6 +22,7 @@
 #include <memory>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "VariableMetadata.hh"
 #include "Timeseries.hh"        // inline code and a member of TSDiagnostic
@@ -276,6 +277,9 @@ public:
   void update(double t0, double t1);
 
   void flush();
+  void flush(const File &file);
+
+  size_t n_buffered() const;
 
   void init(const File &output_file,
             std::shared_ptr<std::vector<double>> requested_times);
@@ -317,12 +321,10 @@ protected:
   unsigned int m_current_time;
 
   //! the name of the file to save to (stored here because it is used by flush(), which is called
-  //! from update())
+  //! from the destructor)
   std::string m_output_filename;
   //! starting index used when flushing the buffer
   unsigned int m_start;
-  //! size of the buffer used to store data
-  size_t m_buffer_size;
 };
 
 typedef std::map<std::string, TSDiagnostic::Ptr> TSDiagnosticList;
@@ -391,6 +393,38 @@ protected:
   const M *model;
 };
 
+//! @brief Scalar diagnostic computed as a sum of contributions from individual grid points.
+/*!
+ * All diagnostics implementing this interface are evaluated together by update_ts_diagnostics():
+ * one pass over the grid and one reduction for all of them, instead of one loop and one
+ * `MPI_Allreduce` per diagnostic.
+ *
+ * A TSDiagnostic implementing this interface should return local_sum_value() from compute().
+ */
+class TSLocalSum {
+public:
+  TSLocalSum();
+  virtual ~TSLocalSum();
+
+  static void evaluate(const IceGrid &grid, const std::vector<TSLocalSum*> &diagnostics);
+protected:
+  double local_sum_value(const IceGrid &grid);
+
+  //! Prepare to compute contributions of grid points and add inputs to `list`.
+  virtual void begin_local_sum(IceModelVec::AccessList &list) = 0;
+  //! Contribution of the grid point (i,j).
+  virtual double local_sum(int i, int j) const = 0;
+  //! Convert the global sum to the value of the diagnostic.
+  virtual double finish_local_sum(double sum) const;
+private:
+  //! value computed by evaluate(), to be used by the next call of local_sum_value()
+  double m_value;
+  bool m_value_ready;
+};
+
+void update_ts_diagnostics(const IceGrid &grid, const TSDiagnosticList &diagnostics,
+                           double t0, double t1);
+
 } // end of namespace pism
 
 #endif /* __Diagnostic_hh */
@@ -197,6 +197,27 @@ double EnthalpyConverter::pressure_adjusted_temperature(double E, double P) cons
   return temperature(E, P) - melting_temperature(P) + m_T_melting;
 }
 
+//! Compute pressure-adjusted temperatures at `n` points (e.g. in a column).
+/*!
+ * Equivalent to calling pressure_adjusted_temperature(E[k], P[k]) for each `k`, but the
+ * loop does not branch, so that the compiler can vectorize it.
+ */
+void EnthalpyConverter::pressure_adjusted_temperature(const double *E, const double *P,
+                                                      unsigned int n, double *result) const {
+  for (unsigned int k = 0; k < n; ++k) {
+    validate_E_P(E[k], P[k]);
+  }
+
+  for (unsigned int k = 0; k < n; ++k) {
+    const double
+      T_m = melting_temperature(P[k]),
+      E_s = m_c_i * (T_m - m_T_0),
+      T   = E[k] < E_s ? temperature_cold(E[k]) : T_m;
+
+    result[k] = T - T_m + m_T_melting;
+  }
+}
+
 
 //! Get liquid water fraction from enthalpy and pressure.
 /*!
@@ -222,6 +243,23 @@ double EnthalpyConverter::water_fraction(double E, double P) const {
   }
 }
 
+//! Compute liquid water fractions at `n` points (see pressure_adjusted_temperature()).
+void EnthalpyConverter::water_fraction(const double *E, const double *P,
+                                       unsigned int n, double *result) const {
+  for (unsigned int k = 0; k < n; ++k) {
+    validate_E_P(E[k], P[k]);
+  }
+
+  for (unsigned int k = 0; k < n; ++k) {
+    const double
+      T_m   = melting_temperature(P[k]),
+      E_s   = m_c_i * (T_m - m_T_0),
+      omega = (E[k] - E_s) / L(T_m);
+
+    result[k] = E[k] <= E_s ? 0.0 : omega;
+  }
+}
+
 
 //! Compute enthalpy from absolute temperature, liquid water fraction, and pressure.
 /*! This is an inverse function to the functions \f$T(E,p)\f$ and
@@ -379,6 +417,13 @@ double EnthalpyConverter::enthalpy_cts(double P) const {
   return m_c_i * (melting_temperature(P) - m_T_0);
 }
 
+//! Compute enthalpies at the cold-temperate transition at `n` points.
+void EnthalpyConverter::enthalpy_cts(const double *P, unsigned int n, double *result) const {
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = m_c_i * (melting_temperature(P[k]) - m_T_0);
+  }
+}
+
 //! Convert temperature into enthalpy (cold case).
 double EnthalpyConverter::enthalpy_cold(double T) const {
   return m_c_i * (T - m_T_0);
@@ -61,11 +61,16 @@ public:
   double temperature(double E, double P) const;
   double melting_temperature(double P) const;
   double pressure_adjusted_temperature(double E, double P) const;
+  void pressure_adjusted_temperature(const double *E, const double *P,
+                                     unsigned int n, double *result) const;
 
   double water_fraction(double E, double P) const;
+  void water_fraction(const double *E, const double *P,
+                      unsigned int n, double *result) const;
 
   double enthalpy(double T, double omega, double P) const;
   double enthalpy_cts(double P) const;
+  void enthalpy_cts(const double *P, unsigned int n, double *result) const;
   double enthalpy_liquid(double P) const;
   double enthalpy_permissive(double T, double omega, double P) const;
 
@@ -0,0 +1,118 @@
+/* Copyright (C) 2019 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <map>
+#include <memory>
+#include <algorithm>            // std::find
+
+#include "ForcingReader.hh"
+#include "pism/util/IceGrid.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/Time.hh"
+#include "pism/util/VariableMetadata.hh"
+#include "pism/util/io/File.hh"
+#include "pism/util/io/io_helpers.hh"
+
+namespace pism {
+
+struct ForcingReader::Impl {
+  Context::ConstPtr ctx;
+  std::shared_ptr<File> file;
+
+  //! times read from the file (in model time units), indexed by variable name
+  std::map<std::string, std::vector<double> > times;
+  //! time bounds read from the file (in model time units), indexed by variable name
+  std::map<std::string, std::vector<double> > time_bounds;
+
+  //! fields reading from this file
+  std::vector<IceModelVec2T*> fields;
+};
+
+ForcingReader::ForcingReader(const IceGrid &grid, const std::string &filename)
+  : m_impl(new Impl) {
+  m_impl->ctx  = grid.ctx();
+  m_impl->file = grid.input_file(filename);
+}
+
+ForcingReader::~ForcingReader() {
+  delete m_impl;
+}
+
+const File& ForcingReader::file() const {
+  return *m_impl->file;
+}
+
+//! Times corresponding to records of a variable (read once).
+const std::vector<double>& ForcingReader::times(const std::string &time_name) const {
+  auto it = m_impl->times.find(time_name);
+  if (it != m_impl->times.end()) {
+    return it->second;
+  }
+
+  auto sys  = m_impl->ctx->unit_system();
+  auto time = m_impl->ctx->time();
+
+  TimeseriesMetadata metadata(time_name, time_name, sys);
+  metadata.set_string("units", time->units_string());
+
+  std::vector<double> result;
+  io::read_timeseries(*m_impl->file, metadata, *time, *m_impl->ctx->log(), result);
+
+  return m_impl->times[time_name] = result;
+}
+
+//! Time bounds corresponding to records of a variable (read once).
+const std::vector<double>& ForcingReader::time_bounds(const std::string &bounds_name,
+                                                      const std::string &time_name) const {
+  auto it = m_impl->time_bounds.find(bounds_name);
+  if (it != m_impl->time_bounds.end()) {
+    return it->second;
+  }
+
+  auto sys  = m_impl->ctx->unit_system();
+  auto time = m_impl->ctx->time();
+
+  TimeBoundsMetadata metadata(bounds_name, time_name, sys);
+  metadata.set_string("units", time->units_string());
+
+  std::vector<double> result;
+  io::read_time_bounds(*m_impl->file, metadata, *time, *m_impl->ctx->log(), result);
+
+  return m_impl->time_bounds[bounds_name] = result;
+}
+
+//! Register a field reading from this file.
+void ForcingReader::add(IceModelVec2T *field) {
+  auto &fields = m_impl->fields;
+  if (std::find(fields.begin(), fields.end(), field) == fields.end()) {
+    fields.push_back(field);
+  }
+}
+
+//! Stop tracking a field (e.g. when it is destroyed).
+void ForcingReader::remove(IceModelVec2T *field) {
+  auto &fields = m_impl->fields;
+  fields.erase(std::remove(fields.begin(), fields.end(), field), fields.end());
+}
+
+const std::vector<IceModelVec2T*>& ForcingReader::fields() const {
+  return m_impl->fields;
+}
+
+} // end of namespace pism
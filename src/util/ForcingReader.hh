@@ -0,0 +1,67 @@
+/* Copyright (C) 2019 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _FORCINGREADER_H_
+#define _FORCINGREADER_H_
+
+#include <string>
+#include <vector>
+
+namespace pism {
+
+class File;
+class IceGrid;
+class IceModelVec2T;
+
+//! Reads time-dependent forcing fields from a file, sharing work among them.
+/*!
+ * Forcing fields (IceModelVec2T instances) reading from the same file share an instance
+ * of this class (see IceGrid::forcing_reader()). It
+ *
+ * - keeps the file open (and with it interpolation contexts cached by File),
+ * - reads the time axis (times and time bounds) once,
+ * - keeps track of fields using it, so that fields with the same time axis and the same
+ *   records in memory can read a time window in one pass (see IceModelVec2T::update()).
+ */
+class ForcingReader {
+public:
+  ForcingReader(const IceGrid &grid, const std::string &filename);
+  ~ForcingReader();
+
+  const File& file() const;
+
+  const std::vector<double>& times(const std::string &time_name) const;
+  const std::vector<double>& time_bounds(const std::string &bounds_name,
+                                         const std::string &time_name) const;
+
+  void add(IceModelVec2T *field);
+  void remove(IceModelVec2T *field);
+  const std::vector<IceModelVec2T*>& fields() const;
+private:
+  struct Impl;
+  Impl *m_impl;
+
+  // disable copying and assignments
+  ForcingReader(const ForcingReader &other);
+  ForcingReader & operator=(const ForcingReader &);
+};
+
+} // end of namespace pism
+
+#endif /* _FORCINGREADER_H_ */
@@ -31,6 +31,7 @@
 #include "pism_options.hh"
 #include "error_handling.hh"
 #include "pism/util/io/File.hh"
+#include "pism/util/ForcingReader.hh"
 #include "pism/util/Vars.hh"
 #include "pism/util/Logger.hh"
 #include "pism/util/projection.hh"
@@ -102,6 +103,12 @@ struct IceGrid::Impl {
 
   std::map<int,petsc::DM::WeakPtr> dms;
 
+  //! input files opened using input_file()
+  std::map<std::string, std::weak_ptr<File> > input_files;
+
+  //! forcing readers created using forcing_reader()
+  std::map<std::string, std::weak_ptr<ForcingReader> > forcing_readers;
+
   // This DM is used for I/O operations and is not owned by any
   // IceModelVec (so far, anyway). We keep a pointer to it here to
   // avoid re-allocating it many times.
@@ -117,6 +124,17 @@ struct IceGrid::Impl {
 
   //! ParallelIO I/O decompositions.
   std::map<int, int> io_decompositions;
+
+  //! Storage of released vectors, see allocate_vec() and release_vec().
+  struct VecPool {
+    //! keeps the DM alive while pooled vectors refer to it
+    petsc::DM::Ptr dm;
+    //! vectors with ghosts
+    std::vector<Vec> local;
+    //! vectors without ghosts
+    std::vector<Vec> global;
+  };
+  std::map<int, VecPool> vec_pool;
 };
 
 IceGrid::Impl::Impl(Context::ConstPtr context)
@@ -359,6 +377,15 @@ IceGrid::~IceGrid() {
   }
 #endif
 
+  for (auto &p : m_impl->vec_pool) {
+    for (auto v : p.second.local) {
+      PetscErrorCode ierr = VecDestroy(&v); CHKERRCONTINUE(ierr);
+    }
+    for (auto v : p.second.global) {
+      PetscErrorCode ierr = VecDestroy(&v); CHKERRCONTINUE(ierr);
+    }
+  }
+
   delete m_impl;
 }
 
@@ -844,6 +871,101 @@ petsc::DM::Ptr IceGrid::get_dm(int da_dof, int stencil_width) const {
   return result;
 }
 
+//! @brief Get a read-only handle of the file `filename`, shared by all users of this grid.
+/*!
+ * The file stays open while a handle is in use, so code reading one record at a time
+ * (such as IceModelVec2T) does not have to re-open it. Interpolation contexts cached by
+ * the file are shared too.
+ */
+std::shared_ptr<File> IceGrid::input_file(const std::string &filename) const {
+  std::shared_ptr<File> result = m_impl->input_files[filename].lock();
+
+  if (not result) {
+    result.reset(new File(com, filename, PISM_GUESS, PISM_READONLY));
+    m_impl->input_files[filename] = result;
+  }
+
+  return result;
+}
+
+//! Get the forcing reader for the file `filename`.
+/*!
+ * Forcing fields reading from the same file share a reader while it is in use.
+ */
+std::shared_ptr<ForcingReader> IceGrid::forcing_reader(const std::string &filename) const {
+  std::shared_ptr<ForcingReader> result = m_impl->forcing_readers[filename].lock();
+
+  if (not result) {
+    result.reset(new ForcingReader(*this, filename));
+    m_impl->forcing_readers[filename] = result;
+  }
+
+  return result;
+}
+
+//! @brief Allocate a vector compatible with the DM returned by `get_dm(da_dof,
+//! stencil_width)`, re-using storage released by release_vec() if possible.
+/*!
+ * Re-used vectors are set to zero, so the result is the same as the one of
+ * DMCreateLocalVector() (if `ghosted` is true) or DMCreateGlobalVector().
+ */
+void IceGrid::allocate_vec(int da_dof, int stencil_width, bool ghosted, Vec *result) const {
+  PetscErrorCode ierr;
+
+  auto pool = m_impl->vec_pool.find(dm_hash(da_dof, stencil_width));
+
+  if (pool != m_impl->vec_pool.end()) {
+    auto &vecs = ghosted ? pool->second.local : pool->second.global;
+
+    if (not vecs.empty()) {
+      *result = vecs.back();
+      vecs.pop_back();
+
+      ierr = VecSet(*result, 0.0);
+      PISM_CHK(ierr, "VecSet");
+      return;
+    }
+  }
+
+  petsc::DM::Ptr dm = get_dm(da_dof, stencil_width);
+
+  if (ghosted) {
+    ierr = DMCreateLocalVector(*dm, result);
+    PISM_CHK(ierr, "DMCreateLocalVector");
+  } else {
+    ierr = DMCreateGlobalVector(*dm, result);
+    PISM_CHK(ierr, "DMCreateGlobalVector");
+  }
+}
+
+//! @brief Return a vector allocated using allocate_vec() to the pool. The grid takes
+//! ownership of `v`.
+/*!
+ * The pool keeps at most `max_pooled_vecs` vectors of each kind (ghosted or not) for each
+ * `(da_dof, stencil_width)` pair; extra vectors are destroyed. This way a burst of
+ * short-lived temporaries (e.g. during initialization) does not pin memory for the rest of
+ * the run.
+ */
+void IceGrid::release_vec(int da_dof, int stencil_width, bool ghosted, Vec v) const {
+  const size_t max_pooled_vecs = 8;
+
+  auto &pool = m_impl->vec_pool[dm_hash(da_dof, stencil_width)];
+
+  auto &vecs = ghosted ? pool.local : pool.global;
+
+  if (vecs.size() >= max_pooled_vecs) {
+    // there is nothing we can do if this fails
+    PetscErrorCode ierr = VecDestroy(&v); CHKERRCONTINUE(ierr);
+    return;
+  }
+
+  if (not pool.dm) {
+    pool.dm = get_dm(da_dof, stencil_width);
+  }
+
+  vecs.push_back(v);
+}
+
 //! Return grid periodicity.
 Periodicity IceGrid::periodicity() const {
   return m_impl->periodicity;
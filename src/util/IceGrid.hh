@@ -20,6 +20,7 @@
 #define __grid_hh
 
 #include <cassert>
+#include <algorithm>            // std::min
 #include <vector>
 #include <string>
 #include <memory>
@@ -31,6 +32,7 @@
 namespace pism {
 
 class File;
+class ForcingReader;
 namespace units {
 class System;
 }
@@ -206,6 +208,29 @@ private:
     field(i,j) = value;
   }
   \endcode
+
+  If PISM is built with OpenMP, per-column loops can be split between threads by giving
+  each thread its own stripe of grid rows. Scratch storage used in the loop body has to be
+  allocated *inside* the parallel region (one copy per thread) and exceptions (including
+  `std::bad_alloc` thrown while allocating it) must not escape it:
+
+  \code
+  ParallelSection loop(grid.com);
+#pragma omp parallel
+  {
+    try {
+      std::vector<double> column(grid.Mz()); // per-thread scratch space
+
+      for (Points p(grid, thread_index(), thread_count()); p; p.next()) {
+        const int i = p.i(), j = p.j();
+        field(i,j) = value;
+      }
+    } catch (...) {
+      loop.failed();
+    }
+  }
+  loop.check();
+  \endcode
 */
 class IceGrid {
 public:
@@ -238,6 +263,12 @@ public:
 
   petsc::DM::Ptr get_dm(int dm_dof, int stencil_width) const;
 
+  void allocate_vec(int dm_dof, int stencil_width, bool ghosted, Vec *result) const;
+  void release_vec(int dm_dof, int stencil_width, bool ghosted, Vec v) const;
+
+  std::shared_ptr<File> input_file(const std::string &filename) const;
+  std::shared_ptr<ForcingReader> forcing_reader(const std::string &filename) const;
+
   void report_parameters() const;
 
   void compute_point_neighbors(double X, double Y,
@@ -353,6 +384,29 @@ public:
     m_done = false;
   }
 
+  /*!
+   * Traverse the `block`-th of `n_blocks` contiguous stripes of grid rows (including ghost
+   * points).
+   *
+   * This is used to split the owned part of the grid between threads:
+   *
+   * `for (PointsWithGhosts p(grid, width, thread_index(), thread_count()); p; p.next()) { ... }`
+   */
+  PointsWithGhosts(const IceGrid &g, unsigned int stencil_width, int block, int n_blocks)
+    : PointsWithGhosts(g, stencil_width) {
+    const int
+      n_rows = m_j_last - m_j_first + 1,
+      chunk  = n_rows / n_blocks,
+      extra  = n_rows % n_blocks,
+      first  = m_j_first + block * chunk + std::min(block, extra),
+      size   = chunk + (block < extra ? 1 : 0);
+
+    m_j_first = first;
+    m_j_last  = first + size - 1;
+    m_j       = m_j_first;
+    m_done    = (size <= 0);
+  }
+
   int i() const {
     return m_i;
   }
@@ -376,7 +430,7 @@ public:
   operator bool() const {
     return not m_done;
   }
-private:
+protected:
   int m_i, m_j;
   int m_i_first, m_i_last, m_j_first, m_j_last;
   bool m_done;
@@ -391,6 +445,108 @@ private:
 class Points : public PointsWithGhosts {
 public:
   Points(const IceGrid &g) : PointsWithGhosts(g, 0) {}
+  Points(const IceGrid &g, int block, int n_blocks) : PointsWithGhosts(g, 0, block, n_blocks) {}
+};
+
+/** Iterator class for traversing grid points owned by the current processor that are at
+ * least `stencil_width` points away from the edge of its sub-domain.
+ *
+ * Computations at these points do not use ghosts, so they can overlap with a ghost update
+ * (see IceModelVec::update_ghosts_begin()). Use PointsBoundary to traverse the rest.
+ *
+ * Usage:
+ *
+ * `for (PointsInterior p(grid, stencil_width); p; p.next()) { ... }`
+ */
+class PointsInterior : public PointsWithGhosts {
+public:
+  PointsInterior(const IceGrid &g, unsigned int stencil_width)
+    : PointsWithGhosts(g, 0) {
+    const int w = stencil_width;
+
+    m_i_first += w;
+    m_i_last  -= w;
+    m_j_first += w;
+    m_j_last  -= w;
+
+    m_i    = m_i_first;
+    m_j    = m_j_first;
+    m_done = (m_i_first > m_i_last or m_j_first > m_j_last);
+  }
+};
+
+/** Iterator class for traversing grid points owned by the current processor that are
+ * within `stencil_width` points from the edge of its sub-domain.
+ *
+ * This is the complement of PointsInterior: together they visit every owned point once.
+ *
+ * Usage:
+ *
+ * `for (PointsBoundary p(grid, stencil_width); p; p.next()) { ... }`
+ */
+class PointsBoundary {
+public:
+  PointsBoundary(const IceGrid &g, unsigned int stencil_width) {
+    const int w = stencil_width;
+
+    m_i_first = g.xs();
+    m_i_last  = g.xs() + g.xm() - 1;
+    m_j_first = g.ys();
+    m_j_last  = g.ys() + g.ym() - 1;
+
+    m_interior_i_first = m_i_first + w;
+    m_interior_i_last  = m_i_last - w;
+    m_interior_j_first = m_j_first + w;
+    m_interior_j_last  = m_j_last - w;
+
+    m_i = m_i_first;
+    m_j = m_j_first;
+    m_done = false;
+
+    if (interior(m_i, m_j)) {
+      next();
+    }
+  }
+
+  int i() const {
+    return m_i;
+  }
+  int j() const {
+    return m_j;
+  }
+
+  void next() {
+    assert(not m_done);
+    do {
+      if (interior(m_i, m_j)) {
+        // skip the interior part of this row
+        m_i = m_interior_i_last;
+      }
+      m_i += 1;
+      if (m_i > m_i_last) {
+        m_i = m_i_first;        // wrap around
+        m_j += 1;
+      }
+      if (m_j > m_j_last) {
+        m_j = m_j_first;        // ensure that indexes are valid
+        m_done = true;
+      }
+    } while (not m_done and interior(m_i, m_j));
+  }
+
+  operator bool() const {
+    return not m_done;
+  }
+private:
+  bool interior(int i, int j) const {
+    return (i >= m_interior_i_first and i <= m_interior_i_last and
+            j >= m_interior_j_first and j <= m_interior_j_last);
+  }
+
+  int m_i, m_j;
+  int m_i_first, m_i_last, m_j_first, m_j_last;
+  int m_interior_i_first, m_interior_i_last, m_interior_j_first, m_interior_j_last;
+  bool m_done;
 };
 
 } // end of namespace pism
@@ -157,6 +157,9 @@ inline double& IceModelVec3D::operator() (int i, int j, int k) {
 #if (Pism_DEBUG==1)
   check_array_indices(i, j, k);
 #endif
+  if (m_precision != DOUBLE_PRECISION) {
+    single_precision_access_error();
+  }
   return static_cast<double***>(m_array)[j][i][k];
 }
 
@@ -164,6 +167,9 @@ inline const double& IceModelVec3D::operator() (int i, int j, int k) const {
 #if (Pism_DEBUG==1)
   check_array_indices(i, j, k);
 #endif
+  if (m_precision != DOUBLE_PRECISION) {
+    single_precision_access_error();
+  }
   return static_cast<double***>(m_array)[j][i][k];
 }
 
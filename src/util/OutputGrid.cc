@@ -0,0 +1,369 @@
+/* Copyright (C) 2019 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::min, std::max
+#include <cstdlib>              // strtod
+
+#include "OutputGrid.hh"
+#include "pism/util/iceModelVec3Custom.hh"
+#include "pism/util/ConfigInterface.hh"
+#include "pism/util/Context.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/pism_utilities.hh"
+#include "pism/util/petscwrappers/Vec.hh"
+
+namespace pism {
+
+//! Find indexes of the first and last points of `x` within `range` (all of `x` if
+//! `range` is empty).
+static void index_range(const std::vector<double> &x, const std::vector<double> &range,
+                        int &first, int &last) {
+  first = 0;
+  last  = x.size() - 1;
+
+  if (range.empty()) {
+    return;
+  }
+
+  while (first < (int)x.size() and x[first] < range[0]) {
+    first++;
+  }
+
+  while (last >= 0 and x[last] > range[1]) {
+    last--;
+  }
+
+  if (first > last) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "the range [%f, %f] does not contain any grid points",
+                                  range[0], range[1]);
+  }
+}
+
+//! Compute the number of points, the center and the half-width of an output grid axis.
+static void output_axis(const std::vector<double> &x, int first, int last,
+                        unsigned int factor, OutputGrid::Method method,
+                        GridRegistration registration,
+                        unsigned int &M, double &center, double &half_width) {
+  const double
+    dx      = x[1] - x[0],
+    spacing = factor * dx,
+    // coordinate of the first output grid point: the first point of a block or its center
+    x_first = x[first] + (method == OutputGrid::AVERAGE ? 0.5 * (factor - 1) * dx : 0.0);
+
+  M      = (last - first) / factor + 1;
+  center = x_first + 0.5 * (M - 1) * spacing;
+
+  if (registration == CELL_CENTER) {
+    half_width = 0.5 * M * spacing;
+  } else {
+    half_width = 0.5 * (M - 1) * spacing;
+  }
+}
+
+/*!
+ * @param[in] grid computational grid
+ * @param[in] method method used to compute values on the output grid
+ * @param[in] factor coarsening factor (1 means "no coarsening")
+ * @param[in] x_range `{min, max}` x coordinates of the region (empty: the whole domain)
+ * @param[in] y_range `{min, max}` y coordinates of the region (empty: the whole domain)
+ */
+OutputGrid::OutputGrid(IceGrid::ConstPtr grid, Method method, unsigned int factor,
+                       const std::vector<double> &x_range, const std::vector<double> &y_range)
+  : m_input_grid(grid), m_method(method), m_factor(factor) {
+
+  if (factor < 1) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "invalid coarsening factor: %d", (int)factor);
+  }
+
+  if (not (x_range.empty() or x_range.size() == 2) or
+      not (y_range.empty() or y_range.size() == 2)) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "x and y ranges have to have two elements (min,max)");
+  }
+
+  try {
+    index_range(grid->x(), x_range, m_i0, m_i1);
+    index_range(grid->y(), y_range, m_j0, m_j1);
+
+    GridParameters P(grid->ctx()->config());
+
+    P.registration = grid->registration();
+    P.periodicity  = NOT_PERIODIC;
+    P.z            = grid->z();
+
+    output_axis(grid->x(), m_i0, m_i1, factor, method, P.registration, P.Mx, P.x0, P.Lx);
+    output_axis(grid->y(), m_j0, m_j1, factor, method, P.registration, P.My, P.y0, P.Ly);
+
+    P.ownership_ranges_from_options(grid->size());
+    P.validate();
+
+    m_grid = IceGrid::ConstPtr(new IceGrid(grid->ctx(), P));
+  } catch (RuntimeError &e) {
+    e.add_context("creating the output grid");
+    throw;
+  }
+}
+
+//! Parse a string containing a comma-separated range ("min,max").
+static std::vector<double> parse_range(const std::string &input) {
+  std::vector<double> result;
+
+  if (input.empty()) {
+    return result;
+  }
+
+  for (auto token : split(input, ',')) {
+    char *endptr = NULL;
+    double value = strtod(token.c_str(), &endptr);
+    if (token.empty() or *endptr != '\0') {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "cannot parse '%s' (expected min,max)", input.c_str());
+    }
+    result.push_back(value);
+  }
+
+  if (result.size() != 2 or result[0] >= result[1]) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "invalid range '%s' (expected min,max with min < max)",
+                                  input.c_str());
+  }
+
+  return result;
+}
+
+//! Create the output grid for spatially-variable diagnostics using configuration
+//! parameters `output.extra.grid.*`.
+/*!
+ * Returns an empty pointer if the output grid would be the same as `grid`.
+ */
+std::shared_ptr<OutputGrid> OutputGrid::FromConfig(IceGrid::ConstPtr grid) {
+  auto config = grid->ctx()->config();
+
+  int factor = config->get_number("output.extra.grid.factor");
+  std::string
+    method  = config->get_string("output.extra.grid.method"),
+    x_range = config->get_string("output.extra.grid.x_range"),
+    y_range = config->get_string("output.extra.grid.y_range");
+
+  if (factor == 1 and x_range.empty() and y_range.empty()) {
+    return std::shared_ptr<OutputGrid>();
+  }
+
+  if (factor < 1) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "output.extra.grid.factor = %d is invalid (has to be 1 or greater)",
+                                  factor);
+  }
+
+  return std::shared_ptr<OutputGrid>(new OutputGrid(grid,
+                                                    method == "stride" ? STRIDE : AVERAGE,
+                                                    factor,
+                                                    parse_range(x_range),
+                                                    parse_range(y_range)));
+}
+
+IceGrid::ConstPtr OutputGrid::grid() const {
+  return m_grid;
+}
+
+//! Compute values of `input` on the output grid.
+/*!
+ * This is a collective operation.
+ */
+IceModelVec::Ptr OutputGrid::map(const IceModelVec &input) const {
+  PetscErrorCode ierr;
+
+  const unsigned int
+    dof = input.ndof(),
+    // number of values per grid point
+    B   = dof * input.levels().size();
+
+  // allocate the result and copy metadata
+  IceModelVec::Ptr result;
+  if (input.ndims() == 3) {
+    const VariableMetadata &z = input.metadata().get_z();
+    result.reset(new IceModelVec3Custom(m_grid, input.get_name(), z.get_name(),
+                                        input.levels(), z.get_all_strings()));
+  } else {
+    result.reset(new IceModelVec2(m_grid, input.get_name(), WITHOUT_GHOSTS, 1, dof));
+  }
+
+  for (unsigned int k = 0; k < dof; ++k) {
+    result->metadata(k) = input.metadata(k);
+  }
+
+  // fill values (in internal units) are excluded from averages
+  std::vector<bool> has_fill(dof, false);
+  std::vector<double> fill(dof, 0.0);
+  for (unsigned int k = 0; k < dof; ++k) {
+    const SpatialVariableMetadata &m = input.metadata(k);
+
+    if (m.has_attribute("_FillValue")) {
+      std::string
+        units               = m.get_string("units"),
+        glaciological_units = m.get_string("glaciological_units");
+
+      has_fill[k] = true;
+      fill[k]     = m.get_number("_FillValue");
+
+      if (not glaciological_units.empty() and glaciological_units != units) {
+        fill[k] = units::convert(m.unit_system(), fill[k], glaciological_units, units);
+      }
+    }
+  }
+
+  // masks have to be sampled
+  const bool sample = (m_method == STRIDE or input.metadata().has_attribute("flag_values"));
+
+  const int
+    s  = m_factor,
+    Mx = m_grid->Mx();
+
+  petsc::Vec sum, count;
+  ierr = DMDACreateNaturalVector(*result->dm(), sum.rawptr());
+  PISM_CHK(ierr, "DMDACreateNaturalVector");
+
+  ierr = VecDuplicate(sum, count.rawptr());
+  PISM_CHK(ierr, "VecDuplicate");
+
+  ierr = VecSet(sum, 0.0);
+  PISM_CHK(ierr, "VecSet");
+
+  ierr = VecSet(count, 0.0);
+  PISM_CHK(ierr, "VecSet");
+
+  // compute partial block sums using points owned by this rank
+  const IceGrid &grid = *m_input_grid;
+  const int
+    i_start = std::max(grid.xs(), m_i0),
+    i_end   = std::min(grid.xs() + grid.xm() - 1, m_i1),
+    j_start = std::max(grid.ys(), m_j0),
+    j_end   = std::min(grid.ys() + grid.ym() - 1, m_j1);
+
+  if (i_start <= i_end and j_start <= j_end) {
+    const int
+      I0 = (i_start - m_i0) / s,
+      I1 = (i_end - m_i0) / s,
+      J0 = (j_start - m_j0) / s,
+      J1 = (j_end - m_j0) / s,
+      nI = I1 - I0 + 1,
+      nJ = J1 - J0 + 1;
+
+    std::vector<double> S(nI * nJ * B, 0.0), C(nI * nJ * B, 0.0);
+
+    {
+      // Note: the input is not modified; we need a Vec to get access to its array
+      petsc::DMDAVecArrayDOF array(input.dm(), const_cast<IceModelVec&>(input).vec());
+      double ***a = static_cast<double***>(array.get());
+
+      for (int j = j_start; j <= j_end; ++j) {
+        for (int i = i_start; i <= i_end; ++i) {
+          const int
+            I = (i - m_i0) / s,
+            J = (j - m_j0) / s;
+
+          if (sample) {
+            int i_s = m_i0 + I * s, j_s = m_j0 + J * s;
+            if (m_method == AVERAGE) {
+              // use the center of a block
+              i_s = std::min(i_s + (s - 1) / 2, m_i1);
+              j_s = std::min(j_s + (s - 1) / 2, m_j1);
+            }
+
+            if (i != i_s or j != j_s) {
+              continue;
+            }
+          }
+
+          const size_t offset = ((J - J0) * nI + (I - I0)) * B;
+          for (unsigned int b = 0; b < B; ++b) {
+            const double v = a[j][i][b];
+            const unsigned int k = b % dof;
+
+            if (not sample and has_fill[k] and v == fill[k]) {
+              continue;
+            }
+
+            S[offset + b] += v;
+            C[offset + b] += 1.0;
+          }
+        }
+      }
+    }
+
+    // indexes of values in the natural ordering
+    std::vector<PetscInt> index(nI * nJ * B);
+    for (int J = J0; J <= J1; ++J) {
+      for (int I = I0; I <= I1; ++I) {
+        const size_t offset = ((J - J0) * nI + (I - I0)) * B;
+        for (unsigned int b = 0; b < B; ++b) {
+          index[offset + b] = ((PetscInt)J * Mx + I) * B + b;
+        }
+      }
+    }
+
+    ierr = VecSetValues(sum, index.size(), index.data(), S.data(), ADD_VALUES);
+    PISM_CHK(ierr, "VecSetValues");
+
+    ierr = VecSetValues(count, index.size(), index.data(), C.data(), ADD_VALUES);
+    PISM_CHK(ierr, "VecSetValues");
+  }
+
+  // add up contributions from all ranks
+  ierr = VecAssemblyBegin(sum);
+  PISM_CHK(ierr, "VecAssemblyBegin");
+  ierr = VecAssemblyEnd(sum);
+  PISM_CHK(ierr, "VecAssemblyEnd");
+
+  ierr = VecAssemblyBegin(count);
+  PISM_CHK(ierr, "VecAssemblyBegin");
+  ierr = VecAssemblyEnd(count);
+  PISM_CHK(ierr, "VecAssemblyEnd");
+
+  // compute averages
+  {
+    PetscInt start = 0, end = 0;
+    ierr = VecGetOwnershipRange(sum, &start, &end);
+    PISM_CHK(ierr, "VecGetOwnershipRange");
+
+    petsc::VecArray S(sum), C(count);
+    double *s_values = S.get(), *c_values = C.get();
+
+    for (PetscInt n = 0; n < end - start; ++n) {
+      const unsigned int k = ((start + n) % B) % dof;
+
+      if (c_values[n] > 0.0) {
+        s_values[n] /= c_values[n];
+      } else {
+        s_values[n] = has_fill[k] ? fill[k] : 0.0;
+      }
+    }
+  }
+
+  ierr = DMDANaturalToGlobalBegin(*result->dm(), sum, INSERT_VALUES, result->vec());
+  PISM_CHK(ierr, "DMDANaturalToGlobalBegin");
+
+  ierr = DMDANaturalToGlobalEnd(*result->dm(), sum, INSERT_VALUES, result->vec());
+  PISM_CHK(ierr, "DMDANaturalToGlobalEnd");
+
+  return result;
+}
+
+} // end of namespace pism
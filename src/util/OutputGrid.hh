@@ -0,0 +1,74 @@
+/* Copyright (C) 2019 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _OUTPUTGRID_H_
+#define _OUTPUTGRID_H_
+
+#include <vector>
+
+#include "pism/util/IceGrid.hh"
+#include "pism/util/iceModelVec.hh"
+
+namespace pism {
+
+//! A coarser and/or smaller grid used to write spatially-variable diagnostics.
+/*!
+ * The output grid covers a rectangular region of the computational grid (the whole
+ * domain by default). Each point of the output grid corresponds to a `factor` by `factor`
+ * block of points of the computational grid.
+ *
+ * map() computes values on the output grid in parallel:
+ *
+ * - AVERAGE uses the average over each block (ignoring values equal to the
+ *   `_FillValue`). Fields with the `flag_values` attribute (masks) are sampled at the
+ *   center of each block instead.
+ *
+ * - STRIDE uses the value at the first point (lower left corner) of each block.
+ *
+ * Each rank computes (partial) block sums using points it owns; these are added up using
+ * a PETSc Vec in the "natural" ordering and scattered to the distributed output field.
+ */
+class OutputGrid {
+public:
+  enum Method {AVERAGE, STRIDE};
+
+  OutputGrid(IceGrid::ConstPtr grid, Method method, unsigned int factor,
+             const std::vector<double> &x_range, const std::vector<double> &y_range);
+
+  static std::shared_ptr<OutputGrid> FromConfig(IceGrid::ConstPtr grid);
+
+  IceGrid::ConstPtr grid() const;
+
+  IceModelVec::Ptr map(const IceModelVec &input) const;
+private:
+  //! computational grid
+  IceGrid::ConstPtr m_input_grid;
+  //! output grid
+  IceGrid::ConstPtr m_grid;
+
+  Method m_method;
+  unsigned int m_factor;
+
+  //! indexes of the first and last points of the computational grid in the region
+  int m_i0, m_i1, m_j0, m_j1;
+};
+
+} // end of namespace pism
+
+#endif /* _OUTPUTGRID_H_ */
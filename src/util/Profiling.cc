@@ -1,4 +1,4 @@
-/* Copyright (C) 2015, 2016 PISM Authors
+/* Copyright (C) 2015, 2016, 2026 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -18,15 +18,23 @@
  */
 
 #include <petscviewer.h>
+#include <cstdio>
+#include <sstream>
 
 #include "Profiling.hh"
 #include "error_handling.hh"
+#include "pism_utilities.hh"
 
 namespace pism {
 
+// Communication counters are per-process: global reductions do not have access to a
+// Context.
+static Profiling::Communication communication_counters;
+
 // PETSc profiling events
 
-Profiling::Profiling() {
+Profiling::Profiling()
+  : m_timeline(false), m_step_start(0.0) {
   PetscErrorCode ierr = PetscClassIdRegister("PISM", &m_classid);
   PISM_CHK(ierr, "PetscClassIdRegister");
 }
@@ -85,6 +93,10 @@ void Profiling::begin(const char * name) const {
   }
   ierr = PetscLogEventBegin(event, 0, 0, 0, 0);
   PISM_CHK(ierr, "PetscLogEventBegin");
+
+  if (m_timeline) {
+    m_event_start[name] = get_time();
+  }
 }
 
 void Profiling::end(const char * name) const {
@@ -97,6 +109,12 @@ void Profiling::end(const char * name) const {
   }
   PetscErrorCode ierr = PetscLogEventEnd(event, 0, 0, 0, 0);
   PISM_CHK(ierr, "PetscLogEventEnd");
+
+  if (m_timeline) {
+    auto &totals = m_current[name];
+    totals.count += 1;
+    totals.time  += get_time() - m_event_start[name];
+  }
 }
 
 void Profiling::stage_begin(const char * name) const {
@@ -121,4 +139,136 @@ void Profiling::stage_end(const char * name) const {
   PISM_CHK(ierr, "PetscLogStagePop");
 }
 
+//! Start collecting wall clock times of profiling events for each time step.
+/*!
+ * Events (see begin() and end()) are accumulated until the next call of record_step().
+ */
+void Profiling::start_timeline() const {
+  m_timeline = true;
+  m_step_start = get_time();
+  m_current.clear();
+  communication_counters = Communication();
+}
+
+//! Save event totals and communication counters for a time step and reset them.
+void Profiling::record_step(int step, double time) const {
+  if (not m_timeline) {
+    return;
+  }
+
+  double now = get_time();
+
+  Step s;
+  s.step          = step;
+  s.time          = time;
+  s.wall_clock    = now - m_step_start;
+  s.events        = m_current;
+  s.communication = communication_counters;
+
+  m_steps.push_back(s);
+
+  m_step_start = now;
+  m_current.clear();
+  communication_counters = Communication();
+}
+
+//! Count a ghost update transferring `bytes` bytes.
+void Profiling::count_ghost_update(size_t bytes) {
+  communication_counters.ghost_updates += 1;
+  communication_counters.ghost_bytes   += bytes;
+}
+
+//! Count a global reduction of `bytes` bytes.
+void Profiling::count_reduction(size_t bytes) {
+  communication_counters.reductions      += 1;
+  communication_counters.reduction_bytes += bytes;
+}
+
+//! Convert the timeline of one rank to JSON.
+static std::string timeline_json(int rank, const std::vector<Profiling::Step> &steps) {
+  std::ostringstream out;
+
+  out.precision(9);
+
+  out << "    {\"rank\": " << rank << ", \"steps\": [";
+  for (size_t k = 0; k < steps.size(); ++k) {
+    const auto &s = steps[k];
+    const auto &c = s.communication;
+
+    out << (k > 0 ? "," : "") << "\n      "
+        << "{\"step\": " << s.step << ", "
+        << "\"time\": " << s.time << ", "
+        << "\"wall_clock\": " << s.wall_clock << ", "
+        << "\"ghost_updates\": " << c.ghost_updates << ", "
+        << "\"ghost_bytes\": " << c.ghost_bytes << ", "
+        << "\"reductions\": " << c.reductions << ", "
+        << "\"reduction_bytes\": " << c.reduction_bytes << ", "
+        << "\"events\": {";
+
+    bool first = true;
+    for (const auto &e : s.events) {
+      out << (first ? "" : ", ")
+          << "\"" << e.first << "\": "
+          << "{\"count\": " << e.second.count << ", \"time\": " << e.second.time << "}";
+      first = false;
+    }
+    out << "}}";
+  }
+  out << "]}";
+
+  return out.str();
+}
+
+//! Gather timelines from all ranks in `com` and save them to a JSON file.
+/*!
+ * The file contains a list of ranks; each rank has a list of time steps. For each step we
+ * save the model time, the wall clock time of the step, wall clock times and numbers of
+ * calls of all profiling events, and the number (and total size) of ghost updates and
+ * global reductions.
+ */
+void Profiling::report_timeline(MPI_Comm com, const std::string &filename) const {
+  int rank = 0, size = 1;
+  MPI_Comm_rank(com, &rank);
+  MPI_Comm_size(com, &size);
+
+  std::string local = timeline_json(rank, m_steps);
+
+  int length = local.size();
+  std::vector<int> lengths(size), offsets(size);
+
+  int err = MPI_Gather(&length, 1, MPI_INT, lengths.data(), 1, MPI_INT, 0, com);
+  PISM_C_CHK(err, 0, "MPI_Gather");
+
+  int total = 0;
+  for (int r = 0; r < size; ++r) {
+    offsets[r] = total;
+    total += lengths[r];
+  }
+
+  std::vector<char> buffer(rank == 0 ? total + 1 : 1, '\0');
+
+  err = MPI_Gatherv(&local[0], length, MPI_CHAR,
+                    buffer.data(), lengths.data(), offsets.data(), MPI_CHAR, 0, com);
+  PISM_C_CHK(err, 0, "MPI_Gatherv");
+
+  if (rank != 0) {
+    return;
+  }
+
+  FILE *f = fopen(filename.c_str(), "w");
+  if (f == NULL) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "failed to open %s for writing", filename.c_str());
+  }
+
+  fprintf(f, "{\n  \"ranks\": %d,\n  \"timeline\": [\n", size);
+  for (int r = 0; r < size; ++r) {
+    fwrite(buffer.data() + offsets[r], 1, lengths[r], f);
+    fputs(r + 1 < size ? ",\n" : "\n", f);
+  }
+  fputs("  ]\n}\n", f);
+
+  fclose(f);
+}
+
 } // end of namespace pism
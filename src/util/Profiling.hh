@@ -1,4 +1,4 @@
-/* Copyright (C) 2015 PISM Authors
+/* Copyright (C) 2015, 2026 PISM Authors
  *
  * This file is part of PISM.
  *
@@ -22,6 +22,8 @@
 
 #include <map>
 #include <string>
+#include <vector>
+#include <mpi.h>
 #include <petsclog.h>
 
 namespace pism {
@@ -35,10 +37,46 @@ public:
   void end(const char *name) const;
   void stage_begin(const char *name) const;
   void stage_end(const char *name) const;
+
+  void start_timeline() const;
+  void record_step(int step, double time) const;
+  void report_timeline(MPI_Comm com, const std::string &filename) const;
+
+  static void count_ghost_update(size_t bytes);
+  static void count_reduction(size_t bytes);
+
+  //! Wall clock time and the number of calls of an event during one time step.
+  struct EventTotals {
+    EventTotals() : count(0), time(0.0) {}
+    int count;
+    double time;
+  };
+
+  //! Communication counters (on one rank).
+  struct Communication {
+    Communication() : ghost_updates(0), ghost_bytes(0), reductions(0), reduction_bytes(0) {}
+    unsigned long ghost_updates, ghost_bytes, reductions, reduction_bytes;
+  };
+
+  //! Profiling data collected during one time step (on one rank).
+  struct Step {
+    int step;
+    double time;
+    double wall_clock;
+    std::map<std::string, EventTotals> events;
+    Communication communication;
+  };
 private:
   PetscClassId m_classid;
   mutable std::map<std::string, PetscLogEvent> m_events;
   mutable std::map<std::string, PetscLogStage> m_stages;
+
+  // per-step timeline
+  mutable bool m_timeline;
+  mutable double m_step_start;
+  mutable std::map<std::string, double> m_event_start;
+  mutable std::map<std::string, EventTotals> m_current;
+  mutable std::vector<Step> m_steps;
 };
 
 } // end of namespace pism
@@ -0,0 +1,136 @@
+/* Copyright (C) 2019 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <algorithm>            // std::min, std::max, std::copy
+
+#include "RaggedColumns.hh"
+#include "pism/util/IceGrid.hh"
+
+namespace pism {
+
+RaggedColumns::RaggedColumns(const IceGrid &grid, unsigned int stencil_width,
+                             unsigned int headroom) {
+  const int w = stencil_width;
+
+  m_i0       = grid.xs() - w;
+  m_j0       = grid.ys() - w;
+  m_nx       = grid.xm() + 2 * w;
+  m_ny       = grid.ym() + 2 * w;
+  m_Mz       = grid.Mz();
+  m_headroom = headroom;
+
+  const size_t n_columns = m_nx * m_ny;
+
+  m_size.resize(n_columns, 1);
+  m_offset.resize(n_columns + 1, 0);
+
+  pack();
+}
+
+//! Set the number of levels stored in the column `(i, j)`.
+/*!
+ * Takes effect when pack() is called. The number of levels is clipped to `[1, Mz]`.
+ *
+ * Different threads can set sizes of different columns at the same time.
+ */
+void RaggedColumns::set_size(int i, int j, unsigned int n_levels) {
+  m_size[index(i, j)] = std::max(1U, std::min(n_levels, m_Mz));
+}
+
+//! Make sure that all columns have enough space for the number of levels set using
+//! set_size().
+/*!
+ * Re-allocates storage if a column does not fit or if more than half of storage would be
+ * wasted. Values in the levels that fit into the new layout are preserved.
+ */
+void RaggedColumns::pack() {
+  const size_t n_columns = m_size.size();
+
+  bool fits = true;
+  size_t required = 0;
+  for (size_t k = 0; k < n_columns; ++k) {
+    const size_t capacity = m_offset[k + 1] - m_offset[k];
+
+    fits = fits and m_size[k] <= capacity;
+
+    required += std::min(m_size[k] + m_headroom, m_Mz);
+  }
+
+  if (fits and m_values.size() <= 2 * required) {
+    return;
+  }
+
+  std::vector<size_t> offset(n_columns + 1, 0);
+  for (size_t k = 0; k < n_columns; ++k) {
+    offset[k + 1] = offset[k] + std::min(m_size[k] + m_headroom, m_Mz);
+  }
+
+  std::vector<double> values(offset[n_columns], 0.0);
+  for (size_t k = 0; k < n_columns; ++k) {
+    const size_t n = std::min(m_offset[k + 1] - m_offset[k], offset[k + 1] - offset[k]);
+
+    std::copy(m_values.begin() + m_offset[k],
+              m_values.begin() + m_offset[k] + n,
+              values.begin() + offset[k]);
+  }
+
+  m_offset.swap(offset);
+  m_values.swap(values);
+}
+
+//! Copy `n_levels` levels of the column `(i, j)` to `result`.
+/*!
+ * Levels above the ones stored in this column get the value of the top stored level.
+ */
+void RaggedColumns::get_column(int i, int j, unsigned int n_levels, double *result) const {
+  const double *values = column(i, j);
+  const unsigned int
+    N = size(i, j),
+    n = std::min(N, n_levels);
+
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = values[k];
+  }
+
+  for (unsigned int k = n; k < n_levels; ++k) {
+    result[k] = values[N - 1];
+  }
+}
+
+//! Set values stored in the column `(i, j)` (extra `values` are ignored).
+void RaggedColumns::set_column(int i, int j, const std::vector<double> &values) {
+  double *result = column(i, j);
+  const unsigned int n = std::min((size_t)size(i, j), values.size());
+  for (unsigned int k = 0; k < n; ++k) {
+    result[k] = values[k];
+  }
+}
+
+std::vector<double> RaggedColumns::get_column_vector(int i, int j, unsigned int n_levels) const {
+  std::vector<double> result(n_levels);
+  get_column(i, j, n_levels, &result[0]);
+  return result;
+}
+
+//! Number of values allocated on this processor (including headroom).
+size_t RaggedColumns::allocated_size() const {
+  return m_values.size();
+}
+
+} // end of namespace pism
@@ -0,0 +1,118 @@
+/* Copyright (C) 2019 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _RAGGEDCOLUMNS_H_
+#define _RAGGEDCOLUMNS_H_
+
+#include <vector>
+#include <cstddef>              // size_t
+#include <cassert>
+
+namespace pism {
+
+class IceGrid;
+
+//! Storage for a 3D field in which each column contains only the levels it needs.
+/*!
+ * IceModelVec3 stores all `Mz` levels in every column. Most of the domain is usually
+ * ice-free or covered by thin ice, though, and many computations only use levels in the
+ * ice (up to IceGrid::kBelowHeight()). A RaggedColumns object stores columns of different
+ * lengths one after another in one array, so its size and the memory traffic of loops
+ * using it scale with the ice volume rather than with `Mx*My*Mz`.
+ *
+ * Columns cover the sub-domain owned by this processor plus `stencil_width` ghost points.
+ * Ghost values are not communicated, so they have to be computed redundantly (i.e. this is
+ * work space for loops over PointsWithGhosts).
+ *
+ * @code
+ * for (PointsWithGhosts p(grid); p; p.next()) {
+ *   const int i = p.i(), j = p.j();
+ *   columns.set_size(i, j, grid.kBelowHeight(H(i, j)) + 1);
+ * }
+ * columns.pack();
+ *
+ * // now columns.column(i, j) points to columns.size(i, j) values
+ * @endcode
+ *
+ * Each column is allocated with `headroom` extra levels, so pack() moves stored values
+ * only if a column grows by more than that (e.g. because the ice got thicker) or if most
+ * of the storage is no longer used.
+ *
+ * Levels above the ones stored in a column are assumed to have the value of the top
+ * stored level (see get_column()).
+ */
+class RaggedColumns {
+public:
+  RaggedColumns(const IceGrid &grid, unsigned int stencil_width = 1,
+                unsigned int headroom = 2);
+
+  void set_size(int i, int j, unsigned int n_levels);
+  void pack();
+
+  inline unsigned int size(int i, int j) const;
+  inline double* column(int i, int j);
+  inline const double* column(int i, int j) const;
+
+  void get_column(int i, int j, unsigned int n_levels, double *result) const;
+
+  // testing methods (for use from Python)
+  void set_column(int i, int j, const std::vector<double> &values);
+  std::vector<double> get_column_vector(int i, int j, unsigned int n_levels) const;
+
+  size_t allocated_size() const;
+private:
+  inline int index(int i, int j) const;
+
+  //! indices of the first column (including ghosts)
+  int m_i0, m_j0;
+  //! numbers of columns in x and y directions (including ghosts)
+  int m_nx, m_ny;
+  unsigned int m_Mz, m_headroom;
+
+  //! number of levels stored in each column
+  std::vector<unsigned int> m_size;
+  //! offsets of columns in m_values; the capacity of column `k` is `m_offset[k + 1] -
+  //! m_offset[k]`
+  std::vector<size_t> m_offset;
+  std::vector<double> m_values;
+};
+
+inline int RaggedColumns::index(int i, int j) const {
+  assert(i >= m_i0 and i < m_i0 + m_nx);
+  assert(j >= m_j0 and j < m_j0 + m_ny);
+  return (j - m_j0) * m_nx + (i - m_i0);
+}
+
+//! Number of levels stored in the column `(i, j)`.
+inline unsigned int RaggedColumns::size(int i, int j) const {
+  return m_size[index(i, j)];
+}
+
+//! Column `(i, j)`. It contains size(i, j) values (valid after pack()).
+inline double* RaggedColumns::column(int i, int j) {
+  return &m_values[m_offset[index(i, j)]];
+}
+
+inline const double* RaggedColumns::column(int i, int j) const {
+  return &m_values[m_offset[index(i, j)]];
+}
+
+} // end of namespace pism
+
+#endif /* _RAGGEDCOLUMNS_H_ */
@@ -185,24 +185,48 @@ ParallelSection::~ParallelSection() {
 //! @brief Indicates a failure of a parallel section.
 /*!
  * This should be called from a `catch (...) { ... }` block **only**.
+ *
+ * May be called by several threads of the same rank at once (e.g. by OpenMP worker
+ * threads), so it does not make any MPI or PETSc calls: the exception is stored and
+ * reported by check().
  */
 void ParallelSection::failed() {
-  int rank = 0;
-  MPI_Comm_rank(m_com, &rank);
-
-  PetscFPrintf(MPI_COMM_SELF, stderr,
-               "PISM ERROR: Rank %d failed with the following message.\n", rank);
-
-  handle_fatal_errors(MPI_COMM_SELF);
-
-  m_failed = true;
+#pragma omp critical (pism_parallel_section)
+  {
+    m_errors.push_back(std::current_exception());
+    m_failed = true;
+  }
 }
 
 void ParallelSection::reset() {
   m_failed = false;
+  m_errors.clear();
 }
 
+/*!
+ * Prints error messages recorded by failed() and throws if any rank failed.
+ *
+ * This is a collective operation. Call it from the master thread (outside of parallel
+ * regions).
+ */
 void ParallelSection::check() {
+
+  if (not m_errors.empty()) {
+    int rank = 0;
+    MPI_Comm_rank(m_com, &rank);
+
+    for (auto e : m_errors) {
+      PetscFPrintf(MPI_COMM_SELF, stderr,
+                   "PISM ERROR: Rank %d failed with the following message.\n", rank);
+      try {
+        std::rethrow_exception(e);
+      } catch (...) {
+        handle_fatal_errors(MPI_COMM_SELF);
+      }
+    }
+    m_errors.clear();
+  }
+
   int success_flag = m_failed ? 0 : 1;
   int success_flag_global = 0;
 
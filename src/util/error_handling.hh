@@ -21,6 +21,7 @@
 #define _ERROR_HANDLING_H_
 
 #include <mpi.h>                // MPI_Comm
+#include <exception>            // std::exception_ptr
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -76,6 +77,8 @@ public:
   void reset();
 private:
   bool m_failed;
+  //! exceptions caught by failed() (reported by check())
+  std::vector<std::exception_ptr> m_errors;
   MPI_Comm m_com;
 };
 
@@ -46,6 +46,9 @@ IceModelVec::IceModelVec() {
   m_begin_end_access_use_dof = true;
 
   m_has_ghosts = true;
+  m_ghost_update_in_progress = false;
+  m_storage_dof = 0;
+  m_use_storage_pool = false;
 
   m_name = "unintialized variable";
 
@@ -102,6 +105,26 @@ void IceModelVec::inc_state_counter() {
 
 IceModelVec::~IceModelVec() {
   assert(m_access_counter == 0);
+
+  if (m_use_storage_pool and m_storage_dof > 0 and m_v != NULL) {
+    try {
+      m_grid->release_vec(m_storage_dof, m_da_stencil_width, m_has_ghosts, m_v);
+      // the grid owns the Vec now
+      *m_v.rawptr() = NULL;
+    } catch (...) {
+      // m_v will be de-allocated by its destructor
+    }
+  }
+}
+
+//! Return storage of this vector to the grid's pool when it is destroyed.
+/*!
+ * Storage in the pool is re-used by IceModelVecs allocated later (see
+ * IceGrid::allocate_vec()). This is used for short-lived vectors (such as results of
+ * diagnostic computations) to avoid re-allocating them every time.
+ */
+void IceModelVec::use_storage_pool() {
+  m_use_storage_pool = true;
 }
 
 //! Returns true if create() was called and false otherwise.
@@ -543,7 +566,8 @@ void IceModelVec::dump(const char filename[]) const {
   File file(m_grid->com, filename,
             string_to_backend(m_grid->ctx()->config()->get_string("output.format")),
             PISM_READWRITE_CLOBBER,
-            m_grid->ctx()->pio_iosys_id());
+            m_grid->ctx()->pio_iosys_id(),
+            m_grid->ctx()->config()->get_number("output.netcdf3.n_aggregators"));
 
   if (not m_metadata[0].get_time_independent()) {
     io::define_time(file, *m_grid->ctx());
@@ -626,6 +650,31 @@ void  IceModelVec::end_access() const {
   }
 }
 
+//! Number of bytes received during a ghost update of `vec` (used for profiling).
+static size_t ghost_update_size(const IceModelVec &vec) {
+  const IceGrid &grid = *vec.grid();
+
+  // use the number of degrees of freedom of the DM (it is smaller than the number of
+  // levels for 3D fields stored in single precision)
+  PetscInt dof = 1;
+  PetscErrorCode ierr = DMDAGetInfo(*vec.dm(),
+                                    NULL,             // dimension
+                                    NULL, NULL, NULL, // global sizes
+                                    NULL, NULL, NULL, // numbers of processors
+                                    &dof,
+                                    NULL, NULL, NULL, NULL, NULL);
+  PISM_CHK(ierr, "DMDAGetInfo");
+
+  const size_t
+    N        = dof,
+    width    = vec.stencil_width(),
+    xm       = grid.xm(),
+    ym       = grid.ym(),
+    n_ghosts = (xm + 2 * width) * (ym + 2 * width) - xm * ym;
+
+  return n_ghosts * N * sizeof(double);
+}
+
 //! Updates ghost points.
 void  IceModelVec::update_ghosts() {
   PetscErrorCode ierr;
@@ -640,6 +689,51 @@ void  IceModelVec::update_ghosts() {
   
   ierr = DMLocalToLocalEnd(*m_da, m_v, INSERT_VALUES, m_v);
   PISM_CHK(ierr, "DMLocalToLocalEnd");
+
+  Profiling::count_ghost_update(ghost_update_size(*this));
+}
+
+//! Starts updating ghost points.
+/*!
+ * The update has to be finished by calling update_ghosts_end(). Computations that do not
+ * use ghost values (for example at interior points of the sub-domain, see PointsInterior)
+ * can be performed in between.
+ */
+void IceModelVec::update_ghosts_begin() {
+  if (not m_has_ghosts) {
+    return;
+  }
+
+  assert(m_v != NULL);
+
+  if (m_ghost_update_in_progress) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "ghost update of '%s' is already in progress",
+                                  m_name.c_str());
+  }
+
+  PetscErrorCode ierr = DMLocalToLocalBegin(*m_da, m_v, INSERT_VALUES, m_v);
+  PISM_CHK(ierr, "DMLocalToLocalBegin");
+
+  m_ghost_update_in_progress = true;
+}
+
+//! Finishes updating ghost points started by update_ghosts_begin().
+/*!
+ * Does nothing if no ghost update is in progress, so code using ghosts can call this
+ * unconditionally.
+ */
+void IceModelVec::update_ghosts_end() {
+  if (not m_ghost_update_in_progress) {
+    return;
+  }
+
+  PetscErrorCode ierr = DMLocalToLocalEnd(*m_da, m_v, INSERT_VALUES, m_v);
+  PISM_CHK(ierr, "DMLocalToLocalEnd");
+
+  m_ghost_update_in_progress = false;
+
+  Profiling::count_ghost_update(ghost_update_size(*this));
 }
 
 void IceModelVec::global_to_local(petsc::DM::Ptr dm, Vec source, Vec destination) const {
@@ -669,12 +763,16 @@ void  IceModelVec::update_ghosts(IceModelVec &destination) const {
     ierr = DMLocalToLocalEnd(*m_da, m_v, INSERT_VALUES, destination.vec());
     PISM_CHK(ierr, "DMLocalToLocalEnd");
 
+    Profiling::count_ghost_update(ghost_update_size(*this));
+
     return;
   }
 
   if (not m_has_ghosts and destination.m_has_ghosts) {
     global_to_local(destination.dm(), m_v, destination.vec());
 
+    Profiling::count_ghost_update(ghost_update_size(destination));
+
     return;
   }
 
@@ -822,7 +920,8 @@ void IceModelVec::write(const std::string &filename) const {
             filename,
             string_to_backend(m_grid->ctx()->config()->get_string("output.format")),
             PISM_READWRITE,
-            m_grid->ctx()->pio_iosys_id());
+            m_grid->ctx()->pio_iosys_id(),
+            m_grid->ctx()->config()->get_number("output.netcdf3.n_aggregators"));
 
   this->write(file);
 }
@@ -22,6 +22,7 @@
 #include <initializer_list>
 #include <memory>
 #include <cstdint>              // uint64_t
+#include <cassert>
 
 #include <petscvec.h>
 #include <gsl/gsl_interp.h>     // gsl_interp_accel
@@ -41,10 +42,14 @@ namespace pism {
 
 class IceGrid;
 class File;
+class Config;
 
 //! What "kind" of a vector to create: with or without ghosts.
 enum IceModelVecKind {WITHOUT_GHOSTS=0, WITH_GHOSTS=1};
 
+//! Precision used to store values of a 3D field (see IceModelVec3D::set_precision()).
+enum IceModelVecPrecision {DOUBLE_PRECISION=0, SINGLE_PRECISION=1};
+
 struct Range {
   double min, max;
 };
@@ -156,6 +161,25 @@ T interpolate(const F &field, double x, double y) {
   ierr = var.update_ghosts(); CHKERRQ(ierr);
   \endcode
 
+  Ghost updates can be split into two phases to overlap communication with computations
+  that do not need ghosts (see PointsInterior and PointsBoundary):
+
+  \code
+  var.update_ghosts_begin();
+  for (PointsInterior p(grid, 1); p; p.next()) {
+    // uses var(i+1,j), etc
+  }
+  var.update_ghosts_end();
+  for (PointsBoundary p(grid, 1); p; p.next()) {
+    // same as above
+  }
+  \endcode
+
+  Values at grid points owned by the current processor should not be modified between
+  update_ghosts_begin() and update_ghosts_end(). Only one ghost update per DM (i.e. per
+  combination of the number of degrees of freedom and the stencil width) can be in
+  progress at any given time.
+
   ## Reading and writing variables
 
   PISM can read variables either from files with data on a grid matching the
@@ -232,7 +256,7 @@ public:
 
   virtual Range range() const;
   double norm(int n) const;
-  std::vector<double> norm_all(int n) const;
+  virtual std::vector<double> norm_all(int n) const;
   virtual void  add(double alpha, const IceModelVec &x);
   virtual void  squareroot();
   virtual void  shift(double alpha);
@@ -270,12 +294,14 @@ public:
   virtual void  end_access() const;
   virtual void  update_ghosts();
   virtual void  update_ghosts(IceModelVec &destination) const;
+  void update_ghosts_begin();
+  void update_ghosts_end();
 
   petsc::Vec::Ptr allocate_proc0_copy() const;
   void put_on_proc0(Vec onp0) const;
   void get_from_proc0(Vec onp0);
 
-  void  set(double c);
+  virtual void  set(double c);
 
   SpatialVariableMetadata& metadata(unsigned int N = 0);
 
@@ -285,6 +311,8 @@ public:
   void inc_state_counter();
   void set_time_independent(bool flag);
 
+  void use_storage_pool();
+
 protected:
 
   //! If true, report range when regridding.
@@ -310,6 +338,13 @@ protected:
   unsigned int m_dof;                     //!< number of "degrees of freedom" per grid point
   unsigned int m_da_stencil_width;      //!< stencil width supported by the DA
   bool m_has_ghosts;            //!< m_has_ghosts == true means "has ghosts"
+  //! true if update_ghosts_begin() was called but update_ghosts_end() was not
+  bool m_ghost_update_in_progress;
+  //! number of degrees of freedom of the DM used to allocate storage using
+  //! IceGrid::allocate_vec() (0 if storage was allocated some other way)
+  unsigned int m_storage_dof;
+  //! if true, storage is returned to the grid's pool by the destructor
+  bool m_use_storage_pool;
   petsc::DM::Ptr m_da;          //!< distributed mesh manager (DM)
 
   bool m_begin_end_access_use_dof;
@@ -572,6 +607,7 @@ public:
   void set_column(int i, int j, const double *valsIN);
   double* get_column(int i, int j);
   const double* get_column(int i, int j) const;
+  void get_column(int i, int j, double *result) const;
 
   // testing methods (for use from Python)
   void set_column(int i, int j, const std::vector<double> &valsIN);
@@ -582,14 +618,51 @@ public:
 
   inline double& operator() (int i, int j, int k);
   inline const double& operator() (int i, int j, int k) const;
+
+  void set_precision(IceModelVecPrecision precision);
+  IceModelVecPrecision precision() const;
+
+  virtual Range range() const;
+  virtual std::vector<double> norm_all(int n) const;
+  virtual void add(double alpha, const IceModelVec &x);
+  virtual void squareroot();
+  virtual void shift(double alpha);
+  virtual void scale(double alpha);
+  virtual void copy_from(const IceModelVec &source);
+  virtual void set(double c);
+  using IceModelVec::update_ghosts;
+  virtual void update_ghosts(IceModelVec &destination) const;
 protected:
   void allocate(IceGrid::ConstPtr mygrid, const std::string &short_name,
                 IceModelVecKind ghostedp, const std::vector<double> &levels,
                 unsigned int stencil_width = 1);
+
+  virtual void read_impl(const File &nc, unsigned int time);
+  virtual void regrid_impl(const File &nc, RegriddingFlag flag,
+                           double default_value = 0.0);
+  virtual void write_impl(const File &nc) const;
 private:
   gsl_interp_accel *m_bsearch_accel;
+
+  IceModelVecPrecision m_precision;
+
+  float* float_column(int i, int j) const;
+  void single_precision_access_error() const;
+  void unpack_column(int i, int j, double *result) const;
+  double* scratch_column() const;
+  void allocate_storage();
+  void copy_columns(const IceModelVec3D &source);
+  void allocate_copy(IceModelVec3D &result) const;
+
+  //! Scratch space for columns of a single precision field converted to double
+  //! precision: `n_scratch_columns` columns per thread.
+  mutable std::vector<double> m_scratch;
+  //! Index of the scratch column used next (one per thread).
+  mutable std::vector<unsigned int> m_scratch_position;
 };
 
+IceModelVecPrecision storage_precision(const Config &config, const std::string &field);
+
 
 //! Class for a 3d DA-based Vec for ice scalar quantities.
 class IceModelVec3 : public IceModelVec3D {
@@ -443,7 +443,6 @@ void IceModelVec2::set_component(unsigned int n, const IceModelVec2S &source) {
 void IceModelVec2::create(IceGrid::ConstPtr grid, const std::string & name,
                            IceModelVecKind ghostedp,
                            unsigned int stencil_width, int dof) {
-  PetscErrorCode ierr;
   assert(m_v == NULL);
 
   m_dof  = dof;
@@ -458,13 +457,8 @@ void IceModelVec2::create(IceGrid::ConstPtr grid, const std::string & name,
   // initialize the da member:
   m_da = m_grid->get_dm(this->m_dof, this->m_da_stencil_width);
 
-  if (ghostedp) {
-    ierr = DMCreateLocalVector(*m_da, m_v.rawptr());
-    PISM_CHK(ierr, "DMCreateLocalVector");
-  } else {
-    ierr = DMCreateGlobalVector(*m_da, m_v.rawptr());
-    PISM_CHK(ierr, "DMCreateGlobalVector");
-  }
+  m_grid->allocate_vec(m_dof, m_da_stencil_width, ghostedp == WITH_GHOSTS, m_v.rawptr());
+  m_storage_dof = m_dof;
 
   m_has_ghosts = (ghostedp == WITH_GHOSTS);
   m_name       = name;
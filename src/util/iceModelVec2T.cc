@@ -21,6 +21,7 @@
 
 #include "iceModelVec2T.hh"
 #include "pism/util/io/File.hh"
+#include "pism/util/ForcingReader.hh"
 #include "pism_utilities.hh"
 #include "Time.hh"
 #include "IceGrid.hh"
@@ -99,14 +100,20 @@ IceModelVec2T::IceModelVec2T(IceGrid::ConstPtr grid, const std::string &short_na
     m_array3(nullptr),
     m_n_records(n_records),
     m_N(0),
+    m_start(0),
     m_n_evaluations_per_year(n_evaluations_per_year),
     m_first(-1),
+    m_updated_by_group(false),
+    m_group_t(0.0),
+    m_group_dt(0.0),
     m_interp_type(interpolation_type),
     m_period(0),
     m_reference_time(0.0)
 {
   m_report_range = false;
 
+  m_n_prefetch = m_grid->ctx()->config()->get_number("input.forcing.prefetch");
+
   if (not (m_interp_type == PIECEWISE_CONSTANT or
            m_interp_type == LINEAR or
            m_interp_type == LINEAR_PERIODIC)) {
@@ -131,7 +138,9 @@ IceModelVec2T::IceModelVec2T(IceGrid::ConstPtr grid, const std::string &short_na
 }
 
 IceModelVec2T::~IceModelVec2T() {
-  // empty
+  if (m_reader) {
+    m_reader->remove(this);
+  }
 }
 
 unsigned int IceModelVec2T::n_records() {
@@ -167,8 +176,6 @@ void IceModelVec2T::end_access() const {
 
 void IceModelVec2T::init(const std::string &fname, unsigned int period, double reference_time) {
 
-  const Logger &log = *m_grid->ctx()->log();
-
   m_filename       = fname;
   m_period         = period;
   m_reference_time = reference_time;
@@ -176,7 +183,14 @@ void IceModelVec2T::init(const std::string &fname, unsigned int period, double r
   // We find the variable in the input file and
   // try to find the corresponding time dimension.
 
-  File file(m_grid->com, m_filename, PISM_GUESS, PISM_READONLY);
+  if (m_reader) {
+    m_reader->remove(this);
+  }
+  m_reader = m_grid->forcing_reader(m_filename);
+  m_reader->add(this);
+
+  const File &file = m_reader->file();
+
   auto var = file.find_variable(m_metadata[0].get_name(), m_metadata[0].get_string("standard_name"));
   if (not var.exists) {
     throw RuntimeError::formatted(PISM_ERROR_LOCATION, "can't find %s (%s) in %s.",
@@ -190,13 +204,8 @@ void IceModelVec2T::init(const std::string &fname, unsigned int period, double r
 
   if (not time_name.empty()) {
     // we're found the time dimension
-    TimeseriesMetadata time_dimension(time_name, time_name, m_grid->ctx()->unit_system());
-
-    auto time_units = m_grid->ctx()->time()->units_string();
-    time_dimension.set_string("units", time_units);
-
-    io::read_timeseries(file, time_dimension,
-                        *m_grid->ctx()->time(), log, m_time);
+    // times are read once and shared with other fields using the same file
+    m_time = m_reader->times(time_name);
 
     std::string bounds_name = file.read_text_attribute(time_name, "bounds");
 
@@ -213,11 +222,7 @@ void IceModelVec2T::init(const std::string &fname, unsigned int period, double r
         }
 
         // read time bounds data from a file
-        TimeBoundsMetadata tb(bounds_name, time_name, m_grid->ctx()->unit_system());
-        tb.set_string("units", time_units);
-
-        io::read_time_bounds(file, tb, *m_grid->ctx()->time(),
-                             log, m_time_bounds);
+        m_time_bounds = m_reader->time_bounds(bounds_name, time_name);
 
         // time bounds data overrides the time variable: we make t[j] be the
         // left end-point of the j-th interval
@@ -263,7 +268,7 @@ void IceModelVec2T::init(const std::string &fname, unsigned int period, double r
     }
 
     // read periodic data right away (we need to hold it all in memory anyway)
-    update(0);
+    update(0, m_n_records, {this});
   }
 }
 
@@ -272,6 +277,7 @@ void IceModelVec2T::init_constant(double value) {
 
   // set constant value everywhere
   set(value);
+  m_start = 0;
   set_record(0);
 
   // set the time to zero
@@ -284,6 +290,10 @@ void IceModelVec2T::init_constant(double value) {
 }
 
 //! Read some data to make sure that the interval (t, t + dt) is covered.
+/*!
+ * Also reads up to `m_n_prefetch` records following the ones in memory (if there is room
+ * in the buffer after discarding records preceding `t`).
+ */
 void IceModelVec2T::update(double t, double dt) {
 
   if (m_filename.empty()) {
@@ -291,8 +301,15 @@ void IceModelVec2T::update(double t, double dt) {
     return;
   }
 
+  if (m_updated_by_group and t == m_group_t and dt == m_group_dt) {
+    // another field reading from the same file did this already
+    m_updated_by_group = false;
+    return;
+  }
+  m_updated_by_group = false;
+
   if (m_time_bounds.size() == 0) {
-    update(0);
+    update(0, m_n_records, {this});
     return;
   }
 
@@ -301,17 +318,13 @@ void IceModelVec2T::update(double t, double dt) {
     return;
   }
 
-  if (m_N > 0) {
-    unsigned int last = m_first + (m_N - 1);
-
-    // find the interval covered by data held in memory:
-    double
-      t0 = m_time_bounds[m_first * 2],
-      t1 = m_time_bounds[last * 2 + 1];
-
-    // just return if we have all the data we need:
-    if (t >= t0 and t + dt <= t1) {
-      return;
+  // Fields in this group would make the same decisions below, so we update all of them.
+  auto fields = group();
+  for (auto f : fields) {
+    if (f != this) {
+      f->m_updated_by_group = true;
+      f->m_group_t          = t;
+      f->m_group_dt         = dt;
     }
   }
 
@@ -330,11 +343,85 @@ void IceModelVec2T::update(double t, double dt) {
                                   N, m_name.c_str(), m_n_records);
   }
 
-  update(first);
+  if (m_N > 0) {
+    unsigned int last_in_memory = m_first + (m_N - 1);
+
+    // find the interval covered by data held in memory:
+    double
+      t0 = m_time_bounds[m_first * 2],
+      t1 = m_time_bounds[last_in_memory * 2 + 1];
+
+    // we have all the data we need: read ahead
+    if (t >= t0 and t + dt <= t1) {
+      if (m_n_prefetch > 0 and first >= static_cast<unsigned int>(m_first)) {
+        update(first, m_n_prefetch, fields);
+      }
+      return;
+    }
+  }
+
+  update(first, m_n_records, fields);
+}
+
+//! Fields that read from the same file, use the same time axis and have the same records
+//! in memory (including this one).
+std::vector<IceModelVec2T*> IceModelVec2T::group() {
+  std::vector<IceModelVec2T*> result = {this};
+
+  if (not m_reader) {
+    return result;
+  }
+
+  for (auto f : m_reader->fields()) {
+    if (f != this and
+        f->m_period == m_period and
+        f->m_interp_type == m_interp_type and
+        f->m_n_records == m_n_records and
+        f->m_n_prefetch == m_n_prefetch and
+        f->m_first == m_first and
+        f->m_N == m_N and
+        f->m_time == m_time and
+        f->m_time_bounds == m_time_bounds) {
+      result.push_back(f);
+    }
+  }
+
+  return result;
+}
+
+//! Position of the record `n` (counting from the first record in memory) in the circular
+//! buffer.
+unsigned int IceModelVec2T::position(unsigned int n) const {
+  return (m_start + n) % m_n_records;
+}
+
+//! Discard records preceding the in-file record `start` (all records if `start` is not
+//! in memory). Returns the number of records kept.
+unsigned int IceModelVec2T::keep(unsigned int start) {
+  unsigned int kept = 0;
+  if (m_first >= 0 and m_N > 0) {
+    unsigned int last = m_first + (m_N - 1);
+    if ((start >= (unsigned int)m_first) && (start <= last)) {
+      discard(start - m_first);
+      kept = m_N;
+    } else {
+      m_N     = 0;
+      m_start = 0;
+    }
+  }
+  m_first = start;
+
+  return kept;
 }
 
-//! Update by reading at most n_records records from the file.
-void IceModelVec2T::update(unsigned int start) {
+//! Make sure that records `start` through `start + count - 1` are in memory (if there is
+//! room), updating all `fields` (which have to have the same records in memory).
+/*!
+ * Fields are read one record at a time: all the variables in a record are read before
+ * moving on to the next one.
+ */
+void IceModelVec2T::update(unsigned int start, unsigned int count,
+                           const std::vector<IceModelVec2T*> &fields) {
 
   unsigned int time_size = (int)m_time.size();
 
@@ -343,102 +430,88 @@ void IceModelVec2T::update(unsigned int start) {
                                   "IceModelVec2T::update(int start): start = %d is invalid", start);
   }
 
-  unsigned int missing = std::min(m_n_records, time_size - start);
-
-  if (start == static_cast<unsigned int>(m_first)) {
-    // nothing to do
-    return;
+  unsigned int kept = 0;
+  for (auto f : fields) {
+    kept = f->keep(start);
   }
 
-  int kept = 0;
-  if (m_first >= 0) {
-    unsigned int last = m_first + (m_N - 1);
-    if ((m_N > 0) && (start >= (unsigned int)m_first) && (start <= last)) {
-      int discarded = start - m_first;
-      kept = last - start + 1;
-      discard(discarded);
-      missing -= kept;
-      start += kept;
-      m_first += discarded;
-    } else {
-      m_first = start;
-    }
-  } else {
-    m_first = start;
-  }
+  unsigned int missing = std::min(std::min(count, m_n_records - kept),
+                                  time_size - (start + kept));
 
-  if (missing <= 0) {
+  if (missing == 0) {
     return;
   }
 
-  m_N = kept + missing;
+  start += kept;
 
   Time::ConstPtr t = m_grid->ctx()->time();
 
   Logger::ConstPtr log = m_grid->ctx()->log();
-  if (this->n_records() > 1) {
-    log->message(4,
-               "  reading \"%s\" into buffer\n"
-               "          (short_name = %s): %d records, time intervals (%s, %s) through (%s, %s)...\n",
-               metadata().get_string("long_name").c_str(), m_name.c_str(), missing,
-               t->date(m_time_bounds[start*2]).c_str(),
-               t->date(m_time_bounds[start*2 + 1]).c_str(),
-               t->date(m_time_bounds[(start + missing - 1)*2]).c_str(),
-               t->date(m_time_bounds[(start + missing - 1)*2 + 1]).c_str());
-    m_report_range = false;
-  } else {
-    m_report_range = true;
+  for (auto f : fields) {
+    if (f->n_records() > 1) {
+      log->message(4,
+                   "  reading \"%s\" into buffer\n"
+                   "          (short_name = %s): %d records, time intervals (%s, %s) through (%s, %s)...\n",
+                   f->metadata().get_string("long_name").c_str(), f->m_name.c_str(), missing,
+                   t->date(m_time_bounds[start*2]).c_str(),
+                   t->date(m_time_bounds[start*2 + 1]).c_str(),
+                   t->date(m_time_bounds[(start + missing - 1)*2]).c_str(),
+                   t->date(m_time_bounds[(start + missing - 1)*2 + 1]).c_str());
+      f->m_report_range = false;
+    } else {
+      f->m_report_range = true;
+    }
   }
 
-  File file(m_grid->com, m_filename, PISM_GUESS, PISM_READONLY);
-
-  const bool allow_extrapolation = m_grid->ctx()->config()->get_flag("grid.allow_extrapolation");
-
   for (unsigned int j = 0; j < missing; ++j) {
-    {
-      petsc::VecArray tmp_array(m_v);
-      io::regrid_spatial_variable(m_metadata[0], *m_grid, file, start + j, CRITICAL,
-                                  m_report_range, allow_extrapolation,
-                                  0.0, m_interpolation_type, tmp_array.get());
+    for (auto f : fields) {
+      f->read_record(start + j, kept + j);
     }
+  }
 
-    m_grid->ctx()->log()->message(5, " %s: reading entry #%02d, year %s...\n",
-                                  m_name.c_str(),
-                                  start + j,
-                                  t->date(m_time[start + j]).c_str());
-
-    set_record(kept + j);
+  for (auto f : fields) {
+    f->m_N = kept + missing;
   }
 }
 
-//! Discard the first N records, shifting the rest of them towards the "beginning".
-void IceModelVec2T::discard(int number) {
+//! Read the in-file record `record` and store it as the record number `n` in memory.
+void IceModelVec2T::read_record(unsigned int record, unsigned int n) {
+  const bool allow_extrapolation = m_grid->ctx()->config()->get_flag("grid.allow_extrapolation");
 
-  if (number == 0) {
-    return;
+  {
+    petsc::VecArray tmp_array(m_v);
+    io::regrid_spatial_variable(m_metadata[0], *m_grid, m_reader->file(), record, CRITICAL,
+                                m_report_range, allow_extrapolation,
+                                0.0, m_interpolation_type, tmp_array.get());
   }
 
-  m_N -= number;
+  m_grid->ctx()->log()->message(5, " %s: reading entry #%02d, year %s...\n",
+                                m_name.c_str(),
+                                record,
+                                m_grid->ctx()->time()->date(m_time[record]).c_str());
 
-  double ***a3 = get_array3();
-  for (Points p(*m_grid); p; p.next()) {
-    const int i = p.i(), j = p.j();
+  set_record(n);
+}
 
-    for (unsigned int k = 0; k < m_N; ++k) {
-      a3[j][i][k] = a3[j][i][k + number];
-    }
-  }
-  end_access();
+//! Discard the first N records.
+/*!
+ * Records are stored in a circular buffer, so this does not move any data.
+ */
+void IceModelVec2T::discard(int number) {
+  m_N    -= number;
+  m_start = position(number);
 }
 
 //! Sets the record number n to the contents of the (internal) Vec v.
 void IceModelVec2T::set_record(int n) {
 
+  const int k = position(n);
+
   double  **a2 = get_array();
   double ***a3 = get_array3();
   for (Points p(*m_grid); p; p.next()) {
     const int i = p.i(), j = p.j();
-    a3[j][i][n] = a2[j][i];
+    a3[j][i][k] = a2[j][i];
   }
   end_access();
   end_access();
@@ -447,11 +520,13 @@ void IceModelVec2T::set_record(int n) {
 //! Sets the (internal) Vec v to the contents of the nth record.
 void IceModelVec2T::get_record(int n) {
 
+  const int k = position(n);
+
   double  **a2 = get_array();
   double ***a3 = get_array3();
   for (Points p(*m_grid); p; p.next()) {
     const int i = p.i(), j = p.j();
-    a2[j][i] = a3[j][i][n];
+    a2[j][i] = a3[j][i][k];
   }
   end_access();
   end_access();
@@ -562,6 +637,15 @@ void IceModelVec2T::init_interpolation(const std::vector<double> &ts) {
   m_interp.reset(new Interpolation(m_interp_type, &m_time[m_first], m_N,
                                    times_requested.data(), times_requested.size(),
                                    time->years_to_seconds(m_period)));
+
+  // positions of records in the circular buffer
+  const auto &L = m_interp->left(), &R = m_interp->right();
+  m_left.resize(L.size());
+  m_right.resize(R.size());
+  for (unsigned int k = 0; k < L.size(); ++k) {
+    m_left[k]  = position(L[k]);
+    m_right[k] = position(R[k]);
+  }
 }
 
 /**
@@ -574,10 +658,19 @@ void IceModelVec2T::init_interpolation(const std::vector<double> &ts) {
  */
 void IceModelVec2T::interp(int i, int j, std::vector<double> &result) {
   double ***a3 = (double***) m_array3;
+  const double *column = a3[j][i];
 
-  result.resize(m_interp->alpha().size());
+  const auto &alpha = m_interp->alpha();
+  const unsigned int N = alpha.size();
 
-  m_interp->interpolate(a3[j][i], result.data());
+  result.resize(N);
+
+  for (unsigned int k = 0; k < N; ++k) {
+    const int
+      L = m_left[k],
+      R = m_right[k];
+    result[k] = column[L] + alpha[k] * (column[R] - column[L]);
+  }
 }
 
 //! \brief Finds the average value at i,j over the interval (t, t +
@@ -591,7 +684,7 @@ double IceModelVec2T::average(int i, int j) {
 
   if (m_N == 1) {
     double ***a3 = (double***) m_array3;
-    result = a3[j][i][0];
+    result = a3[j][i][m_start];
   } else {
     std::vector<double> values(M);
 
@@ -24,6 +24,8 @@
 
 namespace pism {
 
+class ForcingReader;
+
 //! A class for storing and accessing 2D time-series (for climate forcing)
 /*! This class was created to read time-dependent and spatially-varying climate
   forcing data, in particular snow temperatures and precipitation.
@@ -31,6 +33,15 @@ namespace pism {
   If requests (calls to update()) go in sequence, every records should be read
   only once.
 
+  Records are stored in a circular buffer: advancing in time does not move data already
+  in memory. Each call of update() reads up to `input.forcing.prefetch` records following
+  the ones in the buffer (if there is room), so that reading forcing data is spread over
+  several time steps instead of stalling one of them.
+
+  Fields reading from the same file share a ForcingReader. Fields with the same time axis
+  and the same records in memory are updated together: records are read in one pass,
+  reading all the variables in a record before moving on to the next one.
+
   Note that this class is optimized for use with a PDD scheme -- it stores
   records so that data corresponding to a grid point are stored in adjacent
   memory locations.
@@ -90,6 +101,19 @@ private:
   //! number of records kept in memory
   unsigned int m_N;
 
+  //! position of the first record (in-file index m_first) in the circular buffer
+  unsigned int m_start;
+
+  //! maximum number of records to read ahead in update(t, dt)
+  unsigned int m_n_prefetch;
+
+  //! reader shared by all fields reading from the same file
+  std::shared_ptr<ForcingReader> m_reader;
+
+  //! true if update(m_group_t, m_group_dt) of an other field updated this one (see group())
+  bool m_updated_by_group;
+  double m_group_t, m_group_dt;
+
   //! number of evaluations per year used to compute temporal averages
   unsigned int m_n_evaluations_per_year;
 
@@ -99,11 +123,18 @@ private:
 
   InterpolationType m_interp_type;
   std::shared_ptr<Interpolation> m_interp;
+  //! positions in the circular buffer of records used by m_interp
+  std::vector<int> m_left, m_right;
   unsigned int m_period;        // in years
   double m_reference_time;      // in seconds
 
   double*** get_array3();
-  void update(unsigned int start);
+  std::vector<IceModelVec2T*> group();
+  void update(unsigned int start, unsigned int count,
+              const std::vector<IceModelVec2T*> &fields);
+  unsigned int keep(unsigned int start);
+  void read_record(unsigned int record, unsigned int n);
+  unsigned int position(unsigned int n) const;
   void discard(int N);
   double average(int i, int j);
   void set_record(int n);
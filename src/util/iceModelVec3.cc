@@ -19,9 +19,11 @@
 #include <cstring>
 #include <cstdlib>
 #include <cassert>
+#include <cmath>
 
 #include <memory>
 using std::dynamic_pointer_cast;
+#include <limits>
 
 #include <petscdmda.h>
 
@@ -30,6 +32,8 @@ using std::dynamic_pointer_cast;
 #include "ConfigInterface.hh"
 
 #include "error_handling.hh"
+#include "pism_utilities.hh"
+#include "petscwrappers/Vec.hh"
 
 namespace pism {
 
@@ -39,7 +43,7 @@ namespace pism {
 // are in "iceModelVec.cc"
 
 IceModelVec3D::IceModelVec3D()
-  : IceModelVec() {
+  : IceModelVec(), m_precision(DOUBLE_PRECISION) {
   m_bsearch_accel = gsl_interp_accel_alloc();
   if (m_bsearch_accel == NULL) {
     throw RuntimeError(PISM_ERROR_LOCATION, "Failed to allocate a GSL interpolation accelerator");
@@ -76,23 +80,14 @@ IceModelVec3::Ptr IceModelVec3::To3DScalar(IceModelVec::Ptr input) {
 void IceModelVec3D::allocate(IceGrid::ConstPtr grid, const std::string &name,
                              IceModelVecKind ghostedp, const std::vector<double> &levels,
                              unsigned int stencil_width) {
-  PetscErrorCode ierr;
   m_grid = grid;
 
   m_zlevels = levels;
   m_da_stencil_width = stencil_width;
 
-  m_da = m_grid->get_dm(this->m_zlevels.size(), this->m_da_stencil_width);
-
   m_has_ghosts = (ghostedp == WITH_GHOSTS);
 
-  if (m_has_ghosts == true) {
-    ierr = DMCreateLocalVector(*m_da, m_v.rawptr());
-    PISM_CHK(ierr, "DMCreateLocalVector");
-  } else {
-    ierr = DMCreateGlobalVector(*m_da, m_v.rawptr());
-    PISM_CHK(ierr, "DMCreateGlobalVector");
-  }
+  allocate_storage();
 
   m_name = name;
 
@@ -100,6 +95,138 @@ void IceModelVec3D::allocate(IceGrid::ConstPtr grid, const std::string &name,
                                                name, m_zlevels));
 }
 
+//! Number of columns of a single precision field each thread can convert to double
+//! precision before scratch space is re-used (see IceModelVec3D::get_column(i, j)).
+static const unsigned int n_scratch_columns = 16;
+
+//! Allocate storage using the current precision.
+/*!
+ * Two single precision values are packed into one double precision value, so storage of a
+ * single precision field uses a DM with half the number of degrees of freedom.
+ */
+void IceModelVec3D::allocate_storage() {
+  const unsigned int N = m_zlevels.size();
+
+  m_storage_dof = m_precision == SINGLE_PRECISION ? (N + 1) / 2 : N;
+
+  m_da = m_grid->get_dm(m_storage_dof, m_da_stencil_width);
+
+  m_grid->allocate_vec(m_storage_dof, m_da_stencil_width, m_has_ghosts, m_v.rawptr());
+
+  if (m_precision == SINGLE_PRECISION) {
+    const unsigned int n_threads = max_thread_count();
+    m_scratch.resize(n_threads * n_scratch_columns * N);
+    m_scratch_position.resize(n_threads, 0);
+  } else {
+    m_scratch.clear();
+    m_scratch_position.clear();
+  }
+}
+
+//! Set the precision used to store values of this field.
+/*!
+ * A field stored in single precision uses half the memory (and half the memory bandwidth)
+ * of a field stored in double precision. Values are converted to double precision by
+ * get_column() and getValZ(), so computations using them are done in double precision.
+ *
+ * Columns of a single precision field can be modified using set_column() only: the
+ * non-const version of get_column() throws an exception and operator() cannot be used.
+ *
+ * Changing the precision discards stored values, so this should be called right after the
+ * field is created.
+ */
+void IceModelVec3D::set_precision(IceModelVecPrecision precision) {
+  if (precision == m_precision) {
+    return;
+  }
+
+  if (m_access_counter != 0) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot change the precision of '%s' while it is being accessed",
+                                  m_name.c_str());
+  }
+
+  m_precision = precision;
+
+  if (m_v != NULL) {
+    if (m_use_storage_pool) {
+      m_grid->release_vec(m_storage_dof, m_da_stencil_width, m_has_ghosts, m_v);
+      // the grid owns the Vec now
+      *m_v.rawptr() = NULL;
+    } else {
+      PetscErrorCode ierr = VecDestroy(m_v.rawptr());
+      PISM_CHK(ierr, "VecDestroy");
+    }
+
+    allocate_storage();
+  }
+
+  inc_state_counter();
+}
+
+IceModelVecPrecision IceModelVec3D::precision() const {
+  return m_precision;
+}
+
+//! Precision used to store the 3D field `field` (see the configuration parameter
+//! `grid.single_precision_3d_fields`).
+IceModelVecPrecision storage_precision(const Config &config, const std::string &field) {
+  const std::set<std::string>
+    fields    = set_split(config.get_string("grid.single_precision_3d_fields"), ','),
+    supported = {"age", "enthalpy", "strain_heating", "velocity"};
+
+  for (const auto &f : fields) {
+    if (not member(f, supported)) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "cannot store '%s' in single precision (supported: %s)",
+                                    f.c_str(), set_join(supported, ",").c_str());
+    }
+  }
+
+  return member(field, fields) ? SINGLE_PRECISION : DOUBLE_PRECISION;
+}
+
+float* IceModelVec3D::float_column(int i, int j) const {
+  return reinterpret_cast<float*>(((double***) m_array)[j][i]);
+}
+
+//! Report an attempt to access values of a single precision field using operator().
+void IceModelVec3D::single_precision_access_error() const {
+  throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                "'%s' is stored in single precision: use get_column(),"
+                                " getValZ() or set_column() to access it", m_name.c_str());
+}
+
+//! Convert a column of a single precision field to double precision, storing it in
+//! `result` (owned by the caller; must have room for all levels).
+void IceModelVec3D::unpack_column(int i, int j, double *result) const {
+  const float *column = float_column(i, j);
+  for (unsigned int k = 0; k < m_zlevels.size(); ++k) {
+    result[k] = column[k];
+  }
+}
+
+//! Return the scratch column the current thread uses next.
+/*!
+ * Scratch columns are re-used in a round-robin fashion: the returned pointer remains valid
+ * until the same thread requests `n_scratch_columns` more columns of this field.
+ */
+double* IceModelVec3D::scratch_column() const {
+  const unsigned int thread = thread_index();
+
+  if (thread >= m_scratch_position.size()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "no scratch space for thread %u (field '%s')",
+                                  thread, m_name.c_str());
+  }
+
+  unsigned int &position = m_scratch_position[thread];
+  double *result = &m_scratch[(thread * n_scratch_columns + position) * m_zlevels.size()];
+  position = (position + 1) % n_scratch_columns;
+
+  return result;
+}
+
 bool IceModelVec3D::isLegalLevel(double z) const {
   double z_min = m_zlevels.front(),
     z_max = m_zlevels.back();
@@ -117,6 +244,14 @@ void IceModelVec3D::set_column(int i, int j, double c) {
   check_array_indices(i, j, 0);
 #endif
 
+  if (m_precision == SINGLE_PRECISION) {
+    float *column = float_column(i, j);
+    for (unsigned int k = 0; k < m_zlevels.size(); ++k) {
+      column[k] = c;
+    }
+    return;
+  }
+
   double ***arr = (double***) m_array;
 
   if (c == 0.0) {
@@ -131,24 +266,37 @@ void IceModelVec3D::set_column(int i, int j, double c) {
 }
 
 void IceModelVec3D::set_column(int i, int j, const std::vector<double> &data) {
-  double *column = get_column(i, j);
+  std::vector<double> column = get_column_vector(i, j);
   for (unsigned int k = 0; k < data.size(); ++k) {
     column[k] = data[k];
   }
-
+  set_column(i, j, &column[0]);
 }
 
 const std::vector<double> IceModelVec3D::get_column_vector(int i, int j) const {
-  unsigned int n = m_zlevels.size();
-  std::vector<double> result(n);
-  const double *data = get_column(i, j);
-  for (unsigned int k = 0; k < n; ++k) {
-    result[k] = data[k];
-  }
+  std::vector<double> result(m_zlevels.size());
+  get_column(i, j, &result[0]);
   return result;
 }
 
 
+//! Linearly interpolate `column` (defined at `levels`) to `z`.
+template<typename T>
+static double value_at(const std::vector<double> &levels, gsl_interp_accel *accel,
+                       const T *column, double z) {
+  if (z >= levels.back()) {
+    return column[levels.size() - 1];
+  } else if (z <= levels.front()) {
+    return column[0];
+  }
+
+  unsigned int mcurr = gsl_interp_accel_find(accel, &levels[0], levels.size(), z);
+
+  const double incr = (z - levels[mcurr]) / (levels[mcurr+1] - levels[mcurr]);
+  const double valm = column[mcurr];
+  return valm + incr * (column[mcurr+1] - valm);
+}
+
 //! Return value of scalar quantity at level z (m) above base of ice (by linear interpolation).
 double IceModelVec3D::getValZ(int i, int j, double z) const {
 #if (Pism_DEBUG==1)
@@ -161,19 +309,11 @@ double IceModelVec3D::getValZ(int i, int j, double z) const {
   }
 #endif
 
-  double ***arr = (double***) m_array;
-  if (z >= m_zlevels.back()) {
-    unsigned int nlevels = m_zlevels.size();
-    return arr[j][i][nlevels - 1];
-  } else if (z <= m_zlevels.front()) {
-    return arr[j][i][0];
+  if (m_precision == SINGLE_PRECISION) {
+    return value_at(m_zlevels, m_bsearch_accel, float_column(i, j), z);
   }
 
-  unsigned int mcurr = gsl_interp_accel_find(m_bsearch_accel, &m_zlevels[0], m_zlevels.size(), z);
-
-  const double incr = (z - m_zlevels[mcurr]) / (m_zlevels[mcurr+1] - m_zlevels[mcurr]);
-  const double valm = arr[j][i][mcurr];
-  return valm + incr * (arr[j][i][mcurr+1] - valm);
+  return value_at(m_zlevels, m_bsearch_accel, ((double***) m_array)[j][i], z);
 }
 
 //! Copies a horizontal slice at level z of an IceModelVec3 into a Vec gslice.
@@ -243,20 +383,63 @@ double* IceModelVec3D::get_column(int i, int j) {
 #if (Pism_DEBUG==1)
   check_array_indices(i, j, 0);
 #endif
+  if (m_precision == SINGLE_PRECISION) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "'%s' is stored in single precision: use set_column()"
+                                  " to modify it", m_name.c_str());
+  }
   return ((double***) m_array)[j][i];
 }
 
+//! Get a column of values.
+/*!
+ * If this field is stored in single precision the column is converted to double
+ * precision in per-thread scratch space. In this case the returned pointer stays valid
+ * only until the same thread gets `n_scratch_columns` (16) more columns of this field:
+ * use it right away and do not store it. Use get_column(i, j, result) to get a copy that
+ * does not have this restriction.
+ */
 const double* IceModelVec3D::get_column(int i, int j) const {
 #if (Pism_DEBUG==1)
   check_array_indices(i, j, 0);
 #endif
+  if (m_precision == SINGLE_PRECISION) {
+    double *result = scratch_column();
+    unpack_column(i, j, result);
+    return result;
+  }
   return ((double***) m_array)[j][i];
 }
 
+//! Copy a column of values (converted to double precision if necessary) to `result`.
+/*!
+ * `result` is owned by the caller and has to have room for all levels of this field.
+ */
+void IceModelVec3D::get_column(int i, int j, double *result) const {
+#if (Pism_DEBUG==1)
+  check_array_indices(i, j, 0);
+#endif
+  if (m_precision == SINGLE_PRECISION) {
+    unpack_column(i, j, result);
+    return;
+  }
+  PetscErrorCode ierr = PetscMemcpy(result, ((double***) m_array)[j][i],
+                                    m_zlevels.size()*sizeof(double));
+  PISM_CHK(ierr, "PetscMemcpy");
+}
+
 void  IceModelVec3D::set_column(int i, int j, const double *valsIN) {
 #if (Pism_DEBUG==1)
   check_array_indices(i, j, 0);
 #endif
+  if (m_precision == SINGLE_PRECISION) {
+    float *column = float_column(i, j);
+    for (unsigned int k = 0; k < m_zlevels.size(); ++k) {
+      column[k] = valsIN[k];
+    }
+    return;
+  }
+
   double ***arr = (double***) m_array;
   PetscErrorCode ierr = PetscMemcpy(arr[j][i], valsIN, m_zlevels.size()*sizeof(double));
   PISM_CHK(ierr, "PetscMemcpy");
@@ -310,4 +493,283 @@ void IceModelVec3::sumColumns(IceModelVec2S &output, double A, double B) const {
   }
 }
 
+//! Apply `op` to all single precision values stored in `v` (including ghosts).
+template<class F>
+static void apply(Vec v, F op) {
+  PetscInt size = 0;
+  PetscErrorCode ierr = VecGetLocalSize(v, &size);
+  PISM_CHK(ierr, "VecGetLocalSize");
+
+  petsc::VecArray array(v);
+  float *values = reinterpret_cast<float*>(array.get());
+
+  for (PetscInt k = 0; k < 2 * size; ++k) {
+    values[k] = op(values[k], k);
+  }
+}
+
+//! Copy columns from `source`, converting between single and double precision.
+void IceModelVec3D::copy_columns(const IceModelVec3D &source) {
+  if (source.m_zlevels.size() != m_zlevels.size()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot copy '%s' to '%s': different numbers of levels",
+                                  source.m_name.c_str(), m_name.c_str());
+  }
+
+  AccessList list{this, &source};
+
+  ParallelSection loop(m_grid->com);
+  try {
+    for (Points p(*m_grid); p; p.next()) {
+      const int i = p.i(), j = p.j();
+
+      set_column(i, j, source.get_column(i, j));
+    }
+  } catch (...) {
+    loop.failed();
+  }
+  loop.check();
+
+  update_ghosts();
+}
+
+//! Allocate a double precision field without ghosts with the same levels and metadata
+//! (used for I/O).
+void IceModelVec3D::allocate_copy(IceModelVec3D &result) const {
+  result.allocate(m_grid, m_name, WITHOUT_GHOSTS, m_zlevels, m_da_stencil_width);
+  result.use_storage_pool();
+  result.m_metadata           = m_metadata;
+  result.m_report_range       = m_report_range;
+  result.m_interpolation_type = m_interpolation_type;
+}
+
+Range IceModelVec3D::range() const {
+  if (m_precision == DOUBLE_PRECISION) {
+    return IceModelVec::range();
+  }
+
+  const unsigned int N = m_zlevels.size();
+  double
+    min = std::numeric_limits<double>::max(),
+    max = -min;
+
+  AccessList list(*this);
+  for (Points p(*m_grid); p; p.next()) {
+    const float *column = float_column(p.i(), p.j());
+
+    for (unsigned int k = 0; k < N; ++k) {
+      min = std::min(min, (double)column[k]);
+      max = std::max(max, (double)column[k]);
+    }
+  }
+
+  GlobalReduction reduction(m_grid->com);
+  int
+    min_index = reduction.add(GlobalReduction::MIN, min),
+    max_index = reduction.add(GlobalReduction::MAX, max);
+  reduction.reduce();
+
+  return {reduction[min_index], reduction[max_index]};
+}
+
+std::vector<double> IceModelVec3D::norm_all(int n) const {
+  if (m_precision == DOUBLE_PRECISION) {
+    return IceModelVec::norm_all(n);
+  }
+
+  const NormType type = int_to_normtype(n);
+  const unsigned int N = m_zlevels.size();
+
+  double result = 0.0;
+
+  AccessList list(*this);
+  for (Points p(*m_grid); p; p.next()) {
+    const float *column = float_column(p.i(), p.j());
+
+    for (unsigned int k = 0; k < N; ++k) {
+      const double v = column[k];
+      switch (type) {
+      case NORM_1:
+        result += std::fabs(v);
+        break;
+      case NORM_2:
+        result += v * v;
+        break;
+      default:
+        result = std::max(result, std::fabs(v));
+      }
+    }
+  }
+
+  if (type == NORM_INFINITY) {
+    return {GlobalMax(m_grid->com, result)};
+  }
+
+  result = GlobalSum(m_grid->com, result);
+
+  return {type == NORM_2 ? std::sqrt(result) : result};
+}
+
+void IceModelVec3D::add(double alpha, const IceModelVec &x) {
+  const IceModelVec3D *other = dynamic_cast<const IceModelVec3D*>(&x);
+
+  if (other == NULL or (m_precision == DOUBLE_PRECISION and
+                        other->m_precision == DOUBLE_PRECISION)) {
+    IceModelVec::add(alpha, x);
+    return;
+  }
+
+  if (m_precision == SINGLE_PRECISION and other->m_precision == SINGLE_PRECISION) {
+    checkCompatibility("add", x);
+
+    petsc::VecArray x_array(other->m_v);
+    const float *x_values = reinterpret_cast<const float*>(x_array.get());
+
+    apply(m_v, [=](float v, PetscInt k) { return v + alpha * x_values[k]; });
+  } else {
+    // mixed precision
+    if (other->m_zlevels.size() != m_zlevels.size()) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "cannot add '%s' to '%s': different numbers of levels",
+                                    other->m_name.c_str(), m_name.c_str());
+    }
+
+    const unsigned int N = m_zlevels.size();
+    const IceModelVec3D &self = *this;
+    std::vector<double> column(N);
+
+    AccessList list{this, other};
+
+    ParallelSection loop(m_grid->com);
+    try {
+      for (Points p(*m_grid); p; p.next()) {
+        const int i = p.i(), j = p.j();
+
+        const double
+          *a = self.get_column(i, j),
+          *b = other->get_column(i, j);
+
+        for (unsigned int k = 0; k < N; ++k) {
+          column[k] = a[k] + alpha * b[k];
+        }
+        set_column(i, j, &column[0]);
+      }
+    } catch (...) {
+      loop.failed();
+    }
+    loop.check();
+
+    update_ghosts();
+  }
+
+  inc_state_counter();          // mark as modified
+}
+
+void IceModelVec3D::squareroot() {
+  if (m_precision == DOUBLE_PRECISION) {
+    IceModelVec::squareroot();
+    return;
+  }
+
+  apply(m_v, [](float v, PetscInt) { return std::sqrt(std::fabs(v)); });
+
+  inc_state_counter();          // mark as modified
+}
+
+void IceModelVec3D::shift(double alpha) {
+  if (m_precision == DOUBLE_PRECISION) {
+    IceModelVec::shift(alpha);
+    return;
+  }
+
+  apply(m_v, [=](float v, PetscInt) { return v + alpha; });
+
+  inc_state_counter();          // mark as modified
+}
+
+void IceModelVec3D::scale(double alpha) {
+  if (m_precision == DOUBLE_PRECISION) {
+    IceModelVec::scale(alpha);
+    return;
+  }
+
+  apply(m_v, [=](float v, PetscInt) { return v * alpha; });
+
+  inc_state_counter();          // mark as modified
+}
+
+void IceModelVec3D::set(double c) {
+  if (m_precision == DOUBLE_PRECISION) {
+    IceModelVec::set(c);
+    return;
+  }
+
+  apply(m_v, [=](float, PetscInt) { return c; });
+
+  inc_state_counter();          // mark as modified
+}
+
+//! Copy values from `source`, converting between single and double precision if necessary.
+void IceModelVec3D::copy_from(const IceModelVec &source) {
+  const IceModelVec3D *other = dynamic_cast<const IceModelVec3D*>(&source);
+
+  if (other != NULL and other->m_precision != m_precision) {
+    copy_columns(*other);
+    inc_state_counter();          // mark as modified
+    return;
+  }
+
+  IceModelVec::copy_from(source);
+}
+
+void IceModelVec3D::update_ghosts(IceModelVec &destination) const {
+  IceModelVec3D *result = dynamic_cast<IceModelVec3D*>(&destination);
+
+  if (result != NULL and result->m_precision != m_precision) {
+    result->copy_columns(*this);
+    result->inc_state_counter();
+    return;
+  }
+
+  IceModelVec::update_ghosts(destination);
+}
+
+void IceModelVec3D::read_impl(const File &file, unsigned int time) {
+  if (m_precision == DOUBLE_PRECISION) {
+    IceModelVec::read_impl(file, time);
+    return;
+  }
+
+  IceModelVec3D tmp;
+  allocate_copy(tmp);
+  tmp.read_impl(file, time);
+
+  copy_columns(tmp);
+}
+
+void IceModelVec3D::regrid_impl(const File &file, RegriddingFlag flag, double default_value) {
+  if (m_precision == DOUBLE_PRECISION) {
+    IceModelVec::regrid_impl(file, flag, default_value);
+    return;
+  }
+
+  IceModelVec3D tmp;
+  allocate_copy(tmp);
+  tmp.regrid_impl(file, flag, default_value);
+
+  copy_columns(tmp);
+}
+
+void IceModelVec3D::write_impl(const File &file) const {
+  if (m_precision == DOUBLE_PRECISION) {
+    IceModelVec::write_impl(file);
+    return;
+  }
+
+  IceModelVec3D tmp;
+  allocate_copy(tmp);
+  tmp.copy_columns(*this);
+  tmp.write_impl(file);
+}
+
 } // end of namespace pism
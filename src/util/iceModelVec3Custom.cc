@@ -51,8 +51,8 @@ IceModelVec3Custom::IceModelVec3Custom(IceGrid::ConstPtr grid,
 
   m_da = m_grid->get_dm(this->m_zlevels.size(), this->m_da_stencil_width);
 
-  PetscErrorCode ierr = DMCreateGlobalVector(*m_da, m_v.rawptr());
-  PISM_CHK(ierr, "DMCreateGlobalVector");
+  m_grid->allocate_vec(m_zlevels.size(), m_da_stencil_width, false, m_v.rawptr());
+  m_storage_dof = m_zlevels.size();
 
   m_metadata.push_back(SpatialVariableMetadata(m_grid->ctx()->unit_system(),
                                                m_name, m_zlevels));
@@ -0,0 +1,250 @@
+/* Copyright (C) 2019 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdio>               // fprintf, stderr
+
+#include "AsyncWriter.hh"
+#include "pism/util/error_handling.hh"
+
+namespace pism {
+namespace io {
+
+struct AsyncWriter::Impl {
+  void run();
+  void stop_thread();
+
+  MPI_Comm com;
+  int rank;
+
+  struct Task {
+    std::function<void()> run;
+    size_t size;
+  };
+
+  //! tasks waiting to be processed
+  std::deque<Task> queue;
+  //! maximum total size of tasks in the queue
+  size_t buffer_size;
+  //! total size of tasks in the queue (including the one being processed)
+  size_t queued_size;
+  //! true if the writer thread is processing a task
+  bool busy;
+  //! true if the writer thread should stop once the queue is empty
+  bool stop;
+  //! the message describing the first failure (empty if none)
+  std::string error;
+  //! true if `error` was reported by check()
+  bool reported;
+
+  std::mutex mutex;
+  std::condition_variable changed;
+  std::thread thread;
+};
+
+/*!
+ * The writer thread is started on rank 0 only.
+ *
+ * @param[in] com MPI communicator
+ * @param[in] buffer_size maximum size of data (in bytes) waiting to be written
+ */
+AsyncWriter::AsyncWriter(MPI_Comm com, size_t buffer_size)
+  : m_impl(new Impl) {
+  m_impl->com         = com;
+  m_impl->rank        = 0;
+  m_impl->buffer_size = buffer_size;
+  m_impl->queued_size = 0;
+  m_impl->busy        = false;
+  m_impl->stop        = false;
+  m_impl->reported    = false;
+
+  MPI_Comm_rank(com, &m_impl->rank);
+
+  if (m_impl->rank == 0) {
+    m_impl->thread = std::thread(&AsyncWriter::Impl::run, m_impl);
+  }
+}
+
+//! Finishes writing all submitted data and stops the writer thread.
+/*!
+ * Use close() to make sure that errors are reported: the destructor cannot throw, so it
+ * only prints errors that were not reported yet.
+ */
+AsyncWriter::~AsyncWriter() {
+  m_impl->stop_thread();
+
+  if (not m_impl->error.empty() and not m_impl->reported) {
+    fprintf(stderr, "PISM ERROR: failed to write output: %s\n", m_impl->error.c_str());
+  }
+  delete m_impl;
+}
+
+//! Stop the writer thread once all submitted tasks are processed (if it is running).
+void AsyncWriter::Impl::stop_thread() {
+  if (thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      stop = true;
+    }
+    changed.notify_all();
+    thread.join();
+  }
+}
+
+MPI_Comm AsyncWriter::com() const {
+  return m_impl->com;
+}
+
+void AsyncWriter::Impl::run() {
+  while (true) {
+    Task task;
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      changed.wait(lock, [this]() { return stop or not queue.empty(); });
+
+      if (queue.empty()) {
+        // stop was requested and there is nothing left to do
+        return;
+      }
+
+      task = queue.front();
+      queue.pop_front();
+      busy = true;
+    }
+
+    std::string message;
+    try {
+      task.run();
+    } catch (std::exception &e) {
+      message = e.what();
+    }
+
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      busy = false;
+      queued_size -= task.size;
+
+      if (error.empty()) {
+        error = message;
+      }
+
+      if (not error.empty()) {
+        // the file being written is likely to be corrupted anyway, so we stop writing
+        queue.clear();
+        queued_size = 0;
+      }
+    }
+    changed.notify_all();
+  }
+}
+
+//! Add a task to the queue. Blocks while the staging buffer is full.
+/*!
+ * Should be called on rank 0 only. Tasks are processed in the order in which they were
+ * submitted.
+ *
+ * @param[in] task task to run in the writer thread
+ * @param[in] size size (in bytes) of data staged for this task
+ */
+void AsyncWriter::submit(std::function<void()> task, size_t size) {
+  if (m_impl->rank != 0) {
+    return;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(m_impl->mutex);
+
+    // Wait for the writer to catch up. Note that we accept a task that is bigger than the
+    // whole buffer if the queue is empty.
+    m_impl->changed.wait(lock, [this, size]() {
+        return (m_impl->queued_size == 0 or
+                m_impl->queued_size + size <= m_impl->buffer_size);
+      });
+
+    if (m_impl->stop and m_impl->error.empty()) {
+      m_impl->error = "cannot write: the output writer was closed";
+    }
+
+    if (not m_impl->error.empty()) {
+      // this will be reported by check()
+      return;
+    }
+
+    m_impl->queue.push_back({task, size});
+    m_impl->queued_size += size;
+  }
+  m_impl->changed.notify_all();
+}
+
+//! Throw an exception on all ranks if writing failed. Does not wait for the writer.
+/*!
+ * This is a collective operation.
+ */
+void AsyncWriter::check() const {
+  std::string message;
+  if (m_impl->rank == 0) {
+    std::lock_guard<std::mutex> lock(m_impl->mutex);
+    message = m_impl->error;
+    m_impl->reported = not message.empty();
+  }
+
+  int length = message.size();
+  MPI_Bcast(&length, 1, MPI_INT, 0, m_impl->com);
+
+  if (length > 0) {
+    message.resize(length);
+    MPI_Bcast(&message[0], length, MPI_CHAR, 0, m_impl->com);
+
+    throw RuntimeError(PISM_ERROR_LOCATION, "failed to write output: " + message);
+  }
+}
+
+//! Wait until all submitted data are written.
+/*!
+ * This is a collective operation.
+ */
+void AsyncWriter::wait() const {
+  if (m_impl->rank == 0) {
+    std::unique_lock<std::mutex> lock(m_impl->mutex);
+    m_impl->changed.wait(lock, [this]() {
+        return m_impl->queue.empty() and not m_impl->busy;
+      });
+  }
+
+  check();
+}
+
+//! Write all submitted data, stop the writer thread and report errors.
+/*!
+ * This is a collective operation. Data submitted after this call are not written (this is
+ * reported as an error by the next check()).
+ */
+void AsyncWriter::close() {
+  if (m_impl->rank == 0) {
+    m_impl->stop_thread();
+  }
+
+  check();
+}
+
+} // end of namespace io
+} // end of namespace pism
@@ -0,0 +1,68 @@
+/* Copyright (C) 2019 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _ASYNCWRITER_H_
+#define _ASYNCWRITER_H_
+
+#include <memory>
+#include <functional>
+#include <mpi.h>
+
+namespace pism {
+namespace io {
+
+//! Writes output files using a background thread on rank 0.
+/*!
+ * Output files written asynchronously use the NCStaging "backend": data are gathered on
+ * rank 0 and copied into a staging buffer at the time they are "written" and then the
+ * writer thread writes them to disk while the model keeps going.
+ *
+ * The writer thread calls the NetCDF library (serialized using netcdf_mutex()), but never
+ * calls MPI or PETSc.
+ *
+ * The size of the staging buffer is limited: submit() blocks if the data that are not
+ * written yet would exceed `buffer_size` bytes.
+ *
+ * Errors that happened in the writer thread are reported by check(), wait() and close()
+ * (on all ranks). Call close() when done: the destructor cannot report errors (it prints
+ * a message to `stderr` if an error was not reported).
+ */
+class AsyncWriter {
+public:
+  typedef std::shared_ptr<AsyncWriter> Ptr;
+
+  AsyncWriter(MPI_Comm com, size_t buffer_size);
+  ~AsyncWriter();
+
+  MPI_Comm com() const;
+
+  void submit(std::function<void()> task, size_t size);
+
+  void check() const;
+  void wait() const;
+  void close();
+private:
+  struct Impl;
+  Impl *m_impl;
+};
+
+} // end of namespace io
+} // end of namespace pism
+
+#endif /* _ASYNCWRITER_H_ */
@@ -19,6 +19,7 @@
 #include <cassert>
 #include <cstdio>
 #include <memory>
+#include <map>
 using std::shared_ptr;
 
 #include <petscvec.h>
@@ -30,6 +31,9 @@ using std::shared_ptr;
 #include "pism/util/ConfigInterface.hh"
 #include "pism/util/Time.hh"
 #include "NC3File.hh"
+#include "NCStaging.hh"
+#include "NativeFile.hh"
+#include "LocalInterpCtx.hh"
 
 #include "pism/pism_config.hh"
 
@@ -54,6 +58,14 @@ struct File::Impl {
   MPI_Comm com;
   IO_Backend backend;
   io::NCFile::Ptr nc;
+  //! true if this file is written asynchronously
+  bool staged;
+  //! true if this file was opened using PISM_READONLY
+  bool read_only;
+  //! interpolation contexts used to regrid from this file (see interpolation_context())
+  std::map<std::string, std::shared_ptr<LocalInterpCtx> > interpolation_contexts;
+  //! distributed arrays that should not be written (see skip_writing())
+  std::set<std::string> skipped;
 };
 
 IO_Backend string_to_backend(const std::string &backend) {
@@ -78,6 +90,9 @@ IO_Backend string_to_backend(const std::string &backend) {
   if (backend == "pio_netcdf4p") {
     return PISM_PIO_NETCDF4P;
   }
+  if (backend == "native") {
+    return PISM_NATIVE;
+  }
   throw RuntimeError::formatted(PISM_ERROR_LOCATION,
                                 "unknown or unsupported I/O backend: %s", backend.c_str());
 }
@@ -110,12 +125,16 @@ static IO_Backend choose_backend(MPI_Comm com, const std::string &filename) {
   return PISM_NETCDF3;
 }
 
-static io::NCFile::Ptr create_backend(MPI_Comm com, IO_Backend backend, int iosysid) {
+static io::NCFile::Ptr create_backend(MPI_Comm com, IO_Backend backend, int iosysid,
+                                      int n_aggregators) {
   int size = 1;
   MPI_Comm_size(com, &size);
 
   if (backend == PISM_NETCDF3) {
-    return io::NCFile::Ptr(new io::NC3File(com));
+    return io::NCFile::Ptr(new io::NC3File(com, n_aggregators));
+  }
+  if (backend == PISM_NATIVE) {
+    return io::NCFile::Ptr(new io::NativeFile(com));
   }
 #if (Pism_USE_PARALLEL_NETCDF4==1)
   if (backend == PISM_NETCDF4_PARALLEL) {
@@ -145,8 +164,16 @@ static io::NCFile::Ptr create_backend(MPI_Comm com, IO_Backend backend, int iosy
                                 "unknown or unsupported I/O backend: %d", backend);
 }
 
+/*!
+ * @param[in] com MPI communicator
+ * @param[in] filename name of the file
+ * @param[in] backend I/O backend (PISM_GUESS to choose automatically when reading)
+ * @param[in] mode I/O mode
+ * @param[in] iosysid ParallelIO I/O system ID (used by ParallelIO backends only)
+ * @param[in] n_aggregators number of aggregators (used by PISM_NETCDF3 only; see NC3File)
+ */
 File::File(MPI_Comm com, const std::string &filename, IO_Backend backend, IO_Mode mode,
-           int iosysid)
+           int iosysid, int n_aggregators)
   : m_impl(new Impl) {
 
   if (filename.empty()) {
@@ -154,14 +181,47 @@ File::File(MPI_Comm com, const std::string &filename, IO_Backend backend, IO_Mod
                                   "cannot open file: provided file name is empty");
   }
 
-  if (backend == PISM_GUESS) {
+  if (mode == PISM_READONLY and io::NativeFile::recognize(com, filename)) {
+    // Native files (checkpoints) can be read wherever PISM reads NetCDF files.
+    m_impl->backend = PISM_NATIVE;
+  } else if (backend == PISM_GUESS) {
     m_impl->backend = choose_backend(com, filename);
   } else {
     m_impl->backend = backend;
   }
 
-  m_impl->com = com;
-  m_impl->nc  = create_backend(m_impl->com, m_impl->backend, iosysid);
+  m_impl->com    = com;
+  m_impl->nc        = create_backend(m_impl->com, m_impl->backend, iosysid, n_aggregators);
+  m_impl->staged    = false;
+  m_impl->read_only = false;
+
+  this->open(filename, mode);
+}
+
+//! Open a file for writing using a background thread.
+/*!
+ * Data written to this file are handed over to `writer` and written while the model keeps
+ * going. Such files are write-only: reading data is not supported.
+ *
+ * @param[in] writer asynchronous writer to use
+ * @param[in] filename name of the file
+ * @param[in] backend the kind of NetCDF file to create (the writer uses serial NetCDF)
+ * @param[in] mode I/O mode (PISM_READONLY is not supported)
+ */
+File::File(std::shared_ptr<io::AsyncWriter> writer, const std::string &filename,
+           IO_Backend backend, IO_Mode mode)
+  : m_impl(new Impl) {
+
+  if (filename.empty()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot open file: provided file name is empty");
+  }
+
+  m_impl->com     = writer->com();
+  m_impl->backend = backend;
+  m_impl->nc.reset(new io::NCStaging(writer, backend));
+  m_impl->staged  = true;
+  m_impl->read_only = false;
 
   this->open(filename, mode);
 }
@@ -189,6 +249,8 @@ IO_Backend File::backend() const {
 
 void File::open(const std::string &filename, IO_Mode mode) {
   try {
+    m_impl->read_only = (mode == PISM_READONLY);
+    m_impl->interpolation_contexts.clear();
 
     // opening for reading
     if (mode == PISM_READONLY) {
@@ -197,10 +259,14 @@ void File::open(const std::string &filename, IO_Mode mode) {
 
     } else if (mode == PISM_READWRITE_CLOBBER or mode == PISM_READWRITE_MOVE) {
 
-      if (mode == PISM_READWRITE_MOVE) {
-        io::move_if_exists(m_impl->com, filename);
-      } else {
-        io::remove_if_exists(m_impl->com, filename);
+      // When writing asynchronously the writer thread takes care of existing files: this
+      // file may still be waiting to be written.
+      if (not m_impl->staged) {
+        if (mode == PISM_READWRITE_MOVE) {
+          io::move_if_exists(m_impl->com, filename);
+        } else {
+          io::remove_if_exists(m_impl->com, filename);
+        }
       }
 
       m_impl->nc->create(filename);
@@ -233,6 +299,7 @@ void File::remove_attribute(const std::string &variable_name, const std::string
 
 void File::close() {
   try {
+    m_impl->interpolation_contexts.clear();
     m_impl->nc->close();
   } catch (RuntimeError &e) {
     e.add_context("closing \"" + filename() + "\"");
@@ -516,28 +583,40 @@ void File::define_dimension(const std::string &name, size_t length) const {
 void File::define_variable(const std::string &name, IO_Type nctype, const std::vector<std::string> &dims) const {
   try {
     m_impl->nc->def_var(name, nctype, dims);
+  } catch (RuntimeError &e) {
+    e.add_context("defining variable '%s' in '%s'", name.c_str(), filename().c_str());
+    throw;
+  }
+}
 
-    // FIXME: I need to write and tune chunk_dimensions that would be called below before we use
-    // this.
-    //
-    /*
-    // if it's not a spatial variable, we're done
-    if (dims.size() < 2) {
-      return;
-    }
+//! Set chunk sizes of a variable. Ignored unless writing NetCDF-4 files.
+/*!
+ * Has to be called right after define_variable().
+ */
+void File::define_chunking(const std::string &name, const std::vector<size_t> &chunks) const {
+  try {
+    std::vector<size_t> tmp = chunks;
+    m_impl->nc->def_var_chunking(name, tmp);
+  } catch (RuntimeError &e) {
+    e.add_context("setting chunk sizes of '%s' in '%s'", name.c_str(), filename().c_str());
+    throw;
+  }
+}
 
-    std::vector<size_t> dim_lengths;
-    for (unsigned int k = 0; k < dims.size(); ++k) {
-      dim_lengths.push_back(this->dimension_length(dims[k]));
+//! Set the compression level (0 to 9) of a variable. Ignored unless writing NetCDF-4 files.
+/*!
+ * Has to be called right after define_variable().
+ */
+void File::define_compression(const std::string &name, int level) const {
+  try {
+    if (level < 0 or level > 9) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "invalid compression level: %d (has to be in [0, 9])",
+                                    level);
     }
-
-    std::vector<size_t> chunk_dims = chunk_dimensions(nctype, dim_lengths);
-
-    m_impl->nc->def_var_chunking(name, chunk_dims);
-    */
-
+    m_impl->nc->def_var_deflate(name, level);
   } catch (RuntimeError &e) {
-    e.add_context("defining variable '%s' in '%s'", name.c_str(), filename().c_str());
+    e.add_context("setting compression of '%s' in '%s'", name.c_str(), filename().c_str());
     throw;
   }
 }
@@ -717,6 +796,10 @@ void File::write_distributed_array(const std::string &variable_name,
                                    const IceGrid &grid,
                                    unsigned int z_count,
                                    const double *input) const {
+  if (m_impl->skipped.find(variable_name) != m_impl->skipped.end()) {
+    return;
+  }
+
   try {
     unsigned int t_length = nrecords();
     assert(t_length > 0);
@@ -768,4 +851,36 @@ std::string File::variable_name(unsigned int id) const {
 }
 
 
+//! Get the interpolation context cached using `key` (or an empty pointer if there is none).
+/*!
+ * Computing an interpolation context requires reading coordinate variables from this
+ * file, which is expensive if a variable is read one record at a time. Contexts are cached
+ * for files opened using PISM_READONLY only (the structure of other files may change) and
+ * are discarded when the file is closed.
+ */
+std::shared_ptr<LocalInterpCtx> File::interpolation_context(const std::string &key) const {
+  auto it = m_impl->interpolation_contexts.find(key);
+  if (it != m_impl->interpolation_contexts.end()) {
+    return it->second;
+  }
+  return std::shared_ptr<LocalInterpCtx>();
+}
+
+//! Cache an interpolation context. Does nothing if the file is not read-only.
+void File::cache_interpolation_context(const std::string &key,
+                                       std::shared_ptr<LocalInterpCtx> context) const {
+  if (m_impl->read_only) {
+    m_impl->interpolation_contexts[key] = context;
+  }
+}
+
+//! Make write_distributed_array() ignore requests to write `variables`.
+/*!
+ * This is used to update a file in place (see IceModel::write_backup()): variables that
+ * did not change since the last time they were written are left alone.
+ */
+void File::skip_writing(const std::set<std::string> &variables) const {
+  m_impl->skipped = variables;
+}
+
 } // end of namespace pism
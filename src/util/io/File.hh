@@ -21,6 +21,8 @@
 
 #include <vector>
 #include <string>
+#include <set>
+#include <memory>
 #include <mpi.h>
 
 #include "pism/util/Units.hh"
@@ -31,6 +33,11 @@ namespace pism {
 enum AxisType {X_AXIS, Y_AXIS, Z_AXIS, T_AXIS, UNKNOWN_AXIS};
 
 class IceGrid;
+class LocalInterpCtx;
+
+namespace io {
+class AsyncWriter;
+}
 
 /*!
  * Convert a string to PISM's backend type.
@@ -51,7 +58,9 @@ class File
 {
 public:
   File(MPI_Comm com, const std::string &filename, IO_Backend backend, IO_Mode mode,
-       int iosysid = -1);
+       int iosysid = -1, int n_aggregators = 0);
+  File(std::shared_ptr<io::AsyncWriter> writer, const std::string &filename,
+       IO_Backend backend, IO_Mode mode);
   ~File();
 
   IO_Backend backend() const;
@@ -99,6 +108,10 @@ public:
   void define_variable(const std::string &name, IO_Type nctype,
                        const std::vector<std::string> &dims) const;
 
+  void define_chunking(const std::string &name, const std::vector<size_t> &chunks) const;
+
+  void define_compression(const std::string &name, int level) const;
+
   VariableLookupData find_variable(const std::string &short_name, const std::string &std_name) const;
 
   bool find_variable(const std::string &short_name) const;
@@ -143,6 +156,17 @@ public:
   std::string read_text_attribute(const std::string &var_name, const std::string &att_name) const;
 
   void append_history(const std::string &history) const;
+
+  // cached interpolation contexts (used when regridding from this file)
+
+  std::shared_ptr<LocalInterpCtx> interpolation_context(const std::string &key) const;
+
+  void cache_interpolation_context(const std::string &key,
+                                   std::shared_ptr<LocalInterpCtx> context) const;
+
+  // updating a file in place
+
+  void skip_writing(const std::set<std::string> &variables) const;
 private:
   struct Impl;
   Impl *m_impl;
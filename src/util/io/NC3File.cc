@@ -26,6 +26,8 @@
 #include <netcdf.h>
 #include <cstring>              // memset
 #include <cstdio>               // stderr, fprintf
+#include <cmath>                // std::sqrt, std::ceil
+#include <algorithm>            // std::min, std::max, std::copy
 
 #include "pism/util/pism_utilities.hh" // join
 #include "pism/util/error_handling.hh"
@@ -50,14 +52,202 @@ static void check_and_abort(MPI_Comm com, const ErrorLocation &where, int return
   }
 }
 
-NC3File::NC3File(MPI_Comm c)
-  : NCFile(c), m_rank(0) {
+namespace {
+
+//! A hyperslab of a variable.
+struct Block {
+  std::vector<unsigned int> start, count;
+
+  size_t size() const {
+    size_t result = 1;
+    for (auto c : count) {
+      result *= c;
+    }
+    return result;
+  }
+};
+
+//! Groups of consecutive ranks: the first rank in each group is its aggregator.
+struct Groups {
+  Groups(MPI_Comm com, int n_aggregators) {
+    int rank = 0;
+    MPI_Comm_rank(com, &rank);
+    MPI_Comm_size(com, &size);
+
+    int N = n_aggregators;
+    if (N <= 0) {
+      N = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(size))));
+    }
+    N = std::max(1, std::min(N, size));
+
+    group_size = (size + N - 1) / N;
+    aggregator = (rank / group_size) * group_size;
+    end        = std::min(aggregator + group_size, size);
+  }
+
+  //! Number of groups (the number of aggregators).
+  int n_groups() const {
+    return (size + group_size - 1) / group_size;
+  }
+
+  int size;
+  int group_size;
+  //! the aggregator of the group containing this rank
+  int aggregator;
+  //! one past the last rank in this group
+  int end;
+};
+
+//! Row-major strides of a block with dimensions `count`.
+std::vector<unsigned int> row_major(const std::vector<unsigned int> &count) {
+  const int ndims = count.size();
+  std::vector<unsigned int> result(ndims, 1);
+  for (int k = ndims - 2; k >= 0; --k) {
+    result[k] = result[k + 1] * count[k + 1];
+  }
+  return result;
+}
+
+//! Copy values of `block` from (`to_box == false`) or to (`to_box == true`) `box_data`.
+/*!
+ * `box_data` stores values in the hyperslab `box` (containing `block`) in row-major
+ * order; `block_data` uses strides `imap`.
+ */
+void copy_values(const Block &box, double *box_data,
+                 const Block &block, const std::vector<unsigned int> &imap, double *block_data,
+                 bool to_box) {
+  const int ndims = box.count.size();
+  const size_t n  = block.size();
+
+  std::vector<unsigned int> box_stride = row_major(box.count);
+  std::vector<unsigned int> index(ndims, 0);
+
+  for (size_t m = 0; m < n; ++m) {
+    size_t a = 0, b = 0;
+    for (int k = 0; k < ndims; ++k) {
+      a += static_cast<size_t>(block.start[k] + index[k] - box.start[k]) * box_stride[k];
+      b += static_cast<size_t>(index[k]) * imap[k];
+    }
+
+    if (to_box) {
+      box_data[a] = block_data[b];
+    } else {
+      block_data[b] = box_data[a];
+    }
+
+    // the last index varies fastest
+    for (int k = ndims - 1; k >= 0; --k) {
+      index[k] += 1;
+      if (index[k] < block.count[k]) {
+        break;
+      }
+      index[k] = 0;
+    }
+  }
+}
+
+//! Return true if non-empty `blocks` form a hyperslab without gaps or overlaps.
+/*!
+ * If they do, sets `box` to this hyperslab. (With PETSc's domain decomposition consecutive
+ * ranks usually form a "stripe" of rows, so data sent by a group of ranks can be
+ * written or read using one call.)
+ */
+bool bounding_box(const std::vector<Block> &blocks, Block &box) {
+  std::vector<const Block*> nonempty;
+  for (const auto &b : blocks) {
+    if (b.size() > 0) {
+      nonempty.push_back(&b);
+    }
+  }
+
+  if (nonempty.empty()) {
+    return false;
+  }
+
+  const int ndims = nonempty[0]->count.size();
+
+  std::vector<unsigned int> box_end(ndims, 0);
+  box.start = nonempty[0]->start;
+  box.count.resize(ndims);
+  for (const auto *b : nonempty) {
+    for (int k = 0; k < ndims; ++k) {
+      box.start[k] = std::min(box.start[k], b->start[k]);
+      box_end[k]   = std::max(box_end[k], b->start[k] + b->count[k]);
+    }
+  }
+  for (int k = 0; k < ndims; ++k) {
+    box.count[k] = box_end[k] - box.start[k];
+  }
+
+  size_t total = 0;
+  for (const auto *b : nonempty) {
+    total += b->size();
+  }
+
+  if (total != box.size()) {
+    return false;
+  }
+
+  // check for overlaps (the number of blocks in a group is small)
+  for (size_t m = 0; m < nonempty.size(); ++m) {
+    for (size_t n = m + 1; n < nonempty.size(); ++n) {
+      bool overlap = true;
+      for (int k = 0; k < ndims; ++k) {
+        const Block &a = *nonempty[m], &b = *nonempty[n];
+        if (a.start[k] + a.count[k] <= b.start[k] or
+            b.start[k] + b.count[k] <= a.start[k]) {
+          overlap = false;
+          break;
+        }
+      }
+      if (overlap) {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
+//! Serialize a list of blocks: the number of blocks followed by starts and counts.
+std::vector<unsigned int> pack(const std::vector<Block> &blocks, int ndims) {
+  std::vector<unsigned int> result{static_cast<unsigned int>(blocks.size())};
+  for (const auto &b : blocks) {
+    result.insert(result.end(), b.start.begin(), b.start.begin() + ndims);
+    result.insert(result.end(), b.count.begin(), b.count.begin() + ndims);
+  }
+  return result;
+}
+
+std::vector<Block> unpack(const std::vector<unsigned int> &message, int ndims) {
+  std::vector<Block> result(message[0]);
+  auto p = message.begin() + 1;
+  for (auto &b : result) {
+    b.start.assign(p, p + ndims);
+    p += ndims;
+    b.count.assign(p, p + ndims);
+    p += ndims;
+  }
+  return result;
+}
+
+} // end of anonymous namespace
+
+/*!
+ * @param[in] c MPI communicator
+ * @param[in] n_aggregators number of ranks aggregating data sent to (or received from)
+ *            rank 0; use 0 to choose automatically (approximately the square root of the
+ *            communicator size) and 1 to send all data directly to rank 0
+ */
+NC3File::NC3File(MPI_Comm c, int n_aggregators)
+  : NCFile(c), m_rank(0), m_n_aggregators(n_aggregators) {
   MPI_Comm_rank(m_com, &m_rank);
 }
 
 NC3File::~NC3File() {
   if (m_file_id >= 0) {
     if (m_rank == 0) {
+      std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
       nc_close(m_file_id);
       fprintf(stderr, "NC3File::~NC3File: NetCDF file %s is still open\n",
               m_filename.c_str());
@@ -290,187 +480,313 @@ void NC3File::get_vara_double_impl(const std::string &variable_name,
 }
 
 //! \brief Get variable data.
+/*!
+ * Ranks are split into groups of consecutive ranks; the first rank in a group is its
+ * aggregator. Aggregators collect requests of ranks in their group (using non-blocking
+ * receives), send them to rank 0 (combined into one request if blocks of the group
+ * form one hyperslab) and distribute data read by rank 0. Rank 0 handles requests from
+ * aggregators in the order in which they arrive.
+ *
+ * Aggregators use `imap` (if `transposed` is true) to put data in the order requested by
+ * each rank, so rank 0 always reads contiguous hyperslabs.
+ */
 void NC3File::get_var_double(const std::string &variable_name,
-                            const std::vector<unsigned int> &start_input,
-                            const std::vector<unsigned int> &count_input,
+                            const std::vector<unsigned int> &start,
+                            const std::vector<unsigned int> &count,
                             const std::vector<unsigned int> &imap_input, double *ip,
                             bool transposed) const {
-  std::vector<unsigned int> start = start_input;
-  std::vector<unsigned int> count = count_input;
-  std::vector<unsigned int> imap = imap_input;
-  const int start_tag = 1,
-    count_tag = 2,
-    data_tag =  3,
-    imap_tag =  4,
-    chunk_size_tag = 5;
-  int stat = NC_NOERR, com_size, ndims = static_cast<int>(start.size());
-  std::vector<double> processor_0_buffer;
-  MPI_Status mpi_stat;
-  unsigned int local_chunk_size = 1,
-    processor_0_chunk_size = 0;
-
-  if (not transposed) {
-    imap.resize(ndims);
-  }
-
-  // get the size of the communicator
-  MPI_Comm_size(m_com, &com_size);
-
-  // compute the size of a local chunk
-  for (int k = 0; k < ndims; ++k) {
-    local_chunk_size *= count[k];
+  const int header_tag = 1,
+    data_tag = 2,
+    request_tag = 3,
+    reply_tag = 4;
+  const int ndims = static_cast<int>(start.size());
+  const Groups groups(m_com, m_n_aggregators);
+
+  const Block local{start, count};
+  const size_t local_size = local.size();
+  const std::vector<unsigned int> imap = transposed ? imap_input : row_major(count);
+
+  // a header contains a block (see pack()) followed by imap
+  const size_t header_size = 1 + 3 * ndims;
+
+  if (m_rank != groups.aggregator) {
+    std::vector<unsigned int> header = pack({local}, ndims);
+    header.insert(header.end(), imap.begin(), imap.begin() + ndims);
+
+    MPI_Send(header.data(), header_size, MPI_UNSIGNED, groups.aggregator, header_tag, m_com);
+    if (local_size > 0) {
+      MPI_Recv(ip, local_size, MPI_DOUBLE, groups.aggregator, data_tag, m_com, MPI_STATUS_IGNORE);
+    }
+    return;
   }
 
-  // compute the maximum and send it to processor 0; this is the size of the
-  // buffer processor 0 will need
-  MPI_Reduce(&local_chunk_size, &processor_0_chunk_size, 1, MPI_UNSIGNED, MPI_MAX, 0, m_com);
+  // rank 0 reads hyperslabs listed in `request`
+  auto read = [this, &variable_name, ndims](const std::vector<Block> &request,
+                                            std::vector<double> &data) {
+    int varid = 0;
+    int stat = nc_inq_varid(m_file_id, variable_name.c_str(), &varid);
+    check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
 
-  // now we need to send start, count and imap data to processor 0 and receive data
-  if (m_rank == 0) {
-    // Note: this could be optimized: if processor_0_chunk_size <=
-    // max(local_chunk_size) we can avoid allocating this buffer. The inner for
-    // loop will have to be re-ordered, though.
-    processor_0_buffer.resize(processor_0_chunk_size);
-
-    // MPI calls below require C datatypes (so that we don't have to worry
-    // about sizes of size_t and ptrdiff_t), so we make local copies of start,
-    // count, and imap to use in the nc_get_varm_double() call.
-    std::vector<size_t> nc_start(ndims), nc_count(ndims);
-    std::vector<ptrdiff_t> nc_imap(ndims), nc_stride(ndims);
-    int varid;
+    size_t offset = 0;
+    for (const auto &b : request) {
+      const size_t n = b.size();
+      if (n > 0) {
+        std::vector<size_t>
+          nc_start(b.start.begin(), b.start.begin() + ndims),
+          nc_count(b.count.begin(), b.count.begin() + ndims);
+
+        stat = nc_get_vara_double(m_file_id, varid, nc_start.data(), nc_count.data(),
+                                  data.data() + offset);
+        check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
+      }
+      offset += n;
+    }
+  };
 
-    stat = nc_inq_varid(m_file_id, variable_name.c_str(), &varid);
-    check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
+  auto total_size = [](const std::vector<Block> &blocks) {
+    size_t result = 0;
+    for (const auto &b : blocks) {
+      result += b.size();
+    }
+    return result;
+  };
+
+  // collect requests from ranks in this group
+  const int n_ranks = groups.end - groups.aggregator;
+  std::vector<Block> blocks(n_ranks);
+  std::vector<std::vector<unsigned int> > imaps(n_ranks);
+  {
+    std::vector<std::vector<unsigned int> > headers(n_ranks,
+                                                    std::vector<unsigned int>(header_size));
+    std::vector<MPI_Request> requests(n_ranks, MPI_REQUEST_NULL);
+    for (int r = 1; r < n_ranks; ++r) {
+      MPI_Irecv(headers[r].data(), header_size, MPI_UNSIGNED, groups.aggregator + r,
+                header_tag, m_com, &requests[r]);
+    }
+    MPI_Waitall(n_ranks, requests.data(), MPI_STATUSES_IGNORE);
 
-    for (int r = 0; r < com_size; ++r) {
+    blocks[0] = local;
+    imaps[0]  = imap;
+    for (int r = 1; r < n_ranks; ++r) {
+      blocks[r] = unpack(headers[r], ndims)[0];
+      imaps[r].assign(headers[r].end() - ndims, headers[r].end());
+    }
+  }
 
-      if (r != 0) {
-        // Note: start, count, imap, and local_chunk_size on processor zero are
-        // used *before* they get overwritten by these calls
-        MPI_Recv(&start[0],         ndims, MPI_UNSIGNED, r, start_tag,      m_com, &mpi_stat);
-        MPI_Recv(&count[0],         ndims, MPI_UNSIGNED, r, count_tag,      m_com, &mpi_stat);
-        MPI_Recv(&imap[0],          ndims, MPI_UNSIGNED, r, imap_tag,       m_com, &mpi_stat);
-        MPI_Recv(&local_chunk_size, 1,     MPI_UNSIGNED, r, chunk_size_tag, m_com, &mpi_stat);
-      }
+  Block box;
+  const bool merged = n_ranks > 1 and bounding_box(blocks, box);
+  const std::vector<Block> request = merged ? std::vector<Block>{box} : blocks;
 
-      // This for loop uses start, count and imap passed in as arguments when r
-      // == 0. For r > 0 they are overwritten by MPI_Recv calls above.
-      for (int k = 0; k < ndims; ++k) {
-        nc_start[k]  = start[k];
-        nc_count[k]  = count[k];
-        nc_imap[k]   = imap[k];
-        nc_stride[k] = 1;       // fill with ones; this way it works even with
-                                // NetCDF versions with a bug affecting the
-                                // stride == NULL case.
-      }
+  std::vector<double> data(total_size(request));
+  if (m_rank == 0) {
+    read(request, data);
+  } else {
+    std::vector<unsigned int> message = pack(request, ndims);
+    MPI_Send(message.data(), message.size(), MPI_UNSIGNED, 0, request_tag, m_com);
+    MPI_Recv(data.data(), data.size(), MPI_DOUBLE, 0, reply_tag, m_com, MPI_STATUS_IGNORE);
+  }
 
-      if (transposed) {
-        stat = nc_get_varm_double(m_file_id, varid, &nc_start[0], &nc_count[0], &nc_stride[0], &nc_imap[0],
-                                  &processor_0_buffer[0]);
-      } else {
-        stat = nc_get_vara_double(m_file_id, varid, &nc_start[0], &nc_count[0],
-                                  &processor_0_buffer[0]);
+  // distribute data
+  {
+    std::vector<std::vector<double> > buffers(n_ranks);
+    std::vector<MPI_Request> requests(n_ranks, MPI_REQUEST_NULL);
+    size_t offset = 0;
+    for (int r = 0; r < n_ranks; ++r) {
+      const size_t n = blocks[r].size();
+      if (n == 0) {
+        continue;
       }
-      check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
 
-      if (r != 0) {
-        MPI_Send(&processor_0_buffer[0], local_chunk_size, MPI_DOUBLE, r, data_tag, m_com);
+      const Block &source = merged ? box : blocks[r];
+      double *source_data = merged ? data.data() : data.data() + offset;
+      offset += n;
+
+      if (r == 0) {
+        copy_values(source, source_data, blocks[r], imaps[r], ip, false);
       } else {
-        for (unsigned int k = 0; k < local_chunk_size; ++k) {
-          ip[k] = processor_0_buffer[k];
-        }
+        buffers[r].resize(n);
+        copy_values(source, source_data, blocks[r], imaps[r], buffers[r].data(), false);
+        MPI_Isend(buffers[r].data(), n, MPI_DOUBLE, groups.aggregator + r, data_tag, m_com,
+                  &requests[r]);
       }
-    } // end of the for loop
+    }
+    MPI_Waitall(n_ranks, requests.data(), MPI_STATUSES_IGNORE);
+  }
 
-  } else {
-    MPI_Send(&start[0],          ndims, MPI_UNSIGNED, 0, start_tag,      m_com);
-    MPI_Send(&count[0],          ndims, MPI_UNSIGNED, 0, count_tag,      m_com);
-    MPI_Send(&imap[0],           ndims, MPI_UNSIGNED, 0, imap_tag,       m_com);
-    MPI_Send(&local_chunk_size,  1,     MPI_UNSIGNED, 0, chunk_size_tag, m_com);
+  // rank 0 handles requests from other aggregators
+  if (m_rank == 0) {
+    const int n_other = groups.n_groups() - 1;
+    const size_t max_length = 1 + 2 * ndims * groups.group_size;
+
+    std::vector<std::vector<unsigned int> > messages(n_other,
+                                                     std::vector<unsigned int>(max_length));
+    std::vector<MPI_Request> requests(n_other, MPI_REQUEST_NULL);
+    for (int g = 0; g < n_other; ++g) {
+      MPI_Irecv(messages[g].data(), max_length, MPI_UNSIGNED, (g + 1) * groups.group_size,
+                request_tag, m_com, &requests[g]);
+    }
+
+    for (int k = 0; k < n_other; ++k) {
+      int g = 0;
+      MPI_Waitany(n_other, requests.data(), &g, MPI_STATUS_IGNORE);
+
+      std::vector<Block> other = unpack(messages[g], ndims);
+      std::vector<double> reply(total_size(other));
+      read(other, reply);
 
-    MPI_Recv(ip, local_chunk_size, MPI_DOUBLE, 0, data_tag, m_com, &mpi_stat);
+      MPI_Send(reply.data(), reply.size(), MPI_DOUBLE, (g + 1) * groups.group_size,
+               reply_tag, m_com);
+    }
   }
 }
 
+/*!
+ * Uses the same groups of ranks as get_var_double(): aggregators collect data from their
+ * groups (using non-blocking receives), combine blocks forming one hyperslab into one and
+ * send data to rank 0, which writes data from aggregators in the order in which they
+ * arrive.
+ *
+ * Rank 0 needs a buffer for data from one group (not from all ranks).
+ */
 void NC3File::put_vara_double_impl(const std::string &variable_name,
-                                 const std::vector<unsigned int> &start_input,
-                                 const std::vector<unsigned int> &count_input,
+                                 const std::vector<unsigned int> &start,
+                                 const std::vector<unsigned int> &count,
                                  const double *op) const {
-  // make copies of start and count so that we can use them in MPI_Recv() calls below
-  std::vector<unsigned int> start = start_input;
-  std::vector<unsigned int> count = count_input;
-  const int start_tag = 1,
-    count_tag = 2,
-    data_tag =  3,
-    chunk_size_tag = 4;
-  int stat = NC_NOERR, com_size = 0, ndims = static_cast<int>(start.size());
-  std::vector<double> processor_0_buffer;
-  MPI_Status mpi_stat;
-  unsigned int local_chunk_size = 1,
-    processor_0_chunk_size = 0;
-
-  // get the size of the communicator
-  MPI_Comm_size(m_com, &com_size);
-
-  // compute the size of a local chunk
-  for (int k = 0; k < ndims; ++k) {
-    local_chunk_size *= count[k];
+  const int header_tag = 1,
+    data_tag = 2,
+    aggregate_header_tag = 3,
+    aggregate_data_tag = 4;
+  const int ndims = static_cast<int>(start.size());
+  const Groups groups(m_com, m_n_aggregators);
+
+  const Block local{start, count};
+  const size_t local_size = local.size();
+
+  // a header contains one block (see pack())
+  const size_t header_size = 1 + 2 * ndims;
+
+  if (m_rank != groups.aggregator) {
+    std::vector<unsigned int> header = pack({local}, ndims);
+
+    MPI_Send(header.data(), header_size, MPI_UNSIGNED, groups.aggregator, header_tag, m_com);
+    if (local_size > 0) {
+      MPI_Send(const_cast<double*>(op), local_size, MPI_DOUBLE, groups.aggregator,
+               data_tag, m_com);
+    }
+    return;
   }
 
-  // compute the maximum and send it to processor 0; this is the size of the
-  // buffer processor 0 will need
-  MPI_Reduce(&local_chunk_size, &processor_0_chunk_size, 1, MPI_UNSIGNED, MPI_MAX, 0, m_com);
+  // collect data from ranks in this group
+  const int n_ranks = groups.end - groups.aggregator;
+  std::vector<Block> blocks(n_ranks);
+  std::vector<size_t> offset(n_ranks + 1, 0);
+  {
+    std::vector<std::vector<unsigned int> > headers(n_ranks,
+                                                    std::vector<unsigned int>(header_size));
+    std::vector<MPI_Request> requests(n_ranks, MPI_REQUEST_NULL);
+    for (int r = 1; r < n_ranks; ++r) {
+      MPI_Irecv(headers[r].data(), header_size, MPI_UNSIGNED, groups.aggregator + r,
+                header_tag, m_com, &requests[r]);
+    }
+    MPI_Waitall(n_ranks, requests.data(), MPI_STATUSES_IGNORE);
 
-  // now we need to send start and count data to processor 0 and receive data
-  if (m_rank == 0) {
-    processor_0_buffer.resize(processor_0_chunk_size);
+    blocks[0] = local;
+    for (int r = 1; r < n_ranks; ++r) {
+      blocks[r] = unpack(headers[r], ndims)[0];
+    }
+    for (int r = 0; r < n_ranks; ++r) {
+      offset[r + 1] = offset[r] + blocks[r].size();
+    }
+  }
 
-    // MPI calls below require C datatypes (so that we don't have to worry about sizes of
-    // size_t and ptrdiff_t), so we make local copies of start and count to use in the
-    // nc_get_vara_double() call.
-    std::vector<size_t> nc_start(ndims), nc_count(ndims);
-    std::vector<ptrdiff_t> nc_stride(ndims);
-    int varid;
+  std::vector<double> data(offset[n_ranks]);
+  {
+    std::copy(op, op + local_size, data.begin());
 
-    stat = nc_inq_varid(m_file_id, variable_name.c_str(), &varid);
-    check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
+    std::vector<MPI_Request> requests(n_ranks, MPI_REQUEST_NULL);
+    for (int r = 1; r < n_ranks; ++r) {
+      const size_t n = blocks[r].size();
+      if (n > 0) {
+        MPI_Irecv(data.data() + offset[r], n, MPI_DOUBLE, groups.aggregator + r, data_tag,
+                  m_com, &requests[r]);
+      }
+    }
+    MPI_Waitall(n_ranks, requests.data(), MPI_STATUSES_IGNORE);
+  }
 
-    for (int r = 0; r < com_size; ++r) {
+  // combine blocks if they form one hyperslab
+  Block box;
+  if (n_ranks > 1 and bounding_box(blocks, box)) {
+    std::vector<double> box_data(box.size());
+    for (int r = 0; r < n_ranks; ++r) {
+      copy_values(box, box_data.data(), blocks[r], row_major(blocks[r].count),
+                  data.data() + offset[r], true);
+    }
+    blocks = {box};
+    data.swap(box_data);
+  }
 
-      if (r != 0) {
-        // Note: start, count, and local_chunk_size on processor zero are used *before*
-        // they get overwritten by these calls
-        MPI_Recv(&start[0],         ndims, MPI_UNSIGNED, r, start_tag,      m_com, &mpi_stat);
-        MPI_Recv(&count[0],         ndims, MPI_UNSIGNED, r, count_tag,      m_com, &mpi_stat);
-        MPI_Recv(&local_chunk_size, 1,     MPI_UNSIGNED, r, chunk_size_tag, m_com, &mpi_stat);
+  if (m_rank != 0) {
+    std::vector<unsigned int> message = pack(blocks, ndims);
+    MPI_Send(message.data(), message.size(), MPI_UNSIGNED, 0, aggregate_header_tag, m_com);
+    MPI_Send(data.data(), data.size(), MPI_DOUBLE, 0, aggregate_data_tag, m_com);
+    return;
+  }
 
-        MPI_Recv(&processor_0_buffer[0], local_chunk_size, MPI_DOUBLE, r, data_tag, m_com, &mpi_stat);
-      } else {
-        for (unsigned int k = 0; k < local_chunk_size; ++k) {
-          processor_0_buffer[k] = op[k];
-        }
+  // rank 0 writes data
+  int varid = 0;
+  int stat = nc_inq_varid(m_file_id, variable_name.c_str(), &varid);
+  check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
+
+  auto write = [this, varid, ndims](const std::vector<Block> &slabs,
+                                    const std::vector<double> &values) {
+    size_t position = 0;
+    for (const auto &b : slabs) {
+      const size_t n = b.size();
+      if (n > 0) {
+        std::vector<size_t>
+          nc_start(b.start.begin(), b.start.begin() + ndims),
+          nc_count(b.count.begin(), b.count.begin() + ndims);
+
+        int status = nc_put_vara_double(m_file_id, varid, nc_start.data(), nc_count.data(),
+                                        values.data() + position);
+        check_and_abort(m_com, PISM_ERROR_LOCATION, status);
       }
+      position += n;
+    }
+  };
 
-      // This for loop uses start and count passed in as arguments when r == 0. For r > 0
-      // they are overwritten by MPI_Recv calls above.
-      for (int k = 0; k < ndims; ++k) {
-        nc_start[k]  = start[k];
-        nc_count[k]  = count[k];
-        nc_stride[k] = 1;       // fill with ones; this way it works even with
-                                // NetCDF versions with a bug affecting the
-                                // stride == NULL case.
-      }
+  write(blocks, data);
 
-      stat = nc_put_vara_double(m_file_id, varid, &nc_start[0], &nc_count[0],
-                                &processor_0_buffer[0]);
-      check_and_abort(m_com, PISM_ERROR_LOCATION, stat);
-    } // end of the for loop
-  } else {
-    MPI_Send(&start[0],          ndims, MPI_UNSIGNED, 0, start_tag,      m_com);
-    MPI_Send(&count[0],          ndims, MPI_UNSIGNED, 0, count_tag,      m_com);
-    MPI_Send(&local_chunk_size,  1,     MPI_UNSIGNED, 0, chunk_size_tag, m_com);
+  // receive data from other aggregators in the order in which they are ready
+  const int n_other = groups.n_groups() - 1;
+  const size_t max_length = 1 + 2 * ndims * groups.group_size;
+
+  std::vector<std::vector<unsigned int> > messages(n_other,
+                                                   std::vector<unsigned int>(max_length));
+  std::vector<MPI_Request> requests(n_other, MPI_REQUEST_NULL);
+  for (int g = 0; g < n_other; ++g) {
+    MPI_Irecv(messages[g].data(), max_length, MPI_UNSIGNED, (g + 1) * groups.group_size,
+              aggregate_header_tag, m_com, &requests[g]);
+  }
+
+  for (int k = 0; k < n_other; ++k) {
+    int g = 0;
+    MPI_Waitany(n_other, requests.data(), &g, MPI_STATUS_IGNORE);
+
+    std::vector<Block> other = unpack(messages[g], ndims);
+
+    size_t size = 0;
+    for (const auto &b : other) {
+      size += b.size();
+    }
+
+    // rank 0 needs a buffer for data from one group at a time
+    data.resize(size);
+    MPI_Recv(data.data(), size, MPI_DOUBLE, (g + 1) * groups.group_size,
+             aggregate_data_tag, m_com, MPI_STATUS_IGNORE);
 
-    MPI_Send(const_cast<double*>(op), local_chunk_size, MPI_DOUBLE, 0, data_tag, m_com);
+    write(other, data);
   }
 }
 
@@ -878,6 +1194,7 @@ std::string NC3File::get_format() const {
   int format;
 
   if (m_rank == 0) {
+    std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
     int stat = nc_inq_format(m_file_id, &format); check(PISM_ERROR_LOCATION, stat);
   }
   MPI_Barrier(m_com);
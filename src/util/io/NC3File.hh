@@ -27,7 +27,7 @@ namespace io {
 class NC3File : public NCFile
 {
 public:
-  NC3File(MPI_Comm com);
+  NC3File(MPI_Comm com, int n_aggregators = 0);
   virtual ~NC3File();
 
   std::string get_format() const;
@@ -105,6 +105,8 @@ protected:
   void del_att_impl(const std::string &variable_name, const std::string &att_name) const;
 private:
   int m_rank;
+  //! number of ranks aggregating data for rank 0 (0 means "choose automatically")
+  int m_n_aggregators;
 
   void get_var_double(const std::string &variable_name,
                      const std::vector<unsigned int> &start,
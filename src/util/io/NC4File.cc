@@ -42,8 +42,8 @@ static void check(const ErrorLocation &where, int return_code) {
   }
 }
 
-NC4File::NC4File(MPI_Comm c, unsigned int compression_level)
-  : NCFile(c), m_compression_level(compression_level) {
+NC4File::NC4File(MPI_Comm c)
+  : NCFile(c) {
   // empty
 }
 
@@ -136,13 +136,6 @@ void NC4File::def_var_impl(const std::string &name,
   stat = nc_def_var(m_file_id, name.c_str(), pism_type_to_nc_type(nctype),
                     static_cast<int>(dims.size()), &dimids[0], &varid);
   check(PISM_ERROR_LOCATION, stat);
-
-  // Compress 2D and 3D variables
-  if (m_compression_level > 0 and dims.size() > 1) {
-    stat = nc_inq_varid(m_file_id, name.c_str(), &varid); check(PISM_ERROR_LOCATION, stat);
-    stat = nc_def_var_deflate(m_file_id, varid, 0, 1, m_compression_level);
-    check(PISM_ERROR_LOCATION, stat);
-  }
 }
 
 void NC4File::def_var_chunking_impl(const std::string &name,
@@ -156,6 +149,21 @@ void NC4File::def_var_chunking_impl(const std::string &name,
   check(PISM_ERROR_LOCATION, stat);
 }
 
+void NC4File::def_var_deflate_impl(const std::string &name, int level) const {
+  if (level <= 0) {
+    return;
+  }
+
+  int stat = 0, varid = 0;
+
+  stat = nc_inq_varid(m_file_id, name.c_str(), &varid);
+  check(PISM_ERROR_LOCATION, stat);
+
+  // use the shuffle filter: it improves compression of floating point data
+  stat = nc_def_var_deflate(m_file_id, varid, 1, 1, level);
+  check(PISM_ERROR_LOCATION, stat);
+}
+
 void NC4File::get_varm_double_impl(const std::string &variable_name,
                                   const std::vector<unsigned int> &start,
                                   const std::vector<unsigned int> &count,
@@ -27,7 +27,7 @@ namespace io {
 class NC4File : public NCFile
 {
 public:
-  NC4File(MPI_Comm com, unsigned int compression_level);
+  NC4File(MPI_Comm com);
   virtual ~NC4File();
 
 protected:
@@ -56,6 +56,8 @@ protected:
   virtual void def_var_chunking_impl(const std::string &name,
                                     std::vector<size_t> &dimensions) const;
 
+  virtual void def_var_deflate_impl(const std::string &name, int level) const;
+
   virtual void def_var_impl(const std::string &name,
                            IO_Type nctype, const std::vector<std::string> &dims) const;
 
@@ -109,8 +111,6 @@ protected:
                                  const std::vector<unsigned int> &imap, double *ip,
                                  bool get,
                                  bool mapped) const;
-  unsigned int m_compression_level;
-
   int get_varid(const std::string &variable_name) const;
 };
 
@@ -25,6 +25,7 @@
 // have a parallel NetCDF library.
 extern "C" {
 #include <netcdf.h>
+#include <netcdf_meta.h>            // NC_HAS_PAR_FILTERS
 #include <netcdf_par.h>
 }
 
@@ -61,6 +62,23 @@ void NC4_Par::create_impl(const std::string &fname) {
   check(PISM_ERROR_LOCATION, stat);
 }
 
+/*!
+ * Writing compressed variables in parallel requires NetCDF 4.7.4 or later built with
+ * HDF5 1.10.3 or later.
+ */
+void NC4_Par::def_var_deflate_impl(const std::string &name, int level) const {
+#if defined(NC_HAS_PAR_FILTERS) && (NC_HAS_PAR_FILTERS==1)
+  NC4File::def_var_deflate_impl(name, level);
+#else
+  if (level > 0) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot compress '%s': this NetCDF library does not support"
+                                  " compression in parallel (NetCDF >= 4.7.4 is required)",
+                                  name.c_str());
+  }
+#endif
+}
+
 void NC4_Par::set_access_mode(int varid, bool transposed) const {
   int stat;
 
@@ -28,7 +28,7 @@ class NC4_Par : public NC4File
 {
 public:
   NC4_Par(MPI_Comm c)
-    : NC4File(c, 0) {}
+    : NC4File(c) {}
   virtual ~NC4_Par() {}
 protected:
   // open/create/close
@@ -36,6 +36,8 @@ protected:
 
   virtual void create_impl(const std::string &filename);
 
+  virtual void def_var_deflate_impl(const std::string &name, int level) const;
+
   virtual void set_access_mode(int varid, bool mapped) const;
 };
 
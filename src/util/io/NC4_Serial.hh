@@ -27,8 +27,8 @@ namespace io {
 class NC4_Serial : public NC4File
 {
 public:
-  NC4_Serial(MPI_Comm c, unsigned int compression_level)
-    : NC4File(c, compression_level) {}
+  NC4_Serial(MPI_Comm c)
+    : NC4File(c) {}
   virtual ~NC4_Serial() {}
 protected:
   // open/create/close
@@ -33,8 +33,31 @@
 namespace pism {
 namespace io {
 
+//! Mutex used to serialize calls to the NetCDF library.
+/*!
+ * NetCDF is not thread-safe, so all calls made while an AsyncWriter thread may be writing
+ * output have to go through this mutex.
+ */
+std::recursive_mutex& netcdf_mutex() {
+  static std::recursive_mutex mutex;
+  return mutex;
+}
+
+//! Locks netcdf_mutex() if calls of a given NCFile instance need to be serialized.
+class NCFile::Lock {
+public:
+  Lock(const NCFile &file)
+    : m_lock(netcdf_mutex(), std::defer_lock) {
+    if (file.m_serialize_calls) {
+      m_lock.lock();
+    }
+  }
+private:
+  std::unique_lock<std::recursive_mutex> m_lock;
+};
+
 NCFile::NCFile(MPI_Comm c)
-  : m_com(c), m_file_id(-1), m_define_mode(false) {
+  : m_com(c), m_file_id(-1), m_serialize_calls(true), m_define_mode(false) {
 }
 
 NCFile::~NCFile() {
@@ -52,31 +75,42 @@ void NCFile::def_var_chunking_impl(const std::string &name,
   // the default implementation does nothing
 }
 
+void NCFile::def_var_deflate_impl(const std::string &name, int level) const {
+  (void) name;
+  (void) level;
+  // the default implementation does nothing
+}
+
 
 void NCFile::open(const std::string &filename, IO_Mode mode) {
+  Lock lock(*this);
   this->open_impl(filename, mode);
   m_filename = filename;
   m_define_mode = false;
 }
 
 void NCFile::create(const std::string &filename) {
+  Lock lock(*this);
   this->create_impl(filename);
   m_filename = filename;
   m_define_mode = true;
 }
 
 void NCFile::sync() const {
+  Lock lock(*this);
   enddef();
   this->sync_impl();
 }
 
 void NCFile::close() {
+  Lock lock(*this);
   this->close_impl();
   m_filename.clear();
   m_file_id = -1;
 }
 
 void NCFile::enddef() const {
+  Lock lock(*this);
   if (m_define_mode) {
     this->enddef_impl();
     m_define_mode = false;
@@ -84,6 +118,7 @@ void NCFile::enddef() const {
 }
 
 void NCFile::redef() const {
+  Lock lock(*this);
   if (not m_define_mode) {
     this->redef_impl();
     m_define_mode = true;
@@ -91,38 +126,52 @@ void NCFile::redef() const {
 }
 
 void NCFile::def_dim(const std::string &name, size_t length) const {
+  Lock lock(*this);
   redef();
   this->def_dim_impl(name, length);
 }
 
 void NCFile::inq_dimid(const std::string &dimension_name, bool &exists) const {
+  Lock lock(*this);
   this->inq_dimid_impl(dimension_name,exists);
 }
 
 void NCFile::inq_dimlen(const std::string &dimension_name, unsigned int &result) const {
+  Lock lock(*this);
   this->inq_dimlen_impl(dimension_name,result);
 }
 
 void NCFile::inq_unlimdim(std::string &result) const {
+  Lock lock(*this);
   this->inq_unlimdim_impl(result);
 }
 
 void NCFile::def_var(const std::string &name, IO_Type nctype,
                     const std::vector<std::string> &dims) const {
+  Lock lock(*this);
   redef();
   this->def_var_impl(name, nctype, dims);
 }
 
 void NCFile::def_var_chunking(const std::string &name,
                               std::vector<size_t> &dimensions) const {
+  Lock lock(*this);
   this->def_var_chunking_impl(name, dimensions);
 }
 
+//! Set the compression level of a variable (0 to 9). Ignored by backends that do not
+//! support compression.
+void NCFile::def_var_deflate(const std::string &name, int level) const {
+  Lock lock(*this);
+  this->def_var_deflate_impl(name, level);
+}
+
 
 void NCFile::get_vara_double(const std::string &variable_name,
                             const std::vector<unsigned int> &start,
                             const std::vector<unsigned int> &count,
                             double *ip) const {
+  Lock lock(*this);
 #if (Pism_DEBUG==1)
   if (start.size() != count.size()) {
     throw RuntimeError::formatted(PISM_ERROR_LOCATION,
@@ -138,6 +187,7 @@ void NCFile::put_vara_double(const std::string &variable_name,
                             const std::vector<unsigned int> &start,
                             const std::vector<unsigned int> &count,
                             const double *op) const {
+  Lock lock(*this);
 #if (Pism_DEBUG==1)
   if (start.size() != count.size()) {
     throw RuntimeError::formatted(PISM_ERROR_LOCATION,
@@ -155,6 +205,7 @@ void NCFile::write_darray(const std::string &variable_name,
                           unsigned int z_count,
                           unsigned int record,
                           const double *input) {
+  Lock lock(*this);
   enddef();
   this->write_darray_impl(variable_name, grid, z_count, record, input);
 }
@@ -204,6 +255,7 @@ void NCFile::get_varm_double(const std::string &variable_name,
                             const std::vector<unsigned int> &count,
                             const std::vector<unsigned int> &imap,
                             double *ip) const {
+  Lock lock(*this);
 
 #if (Pism_DEBUG==1)
   if (start.size() != count.size() or
@@ -218,34 +270,41 @@ void NCFile::get_varm_double(const std::string &variable_name,
 }
 
 void NCFile::inq_nvars(int &result) const {
+  Lock lock(*this);
   this->inq_nvars_impl(result);
 }
 
 void NCFile::inq_vardimid(const std::string &variable_name, std::vector<std::string> &result) const {
+  Lock lock(*this);
   this->inq_vardimid_impl(variable_name, result);
 }
 
 void NCFile::inq_varnatts(const std::string &variable_name, int &result) const {
+  Lock lock(*this);
   this->inq_varnatts_impl(variable_name, result);
 }
 
 void NCFile::inq_varid(const std::string &variable_name, bool &result) const {
+  Lock lock(*this);
   this->inq_varid_impl(variable_name, result);
 }
 
 void NCFile::inq_varname(unsigned int j, std::string &result) const {
+  Lock lock(*this);
   this->inq_varname_impl(j, result);
 }
 
 void NCFile::get_att_double(const std::string &variable_name,
                             const std::string &att_name,
                             std::vector<double> &result) const {
+  Lock lock(*this);
   this->get_att_double_impl(variable_name, att_name, result);
 }
 
 void NCFile::get_att_text(const std::string &variable_name,
                           const std::string &att_name,
                           std::string &result) const {
+  Lock lock(*this);
   this->get_att_text_impl(variable_name, att_name, result);
 }
 
@@ -253,33 +312,39 @@ void NCFile::put_att_double(const std::string &variable_name,
                             const std::string &att_name,
                             IO_Type xtype,
                             const std::vector<double> &data) const {
+  Lock lock(*this);
   this->put_att_double_impl(variable_name, att_name, xtype, data);
 }
 
 void NCFile::put_att_text(const std::string &variable_name,
                           const std::string &att_name,
                           const std::string &value) const {
+  Lock lock(*this);
   this->put_att_text_impl(variable_name, att_name, value);
 }
 
 void NCFile::inq_attname(const std::string &variable_name,
                          unsigned int n,
                          std::string &result) const {
+  Lock lock(*this);
   this->inq_attname_impl(variable_name, n, result);
 }
 
 void NCFile::inq_atttype(const std::string &variable_name,
                          const std::string &att_name,
                          IO_Type &result) const {
+  Lock lock(*this);
   this->inq_atttype_impl(variable_name, att_name, result);
 }
 
 void NCFile::set_fill(int fillmode, int &old_modep) const {
+  Lock lock(*this);
   redef();
   this->set_fill_impl(fillmode, old_modep);
 }
 
 void NCFile::del_att(const std::string &variable_name, const std::string &att_name) const {
+  Lock lock(*this);
   this->del_att_impl(variable_name, att_name);
 }
 
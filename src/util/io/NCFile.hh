@@ -22,6 +22,7 @@
 #include <memory>
 #include <string>
 #include <vector>
+#include <mutex>
 
 #include <mpi.h>
 
@@ -34,6 +35,8 @@ class IceGrid;
 //! Input and output code (NetCDF wrappers, etc)
 namespace io {
 
+std::recursive_mutex& netcdf_mutex();
+
 //! \brief The PISM wrapper for a subset of the NetCDF C API.
 /*!
  * The goal of this class is to hide the fact that we need to communicate data
@@ -90,6 +93,8 @@ public:
 
   void def_var_chunking(const std::string &name, std::vector<size_t> &dimensions) const;
 
+  void def_var_deflate(const std::string &name, int level) const;
+
   void get_vara_double(const std::string &variable_name,
                        const std::vector<unsigned int> &start,
                        const std::vector<unsigned int> &count,
@@ -173,6 +178,7 @@ protected:
   virtual void def_var_impl(const std::string &name, IO_Type nctype,
                            const std::vector<std::string> &dims) const = 0;
 
+  virtual void def_var_deflate_impl(const std::string &name, int level) const;
   virtual void def_var_chunking_impl(const std::string &name,
                                     std::vector<size_t> &dimensions) const;
 
@@ -231,8 +237,12 @@ protected:                      // data members
   MPI_Comm m_com;
   int m_file_id;
   std::string m_filename;
+  //! true if calls of this instance should be serialized using netcdf_mutex()
+  bool m_serialize_calls;
 private:
   mutable bool m_define_mode;
+
+  class Lock;
 };
 
 } // end of namespace io
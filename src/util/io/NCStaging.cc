@@ -0,0 +1,813 @@
+/* Copyright (C) 2019 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+// The following is a stupid kludge necessary to make NetCDF 4.x work in
+// serial mode in an MPI program:
+#ifndef MPI_INCLUDED
+#define MPI_INCLUDED 1
+#endif
+#include <netcdf.h>
+#include <cstdio>               // fopen, fclose, rename
+#include <algorithm>            // std::max
+
+#include "NCStaging.hh"
+#include "NC3File.hh"
+#include "AsyncWriter.hh"
+#include "pism/util/error_handling.hh"
+
+#include "pism_type_conversion.hh" // This has to be included *after* netcdf.h.
+
+namespace pism {
+namespace io {
+
+struct NCStaging::Impl {
+  struct Attribute {
+    std::string name;
+    IO_Type type;
+    //! values of a numeric attribute
+    std::vector<double> numbers;
+    //! value of a text attribute
+    std::string text;
+  };
+
+  struct Variable {
+    std::string name;
+    std::vector<std::string> dimensions;
+    std::vector<Attribute> attributes;
+  };
+
+  struct Dimension {
+    std::string name;
+    unsigned int length;
+  };
+
+  //! A recorded NetCDF call.
+  struct Operation {
+    enum Kind {CREATE, OPEN, SYNC, CLOSE, DEF_DIM, DEF_VAR, DEF_VAR_CHUNKING,
+               DEF_VAR_DEFLATE, PUT_ATT_DOUBLE, PUT_ATT_TEXT, DEL_ATT, PUT_VARA, SET_FILL};
+
+    Operation(Kind k)
+      : kind(k), type(PISM_NAT), length(0) {
+      // empty
+    }
+
+    Kind kind;
+    //! file, dimension or variable name
+    std::string name;
+    //! attribute name
+    std::string attribute;
+    //! value of a text attribute
+    std::string text;
+    //! variable or attribute type
+    IO_Type type;
+    //! dimension length, fill mode or compression level
+    size_t length;
+    //! dimensions of a variable
+    std::vector<std::string> dimensions;
+    //! values of a numeric attribute or data written by put_vara_double()
+    std::vector<double> data;
+    //! start and count used by put_vara_double(); chunk sizes are stored in `count`
+    std::vector<size_t> start, count;
+  };
+
+  //! NetCDF file written by the writer thread.
+  class Output {
+  public:
+    Output(IO_Backend format);
+    ~Output();
+    void apply(const Operation &op);
+  private:
+    void check(const ErrorLocation &location, int stat) const;
+    int varid(const std::string &name) const;
+    void redef();
+    void enddef();
+    bool netcdf4() const;
+
+    int m_ncid;
+    bool m_define_mode;
+    IO_Backend m_format;
+    std::string m_filename;
+  };
+
+  void reset();
+  void record(Operation &op);
+  void flush();
+  void read_structure(MPI_Comm com, const std::string &filename);
+
+  Variable& variable(const std::string &name);
+  Attribute* attribute(const std::string &variable_name, const std::string &attribute_name);
+  Dimension* dimension(const std::string &name);
+
+  std::shared_ptr<AsyncWriter> writer;
+  int rank;
+
+  // Structure of the file (maintained on all ranks):
+  std::vector<Dimension> dimensions;
+  std::string unlimited_dimension;
+  std::vector<Variable> variables;
+  //! global attributes
+  Variable global;
+  int fill_mode;
+
+  // Recorded operations (on rank 0 only):
+  std::shared_ptr<Output> output;
+  std::shared_ptr<std::vector<Operation> > pending;
+  //! size (in bytes) of data in `pending`
+  size_t pending_size;
+};
+
+NCStaging::NCStaging(std::shared_ptr<AsyncWriter> writer, IO_Backend format)
+  : NCFile(writer->com()), m_impl(new Impl) {
+
+  // calls of this class do not use NetCDF and may have to wait for the writer thread
+  // (which needs netcdf_mutex()), so we should not lock it
+  m_serialize_calls = false;
+
+  m_impl->writer = writer;
+  m_impl->rank   = 0;
+  MPI_Comm_rank(m_com, &m_impl->rank);
+
+  if (m_impl->rank == 0) {
+    m_impl->output.reset(new Impl::Output(format));
+  }
+
+  m_impl->reset();
+}
+
+NCStaging::~NCStaging() {
+  delete m_impl;
+}
+
+void NCStaging::Impl::reset() {
+  dimensions.clear();
+  unlimited_dimension.clear();
+  variables.clear();
+  global = Variable();
+  global.name = "PISM_GLOBAL";
+  fill_mode = PISM_FILL;
+
+  pending.reset(new std::vector<Operation>());
+  pending_size = 0;
+}
+
+//! Record an operation (only rank 0 has to keep them). Moves data out of `op`.
+void NCStaging::Impl::record(Operation &op) {
+  if (rank == 0) {
+    pending_size += op.data.size() * sizeof(double);
+    pending->push_back(std::move(op));
+  }
+}
+
+//! Send recorded operations to the writer thread.
+void NCStaging::Impl::flush() {
+  if (rank == 0 and not pending->empty()) {
+    std::shared_ptr<std::vector<Operation> > operations = pending;
+    std::shared_ptr<Output> file = output;
+
+    writer->submit([operations, file]() {
+        for (const auto &op : *operations) {
+          file->apply(op);
+        }
+      },
+      pending_size);
+
+    pending.reset(new std::vector<Operation>());
+    pending_size = 0;
+  }
+}
+
+//! Read the structure (dimensions, variables, attributes) of an existing file.
+void NCStaging::Impl::read_structure(MPI_Comm com, const std::string &filename) {
+  NC3File file(com);
+
+  file.open(filename, PISM_READONLY);
+
+  auto read_attributes = [&file](Variable &var) {
+    int n_attributes = 0;
+    file.inq_varnatts(var.name, n_attributes);
+
+    for (int k = 0; k < n_attributes; ++k) {
+      Attribute att;
+      file.inq_attname(var.name, k, att.name);
+      file.inq_atttype(var.name, att.name, att.type);
+
+      if (att.type == PISM_CHAR) {
+        file.get_att_text(var.name, att.name, att.text);
+      } else {
+        file.get_att_double(var.name, att.name, att.numbers);
+      }
+      var.attributes.push_back(att);
+    }
+  };
+
+  int n_variables = 0;
+  file.inq_nvars(n_variables);
+
+  for (int j = 0; j < n_variables; ++j) {
+    Variable var;
+    file.inq_varname(j, var.name);
+    file.inq_vardimid(var.name, var.dimensions);
+    read_attributes(var);
+
+    for (const auto &d : var.dimensions) {
+      if (dimension(d) == nullptr) {
+        Dimension dim{d, 0};
+        file.inq_dimlen(d, dim.length);
+        dimensions.push_back(dim);
+      }
+    }
+
+    variables.push_back(var);
+  }
+
+  read_attributes(global);
+
+  file.inq_unlimdim(unlimited_dimension);
+
+  file.close();
+}
+
+NCStaging::Impl::Variable& NCStaging::Impl::variable(const std::string &name) {
+  if (name == global.name) {
+    return global;
+  }
+
+  for (auto &v : variables) {
+    if (v.name == name) {
+      return v;
+    }
+  }
+
+  throw RuntimeError::formatted(PISM_ERROR_LOCATION, "variable '%s' not found", name.c_str());
+}
+
+NCStaging::Impl::Attribute* NCStaging::Impl::attribute(const std::string &variable_name,
+                                                       const std::string &attribute_name) {
+  for (auto &a : variable(variable_name).attributes) {
+    if (a.name == attribute_name) {
+      return &a;
+    }
+  }
+  return nullptr;
+}
+
+NCStaging::Impl::Dimension* NCStaging::Impl::dimension(const std::string &name) {
+  for (auto &d : dimensions) {
+    if (d.name == name) {
+      return &d;
+    }
+  }
+  return nullptr;
+}
+
+// open/create/close
+
+void NCStaging::open_impl(const std::string &filename, IO_Mode mode) {
+  if (mode == PISM_READONLY) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot open '%s' for reading: files written"
+                                  " asynchronously are write-only", filename.c_str());
+  }
+
+  // make sure all pending changes to this file are written before we look at it
+  m_impl->writer->wait();
+
+  m_impl->reset();
+  m_impl->read_structure(m_com, filename);
+
+  Impl::Operation op(Impl::Operation::OPEN);
+  op.name = filename;
+  m_impl->record(op);
+}
+
+void NCStaging::create_impl(const std::string &filename) {
+  m_impl->reset();
+
+  Impl::Operation op(Impl::Operation::CREATE);
+  op.name = filename;
+  m_impl->record(op);
+}
+
+void NCStaging::sync_impl() const {
+  Impl::Operation op(Impl::Operation::SYNC);
+  m_impl->record(op);
+
+  m_impl->flush();
+  m_impl->writer->check();
+}
+
+void NCStaging::close_impl() {
+  Impl::Operation op(Impl::Operation::CLOSE);
+  m_impl->record(op);
+
+  m_impl->flush();
+  m_impl->reset();
+  m_impl->writer->check();
+}
+
+// redef/enddef
+
+void NCStaging::enddef_impl() const {
+  // the writer switches between define and data modes as needed
+}
+
+void NCStaging::redef_impl() const {
+  // the writer switches between define and data modes as needed
+}
+
+// dim
+
+void NCStaging::def_dim_impl(const std::string &name, size_t length) const {
+  if (m_impl->dimension(name) != nullptr) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "dimension '%s' already exists",
+                                  name.c_str());
+  }
+
+  m_impl->dimensions.push_back({name, static_cast<unsigned int>(length)});
+  if (length == PISM_UNLIMITED) {
+    m_impl->unlimited_dimension = name;
+  }
+
+  Impl::Operation op(Impl::Operation::DEF_DIM);
+  op.name   = name;
+  op.length = length;
+  m_impl->record(op);
+}
+
+void NCStaging::inq_dimid_impl(const std::string &dimension_name, bool &exists) const {
+  exists = m_impl->dimension(dimension_name) != nullptr;
+}
+
+void NCStaging::inq_dimlen_impl(const std::string &dimension_name, unsigned int &result) const {
+  auto dim = m_impl->dimension(dimension_name);
+
+  if (dim == nullptr) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "dimension '%s' not found",
+                                  dimension_name.c_str());
+  }
+
+  result = dim->length;
+}
+
+void NCStaging::inq_unlimdim_impl(std::string &result) const {
+  result = m_impl->unlimited_dimension;
+}
+
+// var
+
+void NCStaging::def_var_impl(const std::string &name, IO_Type nctype,
+                             const std::vector<std::string> &dims) const {
+  for (const auto &d : dims) {
+    if (m_impl->dimension(d) == nullptr) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "cannot define '%s': dimension '%s' not found",
+                                    name.c_str(), d.c_str());
+    }
+  }
+
+  m_impl->variables.push_back({name, dims, {}});
+
+  Impl::Operation op(Impl::Operation::DEF_VAR);
+  op.name       = name;
+  op.type       = nctype;
+  op.dimensions = dims;
+  m_impl->record(op);
+}
+
+void NCStaging::def_var_chunking_impl(const std::string &name,
+                                      std::vector<size_t> &dimensions) const {
+  Impl::Operation op(Impl::Operation::DEF_VAR_CHUNKING);
+  op.name  = name;
+  op.count = dimensions;
+  m_impl->record(op);
+}
+
+void NCStaging::def_var_deflate_impl(const std::string &name, int level) const {
+  Impl::Operation op(Impl::Operation::DEF_VAR_DEFLATE);
+  op.name   = name;
+  op.length = level;
+  m_impl->record(op);
+}
+
+void NCStaging::get_vara_double_impl(const std::string &variable_name,
+                                     const std::vector<unsigned int> &start,
+                                     const std::vector<unsigned int> &count,
+                                     double *ip) const {
+  (void) start;
+  (void) count;
+  (void) ip;
+  throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                "cannot read '%s' from '%s': files written asynchronously"
+                                " are write-only", variable_name.c_str(), m_filename.c_str());
+}
+
+/*!
+ * Gathers data on rank 0 (see NC3File::put_vara_double_impl()) and records one operation
+ * per rank.
+ */
+void NCStaging::put_vara_double_impl(const std::string &variable_name,
+                                     const std::vector<unsigned int> &start_input,
+                                     const std::vector<unsigned int> &count_input,
+                                     const double *op) const {
+  std::vector<unsigned int> start = start_input;
+  std::vector<unsigned int> count = count_input;
+  const int start_tag = 1,
+    count_tag = 2,
+    data_tag =  3,
+    chunk_size_tag = 4;
+  int com_size = 0, ndims = static_cast<int>(start.size());
+  MPI_Status mpi_stat;
+  unsigned int local_chunk_size = 1;
+
+  const Impl::Variable &var = m_impl->variable(variable_name);
+
+  // update the length of the unlimited dimension
+  if (ndims > 0 and
+      not var.dimensions.empty() and
+      var.dimensions[0] == m_impl->unlimited_dimension) {
+    unsigned int
+      local_length = start[0] + count[0],
+      length       = 0;
+    MPI_Allreduce(&local_length, &length, 1, MPI_UNSIGNED, MPI_MAX, m_com);
+
+    auto dim = m_impl->dimension(m_impl->unlimited_dimension);
+    dim->length = std::max(dim->length, length);
+  }
+
+  MPI_Comm_size(m_com, &com_size);
+
+  for (int k = 0; k < ndims; ++k) {
+    local_chunk_size *= count[k];
+  }
+
+  if (m_impl->rank == 0) {
+    for (int r = 0; r < com_size; ++r) {
+      Impl::Operation record(Impl::Operation::PUT_VARA);
+      record.name = variable_name;
+
+      if (r != 0) {
+        MPI_Recv(&start[0],         ndims, MPI_UNSIGNED, r, start_tag,      m_com, &mpi_stat);
+        MPI_Recv(&count[0],         ndims, MPI_UNSIGNED, r, count_tag,      m_com, &mpi_stat);
+        MPI_Recv(&local_chunk_size, 1,     MPI_UNSIGNED, r, chunk_size_tag, m_com, &mpi_stat);
+
+        record.data.resize(local_chunk_size);
+        MPI_Recv(record.data.data(), local_chunk_size, MPI_DOUBLE, r, data_tag, m_com, &mpi_stat);
+      } else {
+        record.data.assign(op, op + local_chunk_size);
+      }
+
+      record.start.assign(start.begin(), start.end());
+      record.count.assign(count.begin(), count.end());
+
+      if (local_chunk_size > 0) {
+        m_impl->record(record);
+      }
+    }
+  } else {
+    MPI_Send(&start[0],          ndims, MPI_UNSIGNED, 0, start_tag,      m_com);
+    MPI_Send(&count[0],          ndims, MPI_UNSIGNED, 0, count_tag,      m_com);
+    MPI_Send(&local_chunk_size,  1,     MPI_UNSIGNED, 0, chunk_size_tag, m_com);
+
+    MPI_Send(const_cast<double*>(op), local_chunk_size, MPI_DOUBLE, 0, data_tag, m_com);
+  }
+}
+
+void NCStaging::get_varm_double_impl(const std::string &variable_name,
+                                     const std::vector<unsigned int> &start,
+                                     const std::vector<unsigned int> &count,
+                                     const std::vector<unsigned int> &imap,
+                                     double *ip) const {
+  (void) imap;
+  get_vara_double_impl(variable_name, start, count, ip);
+}
+
+void NCStaging::inq_nvars_impl(int &result) const {
+  result = m_impl->variables.size();
+}
+
+void NCStaging::inq_vardimid_impl(const std::string &variable_name,
+                                  std::vector<std::string> &result) const {
+  result = m_impl->variable(variable_name).dimensions;
+}
+
+void NCStaging::inq_varnatts_impl(const std::string &variable_name, int &result) const {
+  result = m_impl->variable(variable_name).attributes.size();
+}
+
+void NCStaging::inq_varid_impl(const std::string &variable_name, bool &exists) const {
+  exists = false;
+  for (const auto &v : m_impl->variables) {
+    if (v.name == variable_name) {
+      exists = true;
+      return;
+    }
+  }
+}
+
+void NCStaging::inq_varname_impl(unsigned int j, std::string &result) const {
+  if (j >= m_impl->variables.size()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "invalid variable index: %d", (int)j);
+  }
+  result = m_impl->variables[j].name;
+}
+
+// att
+
+void NCStaging::get_att_double_impl(const std::string &variable_name,
+                                    const std::string &att_name,
+                                    std::vector<double> &result) const {
+  auto att = m_impl->attribute(variable_name, att_name);
+
+  if (att != nullptr and att->type != PISM_CHAR) {
+    result = att->numbers;
+  } else {
+    result.clear();
+  }
+}
+
+void NCStaging::get_att_text_impl(const std::string &variable_name,
+                                  const std::string &att_name, std::string &result) const {
+  auto att = m_impl->attribute(variable_name, att_name);
+
+  if (att != nullptr and att->type == PISM_CHAR) {
+    result = att->text;
+  } else {
+    result.clear();
+  }
+}
+
+void NCStaging::put_att_double_impl(const std::string &variable_name,
+                                    const std::string &att_name,
+                                    IO_Type xtype, const std::vector<double> &data) const {
+  auto att = m_impl->attribute(variable_name, att_name);
+  if (att == nullptr) {
+    m_impl->variable(variable_name).attributes.push_back({att_name, xtype, data, ""});
+  } else {
+    *att = {att_name, xtype, data, ""};
+  }
+
+  Impl::Operation op(Impl::Operation::PUT_ATT_DOUBLE);
+  op.name      = variable_name;
+  op.attribute = att_name;
+  op.type      = xtype;
+  op.data      = data;
+  m_impl->record(op);
+}
+
+void NCStaging::put_att_text_impl(const std::string &variable_name,
+                                  const std::string &att_name,
+                                  const std::string &value) const {
+  auto att = m_impl->attribute(variable_name, att_name);
+  if (att == nullptr) {
+    m_impl->variable(variable_name).attributes.push_back({att_name, PISM_CHAR, {}, value});
+  } else {
+    *att = {att_name, PISM_CHAR, {}, value};
+  }
+
+  Impl::Operation op(Impl::Operation::PUT_ATT_TEXT);
+  op.name      = variable_name;
+  op.attribute = att_name;
+  op.text      = value;
+  m_impl->record(op);
+}
+
+void NCStaging::inq_attname_impl(const std::string &variable_name, unsigned int n,
+                                 std::string &result) const {
+  const auto &attributes = m_impl->variable(variable_name).attributes;
+
+  if (n >= attributes.size()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "invalid attribute index: %d", (int)n);
+  }
+
+  result = attributes[n].name;
+}
+
+void NCStaging::inq_atttype_impl(const std::string &variable_name,
+                                 const std::string &att_name, IO_Type &result) const {
+  auto att = m_impl->attribute(variable_name, att_name);
+
+  result = att != nullptr ? att->type : PISM_NAT;
+}
+
+// misc
+
+void NCStaging::set_fill_impl(int fillmode, int &old_modep) const {
+  old_modep = m_impl->fill_mode;
+  m_impl->fill_mode = fillmode;
+
+  Impl::Operation op(Impl::Operation::SET_FILL);
+  op.length = fillmode;
+  m_impl->record(op);
+}
+
+void NCStaging::del_att_impl(const std::string &variable_name, const std::string &att_name) const {
+  auto &attributes = m_impl->variable(variable_name).attributes;
+
+  for (auto a = attributes.begin(); a != attributes.end(); ++a) {
+    if (a->name == att_name) {
+      attributes.erase(a);
+
+      Impl::Operation op(Impl::Operation::DEL_ATT);
+      op.name      = variable_name;
+      op.attribute = att_name;
+      m_impl->record(op);
+
+      return;
+    }
+  }
+}
+
+// Output (used by the writer thread)
+
+//! NetCDF format flag corresponding to a PISM I/O backend.
+static int create_mode(IO_Backend format) {
+  if (format == PISM_NETCDF4_PARALLEL or
+      format == PISM_PIO_NETCDF4C or
+      format == PISM_PIO_NETCDF4P) {
+    return NC_NETCDF4;
+  }
+
+#ifdef NC_64BIT_DATA
+  if (format == PISM_PNETCDF or format == PISM_PIO_PNETCDF) {
+    return NC_64BIT_DATA;
+  }
+#endif
+
+  return NC_64BIT_OFFSET;
+}
+
+//! Move `filename` to `filename~` if it exists (see move_if_exists()).
+static void move_aside(const std::string &filename) {
+  if (FILE *f = fopen(filename.c_str(), "r")) {
+    fclose(f);
+
+    std::string backup_filename = filename + "~";
+    if (rename(filename.c_str(), backup_filename.c_str()) != 0) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION, "can't move '%s' to '%s'",
+                                    filename.c_str(), backup_filename.c_str());
+    }
+  }
+}
+
+NCStaging::Impl::Output::Output(IO_Backend format)
+  : m_ncid(-1), m_define_mode(false), m_format(format) {
+  // empty
+}
+
+NCStaging::Impl::Output::~Output() {
+  if (m_ncid >= 0) {
+    std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+    nc_close(m_ncid);
+  }
+}
+
+void NCStaging::Impl::Output::check(const ErrorLocation &location, int stat) const {
+  if (stat != NC_NOERR) {
+    throw RuntimeError::formatted(location, "%s (file '%s')",
+                                  nc_strerror(stat), m_filename.c_str());
+  }
+}
+
+int NCStaging::Impl::Output::varid(const std::string &name) const {
+  if (name == "PISM_GLOBAL") {
+    return NC_GLOBAL;
+  }
+
+  int result = 0;
+  int stat = nc_inq_varid(m_ncid, name.c_str(), &result); check(PISM_ERROR_LOCATION, stat);
+
+  return result;
+}
+
+void NCStaging::Impl::Output::redef() {
+  if (not m_define_mode) {
+    int stat = nc_redef(m_ncid); check(PISM_ERROR_LOCATION, stat);
+    m_define_mode = true;
+  }
+}
+
+void NCStaging::Impl::Output::enddef() {
+  if (m_define_mode) {
+    int stat = nc_enddef(m_ncid); check(PISM_ERROR_LOCATION, stat);
+    m_define_mode = false;
+  }
+}
+
+//! True if the file being written uses the NetCDF-4 format.
+bool NCStaging::Impl::Output::netcdf4() const {
+  int format = 0;
+  int stat = nc_inq_format(m_ncid, &format); check(PISM_ERROR_LOCATION, stat);
+
+  return format == NC_FORMAT_NETCDF4;
+}
+
+//! Perform a recorded operation. Runs in the writer thread.
+void NCStaging::Impl::Output::apply(const Operation &op) {
+  std::lock_guard<std::recursive_mutex> lock(netcdf_mutex());
+
+  int stat = NC_NOERR;
+
+  switch (op.kind) {
+  case Operation::CREATE:
+    m_filename = op.name;
+    move_aside(op.name);
+    stat = nc_create(op.name.c_str(), NC_CLOBBER | create_mode(m_format), &m_ncid);
+    m_define_mode = true;
+    break;
+  case Operation::OPEN:
+    m_filename = op.name;
+    stat = nc_open(op.name.c_str(), NC_WRITE, &m_ncid);
+    m_define_mode = false;
+    break;
+  case Operation::SYNC:
+    enddef();
+    stat = nc_sync(m_ncid);
+    break;
+  case Operation::CLOSE:
+    enddef();
+    stat = nc_close(m_ncid);
+    m_ncid = -1;
+    break;
+  case Operation::DEF_DIM:
+    {
+      redef();
+      int dimid = 0;
+      stat = nc_def_dim(m_ncid, op.name.c_str(), op.length, &dimid);
+      break;
+    }
+  case Operation::DEF_VAR:
+    {
+      redef();
+      std::vector<int> dimids;
+      for (const auto &d : op.dimensions) {
+        int dimid = 0;
+        stat = nc_inq_dimid(m_ncid, d.c_str(), &dimid); check(PISM_ERROR_LOCATION, stat);
+        dimids.push_back(dimid);
+      }
+
+      int varid = 0;
+      stat = nc_def_var(m_ncid, op.name.c_str(), pism_type_to_nc_type(op.type),
+                        static_cast<int>(dimids.size()), dimids.data(), &varid);
+      break;
+    }
+  case Operation::DEF_VAR_CHUNKING:
+    if (netcdf4()) {
+      redef();
+      stat = nc_def_var_chunking(m_ncid, varid(op.name), NC_CHUNKED, op.count.data());
+    }
+    break;
+  case Operation::DEF_VAR_DEFLATE:
+    if (netcdf4() and op.length > 0) {
+      redef();
+      stat = nc_def_var_deflate(m_ncid, varid(op.name), 1, 1, static_cast<int>(op.length));
+    }
+    break;
+  case Operation::PUT_ATT_DOUBLE:
+    redef();
+    stat = nc_put_att_double(m_ncid, varid(op.name), op.attribute.c_str(),
+                             pism_type_to_nc_type(op.type), op.data.size(), op.data.data());
+    break;
+  case Operation::PUT_ATT_TEXT:
+    redef();
+    stat = nc_put_att_text(m_ncid, varid(op.name), op.attribute.c_str(),
+                           op.text.size(), op.text.c_str());
+    break;
+  case Operation::DEL_ATT:
+    redef();
+    stat = nc_del_att(m_ncid, varid(op.name), op.attribute.c_str());
+    break;
+  case Operation::PUT_VARA:
+    enddef();
+    stat = nc_put_vara_double(m_ncid, varid(op.name), op.start.data(), op.count.data(),
+                              op.data.data());
+    break;
+  case Operation::SET_FILL:
+    {
+      redef();
+      int old_mode = 0;
+      stat = nc_set_fill(m_ncid, static_cast<int>(op.length), &old_mode);
+      break;
+    }
+  }
+
+  check(PISM_ERROR_LOCATION, stat);
+}
+
+} // end of namespace io
+} // end of namespace pism
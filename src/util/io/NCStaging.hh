@@ -0,0 +1,136 @@
+/* Copyright (C) 2019 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#ifndef _NCSTAGING_H_
+#define _NCSTAGING_H_
+
+#include "NCFile.hh"
+
+namespace pism {
+namespace io {
+
+class AsyncWriter;
+
+//! Stages output for writing by an AsyncWriter.
+/*!
+ * Calls defining dimensions, variables and attributes and writing data are recorded and
+ * passed to the writer thread on sync() and close(). Data written by all ranks are
+ * gathered on rank 0 (and copied) right away, so callers can re-use their buffers.
+ *
+ * Inquiry calls are answered using the structure of the file maintained on all ranks. To
+ * append to an existing file (PISM_READWRITE) this class waits for the writer and reads
+ * the structure of the file.
+ *
+ * Notes:
+ * - Reading data is not supported.
+ * - An existing file is always moved aside (as in PISM_READWRITE_MOVE) when the writer
+ *   creates a new one.
+ * - `format` selects the kind of NetCDF file created by the writer (it writes in serial
+ *   mode, so "parallel" formats are mapped to corresponding serial ones).
+ */
+class NCStaging : public NCFile
+{
+public:
+  NCStaging(std::shared_ptr<AsyncWriter> writer, IO_Backend format);
+  virtual ~NCStaging();
+
+protected:
+  // implementations:
+  // open/create/close
+  void open_impl(const std::string &filename, IO_Mode mode);
+
+  void create_impl(const std::string &filename);
+
+  void sync_impl() const;
+
+  void close_impl();
+
+  // redef/enddef
+  void enddef_impl() const;
+
+  void redef_impl() const;
+
+  // dim
+  void def_dim_impl(const std::string &name, size_t length) const;
+
+  void inq_dimid_impl(const std::string &dimension_name, bool &exists) const;
+
+  void inq_dimlen_impl(const std::string &dimension_name, unsigned int &result) const;
+
+  void inq_unlimdim_impl(std::string &result) const;
+
+  // var
+  void def_var_impl(const std::string &name, IO_Type nctype, const std::vector<std::string> &dims) const;
+
+  void def_var_chunking_impl(const std::string &name, std::vector<size_t> &dimensions) const;
+
+  void def_var_deflate_impl(const std::string &name, int level) const;
+
+  void get_vara_double_impl(const std::string &variable_name,
+                            const std::vector<unsigned int> &start,
+                            const std::vector<unsigned int> &count,
+                            double *ip) const;
+
+  void put_vara_double_impl(const std::string &variable_name,
+                            const std::vector<unsigned int> &start,
+                            const std::vector<unsigned int> &count,
+                            const double *op) const;
+
+  void get_varm_double_impl(const std::string &variable_name,
+                            const std::vector<unsigned int> &start,
+                            const std::vector<unsigned int> &count,
+                            const std::vector<unsigned int> &imap,
+                            double *ip) const;
+
+  void inq_nvars_impl(int &result) const;
+
+  void inq_vardimid_impl(const std::string &variable_name, std::vector<std::string> &result) const;
+
+  void inq_varnatts_impl(const std::string &variable_name, int &result) const;
+
+  void inq_varid_impl(const std::string &variable_name, bool &exists) const;
+
+  void inq_varname_impl(unsigned int j, std::string &result) const;
+
+  // att
+  void get_att_double_impl(const std::string &variable_name, const std::string &att_name, std::vector<double> &result) const;
+
+  void get_att_text_impl(const std::string &variable_name, const std::string &att_name, std::string &result) const;
+
+  void put_att_double_impl(const std::string &variable_name, const std::string &att_name, IO_Type xtype, const std::vector<double> &data) const;
+
+  void put_att_text_impl(const std::string &variable_name, const std::string &att_name, const std::string &value) const;
+
+  void inq_attname_impl(const std::string &variable_name, unsigned int n, std::string &result) const;
+
+  void inq_atttype_impl(const std::string &variable_name, const std::string &att_name, IO_Type &result) const;
+
+  // misc
+  void set_fill_impl(int fillmode, int &old_modep) const;
+
+  void del_att_impl(const std::string &variable_name, const std::string &att_name) const;
+private:
+  struct Impl;
+  Impl *m_impl;
+};
+
+} // end of namespace io
+} // end of namespace pism
+
+#endif /* _NCSTAGING_H_ */
@@ -0,0 +1,1079 @@
+/* Copyright (C) 2019 PISM Authors
+ *
+ * This file is part of PISM.
+ *
+ * PISM is free software; you can redistribute it and/or modify it under the
+ * terms of the GNU General Public License as published by the Free Software
+ * Foundation; either version 3 of the License, or (at your option) any later
+ * version.
+ *
+ * PISM is distributed in the hope that it will be useful, but WITHOUT ANY
+ * WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PISM; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA
+ */
+
+#include <cstdio>               // fopen, fread, fwrite, rename
+#include <algorithm>            // std::min, std::max, std::copy
+#include <cstring>              // memcpy
+#include <cstdint>              // uint64_t
+#include <map>
+#include <chrono>
+#include <sys/types.h>          // off_t
+
+#include "NativeFile.hh"
+#include "pism/util/error_handling.hh"
+#include "pism/util/pism_utilities.hh"
+
+namespace pism {
+namespace io {
+
+//! The first 8 bytes of a header.
+static const char header_magic[] = "PISMNAT1";
+//! The first 8 bytes of a data file.
+static const char data_magic[] = "PISMDAT1";
+static const size_t magic_length = 8;
+
+//! Size (in bytes) of the data file "preamble": magic and the checkpoint ID.
+static const uint64_t data_offset = magic_length + sizeof(uint64_t);
+
+namespace {
+
+//! Serializes the header.
+class Writer {
+public:
+  void put(uint64_t value) {
+    m_buffer.append(reinterpret_cast<const char*>(&value), sizeof(value));
+  }
+
+  void put(const std::string &value) {
+    put(static_cast<uint64_t>(value.size()));
+    m_buffer.append(value);
+  }
+
+  void put(const std::vector<double> &values) {
+    put(static_cast<uint64_t>(values.size()));
+    m_buffer.append(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(double));
+  }
+
+  void put(const std::vector<unsigned int> &values) {
+    put(static_cast<uint64_t>(values.size()));
+    for (auto v : values) {
+      put(static_cast<uint64_t>(v));
+    }
+  }
+
+  const std::string& buffer() const {
+    return m_buffer;
+  }
+private:
+  std::string m_buffer;
+};
+
+//! De-serializes the header.
+class Reader {
+public:
+  Reader(const std::string &buffer)
+    : m_buffer(buffer), m_position(0) {
+    // empty
+  }
+
+  uint64_t number() {
+    uint64_t result = 0;
+    read(&result, sizeof(result));
+    return result;
+  }
+
+  std::string text() {
+    std::string result(number(), '\0');
+    read(&result[0], result.size());
+    return result;
+  }
+
+  std::vector<double> doubles() {
+    std::vector<double> result(number());
+    read(result.data(), result.size() * sizeof(double));
+    return result;
+  }
+
+  std::vector<unsigned int> indices() {
+    std::vector<unsigned int> result(number());
+    for (auto &v : result) {
+      v = number();
+    }
+    return result;
+  }
+
+  bool done() const {
+    return m_position == m_buffer.size();
+  }
+private:
+  void read(void *output, size_t size) {
+    if (m_position + size > m_buffer.size()) {
+      throw RuntimeError(PISM_ERROR_LOCATION, "unexpected end of a native file header");
+    }
+    if (size > 0) {
+      memcpy(output, &m_buffer[m_position], size);
+    }
+    m_position += size;
+  }
+
+  const std::string &m_buffer;
+  size_t m_position;
+};
+
+//! Number of elements in a hyperslab.
+size_t volume(const std::vector<unsigned int> &count) {
+  size_t result = 1;
+  for (auto c : count) {
+    result *= c;
+  }
+  return result;
+}
+
+} // end of anonymous namespace
+
+struct NativeFile::Impl {
+  struct Attribute {
+    std::string name;
+    IO_Type type;
+    //! values of a numeric attribute
+    std::vector<double> numbers;
+    //! value of a text attribute
+    std::string text;
+  };
+
+  struct Variable {
+    std::string name;
+    IO_Type type;
+    std::vector<std::string> dimensions;
+    std::vector<Attribute> attributes;
+  };
+
+  struct Dimension {
+    std::string name;
+    unsigned int length;
+  };
+
+  //! A hyperslab of a variable written by one rank.
+  struct Block {
+    int rank;
+    std::vector<unsigned int> start, count;
+    //! offset (in bytes) of data in the data file of `rank`
+    uint64_t offset;
+  };
+
+  void reset();
+
+  Variable& variable(const std::string &name);
+  Attribute* attribute(const std::string &variable_name, const std::string &attribute_name);
+  Dimension* dimension(const std::string &name);
+
+  std::string data_filename(int r) const;
+  FILE* input(int r);
+  void read_block(const Block &block, std::vector<double> &result);
+
+  std::string header() const;
+  void parse(const std::string &header);
+
+  int rank;
+  int size;
+  std::string filename;
+  //! true if this file was created by this instance
+  bool writing;
+  //! identifies data files that belong to this file
+  uint64_t id;
+
+  // Structure of the file (maintained on all ranks):
+  std::vector<Dimension> dimensions;
+  std::string unlimited_dimension;
+  std::vector<Variable> variables;
+  //! global attributes
+  Variable global;
+  int fill_mode;
+
+  //! Blocks of data, for each variable. When writing: blocks written by this rank. When
+  //! reading: blocks written by all ranks.
+  std::map<std::string, std::vector<Block> > blocks;
+  //! number of ranks that wrote the file (when reading)
+  int n_writers;
+
+  //! the data file of this rank (when writing)
+  FILE *output;
+  //! the size of the data file of this rank (when writing)
+  uint64_t output_size;
+  //! data files opened for reading
+  std::map<int, FILE*> inputs;
+};
+
+NativeFile::NativeFile(MPI_Comm com)
+  : NCFile(com), m_impl(new Impl) {
+
+  // this class does not use NetCDF
+  m_serialize_calls = false;
+
+  m_impl->rank = 0;
+  m_impl->size = 1;
+  MPI_Comm_rank(m_com, &m_impl->rank);
+  MPI_Comm_size(m_com, &m_impl->size);
+
+  m_impl->output = nullptr;
+  m_impl->reset();
+}
+
+NativeFile::~NativeFile() {
+  // close_impl() was not called (or failed): don't leave files open
+  if (m_impl->output != nullptr) {
+    fclose(m_impl->output);
+  }
+  for (auto f : m_impl->inputs) {
+    fclose(f.second);
+  }
+  delete m_impl;
+}
+
+void NativeFile::Impl::reset() {
+  filename.clear();
+  writing = false;
+  id      = 0;
+
+  dimensions.clear();
+  unlimited_dimension.clear();
+  variables.clear();
+  global = Variable();
+  global.name = "PISM_GLOBAL";
+  fill_mode = PISM_FILL;
+
+  blocks.clear();
+  n_writers = 0;
+
+  output_size = 0;
+}
+
+//! Check if `filename` is a native file. This is a collective operation.
+bool NativeFile::recognize(MPI_Comm com, const std::string &filename) {
+  int rank = 0, result = 0;
+  MPI_Comm_rank(com, &rank);
+
+  if (rank == 0) {
+    FILE *f = fopen(filename.c_str(), "rb");
+    if (f != nullptr) {
+      char magic[magic_length];
+      if (fread(magic, 1, magic_length, f) == magic_length and
+          memcmp(magic, header_magic, magic_length) == 0) {
+        result = 1;
+      }
+      fclose(f);
+    }
+  }
+
+  MPI_Bcast(&result, 1, MPI_INT, 0, com);
+
+  return result == 1;
+}
+
+NativeFile::Impl::Variable& NativeFile::Impl::variable(const std::string &name) {
+  if (name == global.name) {
+    return global;
+  }
+
+  for (auto &v : variables) {
+    if (v.name == name) {
+      return v;
+    }
+  }
+
+  throw RuntimeError::formatted(PISM_ERROR_LOCATION, "variable '%s' not found", name.c_str());
+}
+
+NativeFile::Impl::Attribute* NativeFile::Impl::attribute(const std::string &variable_name,
+                                                         const std::string &attribute_name) {
+  for (auto &a : variable(variable_name).attributes) {
+    if (a.name == attribute_name) {
+      return &a;
+    }
+  }
+  return nullptr;
+}
+
+NativeFile::Impl::Dimension* NativeFile::Impl::dimension(const std::string &name) {
+  for (auto &d : dimensions) {
+    if (d.name == name) {
+      return &d;
+    }
+  }
+  return nullptr;
+}
+
+//! Name of the data file written by the rank `r`.
+std::string NativeFile::Impl::data_filename(int r) const {
+  return pism::printf("%s.%d", filename.c_str(), r);
+}
+
+//! Open the data file written by the rank `r` for reading (if it is not open yet).
+FILE* NativeFile::Impl::input(int r) {
+  auto it = inputs.find(r);
+  if (it != inputs.end()) {
+    return it->second;
+  }
+
+  std::string name = data_filename(r);
+
+  FILE *f = fopen(name.c_str(), "rb");
+  if (f == nullptr) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "failed to open '%s'", name.c_str());
+  }
+
+  char magic[magic_length];
+  uint64_t file_id = 0;
+  if (fread(magic, 1, magic_length, f) != magic_length or
+      memcmp(magic, data_magic, magic_length) != 0 or
+      fread(&file_id, sizeof(file_id), 1, f) != 1 or
+      file_id != id) {
+    fclose(f);
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "'%s' does not belong to '%s'", name.c_str(), filename.c_str());
+  }
+
+  inputs[r] = f;
+
+  return f;
+}
+
+//! Read a block of data.
+void NativeFile::Impl::read_block(const Block &block, std::vector<double> &result) {
+  FILE *f = input(block.rank);
+
+  result.resize(volume(block.count));
+
+  if (fseeko(f, static_cast<off_t>(block.offset), SEEK_SET) != 0 or
+      fread(result.data(), sizeof(double), result.size(), f) != result.size()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "failed to read from '%s'",
+                                  data_filename(block.rank).c_str());
+  }
+}
+
+//! Serialize the structure of the file (without the index).
+std::string NativeFile::Impl::header() const {
+  Writer result;
+
+  auto put_attributes = [&result](const Variable &var) {
+    result.put(var.attributes.size());
+    for (const auto &a : var.attributes) {
+      result.put(a.name);
+      result.put(static_cast<uint64_t>(a.type));
+      if (a.type == PISM_CHAR) {
+        result.put(a.text);
+      } else {
+        result.put(a.numbers);
+      }
+    }
+  };
+
+  result.put(id);
+
+  result.put(dimensions.size());
+  for (const auto &d : dimensions) {
+    result.put(d.name);
+    result.put(static_cast<uint64_t>(d.length));
+  }
+  result.put(unlimited_dimension);
+
+  result.put(variables.size());
+  for (const auto &v : variables) {
+    result.put(v.name);
+    result.put(static_cast<uint64_t>(v.type));
+    result.put(v.dimensions.size());
+    for (const auto &d : v.dimensions) {
+      result.put(d);
+    }
+    put_attributes(v);
+  }
+  put_attributes(global);
+
+  return result.buffer();
+}
+
+//! Parse the header (everything after the magic): the number of ranks that wrote the file,
+//! the structure of the file and the index of each rank.
+void NativeFile::Impl::parse(const std::string &header) {
+  Reader input(header);
+
+  auto get_attributes = [&input](Variable &var) {
+    uint64_t n_attributes = input.number();
+    for (uint64_t k = 0; k < n_attributes; ++k) {
+      Attribute a;
+      a.name = input.text();
+      a.type = static_cast<IO_Type>(input.number());
+      if (a.type == PISM_CHAR) {
+        a.text = input.text();
+      } else {
+        a.numbers = input.doubles();
+      }
+      var.attributes.push_back(a);
+    }
+  };
+
+  n_writers = input.number();
+
+  id = input.number();
+
+  uint64_t n_dimensions = input.number();
+  for (uint64_t k = 0; k < n_dimensions; ++k) {
+    Dimension d;
+    d.name   = input.text();
+    d.length = input.number();
+    dimensions.push_back(d);
+  }
+  unlimited_dimension = input.text();
+
+  uint64_t n_variables = input.number();
+  for (uint64_t k = 0; k < n_variables; ++k) {
+    Variable v;
+    v.name = input.text();
+    v.type = static_cast<IO_Type>(input.number());
+    uint64_t n = input.number();
+    for (uint64_t j = 0; j < n; ++j) {
+      v.dimensions.push_back(input.text());
+    }
+    get_attributes(v);
+    variables.push_back(v);
+  }
+  get_attributes(global);
+
+  for (int r = 0; r < n_writers; ++r) {
+    uint64_t n_blocks = input.number();
+    for (uint64_t k = 0; k < n_blocks; ++k) {
+      std::string name = input.text();
+      Block b;
+      b.rank   = r;
+      b.start  = input.indices();
+      b.count  = input.indices();
+      b.offset = input.number();
+      blocks[name].push_back(b);
+    }
+  }
+
+  if (not input.done()) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "invalid native file header");
+  }
+}
+
+// open/create/close
+
+void NativeFile::open_impl(const std::string &filename, IO_Mode mode) {
+  if (mode != PISM_READONLY) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot open '%s' for writing:"
+                                  " appending to native files is not supported",
+                                  filename.c_str());
+  }
+
+  m_impl->reset();
+  m_impl->filename = filename;
+
+  // read the header on rank 0
+  std::string header;
+  {
+    ParallelSection rank0(m_com);
+    try {
+      if (m_impl->rank == 0) {
+        FILE *f = fopen(filename.c_str(), "rb");
+        if (f == nullptr) {
+          throw RuntimeError::formatted(PISM_ERROR_LOCATION, "failed to open '%s'",
+                                        filename.c_str());
+        }
+
+        char magic[magic_length];
+        bool success = (fread(magic, 1, magic_length, f) == magic_length and
+                        memcmp(magic, header_magic, magic_length) == 0);
+
+        if (success) {
+          char buffer[4096];
+          size_t n = 0;
+          while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) {
+            header.append(buffer, n);
+          }
+          success = ferror(f) == 0;
+        }
+        fclose(f);
+
+        if (not success) {
+          throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                        "'%s' is not a native file", filename.c_str());
+        }
+      }
+    } catch (...) {
+      rank0.failed();
+    }
+    rank0.check();
+  }
+
+  // broadcast it
+  unsigned long long int length = header.size();
+  MPI_Bcast(&length, 1, MPI_UNSIGNED_LONG_LONG, 0, m_com);
+  header.resize(length);
+  MPI_Bcast(&header[0], static_cast<int>(length), MPI_CHAR, 0, m_com);
+
+  m_impl->parse(header);
+}
+
+void NativeFile::create_impl(const std::string &filename) {
+  m_impl->reset();
+  m_impl->filename = filename;
+  m_impl->writing  = true;
+
+  // ID of this file (used to check if data files belong to it)
+  {
+    unsigned long long int id = std::chrono::system_clock::now().time_since_epoch().count();
+    MPI_Bcast(&id, 1, MPI_UNSIGNED_LONG_LONG, 0, m_com);
+    m_impl->id = id;
+  }
+
+  ParallelSection loop(m_com);
+  try {
+    std::string name = m_impl->data_filename(m_impl->rank);
+
+    // Move the old data file aside, just like File moves the header (this keeps the
+    // old file usable). Data files are checked using the ID stored in the header, so
+    // a data file that does not belong to a header cannot be used by mistake.
+    if (FILE *f = fopen(name.c_str(), "rb")) {
+      fclose(f);
+      std::string old = pism::printf("%s~.%d", filename.c_str(), m_impl->rank);
+      if (rename(name.c_str(), old.c_str()) != 0) {
+        throw RuntimeError::formatted(PISM_ERROR_LOCATION, "can't move '%s' to '%s'",
+                                      name.c_str(), old.c_str());
+      }
+    }
+
+    m_impl->output = fopen(name.c_str(), "wb");
+    if (m_impl->output == nullptr) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION, "failed to create '%s'", name.c_str());
+    }
+
+    if (fwrite(data_magic, 1, magic_length, m_impl->output) != magic_length or
+        fwrite(&m_impl->id, sizeof(m_impl->id), 1, m_impl->output) != 1) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION, "failed to write to '%s'", name.c_str());
+    }
+    m_impl->output_size = data_offset;
+  } catch (...) {
+    loop.failed();
+  }
+  loop.check();
+}
+
+void NativeFile::sync_impl() const {
+  if (m_impl->output != nullptr) {
+    fflush(m_impl->output);
+  }
+}
+
+/*!
+ * When writing, closes data files and writes the header (including the index of blocks
+ * written by all ranks) on rank 0.
+ */
+void NativeFile::close_impl() {
+  for (auto f : m_impl->inputs) {
+    fclose(f.second);
+  }
+  m_impl->inputs.clear();
+
+  if (not m_impl->writing) {
+    m_impl->reset();
+    return;
+  }
+
+  // close the data file and serialize the index of this rank
+  Writer index;
+  {
+    ParallelSection loop(m_com);
+    try {
+      int stat = fclose(m_impl->output);
+      m_impl->output = nullptr;
+
+      if (stat != 0) {
+        throw RuntimeError::formatted(PISM_ERROR_LOCATION, "failed to write '%s'",
+                                      m_impl->data_filename(m_impl->rank).c_str());
+      }
+    } catch (...) {
+      loop.failed();
+    }
+    loop.check();
+
+    uint64_t n_blocks = 0;
+    for (const auto &v : m_impl->blocks) {
+      n_blocks += v.second.size();
+    }
+
+    index.put(n_blocks);
+    for (const auto &v : m_impl->blocks) {
+      for (const auto &b : v.second) {
+        index.put(v.first);
+        index.put(b.start);
+        index.put(b.count);
+        index.put(b.offset);
+      }
+    }
+  }
+
+  // gather indexes on rank 0
+  const std::string &local = index.buffer();
+  int local_size = local.size();
+  std::vector<int> sizes(m_impl->size, 0), displacements(m_impl->size, 0);
+  MPI_Gather(&local_size, 1, MPI_INT, sizes.data(), 1, MPI_INT, 0, m_com);
+
+  std::string indexes;
+  if (m_impl->rank == 0) {
+    for (int r = 1; r < m_impl->size; ++r) {
+      displacements[r] = displacements[r - 1] + sizes[r - 1];
+    }
+    indexes.resize(displacements.back() + sizes.back());
+  }
+  MPI_Gatherv(const_cast<char*>(local.data()), local_size, MPI_CHAR,
+              &indexes[0], sizes.data(), displacements.data(), MPI_CHAR, 0, m_com);
+
+  // write the header
+  {
+    ParallelSection rank0(m_com);
+    try {
+      if (m_impl->rank == 0) {
+        Writer header;
+        header.put(m_impl->size);
+
+        std::string structure = m_impl->header();
+
+        FILE *f = fopen(m_impl->filename.c_str(), "wb");
+        if (f == nullptr) {
+          throw RuntimeError::formatted(PISM_ERROR_LOCATION, "failed to create '%s'",
+                                        m_impl->filename.c_str());
+        }
+
+        bool success =
+          fwrite(header_magic, 1, magic_length, f) == magic_length and
+          fwrite(header.buffer().data(), 1, header.buffer().size(), f) == header.buffer().size() and
+          fwrite(structure.data(), 1, structure.size(), f) == structure.size() and
+          fwrite(indexes.data(), 1, indexes.size(), f) == indexes.size();
+
+        success = (fclose(f) == 0) and success;
+
+        if (not success) {
+          throw RuntimeError::formatted(PISM_ERROR_LOCATION, "failed to write '%s'",
+                                        m_impl->filename.c_str());
+        }
+      }
+    } catch (...) {
+      rank0.failed();
+    }
+    rank0.check();
+  }
+
+  m_impl->reset();
+}
+
+// redef/enddef
+
+void NativeFile::enddef_impl() const {
+  // empty
+}
+
+void NativeFile::redef_impl() const {
+  // empty
+}
+
+// dim
+
+void NativeFile::def_dim_impl(const std::string &name, size_t length) const {
+  if (m_impl->dimension(name) != nullptr) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "dimension '%s' already exists",
+                                  name.c_str());
+  }
+
+  m_impl->dimensions.push_back({name, static_cast<unsigned int>(length)});
+  if (length == PISM_UNLIMITED) {
+    m_impl->unlimited_dimension = name;
+  }
+}
+
+void NativeFile::inq_dimid_impl(const std::string &dimension_name, bool &exists) const {
+  exists = m_impl->dimension(dimension_name) != nullptr;
+}
+
+void NativeFile::inq_dimlen_impl(const std::string &dimension_name, unsigned int &result) const {
+  auto dim = m_impl->dimension(dimension_name);
+
+  if (dim == nullptr) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "dimension '%s' not found",
+                                  dimension_name.c_str());
+  }
+
+  result = dim->length;
+}
+
+void NativeFile::inq_unlimdim_impl(std::string &result) const {
+  result = m_impl->unlimited_dimension;
+}
+
+// var
+
+void NativeFile::def_var_impl(const std::string &name, IO_Type nctype,
+                              const std::vector<std::string> &dims) const {
+  for (const auto &d : dims) {
+    if (m_impl->dimension(d) == nullptr) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "cannot define '%s': dimension '%s' not found",
+                                    name.c_str(), d.c_str());
+    }
+  }
+
+  m_impl->variables.push_back({name, nctype, dims, {}});
+}
+
+//! Copy the part of `block` (containing `data`) that overlaps the hyperslab (`start`,
+//! `count`) to `output`. Returns the number of values copied.
+static size_t copy_overlap(const std::vector<unsigned int> &block_start,
+                           const std::vector<unsigned int> &block_count,
+                           const double *data,
+                           const std::vector<unsigned int> &start,
+                           const std::vector<unsigned int> &count,
+                           double *output) {
+  const size_t ndims = start.size();
+
+  if (ndims == 0) {
+    output[0] = data[0];
+    return 1;
+  }
+
+  // the intersection
+  std::vector<unsigned int> lo(ndims), hi(ndims);
+  for (size_t k = 0; k < ndims; ++k) {
+    lo[k] = std::max(start[k], block_start[k]);
+    hi[k] = std::min(start[k] + count[k], block_start[k] + block_count[k]);
+    if (lo[k] >= hi[k]) {
+      return 0;
+    }
+  }
+
+  // copy contiguous runs along the last dimension
+  const size_t last = ndims - 1, run = hi[last] - lo[last];
+  std::vector<unsigned int> index = lo;
+  size_t result = 0;
+  while (true) {
+    size_t input_offset = 0, output_offset = 0;
+    for (size_t k = 0; k < ndims; ++k) {
+      input_offset  = input_offset  * block_count[k] + (index[k] - block_start[k]);
+      output_offset = output_offset * count[k]       + (index[k] - start[k]);
+    }
+
+    std::copy(data + input_offset, data + input_offset + run, output + output_offset);
+    result += run;
+
+    // advance the index (all dimensions except for the last one)
+    size_t k = last;
+    while (k > 0) {
+      --k;
+      index[k] += 1;
+      if (index[k] < hi[k]) {
+        break;
+      }
+      index[k] = lo[k];
+    }
+    if (k == 0 and index[0] == lo[0]) {
+      break;
+    }
+  }
+
+  return result;
+}
+
+//! Check if a block contains the hyperslab (`start`, `count`).
+static bool contains(const std::vector<unsigned int> &block_start,
+                     const std::vector<unsigned int> &block_count,
+                     const std::vector<unsigned int> &start,
+                     const std::vector<unsigned int> &count) {
+  for (size_t k = 0; k < start.size(); ++k) {
+    if (start[k] < block_start[k] or
+        start[k] + count[k] > block_start[k] + block_count[k]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*!
+ * Uses a block written by this rank if it contains the requested hyperslab (this is the
+ * case when reading using the same domain decomposition). Otherwise assembles the
+ * hyperslab from blocks written by all ranks.
+ */
+void NativeFile::get_vara_double_impl(const std::string &variable_name,
+                                      const std::vector<unsigned int> &start,
+                                      const std::vector<unsigned int> &count,
+                                      double *ip) const {
+  const size_t size = volume(count);
+
+  if (size == 0) {
+    return;
+  }
+
+  auto it = m_impl->blocks.find(variable_name);
+  if (it == m_impl->blocks.end()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot read '%s' from '%s': no data",
+                                  variable_name.c_str(), m_impl->filename.c_str());
+  }
+  const auto &blocks = it->second;
+
+  for (const auto &b : blocks) {
+    if (b.count.size() != start.size()) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "cannot read '%s' from '%s': invalid start and count",
+                                    variable_name.c_str(), m_impl->filename.c_str());
+    }
+  }
+
+  std::vector<double> buffer;
+
+  // the "fast path": a block written by this rank contains the hyperslab
+  for (const auto &b : blocks) {
+    if (b.rank == m_impl->rank and contains(b.start, b.count, start, count)) {
+      if (b.start == start and b.count == count) {
+        FILE *f = m_impl->input(b.rank);
+        if (fseeko(f, static_cast<off_t>(b.offset), SEEK_SET) != 0 or
+            fread(ip, sizeof(double), size, f) != size) {
+          throw RuntimeError::formatted(PISM_ERROR_LOCATION, "failed to read from '%s'",
+                                        m_impl->data_filename(b.rank).c_str());
+        }
+      } else {
+        m_impl->read_block(b, buffer);
+        copy_overlap(b.start, b.count, buffer.data(), start, count, ip);
+      }
+      return;
+    }
+  }
+
+  // assemble the hyperslab using overlapping blocks written by all ranks
+  size_t copied = 0;
+  for (const auto &b : blocks) {
+    bool overlaps = true;
+    for (size_t k = 0; k < start.size(); ++k) {
+      overlaps = (overlaps and
+                  start[k] < b.start[k] + b.count[k] and
+                  b.start[k] < start[k] + count[k]);
+    }
+
+    if (not overlaps) {
+      continue;
+    }
+
+    m_impl->read_block(b, buffer);
+    copied += copy_overlap(b.start, b.count, buffer.data(), start, count, ip);
+
+    // Variables that are not distributed are written by all ranks, so we stop as soon
+    // as we find a block that contains the hyperslab.
+    if (contains(b.start, b.count, start, count)) {
+      return;
+    }
+  }
+
+  if (copied < size) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot read '%s' from '%s': some of the requested values"
+                                  " were not written", variable_name.c_str(),
+                                  m_impl->filename.c_str());
+  }
+}
+
+/*!
+ * Appends data to the data file of this rank.
+ */
+void NativeFile::put_vara_double_impl(const std::string &variable_name,
+                                      const std::vector<unsigned int> &start,
+                                      const std::vector<unsigned int> &count,
+                                      const double *op) const {
+  if (not m_impl->writing) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                  "cannot write '%s': '%s' is open for reading",
+                                  variable_name.c_str(), m_impl->filename.c_str());
+  }
+
+  const Impl::Variable &var = m_impl->variable(variable_name);
+
+  // update the length of the unlimited dimension
+  if (not start.empty() and
+      not var.dimensions.empty() and
+      var.dimensions[0] == m_impl->unlimited_dimension) {
+    unsigned int
+      local_length = start[0] + count[0],
+      length       = 0;
+    MPI_Allreduce(&local_length, &length, 1, MPI_UNSIGNED, MPI_MAX, m_com);
+
+    auto dim = m_impl->dimension(m_impl->unlimited_dimension);
+    dim->length = std::max(dim->length, length);
+  }
+
+  const size_t size = volume(count);
+
+  if (size == 0) {
+    return;
+  }
+
+  if (fwrite(op, sizeof(double), size, m_impl->output) != size) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "failed to write to '%s'",
+                                  m_impl->data_filename(m_impl->rank).c_str());
+  }
+
+  m_impl->blocks[variable_name].push_back({m_impl->rank, start, count, m_impl->output_size});
+  m_impl->output_size += size * sizeof(double);
+}
+
+void NativeFile::get_varm_double_impl(const std::string &variable_name,
+                                      const std::vector<unsigned int> &start,
+                                      const std::vector<unsigned int> &count,
+                                      const std::vector<unsigned int> &imap,
+                                      double *ip) const {
+  const size_t size = volume(count), ndims = count.size();
+
+  if (size == 0) {
+    return;
+  }
+
+  std::vector<double> buffer(size);
+  get_vara_double_impl(variable_name, start, count, buffer.data());
+
+  // re-arrange data using the mapping vector
+  std::vector<unsigned int> index(ndims, 0);
+  for (size_t n = 0; n < size; ++n) {
+    size_t offset = 0;
+    for (size_t k = 0; k < ndims; ++k) {
+      offset += index[k] * imap[k];
+    }
+    ip[offset] = buffer[n];
+
+    for (size_t k = ndims; k > 0; --k) {
+      index[k - 1] += 1;
+      if (index[k - 1] < count[k - 1]) {
+        break;
+      }
+      index[k - 1] = 0;
+    }
+  }
+}
+
+void NativeFile::inq_nvars_impl(int &result) const {
+  result = m_impl->variables.size();
+}
+
+void NativeFile::inq_vardimid_impl(const std::string &variable_name,
+                                   std::vector<std::string> &result) const {
+  result = m_impl->variable(variable_name).dimensions;
+}
+
+void NativeFile::inq_varnatts_impl(const std::string &variable_name, int &result) const {
+  result = m_impl->variable(variable_name).attributes.size();
+}
+
+void NativeFile::inq_varid_impl(const std::string &variable_name, bool &exists) const {
+  exists = false;
+  for (const auto &v : m_impl->variables) {
+    if (v.name == variable_name) {
+      exists = true;
+      return;
+    }
+  }
+}
+
+void NativeFile::inq_varname_impl(unsigned int j, std::string &result) const {
+  if (j >= m_impl->variables.size()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "invalid variable index: %d", (int)j);
+  }
+  result = m_impl->variables[j].name;
+}
+
+// att
+
+void NativeFile::get_att_double_impl(const std::string &variable_name,
+                                     const std::string &att_name,
+                                     std::vector<double> &result) const {
+  auto att = m_impl->attribute(variable_name, att_name);
+
+  if (att != nullptr and att->type != PISM_CHAR) {
+    result = att->numbers;
+  } else {
+    result.clear();
+  }
+}
+
+void NativeFile::get_att_text_impl(const std::string &variable_name,
+                                   const std::string &att_name, std::string &result) const {
+  auto att = m_impl->attribute(variable_name, att_name);
+
+  if (att != nullptr and att->type == PISM_CHAR) {
+    result = att->text;
+  } else {
+    result.clear();
+  }
+}
+
+void NativeFile::put_att_double_impl(const std::string &variable_name,
+                                     const std::string &att_name,
+                                     IO_Type xtype, const std::vector<double> &data) const {
+  auto att = m_impl->attribute(variable_name, att_name);
+  if (att == nullptr) {
+    m_impl->variable(variable_name).attributes.push_back({att_name, xtype, data, ""});
+  } else {
+    *att = {att_name, xtype, data, ""};
+  }
+}
+
+void NativeFile::put_att_text_impl(const std::string &variable_name,
+                                   const std::string &att_name,
+                                   const std::string &value) const {
+  auto att = m_impl->attribute(variable_name, att_name);
+  if (att == nullptr) {
+    m_impl->variable(variable_name).attributes.push_back({att_name, PISM_CHAR, {}, value});
+  } else {
+    *att = {att_name, PISM_CHAR, {}, value};
+  }
+}
+
+void NativeFile::inq_attname_impl(const std::string &variable_name, unsigned int n,
+                                  std::string &result) const {
+  const auto &attributes = m_impl->variable(variable_name).attributes;
+
+  if (n >= attributes.size()) {
+    throw RuntimeError::formatted(PISM_ERROR_LOCATION, "invalid attribute index: %d", (int)n);
+  }
+
+  result = attributes[n].name;
+}
+
+void NativeFile::inq_atttype_impl(const std::string &variable_name,
+                                  const std::string &att_name, IO_Type &result) const {
+  auto att = m_impl->attribute(variable_name, att_name);
+
+  result = att != nullptr ? att->type : PISM_NAT;
+}
+
+// misc
+
+void NativeFile::set_fill_impl(int fillmode, int &old_modep) const {
+  old_modep = m_impl->fill_mode;
+  m_impl->fill_mode = fillmode;
+}
+
+void NativeFile::del_att_impl(const std::string &variable_name, const std::string &att_name) const {
+  auto &attributes = m_impl->variable(variable_name).attributes;
+
+  for (auto a = attributes.begin(); a != attributes.end(); ++a) {
+    if (a->name == att_name) {
+      attributes.erase(a);
+      return;
+    }
+  }
+}
+
+} // end of namespace io
+} // end of namespace pism
@@ -19,6 +19,10 @@
 
 #include <memory>
 #include <cassert>
+#include <cstdlib>              // strtol
+#include <cstring>              // memcpy
+#include <cstdint>              // uint32_t
+#include <cmath>                // std::isfinite
 
 #include "io_helpers.hh"
 #include "File.hh"
@@ -444,16 +448,13 @@ static void regrid_vec_generic(const File &file, const IceGrid &grid,
                                unsigned int t_start,
                                bool fill_missing,
                                double default_value,
-                               InterpolationType interpolation_type,
+                               LocalInterpCtx &lic,
                                double *output) {
   const int X = 1, Y = 2, Z = 3; // indices, just for clarity
 
   const Profiling& profiling = grid.ctx()->profiling();
 
   try {
-    grid_info gi(file, variable_name, grid.ctx()->unit_system(), grid.registration());
-    LocalInterpCtx lic(gi, grid, zlevels_out, interpolation_type);
-
     std::vector<double> &buffer = lic.buffer;
 
     const unsigned int t_count = 1;
@@ -507,14 +508,14 @@ static void regrid_vec_generic(const File &file, const IceGrid &grid,
 static void regrid_vec(const File &file, const IceGrid &grid, const std::string &var_name,
                        const std::vector<double> &zlevels_out,
                        unsigned int t_start,
-                       InterpolationType interpolation_type,
+                       LocalInterpCtx &lic,
                        double *output) {
   regrid_vec_generic(file, grid,
                      var_name,
                      zlevels_out,
                      t_start,
                      false, 0.0,
-                     interpolation_type,
+                     lic,
                      output);
 }
 
@@ -526,6 +527,7 @@ static void regrid_vec(const File &file, const IceGrid &grid, const std::string
  * @param zlevels_out vertical levels of the resulting grid
  * @param t_start time index of the record to regrid
  * @param default_value default value to replace `_FillValue` with
+ * @param lic interpolation context
  * @param[out] output resulting interpolated field
  */
 static void regrid_vec_fill_missing(const File &file, const IceGrid &grid,
@@ -533,17 +535,126 @@ static void regrid_vec_fill_missing(const File &file, const IceGrid &grid,
                                     const std::vector<double> &zlevels_out,
                                     unsigned int t_start,
                                     double default_value,
-                                    InterpolationType interpolation_type,
+                                    LocalInterpCtx &lic,
                                     double *output) {
   regrid_vec_generic(file, grid,
                      var_name,
                      zlevels_out,
                      t_start,
                      true, default_value,
-                     interpolation_type,
+                     lic,
                      output);
 }
 
+//! Compression level of the variable `name`.
+/*!
+ * Uses `output.netcdf4.compression_level` unless `output.netcdf4.compression_overrides`
+ * (a comma-separated list of `name:level` pairs) lists this variable.
+ */
+int compression_level(const Config &config, const std::string &name) {
+  int result = config.get_number("output.netcdf4.compression_level");
+
+  std::string overrides = config.get_string("output.netcdf4.compression_overrides");
+  for (const auto &item : split(overrides, ',')) {
+    auto parts = split(item, ':');
+
+    if (parts.size() != 2) {
+      throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                    "invalid compression override '%s' (expected 'name:level')",
+                                    item.c_str());
+    }
+
+    if (parts[0] == name) {
+      char *endptr = NULL;
+      long int level = strtol(parts[1].c_str(), &endptr, 10);
+      if (*endptr != '\0') {
+        throw RuntimeError::formatted(PISM_ERROR_LOCATION,
+                                      "invalid compression override '%s' ('%s' is not an integer)",
+                                      item.c_str(), parts[1].c_str());
+      }
+      result = level;
+    }
+  }
+
+  return result;
+}
+
+//! Set chunk sizes and compression of a spatial variable (used by NetCDF-4 backends only).
+/*!
+ * Chunks match the domain decomposition: a chunk contains one record and whole columns
+ * of the largest sub-domain, so with `netcdf4_parallel` each rank writes its own chunks
+ * (mostly) and does not share them with other ranks.
+ */
+static void define_storage(const SpatialVariableMetadata &var, const IceGrid &grid,
+                           const File &file) {
+  auto config = grid.ctx()->config();
+  auto name = var.get_name();
+
+  if (config->get_flag("output.netcdf4.chunking")) {
+    int
+      xm     = grid.xm(),
+      ym     = grid.ym(),
+      xm_max = 0,
+      ym_max = 0;
+    MPI_Allreduce(&xm, &xm_max, 1, MPI_INT, MPI_MAX, grid.com);
+    MPI_Allreduce(&ym, &ym_max, 1, MPI_INT, MPI_MAX, grid.com);
+
+    std::vector<size_t> chunks;
+    if (not var.get_time_independent()) {
+      chunks.push_back(1);
+    }
+    chunks.push_back(ym_max);
+    chunks.push_back(xm_max);
+    if (not var.get_z().get_name().empty()) {
+      chunks.push_back(std::max(var.get_levels().size(), (size_t)1));
+    }
+
+    file.define_chunking(name, chunks);
+  }
+
+  file.define_compression(name, compression_level(*config, name));
+}
+
+//! Round single precision values to `n_bits` significant bits of the mantissa.
+/*!
+ * This makes compressed output files smaller. Values equal to `fill_value` and values
+ * that are not finite are not modified.
+ */
+void round_mantissa(std::vector<double> &data, int n_bits, double fill_value) {
+  const int mantissa_bits = 23;
+
+  if (n_bits <= 0 or n_bits >= mantissa_bits) {
+    return;
+  }
+
+  const uint32_t
+    drop = mantissa_bits - n_bits,
+    half = 1U << (drop - 1),
+    mask = ~((1U << drop) - 1U);
+
+  for (auto &v : data) {
+    float f = v;
+    if (v == fill_value or not std::isfinite(f)) {
+      continue;
+    }
+
+    uint32_t bits = 0;
+    memcpy(&bits, &f, sizeof(f));
+
+    float rounded = 0.0;
+    uint32_t rounded_bits = (bits + half) & mask;
+    memcpy(&rounded, &rounded_bits, sizeof(rounded));
+
+    if (not std::isfinite(rounded)) {
+      // rounding up overflowed: truncate instead
+      rounded_bits = bits & mask;
+      memcpy(&rounded, &rounded_bits, sizeof(rounded));
+    }
+
+    v = rounded;
+  }
+}
+
 //! Define a NetCDF variable corresponding to a VariableMetadata object.
 void define_spatial_variable(const SpatialVariableMetadata &var,
                              const IceGrid &grid, const File &file,
@@ -581,8 +692,16 @@ void define_spatial_variable(const SpatialVariableMetadata &var,
   }
   file.define_variable(name, type, dims);
 
+  define_storage(var, grid, file);
+
   write_attributes(file, var, type);
 
+  // lossy compression of single precision output (see write_spatial_variable())
+  int significant_bits = grid.ctx()->config()->get_number("output.float_significant_bits");
+  if (type == PISM_FLOAT and significant_bits > 0) {
+    file.write_attribute(name, "pism_significant_bits", PISM_INT, {(double)significant_bits});
+  }
+
   // add the "grid_mapping" attribute if the grid has an associated mapping. Variables lat, lon,
   // lat_bnds, and lon_bnds should not have the grid_mapping attribute to support CDO (see issue
   // #384).
@@ -727,7 +846,13 @@ void write_spatial_variable(const SpatialVariableMetadata &var,
     units               = var.get_string("units"),
     glaciological_units = var.get_string("glaciological_units");
 
-  if (units != glaciological_units) {
+  // number of significant bits to keep in single precision output; define_spatial_variable()
+  // marks variables that should be rounded, so the file is checked only if rounding is on
+  int significant_bits = grid.ctx()->config()->get_number("output.float_significant_bits");
+  bool round = (significant_bits > 0 and
+                file.attribute_type(name, "pism_significant_bits") != PISM_NAT);
+
+  if (units != glaciological_units or round) {
     size_t data_size = grid.xm() * grid.ym() * nlevels;
 
     // create a temporary array, convert to glaciological units, and
@@ -737,9 +862,17 @@ void write_spatial_variable(const SpatialVariableMetadata &var,
       tmp[k] = input[k];
     }
 
-    units::Converter(var.unit_system(),
-                     units,
-                     glaciological_units).convert_doubles(&tmp[0], tmp.size());
+    if (units != glaciological_units) {
+      units::Converter(var.unit_system(),
+                       units,
+                       glaciological_units).convert_doubles(&tmp[0], tmp.size());
+    }
+
+    if (round) {
+      double fill_value = (var.has_attribute("_FillValue") ?
+                           var.get_number("_FillValue") : 0.0);
+      round_mantissa(tmp, significant_bits, fill_value);
+    }
 
     file.write_distributed_array(name, grid, nlevels, &tmp[0]);
   } else {
@@ -892,6 +1025,47 @@ static void check_grid_overlap(const grid_info &input, const IceGrid &internal,
   }
 }
 
+//! Get the context used to interpolate `variable_name` from `file` onto `grid`.
+/*!
+ * Reads the grid of `variable_name`, checks it and creates the context unless it is
+ * cached by `file` (see File::interpolation_context()).
+ */
+static std::shared_ptr<LocalInterpCtx> interpolation_context(const File &file,
+                                                             const IceGrid &grid,
+                                                             const std::string &variable_name,
+                                                             const std::vector<double> &levels,
+                                                             InterpolationType type,
+                                                             bool allow_extrapolation) {
+  // The context depends on the variable, the interpolation type, the target grid and the
+  // part of it owned by this processor.
+  std::string key = pism::printf("%s:%d:%d:%d:%u:%u:%d:%d:%d:%d:%.17g:%.17g:%.17g:%.17g",
+                                 variable_name.c_str(), (int)type, (int)allow_extrapolation,
+                                 (int)grid.registration(),
+                                 grid.Mx(), grid.My(), grid.xs(), grid.xm(), grid.ys(), grid.ym(),
+                                 grid.x0(), grid.y0(), grid.Lx(), grid.Ly());
+  for (auto z : levels) {
+    key += pism::printf(":%.17g", z);
+  }
+
+  auto result = file.interpolation_context(key);
+
+  if (not result) {
+    grid_info input_grid(file, variable_name, grid.ctx()->unit_system(), grid.registration());
+
+    check_input_grid(input_grid);
+
+    if (not allow_extrapolation) {
+      check_grid_overlap(input_grid, grid, levels);
+    }
+
+    result.reset(new LocalInterpCtx(input_grid, grid, levels, type));
+
+    file.cache_interpolation_context(key, result);
+  }
+
+  return result;
+}
+
 void regrid_spatial_variable(SpatialVariableMetadata &variable,
                              const IceGrid& grid, const File &file,
                              unsigned int t_start, RegriddingFlag flag,
@@ -911,15 +1085,8 @@ void regrid_spatial_variable(SpatialVariableMetadata &variable,
 
   if (var.exists) {                      // the variable was found successfully
 
-    {
-      grid_info input_grid(file, var.name, sys, grid.registration());
-
-      check_input_grid(input_grid);
-
-      if (not allow_extrapolation) {
-        check_grid_overlap(input_grid, grid, levels);
-      }
-    }
+    auto lic = interpolation_context(file, grid, var.name, levels,
+                                     interpolation_type, allow_extrapolation);
 
     if (flag == OPTIONAL_FILL_MISSING or flag == CRITICAL_FILL_MISSING) {
       log.message(2,
@@ -928,9 +1095,9 @@ void regrid_spatial_variable(SpatialVariableMetadata &variable,
                   file.filename().c_str());
 
       regrid_vec_fill_missing(file, grid, var.name, levels,
-                              t_start, default_value, interpolation_type, output);
+                              t_start, default_value, *lic, output);
     } else {
-      regrid_vec(file, grid, var.name, levels, t_start, interpolation_type, output);
+      regrid_vec(file, grid, var.name, levels, t_start, *lic, output);
     }
 
     // Now we need to get the units string from the file and convert
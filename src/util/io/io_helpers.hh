@@ -118,6 +118,10 @@ void write_attributes(const File &nc, const VariableMetadata &variable, IO_Type
 
 void read_valid_range(const File &nc, const std::string &name, VariableMetadata &variable);
 
+int compression_level(const Config &config, const std::string &name);
+
+void round_mantissa(std::vector<double> &data, int n_bits, double fill_value);
+
 bool file_exists(MPI_Comm com, const std::string &filename);
 
 void move_if_exists(MPI_Comm com, const std::string &file_to_move, int rank_to_use = 0);
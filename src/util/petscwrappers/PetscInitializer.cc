@@ -24,11 +24,17 @@
 #include <cstdio>
 
 #include "pism/util/error_handling.hh"
+#include "pism/pism_config.hh"      // Pism_USE_OPENMP
+
+#if (Pism_USE_OPENMP==1)
+#include <omp.h>                        // omp_set_num_threads
+#endif
 
 namespace pism {
 namespace petsc {
 
-Initializer::Initializer(int argc, char **argv, const char *help) {
+Initializer::Initializer(int argc, char **argv, const char *help)
+  : m_finalize_mpi(false) {
 
   PetscErrorCode ierr = 0;
   PetscBool initialized = PETSC_FALSE;
@@ -37,6 +43,27 @@ Initializer::Initializer(int argc, char **argv, const char *help) {
   PISM_CHK(ierr, "PetscInitialized");
 
   if (initialized == PETSC_FALSE) {
+    // true if the MPI library does not support calls from the main thread of a
+    // multi-threaded process
+    bool single_thread = false;
+#if (Pism_USE_OPENMP==1)
+    // PISM uses OpenMP threads in computational loops only, so all MPI calls are made by
+    // the main thread. Initialize MPI here (PETSc would ask for MPI_THREAD_SINGLE).
+    int mpi_initialized = 0;
+    MPI_Initialized(&mpi_initialized);
+    if (not mpi_initialized) {
+      int provided = MPI_THREAD_SINGLE;
+      MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+      m_finalize_mpi = true;
+
+      if (provided < MPI_THREAD_FUNNELED) {
+        // it is not safe to use more than one thread per MPI process
+        omp_set_num_threads(1);
+        single_thread = true;
+      }
+    }
+#endif
+
     ierr = PetscInitialize(&argc, &argv, NULL, help);
     PISM_CHK(ierr, "PetscInitialize");
 
@@ -44,6 +71,13 @@ Initializer::Initializer(int argc, char **argv, const char *help) {
       printf("PETSc initialization failed. Aborting...\n");
       MPI_Abort(MPI_COMM_WORLD, -1);
     }
+
+    if (single_thread) {
+      ierr = PetscPrintf(PETSC_COMM_WORLD,
+                         "PISM WARNING: the MPI library does not support MPI_THREAD_FUNNELED.\n"
+                         "              Using one OpenMP thread per MPI process.\n");
+      PISM_CHK(ierr, "PetscPrintf");
+    }
   }
 }
 
@@ -56,6 +90,10 @@ Initializer::~Initializer() {
     // there is nothing we can do if this fails
     ierr = PetscFinalize(); CHKERRCONTINUE(ierr);
   }
+
+  if (m_finalize_mpi) {
+    MPI_Finalize();
+  }
 }
 
 } // end of namespace petsc
@@ -29,6 +29,9 @@ class Initializer {
 public:
   Initializer(int argc, char **argv, const char *help);
   ~Initializer();
+private:
+  //! true if MPI was initialized here (and has to be finalized here, too)
+  bool m_finalize_mpi;
 };
 
 } // end of namespace petsc
@@ -44,9 +44,14 @@
 #include <jansson.h>            // JANSSON_VERSION
 #endif
 
+#if (Pism_USE_OPENMP==1)
+#include <omp.h>                // omp_get_num_threads, omp_get_thread_num
+#endif
+
 #include <petsctime.h>          // PetscTime
 
 #include "error_handling.hh"
+#include "Profiling.hh"
 
 namespace pism {
 
@@ -130,6 +135,7 @@ bool member(const std::string &string, const std::set<std::string> &set) {
 void GlobalReduce(MPI_Comm comm, double *local, double *result, int count, MPI_Op op) {
   int err = MPI_Allreduce(local, result, count, MPI_DOUBLE, op, comm);
   PISM_C_CHK(err, 0, "MPI_Allreduce");
+  Profiling::count_reduction(count * sizeof(double));
 }
 
 void GlobalMin(MPI_Comm comm, double *local, double *result, int count) {
@@ -148,6 +154,7 @@ unsigned int GlobalSum(MPI_Comm comm, unsigned int input) {
   unsigned int result;
   int err = MPI_Allreduce(&input, &result, 1, MPI_UNSIGNED, MPI_SUM, comm);
   PISM_C_CHK(err, 0, "MPI_Allreduce");
+  Profiling::count_reduction(sizeof(unsigned int));
   return result;
 }
 
@@ -155,6 +162,7 @@ int GlobalSum(MPI_Comm comm, int input) {
   int result;
   int err = MPI_Allreduce(&input, &result, 1, MPI_INT, MPI_SUM, comm);
   PISM_C_CHK(err, 0, "MPI_Allreduce");
+  Profiling::count_reduction(sizeof(int));
   return result;
 }
 
@@ -176,6 +184,257 @@ double GlobalSum(MPI_Comm comm, double local) {
   return result;
 }
 
+//! Element-wise reduction of pairs (operation, value) used by GlobalReduction.
+static void reduce_pairs(void *input, void *inout, int *length, MPI_Datatype *type) {
+  (void) type;
+
+  const double *in = (const double*)input;
+  double *result = (double*)inout;
+
+  for (int k = 0; k < *length; ++k) {
+    const double a = in[2 * k + 1];
+    double &b = result[2 * k + 1];
+
+    switch ((GlobalReduction::Operation)in[2 * k]) {
+    case GlobalReduction::SUM:
+      b = a + b;
+      break;
+    case GlobalReduction::MIN:
+      b = std::min(a, b);
+      break;
+    case GlobalReduction::MAX:
+    default:
+      b = std::max(a, b);
+      break;
+    }
+  }
+}
+
+struct PairReduction {
+  MPI_Datatype type;
+  MPI_Op op;
+};
+
+//! Free the MPI data type and the operation in a PairReduction. Called by MPI_Finalize().
+static int free_pair_reduction(MPI_Comm comm, int keyval, void *attribute, void *extra) {
+  (void) comm;
+  (void) keyval;
+  (void) attribute;
+
+  PairReduction *reduction = (PairReduction*)extra;
+  MPI_Op_free(&reduction->op);
+  MPI_Type_free(&reduction->type);
+
+  return MPI_SUCCESS;
+}
+
+//! Return the MPI data type (pairs of doubles) and the operation used to reduce pairs
+//! (operation, value).
+/*!
+ * These are created once (on the first call) and re-used. They are freed when MPI is
+ * finalized (MPI_Finalize() deletes attributes of MPI_COMM_SELF first).
+ */
+static const PairReduction& pair_reduction() {
+  static PairReduction reduction = {MPI_DATATYPE_NULL, MPI_OP_NULL};
+
+  if (reduction.op == MPI_OP_NULL) {
+    int err = MPI_Type_contiguous(2, MPI_DOUBLE, &reduction.type);
+    PISM_C_CHK(err, 0, "MPI_Type_contiguous");
+
+    err = MPI_Type_commit(&reduction.type);
+    PISM_C_CHK(err, 0, "MPI_Type_commit");
+
+    err = MPI_Op_create(reduce_pairs, 1, &reduction.op);
+    PISM_C_CHK(err, 0, "MPI_Op_create");
+
+    int keyval = MPI_KEYVAL_INVALID;
+    err = MPI_Comm_create_keyval(MPI_COMM_NULL_COPY_FN, free_pair_reduction,
+                                 &keyval, &reduction);
+    PISM_C_CHK(err, 0, "MPI_Comm_create_keyval");
+
+    err = MPI_Comm_set_attr(MPI_COMM_SELF, keyval, NULL);
+    PISM_C_CHK(err, 0, "MPI_Comm_set_attr");
+  }
+
+  return reduction;
+}
+
+GlobalReduction::GlobalReduction(MPI_Comm comm)
+  : m_comm(comm), m_request(MPI_REQUEST_NULL), m_in_progress(false) {
+  // empty
+}
+
+GlobalReduction::~GlobalReduction() {
+  try {
+    // complete the collective: every rank has to participate
+    end();
+  } catch (...) {
+    // don't throw from a destructor
+  }
+}
+
+//! Add a local value and return its index.
+int GlobalReduction::add(Operation op, double local) {
+  if (m_in_progress) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "cannot add values during a reduction");
+  }
+
+  m_ops.push_back(op);
+  m_values.push_back(local);
+
+  return m_values.size() - 1;
+}
+
+//! Add local values and return the index of the first one.
+int GlobalReduction::add(Operation op, const std::vector<double> &local) {
+  int result = m_values.size();
+
+  for (auto v : local) {
+    add(op, v);
+  }
+
+  return result;
+}
+
+GlobalReduction::Mode GlobalReduction::mode() const {
+  bool sums = false, other = false;
+  for (auto op : m_ops) {
+    if (op == SUM) {
+      sums = true;
+    } else {
+      other = true;
+    }
+  }
+
+  if (sums and other) {
+    return MIXED;
+  }
+  return sums ? ALL_SUMS : NO_SUMS;
+}
+
+//! Start a non-blocking reduction. Local values may not be added until end() is called.
+void GlobalReduction::begin() {
+  if (m_in_progress) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "a reduction is already in progress");
+  }
+
+  const int N = m_values.size();
+  int err = 0;
+
+  switch (mode()) {
+  case ALL_SUMS:
+    m_send = m_values;
+    m_recv.resize(N);
+    err = MPI_Iallreduce(m_send.data(), m_recv.data(), N, MPI_DOUBLE, MPI_SUM, m_comm, &m_request);
+    break;
+  case NO_SUMS:
+    // min(x) = -max(-x): use one MPI_MAX reduction for both minima and maxima
+    m_send.resize(N);
+    m_recv.resize(N);
+    for (int k = 0; k < N; ++k) {
+      m_send[k] = m_ops[k] == MIN ? -m_values[k] : m_values[k];
+    }
+    err = MPI_Iallreduce(m_send.data(), m_recv.data(), N, MPI_DOUBLE, MPI_MAX, m_comm, &m_request);
+    break;
+  case MIXED:
+  default:
+    m_send.resize(2 * N);
+    m_recv.resize(2 * N);
+    for (int k = 0; k < N; ++k) {
+      m_send[2 * k]     = m_ops[k];
+      m_send[2 * k + 1] = m_values[k];
+    }
+    err = MPI_Iallreduce(m_send.data(), m_recv.data(), N,
+                         pair_reduction().type, pair_reduction().op, m_comm, &m_request);
+    break;
+  }
+  PISM_C_CHK(err, 0, "MPI_Iallreduce");
+
+  Profiling::count_reduction(m_send.size() * sizeof(double));
+
+  m_in_progress = true;
+}
+
+//! Complete the reduction started by begin().
+void GlobalReduction::end() {
+  if (not m_in_progress) {
+    return;
+  }
+
+  int err = MPI_Wait(&m_request, MPI_STATUS_IGNORE);
+  m_in_progress = false;
+  PISM_C_CHK(err, 0, "MPI_Wait");
+
+  const int N = m_values.size();
+  switch (mode()) {
+  case ALL_SUMS:
+    m_values = m_recv;
+    break;
+  case NO_SUMS:
+    for (int k = 0; k < N; ++k) {
+      m_values[k] = m_ops[k] == MIN ? -m_recv[k] : m_recv[k];
+    }
+    break;
+  case MIXED:
+  default:
+    for (int k = 0; k < N; ++k) {
+      m_values[k] = m_recv[2 * k + 1];
+    }
+    break;
+  }
+}
+
+//! Compute all global sums, minima and maxima using one collective call.
+void GlobalReduction::reduce() {
+  begin();
+  end();
+}
+
+//! Return the result number `k` (after reduce() or end()).
+double GlobalReduction::operator[](int k) const {
+  if (m_in_progress) {
+    throw RuntimeError(PISM_ERROR_LOCATION, "the reduction is still in progress");
+  }
+  return m_values.at(k);
+}
+
+//! Remove all values to re-use this object.
+void GlobalReduction::reset() {
+  end();
+  m_ops.clear();
+  m_values.clear();
+}
+
+//! Number of threads in the current OpenMP team (1 outside of parallel regions and if
+//! PISM was built without OpenMP).
+int thread_count() {
+#if (Pism_USE_OPENMP==1)
+  return omp_get_num_threads();
+#else
+  return 1;
+#endif
+}
+
+//! Index of the calling thread in the current OpenMP team (always 0 if PISM was built
+//! without OpenMP).
+int thread_index() {
+#if (Pism_USE_OPENMP==1)
+  return omp_get_thread_num();
+#else
+  return 0;
+#endif
+}
+
+//! Maximum number of threads in a team created by a parallel region (always 1 if PISM
+//! was built without OpenMP).
+int max_thread_count() {
+#if (Pism_USE_OPENMP==1)
+  return omp_get_max_threads();
+#else
+  return 1;
+#endif
+}
+
 static const int TEMPORARY_STRING_LENGTH = 32768;
 
 std::string version() {
@@ -226,6 +485,12 @@ std::string version() {
   result += buffer;
 #endif
 
+#if (Pism_USE_OPENMP==1)
+  snprintf(buffer, sizeof(buffer), "OpenMP %d (up to %d threads per rank).\n",
+           _OPENMP, omp_get_max_threads());
+  result += buffer;
+#endif
+
 #if (Pism_BUILD_PYTHON_BINDINGS==1)
   snprintf(buffer, sizeof(buffer), "SWIG %s.\n", pism::swig_version);
   result += buffer;
@@ -115,6 +115,60 @@ unsigned int GlobalSum(MPI_Comm comm, unsigned int input);
 
 int GlobalSum(MPI_Comm comm, int input);
 
+//! Combines several global sums, minima and maxima into one MPI collective.
+/*!
+ * Add local values using add(), then call reduce() (or begin() and end() to overlap the
+ * reduction with computations) and get results using operator[]:
+ *
+ * @code
+ * GlobalReduction reduction(com);
+ * int area  = reduction.add(GlobalReduction::SUM, local_area);
+ * int H_max = reduction.add(GlobalReduction::MAX, local_H_max);
+ * reduction.reduce();
+ * double total_area = reduction[area];
+ * @endcode
+ *
+ * A GlobalReduction object can be re-used after calling reset().
+ */
+class GlobalReduction {
+public:
+  enum Operation {SUM, MIN, MAX};
+
+  GlobalReduction(MPI_Comm comm);
+  ~GlobalReduction();
+
+  int add(Operation op, double local);
+  int add(Operation op, const std::vector<double> &local);
+
+  void reduce();
+
+  void begin();
+  void end();
+
+  double operator[](int k) const;
+
+  void reset();
+private:
+  enum Mode {ALL_SUMS, NO_SUMS, MIXED};
+  Mode mode() const;
+
+  MPI_Comm m_comm;
+  std::vector<Operation> m_ops;
+  std::vector<double> m_values;
+  //! send and receive buffers (pairs (operation, value) if sums are mixed with min/max)
+  std::vector<double> m_send, m_recv;
+
+  MPI_Request m_request;
+  bool m_in_progress;
+};
+
+// threads
+int thread_count();
+
+int thread_index();
+
+int max_thread_count();
+
 std::string version();
 
 std::string printf(const char *format, ...) __attribute__((format(printf, 1, 2)));
@@ -0,0 +1,134 @@
+"""Tests of IceModelVec3 fields stored in single precision."""
+
+import os
+import PISM
+import numpy as np
+
+ctx = PISM.Context()
+ctx.log.set_threshold(1)
+
+def create_grid(Mz):
+    "Create a small grid with Mz levels"
+    params = PISM.GridParameters(ctx.config)
+    params.Lx = 1e5
+    params.Ly = 1e5
+    params.Mx = 3
+    params.My = 4
+    params.Mz = Mz
+    params.Lz = 1000
+    params.registration = PISM.CELL_CORNER
+    params.periodicity = PISM.NOT_PERIODIC
+    params.ownership_ranges_from_options(ctx.size)
+    params.z[:] = np.linspace(0, params.Lz, params.Mz)
+
+    return PISM.IceGrid(ctx.ctx, params)
+
+def create(grid, name, precision):
+    "Create a 3D field stored using a given precision"
+    v = PISM.IceModelVec3(grid, name, PISM.WITHOUT_GHOSTS)
+    v.set_precision(precision)
+    return v
+
+def column(grid, i, j):
+    "Values in the column (i, j). These are exactly representable in single precision."
+    return [i + 10.0 * j + 100.0 * k + 0.25 for k in range(grid.Mz())]
+
+def fill(v):
+    grid = v.grid()
+    with PISM.vec.Access(nocomm=v):
+        for (i, j) in grid.points():
+            v.set_column(i, j, column(grid, i, j))
+
+def check(v, scale=1.0):
+    "Check that v contains scale * column(i, j) in all columns"
+    grid = v.grid()
+    with PISM.vec.Access(nocomm=v):
+        for (i, j) in grid.points():
+            expected = scale * np.array(column(grid, i, j))
+            np.testing.assert_equal(np.array(v.get_column_vector(i, j)), expected)
+
+def single_precision(Mz):
+    grid = create_grid(Mz)
+
+    v = create(grid, "v", PISM.SINGLE_PRECISION)
+    assert v.precision() == PISM.SINGLE_PRECISION
+
+    fill(v)
+    check(v)
+
+    # interpolation in the vertical direction
+    z = grid.z()
+    with PISM.vec.Access(nocomm=v):
+        for (i, j) in grid.points():
+            C = column(grid, i, j)
+            for k in range(Mz - 1):
+                np.testing.assert_almost_equal(v.getValZ(i, j, 0.5 * (z[k] + z[k + 1])),
+                                               0.5 * (C[k] + C[k + 1]))
+
+    # range and norms
+    R = v.range()
+    assert R.min == column(grid, 0, 0)[0]
+    assert R.max == column(grid, grid.Mx() - 1, grid.My() - 1)[-1]
+
+    total = sum(sum(column(grid, i, j)) for i in range(grid.Mx()) for j in range(grid.My()))
+    np.testing.assert_almost_equal(v.norm(PISM.PETSc.NormType.N1), total)
+    np.testing.assert_almost_equal(v.norm(PISM.PETSc.NormType.NORM_INFINITY), R.max)
+
+    # mixed-precision copies
+    d = create(grid, "d", PISM.DOUBLE_PRECISION)
+    d.copy_from(v)
+    check(d)
+
+    w = create(grid, "w", PISM.SINGLE_PRECISION)
+    w.copy_from(d)
+    check(w)
+
+    # arithmetic: double += single, single += double, single += single
+    d.add(2.0, v)
+    check(d, 3.0)
+
+    w.add(1.0, d)
+    check(w, 4.0)
+
+    w.add(-1.0, v)
+    check(w, 3.0)
+
+    w.scale(2.0)
+    check(w, 6.0)
+
+    # values that are not representable in single precision are rounded
+    w.set(0.1)
+    with PISM.vec.Access(nocomm=w):
+        for (i, j) in grid.points():
+            np.testing.assert_allclose(w.get_column_vector(i, j), 0.1, rtol=1e-7)
+
+    # operator() cannot be used with single precision fields
+    with PISM.vec.Access(nocomm=v):
+        try:
+            v[0, 0, 0]
+            assert False, "failed to stop access to a single precision field using operator()"
+        except RuntimeError:
+            pass
+
+    # write/read round trip
+    filename = "single_precision_%d.nc" % Mz
+    try:
+        v.dump(filename)
+
+        u = create(grid, "v", PISM.SINGLE_PRECISION)
+        u.read(filename, 0)
+        check(u)
+
+        u = create(grid, "v", PISM.DOUBLE_PRECISION)
+        u.read(filename, 0)
+        check(u)
+    finally:
+        os.remove(filename)
+
+def single_precision_odd_Mz_test():
+    "IceModelVec3 in single precision (odd number of levels)"
+    single_precision(5)
+
+def single_precision_even_Mz_test():
+    "IceModelVec3 in single precision (even number of levels)"
+    single_precision(6)
@@ -671,6 +671,46 @@ def flowlaw_test():
         check_flow_law(factory, flow_law_name, EC, np.array(data))
 
 
+def flowlaw_batch_test():
+    "Batch flow law kernels (hardness_n, flow_n) match scalar versions"
+    ctx = PISM.context_from_options(PISM.PETSc.COMM_WORLD, "flowlaw_batch_test")
+    EC = ctx.enthalpy_converter()
+    factory = PISM.FlowLawFactory("stress_balance.sia.", ctx.config(), EC)
+
+    def inputs(n):
+        "Cold and temperate ice (including water fractions above the observed limit)"
+        depth = np.linspace(0, 3000, n)
+        pressure = [EC.pressure(d) for d in depth]
+        enthalpy = []
+        for k, p in enumerate(pressure):
+            Tm = EC.melting_temperature(p)
+            if k % 3 == 0:
+                enthalpy.append(EC.enthalpy(Tm, 0.03 * k / max(n - 1, 1), p))
+            else:
+                enthalpy.append(EC.enthalpy(Tm - 40.0 * k / n, 0.0, p))
+        stress = np.linspace(1e3, 2e5, n)
+        grain_size = np.linspace(1e-3, 5e-3, n)
+        return list(stress), enthalpy, pressure, list(grain_size)
+
+    for name in ["gpbld", "pb", "arr", "arrwarm", "hooke", "isothermal_glen", "gk"]:
+        factory.set_default(name)
+        law = factory.create()
+
+        # sizes that are not multiples of the block size used by GPBLD, and zero
+        for n in [0, 1, 63, 64, 65, 200]:
+            S, E, P, gs = inputs(n)
+
+            flow = law.flow_n(S, E, P, gs)
+            flow_scalar = [law.flow(*args) for args in zip(S, E, P, gs)]
+            assert len(flow) == n
+            np.testing.assert_allclose(flow, flow_scalar, rtol=1e-12, atol=0)
+
+            hardness = law.hardness_n(E, P)
+            hardness_scalar = [law.hardness(e, p) for e, p in zip(E, P)]
+            assert len(hardness) == n
+            np.testing.assert_allclose(hardness, hardness_scalar, rtol=1e-12, atol=0)
+
+
 def ssa_trivial_test():
     "Test the SSA solver using a trivial setup."
 
@@ -1219,3 +1259,113 @@ class ForcingOptions(TestCase):
         ctx.config.import_from(self.config)
 
         os.remove(self.filename)
+
+def ragged_columns_test():
+    "RaggedColumns: indexing, sizes and values above stored levels"
+    grid = create_dummy_grid()
+    Mz = grid.Mz()
+    assert Mz > 3
+
+    columns = PISM.RaggedColumns(grid, 1, 0)
+
+    def n_levels(i, j):
+        "Number of levels in the column (i, j); different for all columns."
+        return (i + 2 * j) % Mz + 1
+
+    def values(i, j):
+        return [100.0 * i + 10.0 * j + k for k in range(n_levels(i, j))]
+
+    points = list(grid.points_with_ghosts(nGhosts=1))
+
+    for i, j in points:
+        columns.set_size(i, j, n_levels(i, j))
+    columns.pack()
+
+    for i, j in points:
+        columns.set_column(i, j, values(i, j))
+
+    for i, j in points:
+        assert columns.size(i, j) == n_levels(i, j)
+        expected = values(i, j)
+        # levels above the stored ones get the value of the top stored level
+        expected += [expected[-1]] * (Mz - len(expected))
+        np.testing.assert_equal(columns.get_column_vector(i, j, Mz), expected)
+
+    # growing columns re-allocates storage and preserves stored values
+    for i, j in points:
+        columns.set_size(i, j, Mz)
+    columns.pack()
+
+    for i, j in points:
+        assert columns.size(i, j) == Mz
+        expected = columns.get_column_vector(i, j, n_levels(i, j))
+        np.testing.assert_equal(expected, values(i, j))
+
+def compression_overrides_test():
+    "Parsing output.netcdf4.compression_overrides"
+    config = PISM.DefaultConfig(ctx.com, "pism_config", "-config", ctx.unit_system)
+    config.init_with_default(ctx.log)
+
+    config.set_number("output.netcdf4.compression_level", 2)
+
+    config.set_string("output.netcdf4.compression_overrides", "")
+    assert PISM.compression_level(config, "thk") == 2
+
+    config.set_string("output.netcdf4.compression_overrides", "thk:0,velsurf_mag:5")
+    assert PISM.compression_level(config, "thk") == 0
+    assert PISM.compression_level(config, "velsurf_mag") == 5
+    assert PISM.compression_level(config, "usurf") == 2
+
+    # the last override wins
+    config.set_string("output.netcdf4.compression_overrides", "thk:1,thk:9")
+    assert PISM.compression_level(config, "thk") == 9
+
+    for overrides in ["thk", "thk:", "thk:1:2", "thk:one", "thk:1.5", "usurf:1,thk"]:
+        config.set_string("output.netcdf4.compression_overrides", overrides)
+        try:
+            PISM.compression_level(config, "usurf")
+            assert False, "failed to detect an invalid override '{}'".format(overrides)
+        except RuntimeError:
+            pass
+
+def round_mantissa_test():
+    "Rounding the mantissa of single precision values"
+    fill_value = -2e9
+    values = [0.0, 1.0, -1.0, 1.0 / 3.0, np.pi * 1e5, -np.e * 1e-5, 123.456, 1e-30]
+
+    for n_bits in [1, 4, 10, 16, 22]:
+        data = PISM.DoubleVector(values + [fill_value, np.inf, -np.inf])
+
+        PISM.round_mantissa(data, n_bits, fill_value)
+
+        rounded = np.array(data)
+
+        # the fill value and values that are not finite are not modified
+        assert rounded[len(values)] == fill_value
+        assert rounded[len(values) + 1] == np.inf
+        assert rounded[len(values) + 2] == -np.inf
+
+        # the relative error of round-to-nearest is at most 2^-(n_bits + 1) (plus the
+        # error of the conversion to single precision)
+        exact = np.array(values)
+        bound = 2.0**(-(n_bits + 1)) + 2.0**-24
+        np.testing.assert_array_less(np.abs(rounded[:len(values)] - exact),
+                                     bound * np.abs(exact) + 1e-45)
+
+        # rounding is idempotent
+        again = PISM.DoubleVector(list(rounded))
+        PISM.round_mantissa(again, n_bits, fill_value)
+        np.testing.assert_equal(np.array(again), rounded)
+
+    # rounding the largest finite single precision value up would overflow
+    max_float = float(np.finfo(np.float32).max)
+    data = PISM.DoubleVector([max_float, -max_float])
+    PISM.round_mantissa(data, 4, fill_value)
+    assert np.all(np.isfinite(np.array(data)))
+    np.testing.assert_array_less(np.abs(np.array(data)), max_float + 1)
+
+    # n_bits outside of (0, 23) disables rounding
+    for n_bits in [0, 23, 30]:
+        data = PISM.DoubleVector(values)
+        PISM.round_mantissa(data, n_bits, fill_value)
+        np.testing.assert_equal(np.array(data), values)
@@ -0,0 +1,81 @@
+"""Tests of OutputGrid (block averages and striding used to save spatial time-series on a
+coarser grid)."""
+
+import PISM
+import numpy as np
+
+ctx = PISM.Context()
+
+# 9 by 7 grid: with the coarsening factor 2 the last blocks in both directions are
+# incomplete
+Mx = 9
+My = 7
+
+def input_field(grid, fill_value=None):
+    "Create a field f(i, j) = i + 10 * j"
+    v = PISM.IceModelVec2S(grid, "v", PISM.WITHOUT_GHOSTS)
+
+    with PISM.vec.Access(nocomm=v):
+        for (i, j) in grid.points():
+            v[i, j] = i + 10.0 * j
+
+            if fill_value is not None and (i, j) == (0, 0):
+                v[i, j] = fill_value
+
+    if fill_value is not None:
+        v.metadata().set_number("_FillValue", fill_value)
+
+    return v
+
+def map_field(method, factor, v):
+    "Map v to the output grid, returning the output grid and a dictionary of results."
+    output_grid = PISM.OutputGrid(v.grid(), method, factor, [], [])
+    out = output_grid.grid()
+
+    result = PISM.IceModelVec2S(out, "result", PISM.WITHOUT_GHOSTS)
+    result.copy_from(output_grid.map(v))
+
+    values = {}
+    with PISM.vec.Access(nocomm=result):
+        for (i, j) in out.points():
+            values[(i, j)] = result[i, j]
+
+    return out, values
+
+def block_mean(k, factor, M):
+    "Mean of indexes in the block k along an axis of length M."
+    return np.mean(range(k * factor, min((k + 1) * factor, M)))
+
+def grid():
+    return PISM.IceGrid.Shallow(ctx.ctx, 1e5, 1e5, 0, 0, Mx, My,
+                                PISM.CELL_CORNER, PISM.NOT_PERIODIC)
+
+def average_test():
+    "OutputGrid: block averages"
+    factor = 2
+    out, result = map_field(PISM.OutputGrid.AVERAGE, factor, input_field(grid()))
+
+    assert (out.Mx(), out.My()) == (5, 4)
+
+    for (I, J), value in result.items():
+        expected = block_mean(I, factor, Mx) + 10.0 * block_mean(J, factor, My)
+        np.testing.assert_almost_equal(value, expected)
+
+def average_fill_value_test():
+    "OutputGrid: block averages ignore fill values"
+    factor = 2
+    out, result = map_field(PISM.OutputGrid.AVERAGE, factor, input_field(grid(), -1.0))
+
+    # the block (0, 0) contains 1, 10, 11 and the fill value
+    if (0, 0) in result:
+        np.testing.assert_almost_equal(result[0, 0], (1.0 + 10.0 + 11.0) / 3.0)
+
+def stride_test():
+    "OutputGrid: striding"
+    factor = 3
+    out, result = map_field(PISM.OutputGrid.STRIDE, factor, input_field(grid()))
+
+    assert (out.Mx(), out.My()) == (3, 3)
+
+    for (I, J), value in result.items():
+        np.testing.assert_almost_equal(value, factor * I + 10.0 * factor * J)
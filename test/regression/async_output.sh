@@ -0,0 +1,46 @@
+#!/bin/bash
+
+# Checks that asynchronous output (-async_output) produces the same output, extra and
+# backup files as synchronous output.
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+files="foo-async.nc sync.nc sync_backup.nc ex-sync.nc async.nc async_backup.nc ex-async.nc"
+
+rm -f $files
+
+set -e -x
+
+OPTS="-o_size small -Mx 31 -My 41"
+
+# Create a file to start from:
+$MPIEXEC -n 2 $PISM_PATH/pisms -energy enthalpy -y 1000 $OPTS -o foo-async.nc
+
+# Run for 10 years, saving a backup after every time step and yearly extra files:
+RUN_OPTS="-i foo-async.nc -y 10 -o_size medium -backup_interval 0 \
+          -extra_times 0:1:10 -extra_vars thk,velsurf_mag,enthalpy,flux_divergence"
+
+$MPIEXEC -n 2 $PISM_PATH/pismr $RUN_OPTS -o sync.nc -extra_file ex-sync.nc
+
+$MPIEXEC -n 2 $PISM_PATH/pismr $RUN_OPTS -o async.nc -extra_file ex-async.nc -async_output
+
+set +e
+
+# Compare all variables except for wall clock times:
+for prefix in "" "ex-";
+do
+    $PISM_PATH/nccmp.py -x -v timestamp ${prefix}sync.nc ${prefix}async.nc
+    if [ $? != 0 ];
+    then
+        exit 1
+    fi
+done
+
+$PISM_PATH/nccmp.py -x -v timestamp sync_backup.nc async_backup.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
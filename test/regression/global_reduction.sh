@@ -0,0 +1,58 @@
+#!/bin/bash
+
+# Checks GlobalReduction on 2 ranks, including the "mixed" mode (sums combined with
+# minima and maxima in one reduction).
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+PYTHONEXEC=python
+if [ $# -ge 4 ] && [ "$4" == "-python" ]
+then
+  PYTHONEXEC=$5
+fi
+export PYTHONPATH=${PISM_PATH}/site-packages:${PYTHONPATH}
+
+files="global_reduction.py"
+
+rm -f $files
+
+cat > global_reduction.py <<EOF
+import PISM
+
+com = PISM.PETSc.COMM_WORLD
+rank = com.getRank()
+size = com.getSize()
+assert size == 2
+
+R = PISM.GlobalReduction
+
+def check(ops, expected):
+    "Reduce (operation, local value) pairs and compare to expected results."
+    r = R(com)
+    for op, value in ops:
+        r.add(op, value)
+    r.reduce()
+    for k, e in enumerate(expected):
+        assert r[k] == e, (k, r[k], e)
+
+# rank 0 contributes 1, rank 1 contributes 2
+x = rank + 1.0
+
+# sums only
+check([(R.SUM, x), (R.SUM, -x)], [3.0, -3.0])
+# no sums
+check([(R.MIN, x), (R.MAX, x)], [1.0, 2.0])
+# mixed: sums, minima and maxima in one reduction (repeated to re-use the MPI type)
+for k in range(3):
+    check([(R.MAX, x), (R.SUM, x), (R.MIN, -x), (R.SUM, 10.0 * x)],
+          [2.0, 3.0, -2.0, 30.0])
+EOF
+
+set -e -x
+
+$MPIEXEC -n 2 $PYTHONEXEC global_reduction.py
+
+set +e
+
+rm -f $files; exit 0
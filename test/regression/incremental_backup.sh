@@ -0,0 +1,55 @@
+#!/bin/bash
+
+# Checks that restarting from an incremental backup (-backup_incremental) gives the same
+# model state as restarting from a full backup.
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+files="foo-incr.nc full.nc full_backup.nc full_backup.nc~ incr.nc incr_backup.nc incr_backup.nc~ full-restart.nc incr-restart.nc"
+
+rm -f $files
+
+set -e -x
+
+OPTS="-o_size small -Mx 31 -My 41"
+
+# Create a file to start from:
+$MPIEXEC -n 2 $PISM_PATH/pisms -energy enthalpy -y 1000 $OPTS -o foo-incr.nc
+
+# Run for 10 years, saving a backup after every time step. Use a full backup every time
+# in the first run and mostly incremental backups in the second one:
+$MPIEXEC -n 2 $PISM_PATH/pismr -i foo-incr.nc -y 10 -o_size small -o full.nc \
+         -backup_interval 0
+
+$MPIEXEC -n 2 $PISM_PATH/pismr -i foo-incr.nc -y 10 -o_size small -o incr.nc \
+         -backup_interval 0 -backup_incremental -backup_full_interval 4
+
+# Restart from both backups, running for 0 years:
+$MPIEXEC -n 2 $PISM_PATH/pismr -i full_backup.nc -y 0 -o_size small -o full-restart.nc
+$MPIEXEC -n 2 $PISM_PATH/pismr -i incr_backup.nc -y 0 -o_size small -o incr-restart.nc
+
+set +e
+
+# Compare model state variables:
+vars="basal_melt_rate_grounded,enthalpy,thk,topg,tillwat"
+
+$PISM_PATH/nccmp.py -v $vars full_backup.nc incr_backup.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+$PISM_PATH/nccmp.py -v $vars full-restart.nc incr-restart.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+$PISM_PATH/nccmp.py -v $vars incr.nc incr-restart.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
@@ -0,0 +1,37 @@
+#!/bin/bash
+
+# Checks that a native (per-processor) backup written using 2 processors can be used to
+# restart using 3 processors (i.e. with a different domain decomposition).
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+files="foo-native.nc bar-native.nc baz-native.nc bar-native_backup.pism* bar-native_backup.pism~*"
+
+rm -f $files
+
+set -e -x
+
+OPTS="-o_size small -Mx 31 -My 41"
+
+# Create a file to start from:
+$MPIEXEC -n 2 $PISM_PATH/pisms -energy enthalpy -y 1000 $OPTS -o foo-native.nc
+
+# Run for 10 years, saving a native backup after every time step (the last one contains
+# the final model state):
+$MPIEXEC -n 2 $PISM_PATH/pismr -i foo-native.nc -y 10 -o_size small -o bar-native.nc \
+         -backup_format native -backup_interval 0
+
+# Restart from the backup using a different number of processors, running for 0 years:
+$MPIEXEC -n 3 $PISM_PATH/pismr -i bar-native_backup.pism -y 0 -o_size small -o baz-native.nc
+
+set +e
+
+# Compare model state variables:
+$PISM_PATH/nccmp.py -v basal_melt_rate_grounded,enthalpy,thk,topg,tillwat bar-native.nc baz-native.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
@@ -0,0 +1,58 @@
+#!/bin/bash
+
+# Checks that files written using the netcdf3 backend do not depend on the number of
+# aggregators (output.netcdf3.n_aggregators) and can be read back.
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+NRANGE="1 2 3 5"
+
+files="foo-agg.nc bar-agg-0.nc baz-agg-0.nc"
+for N in $NRANGE;
+do
+    files="$files bar-agg-$N.nc baz-agg-$N.nc"
+done
+
+rm -f $files
+
+set -e -x
+
+OPTS="-o_format netcdf3 -o_size big"
+
+# Create a file to start from (2D and 3D fields):
+$MPIEXEC -n 1 $PISM_PATH/pisms -energy enthalpy -y 100 -Mx 31 -My 41 -Mz 21 -o foo-agg.nc
+
+# Write using 5 ranks choosing the number of aggregators automatically (the default) and
+# using a given number of aggregators, then read the output back:
+for N in 0 $NRANGE;
+do
+    $MPIEXEC -n 5 $PISM_PATH/pismr -i foo-agg.nc -y 0 $OPTS -o bar-agg-$N.nc \
+             -output.netcdf3.n_aggregators $N
+    $MPIEXEC -n 5 $PISM_PATH/pismr -i bar-agg-$N.nc -y 0 $OPTS -o baz-agg-$N.nc \
+             -output.netcdf3.n_aggregators $N
+done
+
+set +e
+
+# Compare:
+for N in $NRANGE;
+do
+    for prefix in bar baz;
+    do
+        $PISM_PATH/nccmp.py -x -v timestamp $prefix-agg-0.nc $prefix-agg-$N.nc
+        if [ $? != 0 ];
+        then
+            exit 1
+        fi
+    done
+done
+
+# Compare model state variables read back from a file:
+$PISM_PATH/nccmp.py -v basal_melt_rate_grounded,enthalpy,thk,topg,tillwat bar-agg-0.nc baz-agg-0.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
@@ -0,0 +1,54 @@
+#!/bin/bash
+
+# Runs all pism_bench kernels on a small grid and checks that the timing report is valid
+# JSON listing every kernel.
+
+PISM_PATH=$1
+MPIEXEC=$2
+PISM_SOURCE_DIR=$3
+
+# List of files to remove when done:
+files="bench.nc bench.nc~ bench.json bench-compressed.nc bench-compressed.nc~ bench-compressed.json"
+
+rm -f $files
+
+set -e -x
+
+OPTS="-verbose 1 -Mx 21 -My 21 -Mz 11 -Lz 4000 -bench_repeat 2 -bench_report bench.json -o bench.nc"
+
+# do stuff
+$MPIEXEC -n 2 $PISM_PATH/pism_bench $OPTS
+
+# time the output kernel only, writing a compressed NetCDF-4 file
+$MPIEXEC -n 2 $PISM_PATH/pism_bench -verbose 1 -Mx 21 -My 21 -Mz 11 -Lz 4000 \
+         -bench_kernels output -bench_repeat 2 -bench_report bench-compressed.json \
+         -o bench-compressed.nc -o_format netcdf4_serial -output.netcdf4.chunking \
+         -output.netcdf4.compression_level 5 -output.netcdf4.compression_overrides thk:0
+
+set +e
+
+# Check results:
+/usr/bin/env python <<EOF
+import json
+report = json.load(open("bench.json"))
+assert report["ranks"] == 2
+for k in ["sia", "ssafd", "enthalpy", "routing", "mass_transport", "output"]:
+    assert len(report["kernels"][k]["times"]) == 2, k
+
+output = report["kernels"]["output"]
+assert output["file_size"] > 0
+assert output["compression_level"] == 0
+
+compressed = json.load(open("bench-compressed.json"))["kernels"]["output"]
+assert compressed["format"] == "netcdf4_serial"
+assert compressed["chunking"]
+assert compressed["compression_level"] == 5
+assert compressed["compression_overrides"] == "thk:0"
+assert 0 < compressed["file_size"] < output["file_size"]
+EOF
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
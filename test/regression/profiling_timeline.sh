@@ -0,0 +1,43 @@
+#!/bin/bash
+
+# Checks that pismr -profile_timeline saves a per-rank, per-step timeline including
+# profiling events and communication counters.
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+files="foo-timeline.nc bar-timeline.nc timeline.json"
+
+rm -f $files
+
+set -e -x
+
+OPTS="-o_size small -Mx 31 -My 31"
+
+# Create a file to start from:
+$MPIEXEC -n 2 $PISM_PATH/pisms -y 1000 $OPTS -o foo-timeline.nc
+
+$MPIEXEC -n 2 $PISM_PATH/pismr -i foo-timeline.nc -y 100 $OPTS -o bar-timeline.nc \
+         -profile_timeline timeline.json
+
+set +e
+
+# Check results:
+/usr/bin/env python <<EOF
+import json
+report = json.load(open("timeline.json"))
+assert report["ranks"] == 2
+assert [r["rank"] for r in report["timeline"]] == [0, 1]
+for r in report["timeline"]:
+    assert len(r["steps"]) > 0
+    for s in r["steps"]:
+        assert s["events"]["stress_balance"]["count"] == 1
+        assert s["ghost_updates"] > 0 and s["ghost_bytes"] > 0
+        assert s["reductions"] > 0
+EOF
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
@@ -0,0 +1,48 @@
+#!/bin/bash
+
+# Checks that Anderson acceleration of SSAFD Picard iterations (verification test I)
+# converges to the same solution as plain Picard iterations, using fewer iterations.
+
+PISM_PATH=$1
+MPIEXEC=$2
+MPIEXEC_COMMAND="$MPIEXEC -n 2"
+
+# List of files to remove when done:
+files="foo-fd-i-picard.nc foo-fd-i-anderson.nc test-I-picard.txt test-I-anderson.txt"
+
+rm -f $files
+
+set -e
+set -x
+
+OPTS="-verbose 3 -ssa_method fd -ssafd_picard_rtol 5e-07 -ssafd_ksp_rtol 1e-12 -Mx 5 -My 61"
+
+$MPIEXEC_COMMAND $PISM_PATH/ssa_testi $OPTS -o foo-fd-i-picard.nc > test-I-picard.txt
+$MPIEXEC_COMMAND $PISM_PATH/ssa_testi $OPTS -o foo-fd-i-anderson.nc \
+                 -ssafd_anderson_depth 5 > test-I-anderson.txt
+
+set +e
+
+# Compare solutions:
+$PISM_PATH/nccmp.py -r -t 1e-4 -v u_ssa,v_ssa foo-fd-i-picard.nc foo-fd-i-anderson.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+# Compare numbers of Picard iterations:
+outer_iterations() {
+    sed -n 's/.*[ =]\([0-9][0-9]*\) outer iterations.*/\1/p' $1 | tail -1
+}
+
+picard=$(outer_iterations test-I-picard.txt)
+anderson=$(outer_iterations test-I-anderson.txt)
+
+echo "Picard iterations: plain: ${picard}, with Anderson acceleration: ${anderson}"
+
+if [ -z "$picard" ] || [ -z "$anderson" ] || [ "$anderson" -ge "$picard" ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
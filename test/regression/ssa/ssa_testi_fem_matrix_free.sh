@@ -0,0 +1,34 @@
+#!/bin/bash
+
+# Checks that the SSAFEM solver using a matrix-free Jacobian and a Picard preconditioner
+# (-ssafem_matrix_free) gives the same solution of verification test I as the default
+# Newton solver.
+
+PISM_PATH=$1
+MPIEXEC=$2
+MPIEXEC_COMMAND="$MPIEXEC -n 2"
+
+# List of files to remove when done:
+files="foo-fem-i-default.nc foo-fem-i-mf.nc"
+
+rm -f $files
+
+set -e
+set -x
+
+OPTS="-verbose 1 -ssa_method fem -Mx 5 -My 61 -snes_rtol 1e-10"
+
+$MPIEXEC_COMMAND $PISM_PATH/ssa_testi $OPTS -o foo-fem-i-default.nc
+$MPIEXEC_COMMAND $PISM_PATH/ssa_testi $OPTS -o foo-fem-i-mf.nc \
+                 -ssafem_matrix_free -ssafem_preconditioner_lag 2
+
+set +e
+
+# Compare solutions:
+$PISM_PATH/nccmp.py -r -t 1e-6 -v u_ssa,v_ssa foo-fem-i-default.nc foo-fem-i-mf.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
@@ -0,0 +1,32 @@
+#!/bin/bash
+
+# Checks that SSAFEM preconditioned using algebraic multigrid (-ssa_multigrid) gives the
+# same solution of verification test I as the default preconditioner.
+
+PISM_PATH=$1
+MPIEXEC=$2
+MPIEXEC_COMMAND="$MPIEXEC -n 2"
+
+# List of files to remove when done:
+files="foo-fem-i-default.nc foo-fem-i-mg.nc"
+
+rm -f $files
+
+set -e
+set -x
+
+OPTS="-verbose 1 -ssa_method fem -Mx 5 -My 61 -snes_rtol 1e-10"
+
+$MPIEXEC_COMMAND $PISM_PATH/ssa_testi $OPTS -o foo-fem-i-default.nc
+$MPIEXEC_COMMAND $PISM_PATH/ssa_testi $OPTS -o foo-fem-i-mg.nc -ssa_multigrid
+
+set +e
+
+# Compare solutions:
+$PISM_PATH/nccmp.py -r -t 1e-6 -v u_ssa,v_ssa foo-fem-i-default.nc foo-fem-i-mg.nc
+if [ $? != 0 ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0
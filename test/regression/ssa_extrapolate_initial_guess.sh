@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# Checks that extrapolating the SSA initial guess in time reduces the total number of
+# Newton iterations of the SSAFEM solver.
+
+PISM_PATH=$1
+MPIEXEC=$2
+
+files="foo-extrapolation.nc bar-extrapolation.nc baz-extrapolation.nc log-default.txt log-extrapolation.txt"
+
+rm -f $files
+
+set -e -x
+
+# Create a file to start from:
+$MPIEXEC -n 2 $PISM_PATH/pisms -y 1000 -Mx 31 -My 31 -o_size small -o foo-extrapolation.nc
+
+OPTS="-i foo-extrapolation.nc -y 20 -max_dt 1 -o_size small -verbose 3 \
+      -stress_balance ssa+sia -ssa_method fem -yield_stress constant -tauc 1e4"
+
+$MPIEXEC -n 2 $PISM_PATH/pismr $OPTS -o bar-extrapolation.nc > log-default.txt
+$MPIEXEC -n 2 $PISM_PATH/pismr $OPTS -o baz-extrapolation.nc \
+         -ssa_extrapolate_initial_guess > log-extrapolation.txt
+
+set +e
+
+# Total numbers of Newton iterations:
+newton_iterations() {
+    sed -n 's/.*SSA: \([0-9][0-9]*\) Newton iterations.*/\1/p' $1 | awk '{n += $1} END {print n}'
+}
+
+default=$(newton_iterations log-default.txt)
+extrapolation=$(newton_iterations log-extrapolation.txt)
+
+echo "Newton iterations: default: ${default}, with extrapolation: ${extrapolation}"
+
+if [ -z "$default" ] || [ -z "$extrapolation" ] || [ "$extrapolation" -ge "$default" ];
+then
+    exit 1
+fi
+
+rm -f $files; exit 0